@@ -1,12 +1,16 @@
 #include "dataeditorwidget.h"
 #include "ui_dataeditorwidget.h"
 #include "pressurederivativecalculator.h"
+#include "flowperioddialog.h"
+#include "deconvolutiondialog.h"
+#include "decimationdialog.h"
+#include "outlierdialog.h"
+#include "spectralfilterdialog.h"
 #include <QDebug>
 #include <QFileDialog>
 #include <QMessageBox>
 #include <QFile>
 #include <QTextStream>
-#include <QStandardItemModel>
 #include <QHeaderView>
 #include <QStyledItemDelegate>
 #include <QPainter>
@@ -51,6 +55,7 @@
 #include <QTextEdit>
 #include <QPlainTextEdit>
 #include <cmath>
+#include <limits>
 #include <algorithm>
 
 // Qt6兼容性处理
@@ -69,12 +74,12 @@
 // 撤销重做命令实现
 // ============================================================================
 
-DataEditCommand::DataEditCommand(QStandardItemModel* model, QUndoCommand* parent)
+DataEditCommand::DataEditCommand(ColumnarTableModel* model, QUndoCommand* parent)
     : QUndoCommand(parent), m_model(model)
 {
 }
 
-CellEditCommand::CellEditCommand(QStandardItemModel* model, int row, int column,
+CellEditCommand::CellEditCommand(ColumnarTableModel* model, int row, int column,
                                  const QString& oldValue, const QString& newValue,
                                  QUndoCommand* parent)
     : DataEditCommand(model, parent), m_row(row), m_column(column),
@@ -86,12 +91,7 @@ CellEditCommand::CellEditCommand(QStandardItemModel* model, int row, int column,
 void CellEditCommand::undo()
 {
     if (m_model && m_row < m_model->rowCount() && m_column < m_model->columnCount()) {
-        QStandardItem* item = m_model->item(m_row, m_column);
-        if (!item) {
-            item = new QStandardItem();
-            m_model->setItem(m_row, m_column, item);
-        }
-        item->setText(m_oldValue);
+        m_model->setText(m_row, m_column, m_oldValue);
     }
 }
 
@@ -169,16 +169,11 @@ void DataEditorWidget::loadDataWithConfig(const QString& filePath, const QString
 void CellEditCommand::redo()
 {
     if (m_model && m_row < m_model->rowCount() && m_column < m_model->columnCount()) {
-        QStandardItem* item = m_model->item(m_row, m_column);
-        if (!item) {
-            item = new QStandardItem();
-            m_model->setItem(m_row, m_column, item);
-        }
-        item->setText(m_newValue);
+        m_model->setText(m_row, m_column, m_newValue);
     }
 }
 
-RowEditCommand::RowEditCommand(QStandardItemModel* model, Operation op, int row,
+RowEditCommand::RowEditCommand(ColumnarTableModel* model, Operation op, int row,
                                const QStringList& rowData, QUndoCommand* parent)
     : DataEditCommand(model, parent), m_operation(op), m_row(row), m_rowData(rowData)
 {
@@ -197,8 +192,7 @@ void RowEditCommand::undo()
     } else {
         m_model->insertRow(m_row);
         for (int col = 0; col < m_rowData.size(); ++col) {
-            QStandardItem* item = new QStandardItem(m_rowData[col]);
-            m_model->setItem(m_row, col, item);
+            m_model->setText(m_row, col, m_rowData[col]);
         }
     }
 }
@@ -209,23 +203,18 @@ void RowEditCommand::redo()
 
     if (m_operation == Insert) {
         m_model->insertRow(m_row);
-        for (int col = 0; col < m_model->columnCount(); ++col) {
-            QStandardItem* item = new QStandardItem("");
-            m_model->setItem(m_row, col, item);
-        }
     } else {
         if (m_row < m_model->rowCount()) {
             m_rowData.clear();
             for (int col = 0; col < m_model->columnCount(); ++col) {
-                QStandardItem* item = m_model->item(m_row, col);
-                m_rowData.append(item ? item->text() : "");
+                m_rowData.append(m_model->text(m_row, col));
             }
             m_model->removeRow(m_row);
         }
     }
 }
 
-ColumnEditCommand::ColumnEditCommand(QStandardItemModel* model, Operation op, int column,
+ColumnEditCommand::ColumnEditCommand(ColumnarTableModel* model, Operation op, int column,
                                      const QString& headerName, const QStringList& columnData,
                                      QUndoCommand* parent)
     : DataEditCommand(model, parent), m_operation(op), m_column(column),
@@ -245,12 +234,10 @@ void ColumnEditCommand::undo()
         }
     } else {
         m_model->insertColumn(m_column);
-        QStandardItem* headerItem = new QStandardItem(m_headerName);
-        m_model->setHorizontalHeaderItem(m_column, headerItem);
+        m_model->setHeaderText(m_column, m_headerName);
 
         for (int row = 0; row < m_columnData.size(); ++row) {
-            QStandardItem* item = new QStandardItem(m_columnData[row]);
-            m_model->setItem(row, m_column, item);
+            m_model->setText(row, m_column, m_columnData[row]);
         }
     }
 }
@@ -261,22 +248,15 @@ void ColumnEditCommand::redo()
 
     if (m_operation == Insert) {
         m_model->insertColumn(m_column);
-        QStandardItem* headerItem = new QStandardItem(m_headerName);
-        m_model->setHorizontalHeaderItem(m_column, headerItem);
-
-        for (int row = 0; row < m_model->rowCount(); ++row) {
-            QStandardItem* item = new QStandardItem("");
-            m_model->setItem(row, m_column, item);
-        }
+        m_model->setHeaderText(m_column, m_headerName);
     } else {
         if (m_column < m_model->columnCount()) {
-            QStandardItem* headerItem = m_model->horizontalHeaderItem(m_column);
-            m_headerName = headerItem ? headerItem->text() : QString("列%1").arg(m_column + 1);
+            m_headerName = m_model->headerText(m_column);
+            if (m_headerName.isEmpty()) m_headerName = QString("列%1").arg(m_column + 1);
 
             m_columnData.clear();
             for (int row = 0; row < m_model->rowCount(); ++row) {
-                QStandardItem* item = m_model->item(row, m_column);
-                m_columnData.append(item ? item->text() : "");
+                m_columnData.append(m_model->text(row, m_column));
             }
 
             m_model->removeColumn(m_column);
@@ -1485,9 +1465,10 @@ void DataCleaningDialog::setupUI()
     QHBoxLayout* outlierLayout = new QHBoxLayout;
     outlierLayout->addWidget(new QLabel("异常值阈值:"));
     m_outlierThresholdSpin = new QSpinBox;
-    m_outlierThresholdSpin->setRange(1, 5);
-    m_outlierThresholdSpin->setValue(2);
-    m_outlierThresholdSpin->setSuffix(" 倍标准差");
+    m_outlierThresholdSpin->setRange(2, 20);
+    m_outlierThresholdSpin->setValue(3);
+    m_outlierThresholdSpin->setSuffix(" 倍稳健标准差");
+    m_outlierThresholdSpin->setToolTip("按时间列滑动窗口的中值/MAD 判断，需预览时请使用“异常值”按钮");
     outlierLayout->addWidget(m_outlierThresholdSpin);
     mainLayout->addLayout(outlierLayout);
 
@@ -1664,7 +1645,8 @@ void DataEditorWidget::init()
 void DataEditorWidget::setupModels()
 {
     // 创建数据模型
-    m_dataModel = new QStandardItemModel(this);
+    m_dataModel = new ColumnarTableModel(this);
+    m_dataModel->setDefaultForeground(QColor("#2c3e50"));
 
     // 创建代理模型用于搜索和筛选
     m_proxyModel = new QSortFilterProxyModel(this);
@@ -1731,6 +1713,11 @@ void DataEditorWidget::setupConnections()
     connect(ui->btnTimeConvert, &QPushButton::clicked, this, &DataEditorWidget::onTimeConvert);
     connect(ui->btnPressureDropCalc, &QPushButton::clicked, this, &DataEditorWidget::onPressureDropCalc);
     connect(ui->btnPressureDerivativeCalc, &QPushButton::clicked, this, &DataEditorWidget::onPressureDerivativeCalc);
+    connect(ui->btnFlowPeriods, &QPushButton::clicked, this, &DataEditorWidget::onFlowPeriodDetect);
+    connect(ui->btnDeconvolution, &QPushButton::clicked, this, &DataEditorWidget::onDeconvolution);
+    connect(ui->btnDecimation, &QPushButton::clicked, this, &DataEditorWidget::onDecimationSettings);
+    connect(ui->btnOutliers, &QPushButton::clicked, this, &DataEditorWidget::onOutlierDetect);
+    connect(ui->btnSpectralFilter, &QPushButton::clicked, this, &DataEditorWidget::onSpectralFilter);
     connect(ui->btnDataClean, &QPushButton::clicked, this, &DataEditorWidget::onDataClean);
     connect(ui->btnDataStatistics, &QPushButton::clicked, this, &DataEditorWidget::onDataStatistics);
 
@@ -1738,8 +1725,7 @@ void DataEditorWidget::setupConnections()
     connect(ui->searchLineEdit, &QLineEdit::textChanged, this, &DataEditorWidget::onSearchTextChanged);
 
     // 模型数据变化
-    connect(m_dataModel, &QStandardItemModel::itemChanged, this, &DataEditorWidget::onCellDataChanged);
-    connect(m_dataModel, &QStandardItemModel::dataChanged, this, &DataEditorWidget::onModelDataChanged);
+    connect(m_dataModel, &ColumnarTableModel::dataChanged, this, &DataEditorWidget::onModelDataChanged);
 
     // 右键菜单连接
     connect(ui->dataTableView, &QTableView::customContextMenuRequested,
@@ -1916,8 +1902,7 @@ TimeConversionResult DataEditorWidget::convertTimeColumn(const TimeConversionCon
             m_dataModel->insertColumn(newColumnIndex);
 
             // 设置列标题
-            QStandardItem* headerItem = new QStandardItem(newColumnName);
-            m_dataModel->setHorizontalHeaderItem(newColumnIndex, headerItem);
+            m_dataModel->setHeaderText(newColumnIndex, newColumnName);
 
             // 获取基准日期和时刻（第一行的数据）
             QDate baseDate;
@@ -1926,12 +1911,10 @@ TimeConversionResult DataEditorWidget::convertTimeColumn(const TimeConversionCon
 
             // 找到第一个有效的日期和时刻
             for (int row = 0; row < m_dataModel->rowCount(); ++row) {
-                QStandardItem* dateItem = m_dataModel->item(row, config.dateColumnIndex);
-                QStandardItem* timeItem = m_dataModel->item(row, config.timeColumnIndex);
+                QString dateStr = m_dataModel->text(row, config.dateColumnIndex).trimmed();
+                QString timeStr = m_dataModel->text(row, config.timeColumnIndex).trimmed();
 
-                if (dateItem && timeItem) {
-                    QString dateStr = dateItem->text().trimmed();
-                    QString timeStr = timeItem->text().trimmed();
+                if (!dateStr.isEmpty() && !timeStr.isEmpty()) {
 
                     QDate parsedDate = parseDateString(dateStr);
                     QTime parsedTime = parseTimeString(timeStr);
@@ -1957,12 +1940,10 @@ TimeConversionResult DataEditorWidget::convertTimeColumn(const TimeConversionCon
             for (int row = 0; row < m_dataModel->rowCount(); ++row) {
                 QString convertedValue;
 
-                QStandardItem* dateItem = m_dataModel->item(row, config.dateColumnIndex);
-                QStandardItem* timeItem = m_dataModel->item(row, config.timeColumnIndex);
+                QString dateStr = m_dataModel->text(row, config.dateColumnIndex).trimmed();
+                QString timeStr = m_dataModel->text(row, config.timeColumnIndex).trimmed();
 
-                if (dateItem && timeItem) {
-                    QString dateStr = dateItem->text().trimmed();
-                    QString timeStr = timeItem->text().trimmed();
+                if (!dateStr.isEmpty() && !timeStr.isEmpty()) {
 
                     QDate currentDate = parseDateString(dateStr);
                     QTime currentTime = parseTimeString(timeStr);
@@ -1988,12 +1969,8 @@ TimeConversionResult DataEditorWidget::convertTimeColumn(const TimeConversionCon
                     convertedValue = "";
                 }
 
-                // 创建新的数据项
-                QStandardItem* newItem = new QStandardItem(convertedValue);
-                if (newItem) {
-                    newItem->setForeground(QBrush(QColor("#2c3e50")));
-                    m_dataModel->setItem(row, newColumnIndex, newItem);
-                }
+                // 写入新列
+                m_dataModel->setText(row, newColumnIndex, convertedValue);
             }
 
         } else {
@@ -2008,8 +1985,7 @@ TimeConversionResult DataEditorWidget::convertTimeColumn(const TimeConversionCon
             m_dataModel->insertColumn(newColumnIndex);
 
             // 设置列标题
-            QStandardItem* headerItem = new QStandardItem(newColumnName);
-            m_dataModel->setHorizontalHeaderItem(newColumnIndex, headerItem);
+            m_dataModel->setHeaderText(newColumnIndex, newColumnName);
 
             // 获取源列的所有时间数据
             QList<QTime> timeValues;
@@ -2018,9 +1994,8 @@ TimeConversionResult DataEditorWidget::convertTimeColumn(const TimeConversionCon
 
             // 首先解析所有时间数据
             for (int row = 0; row < m_dataModel->rowCount(); ++row) {
-                QStandardItem* sourceItem = m_dataModel->item(row, config.sourceTimeColumnIndex);
-                if (sourceItem) {
-                    QString timeStr = sourceItem->text().trimmed();
+                QString timeStr = m_dataModel->text(row, config.sourceTimeColumnIndex).trimmed();
+                if (!timeStr.isEmpty()) {
                     QTime parsedTime = parseTimeString(timeStr);
 
                     if (parsedTime.isValid()) {
@@ -2067,12 +2042,8 @@ TimeConversionResult DataEditorWidget::convertTimeColumn(const TimeConversionCon
                     convertedValue = "";
                 }
 
-                // 创建新的数据项
-                QStandardItem* newItem = new QStandardItem(convertedValue);
-                if (newItem) {
-                    newItem->setForeground(QBrush(QColor("#2c3e50")));
-                    m_dataModel->setItem(row, newColumnIndex, newItem);
-                }
+                // 写入新列
+                m_dataModel->setText(row, newColumnIndex, convertedValue);
             }
         }
 
@@ -2387,8 +2358,7 @@ PressureDropResult DataEditorWidget::calculatePressureDrop()
     m_dataModel->insertColumn(newColumnIndex);
 
     // 设置列标题
-    QStandardItem* headerItem = new QStandardItem(dropColumnName);
-    m_dataModel->setHorizontalHeaderItem(newColumnIndex, headerItem);
+    m_dataModel->setHeaderText(newColumnIndex, dropColumnName);
 
     // 计算压降数据
     int rowCount = m_dataModel->rowCount();
@@ -2396,28 +2366,15 @@ PressureDropResult DataEditorWidget::calculatePressureDrop()
 
     // 收集所有压力数据
     for (int row = 0; row < rowCount; ++row) {
-        QStandardItem* pressureItem = m_dataModel->item(row, pressureColumn);
-        if (pressureItem) {
-            QString pressureText = pressureItem->text().trimmed();
-            if (isValidPressureData(pressureText)) {
-                bool ok;
-                double pressure = pressureText.toDouble(&ok);
-                if (ok) {
-                    pressureValues.append(pressure);
-                } else {
-                    pressureValues.append(0.0);
-                }
-            } else {
-                pressureValues.append(0.0);
-            }
-        } else {
-            pressureValues.append(0.0);
-        }
+        bool ok = false;
+        double pressure = m_dataModel->value(row, pressureColumn, &ok);
+        pressureValues.append(ok ? pressure : 0.0);
     }
 
     // 计算压降值 - 修正的计算逻辑：每个时刻相对于初始时刻的压降
     double initialPressure = pressureValues.isEmpty() ? 0.0 : pressureValues[0]; // 获取初始压力
 
+    QVector<double> dropValues(rowCount);
     for (int row = 0; row < rowCount; ++row) {
         double pressureDrop = 0.0;
 
@@ -2429,14 +2386,10 @@ PressureDropResult DataEditorWidget::calculatePressureDrop()
             pressureDrop = initialPressure - pressureValues[row];
         }
 
-        // 创建新的数据项
-        QString dropValueText = QString::number(pressureDrop, 'f', 3);
-        QStandardItem* dropItem = new QStandardItem(dropValueText);
-        dropItem->setForeground(QBrush(QColor("#2c3e50")));
-        m_dataModel->setItem(row, newColumnIndex, dropItem);
-
+        dropValues[row] = pressureDrop;
         result.processedRows++;
     }
+    m_dataModel->setColumnValues(newColumnIndex, dropValues, 'f', 3);
 
     // 添加列定义
     ColumnDefinition newColumnDef;
@@ -2515,6 +2468,31 @@ int DataEditorWidget::findTimeColumn() const
     return -1;
 }
 
+int DataEditorWidget::findRateColumn() const
+{
+    if (!m_dataModel) {
+        return -1;
+    }
+
+    // 优先查找已定义为流量的列
+    for (int i = 0; i < m_columnDefinitions.size() && i < m_dataModel->columnCount(); ++i) {
+        if (m_columnDefinitions[i].type == WellTestColumnType::FlowRate) {
+            return i;
+        }
+    }
+
+    // 如果没有定义的流量列，尝试从列名推断
+    for (int col = 0; col < m_dataModel->columnCount(); ++col) {
+        QString headerText = m_dataModel->headerData(col, Qt::Horizontal).toString().toLower();
+        if (headerText.contains("rate") || headerText.contains("流量") ||
+            headerText.contains("产量") || headerText == "q") {
+            return col;
+        }
+    }
+
+    return -1;
+}
+
 QString DataEditorWidget::getPressureUnit() const
 {
     int pressureColumn = findPressureColumn();
@@ -2634,8 +2612,7 @@ void DataEditorWidget::onDeleteSelectedRows()
         for (int row : selectedRows) {
             QStringList rowData;
             for (int col = 0; col < m_dataModel->columnCount(); ++col) {
-                QStandardItem* item = m_dataModel->item(row, col);
-                rowData.append(item ? item->text() : "");
+                rowData.append(m_dataModel->text(row, col));
             }
 
             RowEditCommand* command = new RowEditCommand(m_dataModel, RowEditCommand::Delete, row, rowData);
@@ -2732,13 +2709,12 @@ void DataEditorWidget::onDeleteSelectedColumns()
         m_undoStack->beginMacro("删除多列");
 
         for (int col : selectedColumns) {
-            QStandardItem* headerItem = m_dataModel->horizontalHeaderItem(col);
-            QString headerName = headerItem ? headerItem->text() : QString("列%1").arg(col + 1);
+            QString headerName = m_dataModel->headerText(col);
+            if (headerName.isEmpty()) headerName = QString("列%1").arg(col + 1);
 
             QStringList columnData;
             for (int row = 0; row < m_dataModel->rowCount(); ++row) {
-                QStandardItem* item = m_dataModel->item(row, col);
-                columnData.append(item ? item->text() : "");
+                columnData.append(m_dataModel->text(row, col));
             }
 
             ColumnEditCommand* command = new ColumnEditCommand(m_dataModel, ColumnEditCommand::Delete, col, headerName, columnData);
@@ -3132,8 +3108,10 @@ bool DataEditorWidget::loadCsvFileWithConfig(const QString& filePath, const Data
 
     updateProgress(80, "正在加载数据...");
 
-    // 加载数据行
+    // 加载数据行：先一次性分配行，逐单元格写入时不逐个发信号
     int rowIndex = 0;
+    m_dataModel->setRowCount(qMax(0, int(lines.size()) - dataStartIndex));
+    m_dataModel->beginBulkLoad();
     for (int i = dataStartIndex; i < lines.size(); ++i) {
         QStringList lineFields = splitCSVLine(lines[i], config.separator);
 
@@ -3145,15 +3123,9 @@ bool DataEditorWidget::loadCsvFileWithConfig(const QString& filePath, const Data
             lineFields = lineFields.mid(0, headers.size());
         }
 
-        // 插入新行
-        m_dataModel->insertRow(rowIndex);
-
         // 填充数据
         for (int col = 0; col < lineFields.size(); ++col) {
-            QString cellData = lineFields[col].trimmed();
-            QStandardItem* item = new QStandardItem(cellData);
-            item->setForeground(QBrush(QColor("#2c3e50")));
-            m_dataModel->setItem(rowIndex, col, item);
+            m_dataModel->setText(rowIndex, col, lineFields[col].trimmed());
         }
         rowIndex++;
 
@@ -3163,6 +3135,7 @@ bool DataEditorWidget::loadCsvFileWithConfig(const QString& filePath, const Data
             QApplication::processEvents(); // 让界面保持响应
         }
     }
+    m_dataModel->endBulkLoad();
 
     updateProgress(100, "数据加载完成");
 
@@ -3402,6 +3375,7 @@ bool DataEditorWidget::loadCSVFile(const QString& filePath, const QString& separ
     // 批量插入行以提高性能
     int totalDataRows = lines.size() - dataStartRow;
     m_dataModel->setRowCount(totalDataRows);
+    m_dataModel->beginBulkLoad();
 
     for (int i = dataStartRow; i < lines.size(); ++i) {
         QStringList lineFields = splitCSVLine(lines[i], separator);
@@ -3415,10 +3389,7 @@ bool DataEditorWidget::loadCSVFile(const QString& filePath, const QString& separ
         }
 
         for (int col = 0; col < lineFields.size(); ++col) {
-            QString cellData = lineFields[col].trimmed();
-            QStandardItem* item = new QStandardItem(cellData);
-            item->setForeground(QBrush(QColor("#2c3e50")));
-            m_dataModel->setItem(rowIndex, col, item);
+            m_dataModel->setText(rowIndex, col, lineFields[col].trimmed());
         }
         rowIndex++;
 
@@ -3428,6 +3399,7 @@ bool DataEditorWidget::loadCSVFile(const QString& filePath, const QString& separ
             QApplication::processEvents(); // 让界面保持响应
         }
     }
+    m_dataModel->endBulkLoad();
 
     updateProgress(100, "数据加载完成");
 
@@ -3512,20 +3484,18 @@ bool DataEditorWidget::loadJsonFile(const QString& filePath, QString& errorMessa
 
         m_dataModel->setColumnCount(headers.size());
         m_dataModel->setHorizontalHeaderLabels(headers);
+        m_dataModel->setRowCount(array.size());
+        m_dataModel->beginBulkLoad();
 
         for (int i = 0; i < array.size(); ++i) {
             QJsonObject obj = array[i].toObject();
-            m_dataModel->insertRow(i);
 
             for (int col = 0; col < headers.size(); ++col) {
                 QString key = headers[col];
-                QString value = obj[key].toString();
-
-                QStandardItem* item = new QStandardItem(value);
-                item->setForeground(QBrush(QColor("#2c3e50")));
-                m_dataModel->setItem(i, col, item);
+                m_dataModel->setText(i, col, obj[key].toString());
             }
         }
+        m_dataModel->endBulkLoad();
 
         return true;
     }
@@ -3537,6 +3507,7 @@ bool DataEditorWidget::loadJsonFile(const QString& filePath, QString& errorMessa
 #ifdef Q_OS_WIN
 bool DataEditorWidget::loadExcelWithCOM(const QString& filePath, QString& errorMessage)
 {
+    bool bulkLoading = false;
     try {
         QAxObject excel("Excel.Application");
         if (excel.isNull()) {
@@ -3582,6 +3553,10 @@ bool DataEditorWidget::loadExcelWithCOM(const QString& filePath, QString& errorM
         m_dataModel->setRowCount(rowCount > 1 ? rowCount-1 : 0);
         m_dataModel->setColumnCount(columnCount);
 
+        // 表头与数据逐单元格写入期间不逐个发信号
+        m_dataModel->beginBulkLoad();
+        bulkLoading = true;
+
         // 设置表头
         QStringList headers;
         for (int col = 1; col <= columnCount; ++col) {
@@ -3599,11 +3574,11 @@ bool DataEditorWidget::loadExcelWithCOM(const QString& filePath, QString& errorM
             for (int col = 1; col <= columnCount; ++col) {
                 QAxObject* cell = worksheet->querySubObject("Cells(int,int)", row, col);
                 QString value = cell ? cell->property("Value").toString() : "";
-                QStandardItem* item = new QStandardItem(value);
-                item->setForeground(QBrush(QColor("#2c3e50")));
-                m_dataModel->setItem(row-2, col-1, item);
+                m_dataModel->setText(row-2, col-1, value);
             }
         }
+        m_dataModel->endBulkLoad();
+        bulkLoading = false;
 
         workbook->dynamicCall("Close()");
         excel.dynamicCall("Quit()");
@@ -3611,6 +3586,7 @@ bool DataEditorWidget::loadExcelWithCOM(const QString& filePath, QString& errorM
         return true;
 
     } catch (...) {
+        if (bulkLoading) m_dataModel->endBulkLoad();
         errorMessage = "读取Excel文件时发生未知错误";
         return false;
     }
@@ -3913,10 +3889,23 @@ DataStatistics DataEditorWidget::calculateColumnStatistics(int column) const
 
     QList<double> numericValues;
     QStringList textValues;
+    const bool numericColumn = m_dataModel->columnType(column) == ColumnarTableModel::Numeric;
 
     for (int row = 0; row < m_dataModel->rowCount(); ++row) {
-        QStandardItem* item = m_dataModel->item(row, column);
-        QString value = item ? item->text().trimmed() : "";
+        if (numericColumn) {
+            // 数值列直接读取，空单元格计为无效
+            bool ok = false;
+            double numValue = m_dataModel->value(row, column, &ok);
+            if (ok) {
+                numericValues.append(numValue);
+                stats.validCount++;
+            } else {
+                stats.invalidCount++;
+            }
+            continue;
+        }
+
+        QString value = m_dataModel->text(row, column).trimmed();
 
         if (value.isEmpty()) {
             stats.invalidCount++;
@@ -4003,8 +3992,7 @@ void DataEditorWidget::removeEmptyRows()
     for (int row = 0; row < m_dataModel->rowCount(); ++row) {
         bool isEmpty = true;
         for (int col = 0; col < m_dataModel->columnCount(); ++col) {
-            QStandardItem* item = m_dataModel->item(row, col);
-            if (item && !item->text().trimmed().isEmpty()) {
+            if (!m_dataModel->text(row, col).trimmed().isEmpty()) {
                 isEmpty = false;
                 break;
             }
@@ -4021,8 +4009,7 @@ void DataEditorWidget::removeEmptyRows()
         for (int row : emptyRows) {
             QStringList rowData;
             for (int col = 0; col < m_dataModel->columnCount(); ++col) {
-                QStandardItem* item = m_dataModel->item(row, col);
-                rowData.append(item ? item->text() : "");
+                rowData.append(m_dataModel->text(row, col));
             }
 
             RowEditCommand* command = new RowEditCommand(m_dataModel, RowEditCommand::Delete, row, rowData);
@@ -4041,8 +4028,7 @@ void DataEditorWidget::removeEmptyColumns()
     for (int col = 0; col < m_dataModel->columnCount(); ++col) {
         bool isEmpty = true;
         for (int row = 0; row < m_dataModel->rowCount(); ++row) {
-            QStandardItem* item = m_dataModel->item(row, col);
-            if (item && !item->text().trimmed().isEmpty()) {
+            if (!m_dataModel->text(row, col).trimmed().isEmpty()) {
                 isEmpty = false;
                 break;
             }
@@ -4057,13 +4043,12 @@ void DataEditorWidget::removeEmptyColumns()
 
         m_undoStack->beginMacro("删除空列");
         for (int col : emptyColumns) {
-            QStandardItem* headerItem = m_dataModel->horizontalHeaderItem(col);
-            QString headerName = headerItem ? headerItem->text() : QString("列%1").arg(col + 1);
+            QString headerName = m_dataModel->headerText(col);
+            if (headerName.isEmpty()) headerName = QString("列%1").arg(col + 1);
 
             QStringList columnData;
             for (int row = 0; row < m_dataModel->rowCount(); ++row) {
-                QStandardItem* item = m_dataModel->item(row, col);
-                columnData.append(item ? item->text() : "");
+                columnData.append(m_dataModel->text(row, col));
             }
 
             ColumnEditCommand* command = new ColumnEditCommand(m_dataModel, ColumnEditCommand::Delete, col, headerName, columnData);
@@ -4083,8 +4068,7 @@ void DataEditorWidget::removeDuplicates()
     for (int row = 0; row < m_dataModel->rowCount(); ++row) {
         QStringList rowData;
         for (int col = 0; col < m_dataModel->columnCount(); ++col) {
-            QStandardItem* item = m_dataModel->item(row, col);
-            rowData.append(item ? item->text().trimmed() : "");
+            rowData.append(m_dataModel->text(row, col).trimmed());
         }
 
         QString rowSignature = rowData.join("|");
@@ -4102,8 +4086,7 @@ void DataEditorWidget::removeDuplicates()
         for (int row : duplicateRows) {
             QStringList rowData;
             for (int col = 0; col < m_dataModel->columnCount(); ++col) {
-                QStandardItem* item = m_dataModel->item(row, col);
-                rowData.append(item ? item->text() : "");
+                rowData.append(m_dataModel->text(row, col));
             }
 
             RowEditCommand* command = new RowEditCommand(m_dataModel, RowEditCommand::Delete, row, rowData);
@@ -4122,15 +4105,11 @@ void DataEditorWidget::fillMissingValues(const QString& method)
         QList<int> validIndices;
 
         // 收集有效的数值
-        for (int row = 0; row < m_dataModel->rowCount(); ++row) {
-            QStandardItem* item = m_dataModel->item(row, col);
-            if (item) {
-                bool ok;
-                double value = item->text().toDouble(&ok);
-                if (ok) {
-                    numericValues.append(value);
-                    validIndices.append(row);
-                }
+        const QVector<double> columnValues = m_dataModel->columnValues(col);
+        for (int row = 0; row < columnValues.size(); ++row) {
+            if (!std::isnan(columnValues[row])) {
+                numericValues.append(columnValues[row]);
+                validIndices.append(row);
             }
         }
 
@@ -4138,8 +4117,7 @@ void DataEditorWidget::fillMissingValues(const QString& method)
 
         // 填充缺失值
         for (int row = 0; row < m_dataModel->rowCount(); ++row) {
-            QStandardItem* item = m_dataModel->item(row, col);
-            if (!item || item->text().trimmed().isEmpty()) {
+            if (m_dataModel->text(row, col).trimmed().isEmpty()) {
                 QString fillValue;
 
                 if (method == "zero") {
@@ -4158,22 +4136,17 @@ void DataEditorWidget::fillMissingValues(const QString& method)
                 } else if (method == "forward") {
                     // 前值填充
                     for (int prevRow = row - 1; prevRow >= 0; --prevRow) {
-                        QStandardItem* prevItem = m_dataModel->item(prevRow, col);
-                        if (prevItem && !prevItem->text().trimmed().isEmpty()) {
-                            fillValue = prevItem->text();
+                        QString prevText = m_dataModel->text(prevRow, col);
+                        if (!prevText.trimmed().isEmpty()) {
+                            fillValue = prevText;
                             break;
                         }
                     }
                 }
 
                 if (!fillValue.isEmpty()) {
-                    if (!item) {
-                        item = new QStandardItem(fillValue);
-                        m_dataModel->setItem(row, col, item);
-                    } else {
-                        item->setText(fillValue);
-                    }
-                    item->setForeground(QBrush(QColor("#6c757d"))); // 标记为填充值
+                    m_dataModel->setText(row, col, fillValue);
+                    m_dataModel->setCellForeground(row, col, QColor("#6c757d")); // 标记为填充值
                 }
             }
         }
@@ -4184,56 +4157,30 @@ void DataEditorWidget::removeOutliers(double threshold)
 {
     if (!m_dataModel) return;
 
-    for (int col = 0; col < m_dataModel->columnCount(); ++col) {
-        QList<double> values;
-        QList<int> validRows;
-
-        // 收集数值数据
-        for (int row = 0; row < m_dataModel->rowCount(); ++row) {
-            QStandardItem* item = m_dataModel->item(row, col);
-            if (item) {
-                bool ok;
-                double value = item->text().toDouble(&ok);
-                if (ok) {
-                    values.append(value);
-                    validRows.append(row);
-                }
-            }
-        }
-
-        if (values.size() < 3) continue; // 数据太少，跳过
+    // 以时间列为自变量做滑动 Hampel 检测，趋势数据上的局部毛刺也能识别；时间列本身不处理
+    const int timeCol = findTimeColumn();
+    QVector<double> time = timeCol >= 0 ? m_dataModel->columnValues(timeCol) : QVector<double>(m_dataModel->rowCount());
+    if (timeCol < 0) {
+        for (int row = 0; row < time.size(); ++row) time[row] = row;
+    }
 
-        // 计算平均值和标准差
-        double sum = 0;
-        for (double val : values) {
-            sum += val;
-        }
-        double mean = sum / values.size();
+    HampelConfig config;
+    config.threshold = threshold;
+    for (int col = 0; col < m_dataModel->columnCount(); ++col) {
+        if (col == timeCol) continue;
 
-        double variance = 0;
-        for (double val : values) {
-            variance += std::pow(val - mean, 2);
+        // 收集数值数据 (非数值单元格记为 NaN，不参与检测)
+        const QVector<double> values = m_dataModel->columnValues(col);
+        int numeric = 0;
+        for (double value : values) {
+            if (!std::isnan(value)) ++numeric;
         }
-        double stdDev = std::sqrt(variance / values.size());
+        if (numeric < config.minPoints) continue; // 数据太少，跳过
 
-        // 标记异常值
-        QList<int> outlierRows;
-        for (int i = 0; i < values.size(); ++i) {
-            if (std::abs(values[i] - mean) > threshold * stdDev) {
-                outlierRows.append(validRows[i]);
-            }
-        }
-
-        // 删除异常值（从后往前删除）
-        if (!outlierRows.isEmpty()) {
-            std::sort(outlierRows.begin(), outlierRows.end(), std::greater<int>());
-
-            for (int row : outlierRows) {
-                QStandardItem* item = m_dataModel->item(row, col);
-                if (item) {
-                    item->setText(""); // 清空异常值
-                }
-            }
+        // 清空异常值
+        const HampelResult result = HampelFilter::detect(time, values, config);
+        for (int row : result.indices) {
+            m_dataModel->setText(row, col, "");
         }
     }
 }
@@ -4244,10 +4191,7 @@ void DataEditorWidget::standardizeDataFormat()
 
     for (int col = 0; col < m_dataModel->columnCount(); ++col) {
         for (int row = 0; row < m_dataModel->rowCount(); ++row) {
-            QStandardItem* item = m_dataModel->item(row, col);
-            if (!item) continue;
-
-            QString text = item->text().trimmed();
+            QString text = m_dataModel->text(row, col).trimmed();
             if (text.isEmpty()) continue;
 
             // 根据列定义标准化格式
@@ -4264,7 +4208,7 @@ void DataEditorWidget::standardizeDataFormat()
                     double value = text.toDouble(&ok);
                     if (ok) {
                         QString formatted = QString::number(value, 'f', def.decimalPlaces);
-                        item->setText(formatted);
+                        m_dataModel->setText(row, col, formatted);
                     }
                 }
             }
@@ -4316,8 +4260,7 @@ bool DataEditorWidget::saveCsvFile(const QString& filePath)
     for (int row = 0; row < m_dataModel->rowCount(); ++row) {
         QStringList fields;
         for (int col = 0; col < m_dataModel->columnCount(); ++col) {
-            QStandardItem* item = m_dataModel->item(row, col);
-            QString text = item ? item->text() : "";
+            QString text = m_dataModel->text(row, col);
 
             if (text.contains(',') || text.contains('"') || text.contains('\n')) {
                 text = '"' + text.replace('"', "\"\"") + '"';
@@ -4348,8 +4291,7 @@ bool DataEditorWidget::saveJsonFile(const QString& filePath)
         QJsonObject jsonObject;
 
         for (int col = 0; col < m_dataModel->columnCount(); ++col) {
-            QStandardItem* item = m_dataModel->item(row, col);
-            QString value = item ? item->text() : "";
+            QString value = m_dataModel->text(row, col);
 
             bool isNumber;
             double numValue = value.toDouble(&isNumber);
@@ -4423,8 +4365,7 @@ bool DataEditorWidget::exportToPdf(const QString& filePath)
     for (int row = 0; row < maxRows; ++row) {
         htmlContent += "<tr>";
         for (int col = 0; col < m_dataModel->columnCount(); ++col) {
-            QStandardItem* item = m_dataModel->item(row, col);
-            QString text = item ? item->text() : "";
+            QString text = m_dataModel->text(row, col);
             htmlContent += QString("<td>%1</td>").arg(text.toHtmlEscaped());
         }
         htmlContent += "</tr>";
@@ -4518,8 +4459,7 @@ bool DataEditorWidget::exportToHtml(const QString& filePath)
     for (int row = 0; row < m_dataModel->rowCount(); ++row) {
         out << "<tr>\n";
         for (int col = 0; col < m_dataModel->columnCount(); ++col) {
-            QStandardItem* item = m_dataModel->item(row, col);
-            QString text = item ? item->text() : "";
+            QString text = m_dataModel->text(row, col);
             out << QString("<td>%1</td>\n").arg(text.toHtmlEscaped());
         }
         out << "</tr>\n";
@@ -4559,8 +4499,7 @@ ValidationResult DataEditorWidget::validateData() const
         bool isEmpty = true;
 
         for (int col = 0; col < m_dataModel->columnCount(); ++col) {
-            QStandardItem* item = m_dataModel->item(row, col);
-            QString value = item ? item->text().trimmed() : "";
+            QString value = m_dataModel->text(row, col).trimmed();
 
             if (!value.isEmpty()) {
                 isEmpty = false;
@@ -4600,8 +4539,7 @@ bool DataEditorWidget::validateColumnData(int columnIndex, const ColumnDefinitio
     int emptyCount = 0;
 
     for (int row = 0; row < m_dataModel->rowCount(); ++row) {
-        QStandardItem* item = m_dataModel->item(row, columnIndex);
-        QString value = item ? item->text().trimmed() : "";
+        QString value = m_dataModel->text(row, columnIndex).trimmed();
 
         if (value.isEmpty()) {
             emptyCount++;
@@ -4679,8 +4617,7 @@ QStringList DataEditorWidget::detectDataType(int column) const
     QSet<QString> types;
 
     for (int row = 0; row < m_dataModel->rowCount(); ++row) {
-        QStandardItem* item = m_dataModel->item(row, column);
-        QString value = item ? item->text().trimmed() : "";
+        QString value = m_dataModel->text(row, column).trimmed();
 
         if (value.isEmpty()) {
             continue;
@@ -4739,9 +4676,6 @@ void DataEditorWidget::applyColumnDefinition(int columnIndex, const ColumnDefini
 
     // 应用数据格式
     for (int row = 0; row < m_dataModel->rowCount(); ++row) {
-        QStandardItem* item = m_dataModel->item(row, columnIndex);
-        if (!item) continue;
-
         // 根据类型格式化数值
         if (definition.type == WellTestColumnType::Pressure ||
             definition.type == WellTestColumnType::Temperature ||
@@ -4749,17 +4683,17 @@ void DataEditorWidget::applyColumnDefinition(int columnIndex, const ColumnDefini
             definition.type == WellTestColumnType::Time) {
 
             bool ok;
-            double value = item->text().toDouble(&ok);
+            double value = m_dataModel->value(row, columnIndex, &ok);
             if (ok) {
                 QString formatted = QString::number(value, 'f', definition.decimalPlaces);
-                item->setText(formatted);
+                m_dataModel->setText(row, columnIndex, formatted);
             }
         }
+    }
 
-        // 设置颜色标记
-        if (definition.isRequired) {
-            item->setBackground(QBrush(QColor("#fff3cd"))); // 淡黄色背景表示必需
-        }
+    // 设置颜色标记
+    if (definition.isRequired) {
+        m_dataModel->setColumnBackground(columnIndex, QColor("#fff3cd")); // 淡黄色背景表示必需
     }
 }
 
@@ -4803,18 +4737,6 @@ bool DataEditorWidget::canRedo() const
 // 数据模型变化处理
 // ============================================================================
 
-void DataEditorWidget::onCellDataChanged(QStandardItem* item)
-{
-    if (!item || !m_undoStack) {
-        return;
-    }
-
-    m_dataModified = true;
-    updateStatus("数据已修改", "warning");
-    updateDataInfo();
-    emitDataChanged();
-}
-
 void DataEditorWidget::onModelDataChanged(const QModelIndex& topLeft, const QModelIndex& bottomRight)
 {
     Q_UNUSED(topLeft)
@@ -4878,6 +4800,11 @@ void DataEditorWidget::setButtonsEnabled(bool enabled)
     ui->btnTimeConvert->setEnabled(enabled);
     ui->btnPressureDropCalc->setEnabled(enabled);
     ui->btnPressureDerivativeCalc->setEnabled(enabled);
+    ui->btnFlowPeriods->setEnabled(enabled);
+    ui->btnDeconvolution->setEnabled(enabled);
+    ui->btnDecimation->setEnabled(enabled);
+    ui->btnOutliers->setEnabled(enabled);
+    ui->btnSpectralFilter->setEnabled(enabled);
     ui->btnDataClean->setEnabled(enabled);
     ui->btnDataStatistics->setEnabled(enabled);
 }
@@ -4945,16 +4872,9 @@ void DataEditorWidget::applyColumnStyles()
 {
     if (!m_dataModel) return;
 
-    QColor textColor("#2c3e50");
-
-    for (int row = 0; row < m_dataModel->rowCount(); ++row) {
-        for (int col = 0; col < m_dataModel->columnCount(); ++col) {
-            QStandardItem* item = m_dataModel->item(row, col);
-            if (item) {
-                item->setForeground(QBrush(textColor));
-            }
-        }
-    }
+    // 文字颜色由模型的 ForegroundRole 统一给出，清除填充值等单元格标记
+    m_dataModel->setDefaultForeground(QColor("#2c3e50"));
+    m_dataModel->clearCellForegrounds();
 }
 
 void DataEditorWidget::optimizeColumnWidths()
@@ -5237,9 +5157,8 @@ void DataEditorWidget::onPressureDerivativeCalc()
     }
 
     // 获取压力单位
-    QStandardItem* pressureHeader = m_dataModel->horizontalHeaderItem(config.pressureColumnIndex);
-    if (pressureHeader) {
-        QString headerText = pressureHeader->text();
+    if (config.pressureColumnIndex >= 0 && config.pressureColumnIndex < m_dataModel->columnCount()) {
+        QString headerText = m_dataModel->headerText(config.pressureColumnIndex);
         if (headerText.contains("MPa")) {
             config.pressureUnit = "MPa";
         } else if (headerText.contains("kPa")) {
@@ -5294,6 +5213,127 @@ void DataEditorWidget::onPressureDerivativeCalc()
     }
 }
 
+// 流动段自动划分槽函数
+void DataEditorWidget::onFlowPeriodDetect()
+{
+    if (!hasData()) {
+        showStyledMessageBox("流动段划分", "请先加载数据文件", QMessageBox::Information);
+        return;
+    }
+
+    FlowPeriodDialog dlg(m_dataModel, findTimeColumn(), findPressureColumn(), findRateColumn(), this);
+    if (dlg.exec() != QDialog::Accepted) return;
+
+    QList<FlowPeriodDataset> datasets = dlg.datasets();
+    updateStatus(QString("流动段划分完成 - 生成 %1 个拟合数据集").arg(datasets.size()), "success");
+    emit flowPeriodDatasetsReady(datasets);
+}
+
+// 压力-产量反褶积槽函数
+void DataEditorWidget::onDeconvolution()
+{
+    if (!hasData()) {
+        showStyledMessageBox("反褶积", "请先加载数据文件", QMessageBox::Information);
+        return;
+    }
+    if (findRateColumn() < 0 && m_dataModel->columnCount() < 3) {
+        showStyledMessageBox("反褶积", "反褶积需要时间、压力和产量三列数据", QMessageBox::Information);
+        return;
+    }
+
+    DeconvolutionDialog dlg(m_dataModel, findTimeColumn(), findPressureColumn(), findRateColumn(), this);
+    if (dlg.exec() != QDialog::Accepted) return;
+
+    updateStatus("反褶积完成 - 单位响应已生成拟合数据集", "success");
+    emit flowPeriodDatasetsReady(QList<FlowPeriodDataset>() << dlg.dataset());
+}
+
+// 对数时间抽稀设置槽函数
+void DataEditorWidget::onDecimationSettings()
+{
+    DecimationDialog dlg(m_decimationConfig, m_dataModel, findTimeColumn(), findPressureColumn(), this);
+    if (dlg.exec() != QDialog::Accepted) return;
+
+    m_decimationConfig = dlg.config();
+    updateStatus(m_decimationConfig.enabled
+                     ? QString("抽稀设置已更新 - %1，超过 %2 行时生效")
+                           .arg(DecimationConfig::methodNames().value(m_decimationConfig.method))
+                           .arg(m_decimationConfig.minimumRows)
+                     : QString("抽稀已关闭"), "success");
+    emit decimationChanged();
+}
+
+// 滑动 Hampel 异常值检测槽函数: 对话框中预览，确认后清空或替换为窗口中值
+void DataEditorWidget::onOutlierDetect()
+{
+    if (!hasData()) {
+        showStyledMessageBox("异常值检测", "请先加载数据文件", QMessageBox::Information);
+        return;
+    }
+
+    OutlierDialog dlg(m_dataModel, findTimeColumn(), findPressureColumn(), this);
+    if (dlg.exec() != QDialog::Accepted) return;
+
+    const int col = dlg.valueColumn();
+    const QVector<int> rows = dlg.flaggedRows();
+    const QVector<double> medians = dlg.replacementValues();
+    const bool replace = dlg.replaceWithMedian();
+    for (int k = 0; k < rows.size(); ++k) {
+        if (replace) {
+            m_dataModel->setValue(rows[k], col, medians[k]);
+            m_dataModel->setCellForeground(rows[k], col, QColor("#6c757d"));   // 与填充值相同的标记色
+        } else {
+            m_dataModel->setText(rows[k], col, QString());
+        }
+    }
+
+    m_dataModified = true;
+    emitDataChanged();
+    updateStatus(QString("异常值处理完成 - %1 %2 个点").arg(replace ? "替换" : "清空").arg(rows.size()), "success");
+}
+
+// 周期性噪声频域滤波槽函数: 滤波结果写入压力列之后的新列，原始数据保留
+void DataEditorWidget::onSpectralFilter()
+{
+    if (!hasData()) {
+        showStyledMessageBox("周期滤波", "请先加载数据文件", QMessageBox::Information);
+        return;
+    }
+
+    SpectralFilterDialog dlg(m_dataModel, findTimeColumn(), findPressureColumn(), this);
+    if (dlg.exec() != QDialog::Accepted) return;
+
+    const int valueColumn = dlg.valueColumn();
+    const QString columnName = dlg.columnName();
+    const QVector<int> rows = dlg.rows();
+    const QVector<double> values = dlg.filteredValues();
+
+    int newColumnIndex = valueColumn + 1;
+    m_dataModel->insertColumn(newColumnIndex);
+    m_dataModel->setHeaderText(newColumnIndex, columnName);
+    QVector<double> filtered(m_dataModel->rowCount(), std::numeric_limits<double>::quiet_NaN());
+    for (int k = 0; k < rows.size() && k < values.size(); ++k) filtered[rows[k]] = values[k];
+    m_dataModel->setColumnValues(newColumnIndex, filtered, 'g', 10);
+
+    // 添加列定义，沿用原列的类型与单位
+    ColumnDefinition newColumnDef;
+    if (valueColumn < m_columnDefinitions.size()) newColumnDef = m_columnDefinitions[valueColumn];
+    else newColumnDef.type = WellTestColumnType::Pressure;
+    newColumnDef.name = columnName;
+    newColumnDef.description = "周期性噪声滤波";
+    newColumnDef.isRequired = false;
+    if (newColumnIndex < m_columnDefinitions.size()) {
+        m_columnDefinitions.insert(newColumnIndex, newColumnDef);
+    } else {
+        m_columnDefinitions.append(newColumnDef);
+    }
+
+    optimizeColumnWidths();
+    m_dataModified = true;
+    emitDataChanged();
+    updateStatus(QString("周期滤波完成 - 已添加列: %1").arg(columnName), "success");
+}
+
 // 使用配置计算压力导数
 PressureDerivativeResult DataEditorWidget::calculatePressureDerivativeWithConfig(const PressureDerivativeConfig& config)
 {
@@ -5,16 +5,25 @@
 #include <QMap>
 #include <QVector>
 #include <QColor>
+#include <QMutex>
+#include <QFutureWatcher>
+#include <QSharedPointer>
+#include <QPair>
 #include <tuple>
 #include <functional>
+#include <atomic>
 #include "mousezoom.h"
 #include "chartsetting1.h"
+#include "typecurvetable.h"
 
 namespace Ui {
 class ModelWidget01_06;
 }
 
 class QCPTextElement;
+class QCustomPlot;
+class QTimer;
+class CancellationToken;
 
 // 类型定义: <时间, 压力, 导数>
 using ModelCurveData = std::tuple<QVector<double>, QVector<double>, QVector<double>>;
@@ -36,11 +45,39 @@ public:
     explicit ModelWidget01_06(ModelType type, QWidget *parent = nullptr);
     ~ModelWidget01_06();
 
-    // 设置是否使用高精度 Stehfest 反演 (对应 MATLAB 中的 N=8)
+    // 设置界面计算是否使用高精度 Stehfest 反演 (对应 MATLAB 中的 N=8)
+    // 供外部调用的计算接口不受此开关影响，其精度由参数表中的 "N" 指定
     void setHighPrecision(bool high);
 
     // 计算理论曲线 (供 FittingWidget 调用)
-    ModelCurveData calculateTheoreticalCurve(const QMap<QString, double>& params, const QVector<double>& providedTime = QVector<double>());
+    // token 非空时在反演循环内检查取消/超时，被取消时返回的曲线不完整，调用方应丢弃
+    ModelCurveData calculateTheoreticalCurve(const QMap<QString, double>& params, const QVector<double>& providedTime = QVector<double>(),
+                                             const CancellationToken* token = nullptr);
+
+    // 网格模式计算理论曲线: 在自适应对数网格上反演 pD，再以双对数保单调三次插值映射到 providedTime
+    // 反演次数只取决于曲线曲率，与实测点数无关
+    ModelCurveData calculateTheoreticalCurveOnGrid(const QMap<QString, double>& params, const QVector<double>& providedTime,
+                                                   const CancellationToken* token = nullptr);
+
+    // 快速预览曲线: 粗网格 (约 30 点, N=4) 并行反演后插值到预览时间点
+    // 无因次结果按无因次参数缓存，仅修改产量、厚度、粘度等换算参数时直接复用；未命中时需要反演，应在工作线程调用
+    ModelCurveData calculatePreviewCurve(const QMap<QString, double>& params, const QVector<double>& providedTime = QVector<double>());
+    // 只用缓存或预制表给出预览，不做拉普拉斯反演 (可在界面线程调用)；两者都未命中时返回 false
+    bool cachedPreviewCurve(const QMap<QString, double>& params, const QVector<double>& providedTime, ModelCurveData& curve);
+
+    // --- 无因次曲线分步接口 (供目标函数分布图等批量计算复用) ---
+    // 无因次参数键: 去掉换算参数，kf/km 以比值 M12 表示；键相同的参数组无因次曲线相同
+    QMap<QString, double> dimensionlessKey(const QMap<QString, double>& params) const;
+    // 在 log10(tD) ∈ [lo, hi] 上构造自适应网格，gx/gy 返回 log10(tD)/log10(pD) 节点
+    // 按曲率加密后在误差最大的区间中点校验，校验误差超限时继续加密 (受网格点数上限约束)
+    void buildDimensionlessGrid(const QMap<QString, double>& params, double lo, double hi,
+                                QVector<double>& gx, QVector<double>& gy, const CancellationToken* token = nullptr);
+    // 按 params 中的换算参数把无因次网格映射为 providedTime 上的压力与导数
+    ModelCurveData curveFromDimensionlessGrid(const QMap<QString, double>& params, const QVector<double>& gx, const QVector<double>& gy,
+                                              const QVector<double>& providedTime);
+    // tD = dimensionlessTimeScale * t(h)；Δp = pressureFactor * pD
+    static double dimensionlessTimeScale(const QMap<QString, double>& params);
+    static double pressureFactor(const QMap<QString, double>& params);
 
     // 获取当前模型名称
     QString getModelName() const;
@@ -59,28 +96,73 @@ public slots:
     void onChartSettings();
     void onDependentParamsChanged();
     void onShowPointsToggled(bool checked);
+    void onParamsEdited();
+    void onPreviewResultReady(int index);
+    void onPreviewFinished();
+    void onRefinementResultReady(int index);
+    void onRefinementFinished();
+    void onGenerateTable();
+    void onMonteCarloFinished();
 
 private:
     void initUi();
     void initChart();
+    void initSensitivityCharts();
     void setupConnections();
     void runCalculation();
+    // 预览曲线实现: allowSolve 为 false 时缓存与预制表均未命中即返回 false
+    bool previewCurve(const QMap<QString, double>& params, const QVector<double>& providedTime, bool allowSolve, ModelCurveData& curve);
+    // 任一输入框填写分布时的蒙特卡洛不确定性计算 (后台分批并行，结果绘制为 P10/P50/P90 带)
+    void runMonteCarlo();
+
+    // 蒙特卡洛不确定性计算结果: 各时间点压力/导数的 10%、50%、90% 分位
+    struct MonteCarloResult {
+        QVector<double> t;
+        QVector<double> p10, p50, p90;
+        QVector<double> d10, d50, d90;
+        int samples = 0;     // 有效样本数
+        int shapes = 0;      // 不同拉普拉斯解的个数 (实际求解次数的来源)
+        bool completed = false;
+    };
+    // 在所有样本共用的 tD 网格与 z 节点上分批并行求解 (工作线程调用)
+    MonteCarloResult computeMonteCarlo(const QVector<QMap<QString, double>>& samples, const QVector<double>& t,
+                                       const CancellationToken* token, std::atomic<int>* progress);
 
+    // 参数名与输入框对应表 (仅含当前模型可见的参数)
+    QList<QPair<QString, QLineEdit*>> parameterEdits() const;
     // 辅助函数
     QVector<double> parseInput(const QString& text);
     void setInputText(QLineEdit* edit, double value);
     void plotCurve(const ModelCurveData& data, const QString& name, QColor color, bool isSensitivity);
+    // 以末时刻压差相对基准工况的变化绘制龙卷风图与蛛网图
+    void updateSensitivityRanking(const QList<ModelCurveData>& results);
 
     // 数学计算核心 (Stehfest 反演循环)
     void calculatePDandDeriv(const QVector<double>& tD, const QMap<QString, double>& params,
-                             std::function<double(double, const QMap<QString, double>&)> laplaceFunc,
-                             QVector<double>& outPD, QVector<double>& outDeriv);
+                             QVector<double>& outPD, QVector<double>& outDeriv, const CancellationToken* token = nullptr);
+
+    // 单点 Stehfest 反演 (含压敏摄动修正)
+    double stehfestInversion(double tD, const QMap<QString, double>& params, int N, const CancellationToken* token = nullptr);
+    // 根据参数表中的 "N" 确定 Stehfest 阶数
+    int stehfestOrder(const QMap<QString, double>& params) const;
+    // 以预制表插值出的拉普拉斯曲线做 Stehfest 反演 (叠加井储表皮与压敏修正)
+    double stehfestInversionFromTable(double tD, const QMap<QString, double>& params, const LaplaceCurve& curve, int N);
+    // 由已算好的拉普拉斯解 pf[m-1] = f(m*ln2/tD) 做 Stehfest 组合 (叠加井储表皮与压敏修正)
+    double stehfestFromLaplace(double tD, const double* pf, const QMap<QString, double>& params, int N);
+    // 井储表皮叠加 (仅变井储模型) 与压敏摄动修正，完整求解与查表共用
+    double applyWellboreStorage(double z, double pf, const QMap<QString, double>& params) const;
+    static double applyStressSensitivity(double pd, const QMap<QString, double>& params);
+    // 本模型对应的预制表边界类型
+    TypeCurveTable::Geometry tableGeometry() const;
+    // 取消并等待全部后台任务 (含已被取代的任务)，返回后不再有工作线程引用本对象
+    void stopBackgroundTasks();
 
     // 拉普拉斯空间解 (复合模型通用入口)
-    double flaplace_composite(double z, const QMap<QString, double>& p);
+    double flaplace_composite(double z, const QMap<QString, double>& p, const CancellationToken* token = nullptr);
 
     // PWD 核心计算 (包含边界条件处理 Logic from MATLAB PWD_inf)
-    double PWD_composite(double z, double fs1, double fs2, double M12, double LfD, double rmD, double reD, int nf, const QVector<double>& xwD, ModelType type);
+    double PWD_composite(double z, double fs1, double fs2, double M12, double LfD, double rmD, double reD, int nf, const QVector<double>& xwD, ModelType type,
+                         const CancellationToken* token = nullptr);
 
     // 数学工具函数 (对应 MATLAB 内置函数或逻辑)
     double scaled_besseli(int v, double x); // 缩放 Bessel I
@@ -95,12 +177,54 @@ private:
     QCPTextElement* m_plotTitle;
     ModelType m_type;
     bool m_highPrecision;
-    QList<QColor> m_colorList;
+
+    // 敏感性排序图 (龙卷风图、蛛网图)
+    QCustomPlot* m_tornadoPlot;
+    QCustomPlot* m_spiderPlot;
 
     // 缓存结果
     QVector<double> res_tD;
     QVector<double> res_pD;
     QVector<double> res_dpD;
+
+    // 预览用无因次曲线缓存
+    QMutex m_previewMutex;
+    QMap<QString, double> m_previewKey;
+    QVector<double> m_previewTD;
+    QVector<double> m_previewPD;
+
+    // 无因次拉普拉斯解预制表 (内存映射，存在时用于预览)；同一边界类型的模型共用一个实例
+    TypeCurveTable* m_typeTable;
+
+    // 后台粗网格预览 (缓存与预制表未命中的工况) 与全精度细化任务
+    struct RefineJob {
+        QList<QMap<QString, double>> params; // 各工况参数
+        QStringList names;                   // 图例名称
+        QString header;                      // 结果文本表头
+        QList<QColor> colors;                // 各工况曲线颜色
+        QMap<QString, double> baseParams;    // 基础参数 (用于完成信号)
+        bool isSensitivity = false;
+        QStringList sweepKeys;               // 敏感性参数 (可多个，逐一单独变化)
+        QVector<int> caseGroup;              // 各工况所属参数在 sweepKeys 中的序号，基准工况为 -1
+        QVector<double> caseValues;          // 各工况该参数的取值
+        QVector<int> previewCases;           // 后台预览任务第 k 个结果对应的工况序号
+        QVector<bool> refined;               // 各工况是否已得到全精度结果
+    };
+    RefineJob m_refineJob;
+    QSharedPointer<CancellationToken> m_refineToken;
+    QFutureWatcher<ModelCurveData> m_previewWatcher;
+    QFutureWatcher<ModelCurveData> m_refineWatcher;
+    QList<QFuture<ModelCurveData>> m_staleRefines;  // 已被取代但可能仍在运行的预览与细化任务 (引用本对象，析构时须等待)
+
+    // 蒙特卡洛不确定性计算任务
+    QMap<QString, double> m_mcCenterParams;  // 各分布取中心值的参数 (用于完成信号)
+    QString m_mcHeader;
+    QSharedPointer<CancellationToken> m_mcToken;
+    QSharedPointer<std::atomic<int>> m_mcProgress;
+    int m_mcSampleCount;
+    QFutureWatcher<MonteCarloResult> m_mcWatcher;
+    QList<QFuture<MonteCarloResult>> m_staleMcRuns;  // 已被取代但可能仍在运行的蒙特卡洛任务
+    QTimer* m_mcTimer;
 };
 
 #endif // MODELWIDGET01_06_H
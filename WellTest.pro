@@ -27,11 +27,32 @@ win32: LIBS += -lm
 
 # Input
 HEADERS += dataeditorwidget.h \
+           bayesianoptimizer.h \
+           cancellationtoken.h \
            chartsetting1.h \
            chartsetting2.h \
+           columnartablemodel.h \
+           curveinterpolator.h \
+           decimationdialog.h \
+           deconvolutiondialog.h \
+           deconvolutionengine.h \
+           derivativeengine.h \
+           derivativesmoother.h \
+           fitsession.h \
            fittingobserveddata.h \
            fittingpage.h \
            fittingparameterchart.h \
+           flowperioddetector.h \
+           flowperioddialog.h \
+           flowregimeidentifier.h \
+           flowregimeoverlay.h \
+           hampelfilter.h \
+           jointfitdialog.h \
+           jointfitsession.h \
+           logtimedecimator.h \
+           mcmcdialog.h \
+           mcmcsampler.h \
+           modelcomparisondialog.h \
            modelmanager.h \
            modelparameter.h \
            modelselect.h \
@@ -53,6 +74,17 @@ HEADERS += dataeditorwidget.h \
            pressurederivativecalculator1.h \
            settingswidget.h \
            qcustomplot.h \
+           objectivelandscape.h \
+           objectivelandscapedialog.h \
+           outlierdialog.h \
+           slidingmedian.h \
+           spectralfilter.h \
+           spectralfilterdialog.h \
+           superpositiontime.h \
+           surrogatemodel.h \
+           typecurvebank.h \
+           typecurvematchdialog.h \
+           typecurvetable.h \
            wt_fittingwidget.h \
            wt_plottingwidget.h \
            wt_projectwidget.h
@@ -81,12 +113,32 @@ FORMS += dataeditorwidget.ui \
          wt_projectwidget.ui
 
 SOURCES += \
+           bayesianoptimizer.cpp \
            chartsetting1.cpp \
            chartsetting2.cpp \
+           columnartablemodel.cpp \
+           curveinterpolator.cpp \
            dataeditorwidget.cpp \
+           decimationdialog.cpp \
+           deconvolutiondialog.cpp \
+           deconvolutionengine.cpp \
+           derivativeengine.cpp \
+           derivativesmoother.cpp \
+           fitsession.cpp \
            fittingobserveddata.cpp \
            fittingpage.cpp \
            fittingparameterchart.cpp \
+           flowperioddetector.cpp \
+           flowperioddialog.cpp \
+           flowregimeidentifier.cpp \
+           flowregimeoverlay.cpp \
+           hampelfilter.cpp \
+           jointfitdialog.cpp \
+           jointfitsession.cpp \
+           logtimedecimator.cpp \
+           mcmcdialog.cpp \
+           mcmcsampler.cpp \
+           modelcomparisondialog.cpp \
            modelmanager.cpp \
            modelparameter.cpp \
            modelselect.cpp \
@@ -109,6 +161,16 @@ SOURCES += \
            pressurederivativecalculator1.cpp \
            settingswidget.cpp \
            qcustomplot.cpp \
+           objectivelandscape.cpp \
+           objectivelandscapedialog.cpp \
+           outlierdialog.cpp \
+           spectralfilter.cpp \
+           spectralfilterdialog.cpp \
+           superpositiontime.cpp \
+           surrogatemodel.cpp \
+           typecurvebank.cpp \
+           typecurvematchdialog.cpp \
+           typecurvetable.cpp \
            wt_fittingwidget.cpp \
            wt_plottingwidget.cpp \
            wt_projectwidget.cpp
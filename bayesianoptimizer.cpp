@@ -0,0 +1,220 @@
+/*
+ * bayesianoptimizer.cpp
+ * 文件作用：贝叶斯优化器实现文件
+ * 功能描述：
+ * 1. 目标值标准化后拟合零均值高斯过程，Cholesky 分解求后验
+ * 2. 采集函数最大化: 全域随机点 + 当前最优点附近扰动点打分，取前几名做坐标搜索
+ * 3. 批量选点时以当前最小值作为已选点的虚拟观测 (常数说谎者)，使同一批点相互分散
+ */
+
+#include "bayesianoptimizer.h"
+
+#include <QPair>
+#include <cmath>
+#include <algorithm>
+#include <limits>
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+namespace {
+const double kNoise = 1e-4;      // 标准化尺度下的观测噪声 (网格反演带来的微小数值噪声)
+const double kExploration = 0.01; // EI 探索裕量
+}
+
+BayesianOptimizer::BayesianOptimizer(int dim, unsigned int seed)
+    : m_dim(dim), m_rng(seed), m_yMean(0.0), m_yStd(1.0), m_length(0.3)
+{
+}
+
+void BayesianOptimizer::addObservation(const QVector<double>& u, double value)
+{
+    if (u.size() != m_dim || !std::isfinite(value)) return;
+    m_X.append(u);
+    m_y.append(value);
+}
+
+int BayesianOptimizer::observationCount() const { return m_X.size(); }
+
+double BayesianOptimizer::bestValue() const
+{
+    if (m_y.isEmpty()) return std::numeric_limits<double>::infinity();
+    return *std::min_element(m_y.begin(), m_y.end());
+}
+
+QVector<double> BayesianOptimizer::bestPoint() const
+{
+    if (m_y.isEmpty()) return QVector<double>();
+    return m_X[int(std::min_element(m_y.begin(), m_y.end()) - m_y.begin())];
+}
+
+double BayesianOptimizer::kernel(const QVector<double>& a, const QVector<double>& b, double length) const
+{
+    // Matern 5/2
+    double r2 = 0.0;
+    for (int k = 0; k < m_dim; ++k) { double d = a[k] - b[k]; r2 += d * d; }
+    double s = std::sqrt(5.0 * r2) / length;
+    return (1.0 + s + s * s / 3.0) * std::exp(-s);
+}
+
+bool BayesianOptimizer::fitModel(const QVector<QVector<double>>& X, const QVector<double>& y, bool selectLength)
+{
+    const int n = X.size();
+    if (n < 2) return false;
+
+    double mean = 0.0;
+    for (double v : y) mean += v;
+    mean /= n;
+    double var = 0.0;
+    for (double v : y) var += (v - mean) * (v - mean);
+    double stdDev = std::sqrt(var / n);
+    if (!(stdDev > 1e-12)) stdDev = 1.0;
+    Eigen::VectorXd ys(n);
+    for (int i = 0; i < n; ++i) ys(i) = (y[i] - mean) / stdDev;
+
+    // 长度尺度候选按维数放大，单位超立方体对角线长度为 sqrt(d)
+    QVector<double> lengths;
+    if (selectLength) {
+        double scale = std::sqrt((double)m_dim);
+        for (double l : { 0.1, 0.2, 0.3, 0.5, 0.8, 1.2 }) lengths.append(l * scale);
+    } else {
+        lengths.append(m_length);
+    }
+
+    double bestLml = -std::numeric_limits<double>::infinity();
+    bool ok = false;
+    for (double l : lengths) {
+        Eigen::MatrixXd K(n, n);
+        for (int i = 0; i < n; ++i) {
+            K(i, i) = 1.0 + kNoise;
+            for (int j = i + 1; j < n; ++j) K(i, j) = K(j, i) = kernel(X[i], X[j], l);
+        }
+        Eigen::LLT<Eigen::MatrixXd> llt(K);
+        if (llt.info() != Eigen::Success) continue;
+        Eigen::VectorXd alpha = llt.solve(ys);
+        // 对数边际似然 (略去常数项)
+        double logDet = 0.0;
+        Eigen::MatrixXd L = llt.matrixL();
+        for (int i = 0; i < n; ++i) logDet += std::log(L(i, i));
+        double lml = -0.5 * ys.dot(alpha) - logDet;
+        if (lml > bestLml) {
+            bestLml = lml;
+            m_length = l;
+            m_llt = llt;
+            m_alpha = alpha;
+            ok = true;
+        }
+    }
+    if (!ok) return false;
+    m_fitX = X;
+    m_yMean = mean;
+    m_yStd = stdDev;
+    return true;
+}
+
+void BayesianOptimizer::predict(const QVector<double>& u, double& mean, double& var) const
+{
+    const int n = m_fitX.size();
+    Eigen::VectorXd ks(n);
+    for (int i = 0; i < n; ++i) ks(i) = kernel(u, m_fitX[i], m_length);
+    mean = ks.dot(m_alpha);
+    Eigen::VectorXd v = m_llt.matrixL().solve(ks);
+    var = qMax(1.0 - v.squaredNorm(), 1e-12);
+}
+
+double BayesianOptimizer::expectedImprovement(const QVector<double>& u, double best) const
+{
+    double mean, var;
+    predict(u, mean, var);
+    double sigma = std::sqrt(var);
+    double bestStd = (best - m_yMean) / m_yStd;
+    double imp = bestStd - mean - kExploration;
+    double z = imp / sigma;
+    double cdf = 0.5 * std::erfc(-z / std::sqrt(2.0));
+    double pdf = std::exp(-0.5 * z * z) / std::sqrt(2.0 * M_PI);
+    return imp * cdf + sigma * pdf;
+}
+
+QVector<double> BayesianOptimizer::maximizeAcquisition(double best)
+{
+    const int globalCount = 1000;
+    const int localCount = 200;
+    const int refineCount = 3;
+
+    std::uniform_real_distribution<double> uni(0.0, 1.0);
+    std::normal_distribution<double> gauss(0.0, 0.05);
+    QVector<QVector<double>> cand;
+    cand.reserve(globalCount + localCount);
+    for (int i = 0; i < globalCount; ++i) {
+        QVector<double> u(m_dim);
+        for (int k = 0; k < m_dim; ++k) u[k] = uni(m_rng);
+        cand.append(u);
+    }
+    QVector<double> center = bestPoint();
+    for (int i = 0; i < localCount && !center.isEmpty(); ++i) {
+        QVector<double> u = center;
+        for (int k = 0; k < m_dim; ++k) u[k] = qBound(0.0, u[k] + gauss(m_rng), 1.0);
+        cand.append(u);
+    }
+
+    QVector<QPair<double, int>> ranked;
+    ranked.reserve(cand.size());
+    for (int i = 0; i < cand.size(); ++i) ranked.append(qMakePair(expectedImprovement(cand[i], best), i));
+    std::partial_sort(ranked.begin(), ranked.begin() + qMin(refineCount, (int)ranked.size()), ranked.end(),
+                      [](const QPair<double, int>& a, const QPair<double, int>& b) { return a.first > b.first; });
+
+    // 前几名做坐标搜索
+    QVector<double> bestU = cand[ranked[0].second];
+    double bestEi = ranked[0].first;
+    for (int r = 0; r < refineCount && r < ranked.size(); ++r) {
+        QVector<double> u = cand[ranked[r].second];
+        double f = ranked[r].first;
+        for (double step = 0.05; step > 1e-3; ) {
+            bool improved = false;
+            for (int k = 0; k < m_dim; ++k) {
+                for (double sgn : { -1.0, 1.0 }) {
+                    QVector<double> v = u; v[k] = qBound(0.0, u[k] + sgn * step, 1.0);
+                    double fv = expectedImprovement(v, best);
+                    if (fv > f) { u = v; f = fv; improved = true; }
+                }
+            }
+            if (!improved) step *= 0.5;
+        }
+        if (f > bestEi) { bestEi = f; bestU = u; }
+    }
+    return bestU;
+}
+
+QVector<QVector<double>> BayesianOptimizer::proposeBatch(int batchSize)
+{
+    QVector<QVector<double>> batch;
+    if (batchSize <= 0) return batch;
+
+    std::uniform_real_distribution<double> uni(0.0, 1.0);
+    auto randomPoint = [&]() {
+        QVector<double> u(m_dim);
+        for (int k = 0; k < m_dim; ++k) u[k] = uni(m_rng);
+        return u;
+    };
+    if (m_X.size() < 2 || !fitModel(m_X, m_y, true)) {
+        for (int b = 0; b < batchSize; ++b) batch.append(randomPoint());
+        return batch;
+    }
+
+    // 常数说谎者: 已选点以当前最小值作为虚拟观测加入模型，再选下一个点
+    double best = bestValue();
+    QVector<QVector<double>> X = m_X;
+    QVector<double> y = m_y;
+    for (int b = 0; b < batchSize; ++b) {
+        QVector<double> u = maximizeAcquisition(best);
+        batch.append(u);
+        if (b + 1 == batchSize) break;
+        X.append(u); y.append(best);
+        if (!fitModel(X, y, false)) {
+            for (++b; b < batchSize; ++b) batch.append(randomPoint());
+            break;
+        }
+    }
+    return batch;
+}
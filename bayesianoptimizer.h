@@ -0,0 +1,59 @@
+/*
+ * bayesianoptimizer.h
+ * 文件作用：贝叶斯优化器头文件
+ * 功能描述：
+ * 1. 以高斯过程 (Matern 5/2 核) 拟合 [0,1]^d 上的目标函数 (拟合中为 log SSE)
+ * 2. 核长度尺度按对数边际似然在候选集中选取
+ * 3. 以期望改进量 (EI) 为采集函数，"常数说谎者" 策略一次给出一批候选点，便于并行计算真实模型
+ * 4. 本类只负责建模与选点，不调用模型，可在任意线程中使用
+ */
+
+#ifndef BAYESIANOPTIMIZER_H
+#define BAYESIANOPTIMIZER_H
+
+#include <QVector>
+#include <Eigen/Dense>
+#include <random>
+
+class BayesianOptimizer
+{
+public:
+    BayesianOptimizer(int dim, unsigned int seed = 20240601u);
+
+    // 记录一个已计算的点 (u 为 [0,1]^d 内坐标)
+    void addObservation(const QVector<double>& u, double value);
+
+    // 给出下一批候选点 (数目 batchSize)，点数不足以建模时返回随机点
+    QVector<QVector<double>> proposeBatch(int batchSize);
+
+    int observationCount() const;
+    double bestValue() const;
+    QVector<double> bestPoint() const;
+
+private:
+    // 用当前观测拟合高斯过程；selectLength 为 true 时重新选取长度尺度
+    bool fitModel(const QVector<QVector<double>>& X, const QVector<double>& y, bool selectLength);
+    double kernel(const QVector<double>& a, const QVector<double>& b, double length) const;
+    // 标准化尺度下的后验均值与方差
+    void predict(const QVector<double>& u, double& mean, double& var) const;
+    double expectedImprovement(const QVector<double>& u, double best) const;
+    QVector<double> maximizeAcquisition(double best);
+
+private:
+    int m_dim;
+    std::mt19937 m_rng;
+
+    // 观测数据
+    QVector<QVector<double>> m_X;
+    QVector<double> m_y;
+
+    // 当前高斯过程 (目标值已标准化)
+    QVector<QVector<double>> m_fitX;
+    double m_yMean;
+    double m_yStd;
+    double m_length;
+    Eigen::LLT<Eigen::MatrixXd> m_llt;
+    Eigen::VectorXd m_alpha;
+};
+
+#endif // BAYESIANOPTIMIZER_H
@@ -0,0 +1,48 @@
+/*
+ * cancellationtoken.h
+ * 文件作用：协作式取消令牌
+ * 功能描述：
+ * 1. 原子停止标志，可由界面线程随时置位
+ * 2. 可选截止时间 (QDeadlineTimer)，到期后视同取消，用于限时拟合
+ * 3. 以 const 指针形式向下传递到 Stehfest 反演循环和矩阵组装中，
+ *    长时间计算在内层循环即可及时退出
+ */
+
+#ifndef CANCELLATIONTOKEN_H
+#define CANCELLATIONTOKEN_H
+
+#include <QDeadlineTimer>
+#include <atomic>
+
+class CancellationToken
+{
+public:
+    CancellationToken() : m_cancelled(false), m_deadline(QDeadlineTimer::Forever) {}
+
+    // 请求取消 (任意线程可调用)
+    void cancel() { m_cancelled.store(true, std::memory_order_relaxed); }
+
+    // 设置时间预算 (毫秒)，<= 0 表示不限时；从调用时刻开始计时，应在计算实际开始时调用
+    void setTimeBudget(qint64 msecs)
+    {
+        m_deadline = (msecs > 0) ? QDeadlineTimer(msecs) : QDeadlineTimer(QDeadlineTimer::Forever);
+    }
+
+    // 是否由用户主动取消
+    bool isCancelRequested() const { return m_cancelled.load(std::memory_order_relaxed); }
+
+    // 是否已到达截止时间
+    bool isDeadlineReached() const { return m_deadline.hasExpired(); }
+
+    // 计算是否应当停止 (主动取消或到达截止时间)
+    bool isCancelled() const { return isCancelRequested() || isDeadlineReached(); }
+
+    // 便于在空指针情况下调用: 未传令牌时永不取消
+    static bool cancelled(const CancellationToken* token) { return token && token->isCancelled(); }
+
+private:
+    std::atomic<bool> m_cancelled;
+    QDeadlineTimer m_deadline;
+};
+
+#endif // CANCELLATIONTOKEN_H
@@ -0,0 +1,664 @@
+/*
+ * columnartablemodel.cpp
+ * 文件作用：按列类型存储的数据表模型实现文件
+ * 功能描述：
+ * 1. 数值只接受规范十进制写法 (整数部分无多余前导零、无首尾空白以外的字符)，且按记录的格式能还原出原文本，
+ *    其余写法保留为文本，显示与保存不丢信息
+ * 2. 数值显示格式码: 各单元格小数位一致时整列记一个，不一致时逐单元格一字节，与标记色同样按需分配
+ * 3. 日期时间按定宽格式逐字符解析与回写，百万行级别不经过 QDateTime::fromString
+ * 4. 单元格标记色存为每行一字节的调色板序号，只在首次标记时为该列分配
+ */
+
+#include "columnartablemodel.h"
+
+#include <QDate>
+#include <QBrush>
+#include <QLocale>
+#include <cmath>
+#include <limits>
+
+namespace {
+const qint64 kNullTime = std::numeric_limits<qint64>::min();
+const qint64 kMsecsPerDay = 86400000;
+const qint64 kEpochJulianDay = 2440588;   // 1970-01-01
+// 数值显示格式码: 0..127 为 'f' 小数位，128 + p 为 'g' p 位有效数字
+const quint8 kFormatGeneral = 128;
+const quint8 kFormatUnset = 0xFE;          // 数值列尚未写入任何值
+const quint8 kFormatShortest = 0xFF;       // 最短往返表示
+const int kMaxExactDigits = 15;            // 不超过此位数的十进制数经 double 原样还原
+const int kMaxPaletteSize = 256;
+
+// 定宽日期时间格式，按序尝试；字段字母 y M d h m s z，其余字符原样匹配
+const char* const kTimeFormats[] = {
+    "yyyy-MM-dd hh:mm:ss.zzz", "yyyy-MM-dd hh:mm:ss", "yyyy-MM-dd hh:mm",
+    "yyyy/MM/dd hh:mm:ss.zzz", "yyyy/MM/dd hh:mm:ss", "yyyy/MM/dd hh:mm",
+    "yyyy-MM-ddThh:mm:ss", "yyyy-MM-dd", "yyyy/MM/dd", "yyyy.MM.dd",
+    "hh:mm:ss.zzz", "hh:mm:ss", "hh:mm"
+};
+const char kTimeFields[] = "yMdhmsz";
+
+int timeField(QChar c)
+{
+    for (int k = 0; k < 7; ++k) {
+        if (c == QLatin1Char(kTimeFields[k])) return k;
+    }
+    return -1;
+}
+
+bool isDigit(QChar c)
+{
+    return c.unicode() >= '0' && c.unicode() <= '9';
+}
+
+QString formatNumber(double value, quint8 format)
+{
+    if (format < kFormatGeneral) return QString::number(value, 'f', format);
+    if (format == kFormatShortest) return QString::number(value, 'g', QLocale::FloatingPointShortest);
+    return QString::number(value, 'g', format - kFormatGeneral);
+}
+
+// 规范十进制数: [-]整数[.小数][e[+-]指数]；format 为能原样还原 text 的显示格式码，
+// 没有这样的格式 (位数过多、负零、指数写法与最短表示不同等) 时返回 false
+bool parseNumber(const QString& text, double& value, quint8& format)
+{
+    const int n = text.size();
+    int i = 0;
+    if (i < n && text[i] == QLatin1Char('-')) ++i;
+    const int intStart = i;
+    while (i < n && isDigit(text[i])) ++i;
+    if (i == intStart || (i - intStart > 1 && text[intStart] == QLatin1Char('0'))) return false;
+
+    int decimals = 0;
+    if (i < n && text[i] == QLatin1Char('.')) {
+        const int fracStart = ++i;
+        while (i < n && isDigit(text[i])) ++i;
+        if (i == fracStart) return false;
+        decimals = i - fracStart;
+    }
+    const int digits = i - intStart - (decimals > 0 ? 1 : 0);
+    bool exponent = false;
+    if (i < n && (text[i] == QLatin1Char('e') || text[i] == QLatin1Char('E'))) {
+        ++i;
+        if (i < n && (text[i] == QLatin1Char('+') || text[i] == QLatin1Char('-'))) ++i;
+        const int expStart = i;
+        while (i < n && isDigit(text[i])) ++i;
+        if (i == expStart) return false;
+        exponent = true;
+    }
+    if (i != n || (!exponent && decimals >= kFormatGeneral)) return false;
+
+    bool ok = false;
+    value = text.toDouble(&ok);
+    if (!ok || !std::isfinite(value)) return false;
+
+    format = exponent ? kFormatShortest : quint8(decimals);
+    // 定点写法在 15 位有效数字以内必然原样还原，其余情况逐个核对
+    if (exponent || digits > kMaxExactDigits || (value == 0.0 && text[0] == QLatin1Char('-'))) {
+        return formatNumber(value, format) == text;
+    }
+    return true;
+}
+
+bool parseTime(const QString& text, const QString& format, qint64& msecs)
+{
+    if (text.size() != format.size()) return false;
+    int values[7] = {1970, 1, 1, 0, 0, 0, 0};
+    bool hasDate = false;
+    int current = -1;
+    for (int i = 0; i < text.size(); ++i) {
+        const int k = timeField(format[i]);
+        if (k < 0) {
+            if (text[i] != format[i]) return false;
+            current = -1;
+            continue;
+        }
+        if (!isDigit(text[i])) return false;
+        if (k != current) {
+            values[k] = 0;
+            current = k;
+        }
+        values[k] = values[k] * 10 + (text[i].unicode() - '0');
+        if (k < 3) hasDate = true;
+    }
+    if (values[3] > 23 || values[4] > 59 || values[5] > 59) return false;
+
+    qint64 days = 0;
+    if (hasDate) {
+        const QDate date(values[0], values[1], values[2]);
+        if (!date.isValid()) return false;
+        days = date.toJulianDay() - kEpochJulianDay;
+    }
+    msecs = days * kMsecsPerDay + ((values[3] * 60 + values[4]) * 60 + values[5]) * 1000 + values[6];
+    return true;
+}
+
+QString formatTime(qint64 msecs, const QString& format)
+{
+    qint64 days = msecs / kMsecsPerDay;
+    qint64 rest = msecs % kMsecsPerDay;
+    if (rest < 0) {
+        rest += kMsecsPerDay;
+        --days;
+    }
+    const QDate date = QDate::fromJulianDay(days + kEpochJulianDay);
+    const int values[7] = {date.year(), date.month(), date.day(), int(rest / 3600000),
+                           int(rest / 60000 % 60), int(rest / 1000 % 60), int(rest % 1000)};
+
+    QString out = format;
+    int i = 0;
+    while (i < out.size()) {
+        const int k = timeField(format[i]);
+        if (k < 0) {
+            ++i;
+            continue;
+        }
+        int j = i;
+        while (j < out.size() && format[j] == format[i]) ++j;
+        int v = values[k];
+        for (int p = j - 1; p >= i; --p) {
+            out[p] = QLatin1Char(char('0' + v % 10));
+            v /= 10;
+        }
+        i = j;
+    }
+    return out;
+}
+}
+
+ColumnarTableModel::ColumnarTableModel(QObject* parent)
+    : QAbstractTableModel(parent), m_rowCount(0), m_bulkDepth(0)
+{
+    m_strings.append(QString());
+    m_stringIndex.insert(QString(), 0);
+    m_palette.append(QColor());
+}
+
+int ColumnarTableModel::rowCount(const QModelIndex& parent) const
+{
+    return parent.isValid() ? 0 : m_rowCount;
+}
+
+int ColumnarTableModel::columnCount(const QModelIndex& parent) const
+{
+    return parent.isValid() ? 0 : m_columns.size();
+}
+
+QVariant ColumnarTableModel::data(const QModelIndex& index, int role) const
+{
+    if (!index.isValid() || index.row() >= m_rowCount || index.column() >= m_columns.size()) {
+        return QVariant();
+    }
+    const Column& column = m_columns[index.column()];
+
+    switch (role) {
+    case Qt::DisplayRole:
+    case Qt::EditRole:
+        return formatCell(column, index.row());
+    case Qt::ForegroundRole:
+        if (!column.marks.isEmpty() && column.marks[index.row()]) {
+            return QBrush(m_palette[column.marks[index.row()]]);
+        }
+        if (column.foreground.isValid()) return QBrush(column.foreground);
+        if (m_defaultForeground.isValid()) return QBrush(m_defaultForeground);
+        return QVariant();
+    case Qt::BackgroundRole:
+        return column.background.isValid() ? QVariant(QBrush(column.background)) : QVariant();
+    default:
+        return QVariant();
+    }
+}
+
+bool ColumnarTableModel::setData(const QModelIndex& index, const QVariant& value, int role)
+{
+    if (!index.isValid() || (role != Qt::EditRole && role != Qt::DisplayRole)) {
+        return false;
+    }
+    setText(index.row(), index.column(), value.toString());
+    return true;
+}
+
+QVariant ColumnarTableModel::headerData(int section, Qt::Orientation orientation, int role) const
+{
+    if (role == Qt::DisplayRole || role == Qt::EditRole) {
+        if (orientation == Qt::Horizontal && section >= 0 && section < m_columns.size()) {
+            const QString& header = m_columns[section].header;
+            return header.isEmpty() ? QString::number(section + 1) : header;
+        }
+        if (orientation == Qt::Vertical && section >= 0 && section < m_rowCount) {
+            return QString::number(section + 1);
+        }
+    }
+    return QAbstractTableModel::headerData(section, orientation, role);
+}
+
+bool ColumnarTableModel::setHeaderData(int section, Qt::Orientation orientation, const QVariant& value, int role)
+{
+    if (orientation != Qt::Horizontal || section < 0 || section >= m_columns.size() ||
+        (role != Qt::EditRole && role != Qt::DisplayRole)) {
+        return false;
+    }
+    setHeaderText(section, value.toString());
+    return true;
+}
+
+Qt::ItemFlags ColumnarTableModel::flags(const QModelIndex& index) const
+{
+    if (!index.isValid()) return Qt::NoItemFlags;
+    return Qt::ItemIsSelectable | Qt::ItemIsEnabled | Qt::ItemIsEditable;
+}
+
+bool ColumnarTableModel::insertRows(int row, int count, const QModelIndex& parent)
+{
+    if (parent.isValid() || row < 0 || row > m_rowCount || count <= 0) return false;
+
+    beginInsertRows(QModelIndex(), row, row + count - 1);
+    for (Column& column : m_columns) insertCells(column, row, count);
+    m_rowCount += count;
+    endInsertRows();
+    return true;
+}
+
+bool ColumnarTableModel::removeRows(int row, int count, const QModelIndex& parent)
+{
+    if (parent.isValid() || row < 0 || count <= 0 || row + count > m_rowCount) return false;
+
+    beginRemoveRows(QModelIndex(), row, row + count - 1);
+    for (Column& column : m_columns) removeCells(column, row, count);
+    m_rowCount -= count;
+    endRemoveRows();
+    return true;
+}
+
+bool ColumnarTableModel::insertColumns(int column, int count, const QModelIndex& parent)
+{
+    if (parent.isValid() || column < 0 || column > m_columns.size() || count <= 0) return false;
+
+    beginInsertColumns(QModelIndex(), column, column + count - 1);
+    Column fresh;
+    fresh.numbers.fill(std::numeric_limits<double>::quiet_NaN(), m_rowCount);
+    m_columns.insert(column, count, fresh);
+    endInsertColumns();
+    return true;
+}
+
+bool ColumnarTableModel::removeColumns(int column, int count, const QModelIndex& parent)
+{
+    if (parent.isValid() || column < 0 || count <= 0 || column + count > m_columns.size()) return false;
+
+    beginRemoveColumns(QModelIndex(), column, column + count - 1);
+    m_columns.remove(column, count);
+    endRemoveColumns();
+    return true;
+}
+
+void ColumnarTableModel::clear()
+{
+    beginResetModel();
+    m_columns.clear();
+    m_rowCount = 0;
+    m_strings.clear();
+    m_stringIndex.clear();
+    m_strings.append(QString());
+    m_stringIndex.insert(QString(), 0);
+    m_palette.resize(1);
+    endResetModel();
+}
+
+void ColumnarTableModel::setRowCount(int rows)
+{
+    if (rows > m_rowCount) {
+        insertRows(m_rowCount, rows - m_rowCount);
+    } else if (rows >= 0 && rows < m_rowCount) {
+        removeRows(rows, m_rowCount - rows);
+    }
+}
+
+void ColumnarTableModel::setColumnCount(int columns)
+{
+    const int current = m_columns.size();
+    if (columns > current) {
+        insertColumns(current, columns - current);
+    } else if (columns >= 0 && columns < current) {
+        removeColumns(columns, current - columns);
+    }
+}
+
+void ColumnarTableModel::setHorizontalHeaderLabels(const QStringList& labels)
+{
+    if (labels.size() > m_columns.size()) setColumnCount(labels.size());
+    for (int i = 0; i < labels.size(); ++i) m_columns[i].header = labels[i];
+    if (!labels.isEmpty()) emit headerDataChanged(Qt::Horizontal, 0, labels.size() - 1);
+}
+
+void ColumnarTableModel::beginBulkLoad()
+{
+    ++m_bulkDepth;
+}
+
+void ColumnarTableModel::endBulkLoad()
+{
+    if (m_bulkDepth > 0 && --m_bulkDepth == 0 && m_rowCount > 0 && !m_columns.isEmpty()) {
+        emit dataChanged(index(0, 0), index(m_rowCount - 1, m_columns.size() - 1));
+    }
+}
+
+QString ColumnarTableModel::headerText(int column) const
+{
+    return column >= 0 && column < m_columns.size() ? m_columns[column].header : QString();
+}
+
+void ColumnarTableModel::setHeaderText(int column, const QString& text)
+{
+    if (column < 0 || column >= m_columns.size()) return;
+    m_columns[column].header = text;
+    emit headerDataChanged(Qt::Horizontal, column, column);
+}
+
+QString ColumnarTableModel::text(int row, int column) const
+{
+    if (row < 0 || row >= m_rowCount || column < 0 || column >= m_columns.size()) return QString();
+    return formatCell(m_columns[column], row);
+}
+
+void ColumnarTableModel::setText(int row, int column, const QString& text)
+{
+    if (row < 0 || row >= m_rowCount || column < 0 || column >= m_columns.size()) return;
+
+    storeText(m_columns[column], row, text);
+    if (!bulk()) emitCellChanged(row, column);
+}
+
+ColumnarTableModel::ColumnType ColumnarTableModel::columnType(int column) const
+{
+    return column >= 0 && column < m_columns.size() ? m_columns[column].type : Text;
+}
+
+double ColumnarTableModel::value(int row, int column, bool* ok) const
+{
+    if (ok) *ok = false;
+    if (row < 0 || row >= m_rowCount || column < 0 || column >= m_columns.size()) return 0.0;
+
+    const Column& source = m_columns[column];
+    if (source.type == Numeric) {
+        const double v = source.numbers[row];
+        if (std::isnan(v)) return 0.0;
+        if (ok) *ok = true;
+        return v;
+    }
+    if (source.type == Text) {
+        return m_strings[source.textIds[row]].toDouble(ok);
+    }
+    return 0.0;
+}
+
+QVector<double> ColumnarTableModel::columnValues(int column) const
+{
+    if (column < 0 || column >= m_columns.size()) return QVector<double>();
+
+    const Column& source = m_columns[column];
+    if (source.type == Numeric) return source.numbers;
+
+    QVector<double> values(m_rowCount, std::numeric_limits<double>::quiet_NaN());
+    if (source.type == Text) {
+        for (int row = 0; row < m_rowCount; ++row) {
+            bool ok = false;
+            const double v = m_strings[source.textIds[row]].toDouble(&ok);
+            if (ok) values[row] = v;
+        }
+    }
+    return values;
+}
+
+void ColumnarTableModel::setValue(int row, int column, double value)
+{
+    if (row < 0 || row >= m_rowCount || column < 0 || column >= m_columns.size()) return;
+
+    Column& target = m_columns[column];
+    if (target.type != Numeric) {
+        storeText(target, row, std::isfinite(value) ? formatNumber(value, kFormatShortest) : QString());
+    } else {
+        target.numbers[row] = value;
+        if (std::isfinite(value)) {
+            // 原格式能还原该值时保留，例如按 3 位小数录入的列写入 1.25
+            const quint8 current = target.cellFormats.isEmpty() ? target.format : target.cellFormats[row];
+            const bool keep = current != kFormatUnset && formatNumber(value, current).toDouble() == value;
+            setCellFormat(target, row, keep ? current : kFormatShortest);
+        }
+    }
+    if (!bulk()) emitCellChanged(row, column);
+}
+
+void ColumnarTableModel::setColumnValues(int column, const QVector<double>& values, char format, int precision)
+{
+    if (column < 0 || column >= m_columns.size() || values.size() != m_rowCount) return;
+
+    Column& target = m_columns[column];
+    target.type = Numeric;
+    target.numbers = values;
+    target.times.clear();
+    target.textIds.clear();
+    target.timeFormat.clear();
+    target.cellFormats.clear();
+    if (format == 'f' && precision >= 0) {
+        target.format = quint8(qMin(precision, kFormatGeneral - 1));
+    } else if (format == 'g' && precision > 0) {
+        target.format = quint8(kFormatGeneral + qMin(precision, 17));
+    } else {
+        target.format = kFormatShortest;
+    }
+    if (!bulk() && m_rowCount > 0) emit dataChanged(index(0, column), index(m_rowCount - 1, column));
+}
+
+qint64 ColumnarTableModel::timeValue(int row, int column, bool* ok) const
+{
+    if (ok) *ok = false;
+    if (row < 0 || row >= m_rowCount || column < 0 || column >= m_columns.size()) return 0;
+
+    const Column& source = m_columns[column];
+    if (source.type != DateTime || source.times[row] == kNullTime) return 0;
+    if (ok) *ok = true;
+    return source.times[row];
+}
+
+void ColumnarTableModel::setDefaultForeground(const QColor& color)
+{
+    m_defaultForeground = color;
+    if (!bulk() && m_rowCount > 0 && !m_columns.isEmpty()) {
+        emit dataChanged(index(0, 0), index(m_rowCount - 1, m_columns.size() - 1), {Qt::ForegroundRole});
+    }
+}
+
+void ColumnarTableModel::setColumnForeground(int column, const QColor& color)
+{
+    if (column < 0 || column >= m_columns.size()) return;
+    m_columns[column].foreground = color;
+    if (!bulk() && m_rowCount > 0) {
+        emit dataChanged(index(0, column), index(m_rowCount - 1, column), {Qt::ForegroundRole});
+    }
+}
+
+void ColumnarTableModel::setColumnBackground(int column, const QColor& color)
+{
+    if (column < 0 || column >= m_columns.size()) return;
+    m_columns[column].background = color;
+    if (!bulk() && m_rowCount > 0) {
+        emit dataChanged(index(0, column), index(m_rowCount - 1, column), {Qt::BackgroundRole});
+    }
+}
+
+void ColumnarTableModel::setCellForeground(int row, int column, const QColor& color)
+{
+    if (row < 0 || row >= m_rowCount || column < 0 || column >= m_columns.size()) return;
+
+    int entry = 0;
+    if (color.isValid()) {
+        entry = m_palette.indexOf(color, 1);
+        if (entry < 0) {
+            if (m_palette.size() >= kMaxPaletteSize) return;
+            entry = m_palette.size();
+            m_palette.append(color);
+        }
+    }
+
+    Column& target = m_columns[column];
+    if (target.marks.isEmpty()) {
+        if (entry == 0) return;
+        target.marks.fill(0, m_rowCount);
+    }
+    target.marks[row] = quint8(entry);
+    if (!bulk()) {
+        const QModelIndex cell = index(row, column);
+        emit dataChanged(cell, cell, {Qt::ForegroundRole});
+    }
+}
+
+void ColumnarTableModel::clearCellForegrounds()
+{
+    for (Column& column : m_columns) column.marks.clear();
+    m_palette.resize(1);
+    if (!bulk() && m_rowCount > 0 && !m_columns.isEmpty()) {
+        emit dataChanged(index(0, 0), index(m_rowCount - 1, m_columns.size() - 1), {Qt::ForegroundRole});
+    }
+}
+
+void ColumnarTableModel::insertCells(Column& column, int row, int count)
+{
+    switch (column.type) {
+    case Numeric:
+        column.numbers.insert(row, count, std::numeric_limits<double>::quiet_NaN());
+        if (!column.cellFormats.isEmpty()) column.cellFormats.insert(row, count, column.format);
+        break;
+    case DateTime:
+        column.times.insert(row, count, kNullTime);
+        break;
+    case Text:
+        column.textIds.insert(row, count, 0);
+        break;
+    }
+    if (!column.marks.isEmpty()) column.marks.insert(row, count, 0);
+}
+
+void ColumnarTableModel::removeCells(Column& column, int row, int count)
+{
+    switch (column.type) {
+    case Numeric:
+        column.numbers.remove(row, count);
+        if (!column.cellFormats.isEmpty()) column.cellFormats.remove(row, count);
+        break;
+    case DateTime:
+        column.times.remove(row, count);
+        break;
+    case Text:
+        column.textIds.remove(row, count);
+        break;
+    }
+    if (!column.marks.isEmpty()) column.marks.remove(row, count);
+}
+
+void ColumnarTableModel::storeText(Column& column, int row, const QString& text)
+{
+    const QString trimmed = text.trimmed();
+
+    if (column.type == Numeric) {
+        double v = 0.0;
+        quint8 format = 0;
+        if (trimmed.isEmpty()) {
+            column.numbers[row] = std::numeric_limits<double>::quiet_NaN();
+            return;
+        }
+        if (parseNumber(trimmed, v, format)) {
+            column.numbers[row] = v;
+            setCellFormat(column, row, format);
+            return;
+        }
+        // 尚无数值的列: 首个非数值内容若为日期时间，整列按日期时间保存
+        if (column.format == kFormatUnset) {
+            for (const char* format : kTimeFormats) {
+                const QString candidate = QString::fromLatin1(format);
+                qint64 msecs = 0;
+                if (parseTime(trimmed, candidate, msecs)) {
+                    column.type = DateTime;
+                    column.timeFormat = candidate;
+                    column.numbers.clear();
+                    column.numbers.squeeze();
+                    column.times.fill(kNullTime, m_rowCount);
+                    column.times[row] = msecs;
+                    return;
+                }
+            }
+        }
+        convertToText(column);
+    } else if (column.type == DateTime) {
+        qint64 msecs = 0;
+        if (trimmed.isEmpty()) {
+            column.times[row] = kNullTime;
+            return;
+        }
+        if (parseTime(trimmed, column.timeFormat, msecs)) {
+            column.times[row] = msecs;
+            return;
+        }
+        convertToText(column);
+    }
+
+    column.textIds[row] = internString(text);
+}
+
+void ColumnarTableModel::setCellFormat(Column& column, int row, quint8 format)
+{
+    if (column.format == kFormatUnset) column.format = format;
+    if (column.cellFormats.isEmpty()) {
+        if (format == column.format) return;
+        column.cellFormats.fill(column.format, m_rowCount);
+    }
+    column.cellFormats[row] = format;
+}
+
+void ColumnarTableModel::convertToText(Column& column)
+{
+    QVector<int> ids(m_rowCount);
+    for (int row = 0; row < m_rowCount; ++row) ids[row] = internString(formatCell(column, row));
+    column.type = Text;
+    column.textIds = ids;
+    column.numbers.clear();
+    column.numbers.squeeze();
+    column.cellFormats.clear();
+    column.cellFormats.squeeze();
+    column.times.clear();
+    column.times.squeeze();
+    column.timeFormat.clear();
+}
+
+QString ColumnarTableModel::formatCell(const Column& column, int row) const
+{
+    switch (column.type) {
+    case Numeric: {
+        const double v = column.numbers[row];
+        if (std::isnan(v)) return QString();
+        return formatNumber(v, column.cellFormats.isEmpty() ? column.format : column.cellFormats[row]);
+    }
+    case DateTime: {
+        const qint64 msecs = column.times[row];
+        return msecs == kNullTime ? QString() : formatTime(msecs, column.timeFormat);
+    }
+    case Text:
+        return m_strings[column.textIds[row]];
+    }
+    return QString();
+}
+
+int ColumnarTableModel::internString(const QString& text)
+{
+    const auto it = m_stringIndex.constFind(text);
+    if (it != m_stringIndex.constEnd()) return it.value();
+    const int id = m_strings.size();
+    m_strings.append(text);
+    m_stringIndex.insert(text, id);
+    return id;
+}
+
+void ColumnarTableModel::emitCellChanged(int row, int column)
+{
+    const QModelIndex cell = index(row, column);
+    emit dataChanged(cell, cell);
+}
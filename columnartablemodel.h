@@ -0,0 +1,121 @@
+/*
+ * columnartablemodel.h
+ * 文件作用：按列类型存储的数据表模型头文件
+ * 功能描述：
+ * 1. 每列一段连续数组: 数值列为 double (NaN 表示空)，日期时间列为毫秒时间戳，只有文本列使用共享字符串池
+ * 2. 列类型随写入内容推断: 空列写入首个值时确定类型，出现无法按当前类型保存的值时整列转为文本
+ * 3. 数值列记录显示格式 (整列一个，单元格不一致时再逐单元格一字节)、日期时间列记录定宽格式，显示文本由类型值重新格式化
+ * 4. 前景/背景色由 data() 角色给出: 全表默认色、列色与稀疏的单元格标记色，不再逐单元格保存画刷
+ * 5. 提供与 QStandardItemModel 同名的整表操作，以及供计算模块直接读取的数值接口
+ * 6. 批量写入期间不逐单元格发 dataChanged，结束时整表发一次
+ */
+
+#ifndef COLUMNARTABLEMODEL_H
+#define COLUMNARTABLEMODEL_H
+
+#include <QAbstractTableModel>
+#include <QVector>
+#include <QStringList>
+#include <QHash>
+#include <QColor>
+
+class ColumnarTableModel : public QAbstractTableModel
+{
+    Q_OBJECT
+
+public:
+    enum ColumnType { Numeric, DateTime, Text };
+
+    explicit ColumnarTableModel(QObject* parent = nullptr);
+
+    // QAbstractTableModel 接口
+    int rowCount(const QModelIndex& parent = QModelIndex()) const override;
+    int columnCount(const QModelIndex& parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex& index, int role = Qt::DisplayRole) const override;
+    bool setData(const QModelIndex& index, const QVariant& value, int role = Qt::EditRole) override;
+    QVariant headerData(int section, Qt::Orientation orientation, int role = Qt::DisplayRole) const override;
+    bool setHeaderData(int section, Qt::Orientation orientation, const QVariant& value, int role = Qt::EditRole) override;
+    Qt::ItemFlags flags(const QModelIndex& index) const override;
+    bool insertRows(int row, int count, const QModelIndex& parent = QModelIndex()) override;
+    bool removeRows(int row, int count, const QModelIndex& parent = QModelIndex()) override;
+    bool insertColumns(int column, int count, const QModelIndex& parent = QModelIndex()) override;
+    bool removeColumns(int column, int count, const QModelIndex& parent = QModelIndex()) override;
+
+    // 与 QStandardItemModel 同名的整表操作
+    void clear();
+    void setRowCount(int rows);
+    void setColumnCount(int columns);
+    void setHorizontalHeaderLabels(const QStringList& labels);
+
+    // 批量写入: 期间单元格修改不发 dataChanged，endBulkLoad 时整表发一次；行列增删照常通知；可嵌套
+    void beginBulkLoad();
+    void endBulkLoad();
+
+    // 表头与单元格文本
+    QString headerText(int column) const;
+    void setHeaderText(int column, const QString& text);
+    QString text(int row, int column) const;
+    void setText(int row, int column, const QString& text);
+
+    // 数值访问: 数值列直接读取，文本列按文本解析，日期时间列与空单元格 ok = false
+    ColumnType columnType(int column) const;
+    double value(int row, int column, bool* ok = nullptr) const;
+    QVector<double> columnValues(int column) const;
+
+    // 写入数值: setValue 沿用单元格原显示格式，原格式不能还原该值时改为最短往返表示；
+    // setColumnValues 按 QString::number 的 format ('f' 或 'g') 与 precision 设整列显示格式，precision < 0 为最短往返表示
+    void setValue(int row, int column, double value);
+    void setColumnValues(int column, const QVector<double>& values, char format = 'g', int precision = -1);
+
+    // 日期时间列: 自 1970-01-01 起的毫秒数 (只有时刻的格式为当日毫秒数)
+    qint64 timeValue(int row, int column, bool* ok = nullptr) const;
+
+    // 显示样式
+    void setDefaultForeground(const QColor& color);
+    void setColumnForeground(int column, const QColor& color);
+    void setColumnBackground(int column, const QColor& color);
+    void setCellForeground(int row, int column, const QColor& color);
+    void clearCellForegrounds();
+
+private:
+    struct Column {
+        ColumnType type;
+        QString header;
+        QVector<double> numbers;   // Numeric
+        QVector<qint64> times;     // DateTime
+        QVector<int> textIds;      // Text: 字符串池序号
+        quint8 format;             // Numeric: 整列显示格式码，见 columnartablemodel.cpp
+        QString timeFormat;        // DateTime: 定宽格式
+        QColor foreground;
+        QColor background;
+        QVector<quint8> marks;     // 单元格标记色在调色板中的序号，0 为无标记；无标记时为空
+        QVector<quint8> cellFormats; // Numeric: 逐单元格显示格式码；各单元格与整列一致时为空
+
+        Column() : type(Numeric), format(0xFE) {}
+    };
+
+    void insertCells(Column& column, int row, int count);
+    void removeCells(Column& column, int row, int count);
+    void storeText(Column& column, int row, const QString& text);
+    void setCellFormat(Column& column, int row, quint8 format);
+    void convertToText(Column& column);
+    QString formatCell(const Column& column, int row) const;
+    int internString(const QString& text);
+
+    bool bulk() const { return m_bulkDepth > 0; }
+    void emitCellChanged(int row, int column);
+
+private:
+    QVector<Column> m_columns;
+    int m_rowCount;
+    int m_bulkDepth;
+
+    // 文本列共享的字符串池，序号 0 固定为空串
+    QStringList m_strings;
+    QHash<QString, int> m_stringIndex;
+
+    QColor m_defaultForeground;
+    QVector<QColor> m_palette;   // 单元格标记色，序号 0 保留
+};
+
+#endif // COLUMNARTABLEMODEL_H
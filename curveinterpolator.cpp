@@ -0,0 +1,125 @@
+/*
+ * curveinterpolator.cpp
+ * 文件作用：曲线插值工具类实现文件
+ * 功能描述：实现保单调三次插值与双对数空间插值
+ */
+
+#include "curveinterpolator.h"
+
+#include <cmath>
+#include <algorithm>
+
+QVector<double> CurveInterpolator::monotoneTangents(const QVector<double>& x, const QVector<double>& y)
+{
+    int n = x.size();
+    QVector<double> m(n, 0.0);
+    if (n < 2) return m;
+
+    // 各区间割线斜率
+    QVector<double> h(n - 1), d(n - 1);
+    for (int k = 0; k < n - 1; ++k) {
+        h[k] = x[k + 1] - x[k];
+        d[k] = (h[k] > 0) ? (y[k + 1] - y[k]) / h[k] : 0.0;
+    }
+
+    if (n == 2) {
+        m[0] = m[1] = d[0];
+        return m;
+    }
+
+    // 内部节点: Fritsch-Butland 加权调和平均，符号变化处切线置零以保持单调
+    for (int k = 1; k < n - 1; ++k) {
+        if (d[k - 1] * d[k] <= 0.0) {
+            m[k] = 0.0;
+        } else {
+            double w1 = 2.0 * h[k] + h[k - 1];
+            double w2 = h[k] + 2.0 * h[k - 1];
+            m[k] = (w1 + w2) / (w1 / d[k - 1] + w2 / d[k]);
+        }
+    }
+
+    // 端点: 三点单侧公式，并做形状保持修正
+    auto endTangent = [](double h0, double h1, double d0, double d1) -> double {
+        double t = ((2.0 * h0 + h1) * d0 - h0 * d1) / (h0 + h1);
+        if (t * d0 <= 0.0) return 0.0;
+        if (d0 * d1 <= 0.0 && std::abs(t) > std::abs(3.0 * d0)) return 3.0 * d0;
+        return t;
+    };
+    m[0] = endTangent(h[0], h[1], d[0], d[1]);
+    m[n - 1] = endTangent(h[n - 2], h[n - 3], d[n - 2], d[n - 3]);
+
+    return m;
+}
+
+QVector<double> CurveInterpolator::monotoneCubic(const QVector<double>& x, const QVector<double>& y,
+                                                 const QVector<double>& xq, QVector<double>* dydx)
+{
+    int n = qMin(x.size(), y.size());
+    int nq = xq.size();
+    QVector<double> out(nq, 0.0);
+    if (dydx) dydx->fill(0.0, nq);
+    if (n == 0 || nq == 0) return out;
+    if (n == 1) { out.fill(y[0]); return out; }
+
+    QVector<double> m = monotoneTangents(x, y);
+
+    for (int q = 0; q < nq; ++q) {
+        double xv = xq[q];
+
+        // 超出范围: 端点切线线性外推
+        if (xv <= x[0]) {
+            out[q] = y[0] + m[0] * (xv - x[0]);
+            if (dydx) (*dydx)[q] = m[0];
+            continue;
+        }
+        if (xv >= x[n - 1]) {
+            out[q] = y[n - 1] + m[n - 1] * (xv - x[n - 1]);
+            if (dydx) (*dydx)[q] = m[n - 1];
+            continue;
+        }
+
+        // 二分查找所在区间 [k, k+1]
+        int k = int(std::upper_bound(x.constBegin(), x.constBegin() + n, xv) - x.constBegin()) - 1;
+        k = qBound(0, k, n - 2);
+
+        double h = x[k + 1] - x[k];
+        double s = (xv - x[k]) / h;
+        double s2 = s * s, s3 = s2 * s;
+
+        // 三次 Hermite 基函数
+        double h00 = 2 * s3 - 3 * s2 + 1;
+        double h10 = s3 - 2 * s2 + s;
+        double h01 = -2 * s3 + 3 * s2;
+        double h11 = s3 - s2;
+        out[q] = h00 * y[k] + h10 * h * m[k] + h01 * y[k + 1] + h11 * h * m[k + 1];
+
+        if (dydx) {
+            double d00 = (6 * s2 - 6 * s) / h;
+            double d10 = 3 * s2 - 4 * s + 1;
+            double d01 = (-6 * s2 + 6 * s) / h;
+            double d11 = 3 * s2 - 2 * s;
+            (*dydx)[q] = d00 * y[k] + d10 * m[k] + d01 * y[k + 1] + d11 * m[k + 1];
+        }
+    }
+    return out;
+}
+
+QVector<double> CurveInterpolator::logLogInterpolate(const QVector<double>& x, const QVector<double>& y,
+                                                     const QVector<double>& xq, QVector<double>* logSlope)
+{
+    int n = qMin(x.size(), y.size());
+    QVector<double> lx(n), ly(n);
+    for (int i = 0; i < n; ++i) {
+        lx[i] = std::log10(x[i]);
+        ly[i] = std::log10(qMax(y[i], 1e-300));
+    }
+
+    QVector<double> lxq(xq.size());
+    for (int i = 0; i < xq.size(); ++i) lxq[i] = std::log10(qMax(xq[i], 1e-300));
+
+    // 在对数空间插值后还原；log10 对 log10 的斜率即 d(ln y)/d(ln x)
+    QVector<double> lyq = monotoneCubic(lx, ly, lxq, logSlope);
+    QVector<double> out(lyq.size());
+    for (int i = 0; i < lyq.size(); ++i) out[i] = std::pow(10.0, lyq[i]);
+    return out;
+}
@@ -0,0 +1,45 @@
+/*
+ * curveinterpolator.h
+ * 文件作用：曲线插值工具类头文件
+ * 功能描述：
+ * 1. 提供保单调三次 Hermite 插值 (Fritsch-Butland 切线)
+ * 2. 提供双对数空间插值，用于把粗网格上的理论曲线映射到实测时间点
+ * 3. 全部为静态无状态接口，可在工作线程中并发调用
+ */
+
+#ifndef CURVEINTERPOLATOR_H
+#define CURVEINTERPOLATOR_H
+
+#include <QVector>
+
+class CurveInterpolator
+{
+public:
+    /**
+     * @brief 保单调三次插值
+     * @param x 节点横坐标 (严格递增)
+     * @param y 节点纵坐标
+     * @param xq 查询点
+     * @param dydx 可选输出：查询点处的一阶导数 dy/dx
+     * @return 查询点处的插值结果，超出节点范围时按端点切线线性外推
+     */
+    static QVector<double> monotoneCubic(const QVector<double>& x, const QVector<double>& y,
+                                         const QVector<double>& xq, QVector<double>* dydx = nullptr);
+
+    /**
+     * @brief 双对数空间插值: 在 (log10 x, log10 y) 上做保单调三次插值
+     * @param x 节点横坐标 (正值且严格递增)
+     * @param y 节点纵坐标 (非正值会被截断为极小正数)
+     * @param xq 查询点 (正值)
+     * @param logSlope 可选输出：查询点处的双对数斜率 d(ln y)/d(ln x)
+     * @return 查询点处的插值结果
+     */
+    static QVector<double> logLogInterpolate(const QVector<double>& x, const QVector<double>& y,
+                                             const QVector<double>& xq, QVector<double>* logSlope = nullptr);
+
+private:
+    // 计算各节点处保单调的切线斜率
+    static QVector<double> monotoneTangents(const QVector<double>& x, const QVector<double>& y);
+};
+
+#endif // CURVEINTERPOLATOR_H
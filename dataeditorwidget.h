@@ -4,7 +4,6 @@
 #include <QWidget>
 #include <QString>
 #include <QTableView>
-#include <QStandardItemModel>
 #include <QFile>
 #include <QInputDialog>
 #include <QMessageBox>
@@ -63,6 +62,9 @@
 
 // 新增：压力导数计算器头文件
 #include "pressurederivativecalculator.h"
+#include "flowperioddetector.h"
+#include "logtimedecimator.h"
+#include "columnartablemodel.h"
 
 namespace Ui {
 class DataEditorWidget;
@@ -176,18 +178,18 @@ struct PressureDropResult {
 class DataEditCommand : public QUndoCommand
 {
 public:
-    DataEditCommand(QStandardItemModel* model, QUndoCommand* parent = nullptr);
+    DataEditCommand(ColumnarTableModel* model, QUndoCommand* parent = nullptr);
     virtual ~DataEditCommand() = default;
 
 protected:
-    QStandardItemModel* m_model;
+    ColumnarTableModel* m_model;
 };
 
 // 单元格编辑命令
 class CellEditCommand : public DataEditCommand
 {
 public:
-    CellEditCommand(QStandardItemModel* model, int row, int column,
+    CellEditCommand(ColumnarTableModel* model, int row, int column,
                     const QString& oldValue, const QString& newValue,
                     QUndoCommand* parent = nullptr);
     void undo() override;
@@ -206,7 +208,7 @@ class RowEditCommand : public DataEditCommand
 public:
     enum Operation { Insert, Delete };
 
-    RowEditCommand(QStandardItemModel* model, Operation op, int row,
+    RowEditCommand(ColumnarTableModel* model, Operation op, int row,
                    const QStringList& rowData = QStringList(),
                    QUndoCommand* parent = nullptr);
     void undo() override;
@@ -224,7 +226,7 @@ class ColumnEditCommand : public DataEditCommand
 public:
     enum Operation { Insert, Delete };
 
-    ColumnEditCommand(QStandardItemModel* model, Operation op, int column,
+    ColumnEditCommand(ColumnarTableModel* model, Operation op, int column,
                       const QString& headerName = QString(),
                       const QStringList& columnData = QStringList(),
                       QUndoCommand* parent = nullptr);
@@ -424,11 +426,14 @@ public:
     void loadDataWithConfig(const QString& filePath, const QString& fileType, const DataLoadConfigDialog::LoadConfig& config);
 
     // 获取数据模型和文件信息的方法
-    QStandardItemModel* getDataModel() const { return m_dataModel; }
+    ColumnarTableModel* getDataModel() const { return m_dataModel; }
     QString getCurrentFileName() const { return m_currentFilePath; }
     QString getCurrentFileType() const { return m_currentFileType; }
     bool hasData() const { return m_dataModel && m_dataModel->rowCount() > 0 && m_dataModel->columnCount() > 0; }
 
+    // 对数时间抽稀配置 (导数绘图与拟合观测数据共用)
+    DecimationConfig decimationConfig() const { return m_decimationConfig; }
+
     // 数据处理功能
     DataStatistics calculateColumnStatistics(int column) const;
     QList<DataStatistics> calculateAllStatistics() const;
@@ -477,6 +482,12 @@ signals:
     // 新增：压力导数计算完成信号
     void pressureDerivativeCalculated(const PressureDerivativeResult& result);
 
+    // 流动段划分或反褶积完成，各数据集待建立拟合分析
+    void flowPeriodDatasetsReady(const QList<FlowPeriodDataset>& datasets);
+
+    // 抽稀配置已修改
+    void decimationChanged();
+
 private slots:
     // 文件操作槽函数
     void onOpenFile();
@@ -493,12 +504,26 @@ private slots:
     // 新增：压力导数计算槽函数
     void onPressureDerivativeCalc();
 
+    // 流动段自动划分
+    void onFlowPeriodDetect();
+
+    // 压力-产量反褶积
+    void onDeconvolution();
+
+    // 对数时间抽稀设置
+    void onDecimationSettings();
+
+    // 滑动 Hampel 异常值检测
+    void onOutlierDetect();
+
+    // 周期性噪声频域滤波
+    void onSpectralFilter();
+
     // 搜索槽函数
     void onSearchTextChanged();
     void onSearchData();
 
     // 模型数据变化槽函数
-    void onCellDataChanged(QStandardItem* item);
     void onModelDataChanged(const QModelIndex& topLeft, const QModelIndex& bottomRight);
 
     // 右键菜单槽函数
@@ -514,7 +539,7 @@ private:
     Ui::DataEditorWidget *ui;
 
     // 数据模型和代理
-    QStandardItemModel* m_dataModel;
+    ColumnarTableModel* m_dataModel;
     QSortFilterProxyModel* m_proxyModel;
 
     // 撤销重做栈
@@ -524,6 +549,9 @@ private:
     QString m_currentFilePath;
     QString m_currentFileType;
 
+    // 对数时间抽稀配置
+    DecimationConfig m_decimationConfig;
+
     // 数据状态
     bool m_dataModified;
     QString m_currentSearchText;
@@ -596,12 +624,13 @@ private:
     void removeEmptyColumns();
     void removeDuplicates();
     void fillMissingValues(const QString& method = "interpolation");
-    void removeOutliers(double threshold = 2.0);
+    void removeOutliers(double threshold = 3.0);
     void standardizeDataFormat();
 
     // 压降计算相关方法 - 优化的压降计算
     int findPressureColumn() const;
     int findTimeColumn() const;
+    int findRateColumn() const;
     QString getPressureUnit() const;
     bool isValidPressureData(const QString& data) const;
 
@@ -0,0 +1,122 @@
+/*
+ * decimationdialog.cpp
+ * 文件作用：对数时间抽稀设置对话框实现文件
+ * 功能描述：
+ * 1. 方法切换时只启用该方法用到的参数
+ * 2. 预览逐行读取数据模型直接送入抽稀器，不保留原始数组
+ */
+
+#include "decimationdialog.h"
+
+#include <QVBoxLayout>
+#include <QHBoxLayout>
+#include <QGridLayout>
+#include <QGroupBox>
+#include <QPushButton>
+#include <QElapsedTimer>
+#include <cmath>
+
+DecimationDialog::DecimationDialog(const DecimationConfig& config, ColumnarTableModel* model, int timeCol, int pressureCol, QWidget* parent)
+    : QDialog(parent), m_model(model), m_timeCol(timeCol >= 0 ? timeCol : 0), m_pressureCol(pressureCol >= 0 ? pressureCol : 1)
+{
+    setWindowTitle("对数时间抽稀设置"); resize(460, 300);
+
+    this->setStyleSheet(
+        "QDialog { background-color: #ffffff; color: #000000; font-family: 'Microsoft YaHei'; }"
+        "QLabel, QGroupBox, QComboBox, QCheckBox, QSpinBox, QDoubleSpinBox { color: #000000; }"
+        "QPushButton { background-color: #ffffff; border: 1px solid #c0c0c0; border-radius: 4px; padding: 5px 15px; color: #333333; }"
+        "QPushButton:hover { background-color: #f2f2f2; border-color: #a0a0a0; color: #000000; }"
+        "QPushButton:pressed { background-color: #e0e0e0; }"
+        );
+
+    QVBoxLayout* layout = new QVBoxLayout(this);
+
+    QGroupBox* group = new QGroupBox("抽稀参数 (用于导数绘图与拟合观测数据)", this);
+    QGridLayout* grid = new QGridLayout(group);
+    m_checkEnabled = new QCheckBox("启用抽稀", group);
+    m_checkEnabled->setChecked(config.enabled);
+    m_spinMinimumRows = new QSpinBox(group);
+    m_spinMinimumRows->setRange(0, 100000000); m_spinMinimumRows->setSingleStep(1000);
+    m_spinMinimumRows->setValue(config.minimumRows);
+    m_spinMinimumRows->setToolTip("原始数据超过此行数时才抽稀");
+    m_comboMethod = new QComboBox(group);
+    m_comboMethod->addItems(DecimationConfig::methodNames());
+    m_comboMethod->setCurrentIndex(config.method);
+    m_spinPointsPerCycle = new QSpinBox(group);
+    m_spinPointsPerCycle->setRange(2, 1000); m_spinPointsPerCycle->setValue(config.pointsPerCycle);
+    m_spinPointsPerCycle->setToolTip("分箱: 每个对数周期的箱数；其他方法: 每个对数周期至少保留的点数");
+    m_spinTolerance = new QDoubleSpinBox(group);
+    m_spinTolerance->setDecimals(4); m_spinTolerance->setRange(0.0001, 1.0); m_spinTolerance->setSingleStep(0.001);
+    m_spinTolerance->setValue(config.tolerance);
+    m_spinTolerance->setToolTip("双对数坐标下点到弦的最大距离 (lg 单位)");
+    m_spinDerivativeTolerance = new QDoubleSpinBox(group);
+    m_spinDerivativeTolerance->setRange(0.1, 100.0); m_spinDerivativeTolerance->setSuffix(" %");
+    m_spinDerivativeTolerance->setValue(config.derivativeTolerance * 100.0);
+    m_spinDerivativeTolerance->setToolTip("局部导数相对上一保留点变化超过此比例时保留");
+
+    grid->addWidget(m_checkEnabled, 0, 0, 1, 2);
+    grid->addWidget(new QLabel("触发行数:", group), 1, 0); grid->addWidget(m_spinMinimumRows, 1, 1);
+    grid->addWidget(new QLabel("抽稀方法:", group), 2, 0); grid->addWidget(m_comboMethod, 2, 1);
+    grid->addWidget(new QLabel("每周期点数:", group), 3, 0); grid->addWidget(m_spinPointsPerCycle, 3, 1);
+    grid->addWidget(new QLabel("DP 距离容差:", group), 4, 0); grid->addWidget(m_spinTolerance, 4, 1);
+    grid->addWidget(new QLabel("导数变化阈值:", group), 5, 0); grid->addWidget(m_spinDerivativeTolerance, 5, 1);
+    layout->addWidget(group);
+
+    QHBoxLayout* preview = new QHBoxLayout;
+    QPushButton* btnPreview = new QPushButton("预览", this);
+    m_lblPreview = new QLabel(this);
+    preview->addWidget(btnPreview); preview->addWidget(m_lblPreview, 1);
+    layout->addLayout(preview);
+    layout->addStretch();
+
+    QHBoxLayout* btns = new QHBoxLayout;
+    QPushButton* ok = new QPushButton("确定", this);
+    QPushButton* cancel = new QPushButton("取消", this);
+    btns->addStretch(); btns->addWidget(ok); btns->addWidget(cancel);
+    layout->addLayout(btns);
+
+    connect(m_comboMethod, QOverload<int>::of(&QComboBox::currentIndexChanged), this, &DecimationDialog::onMethodChanged);
+    connect(btnPreview, &QPushButton::clicked, this, &DecimationDialog::onPreview);
+    connect(ok, &QPushButton::clicked, this, &QDialog::accept);
+    connect(cancel, &QPushButton::clicked, this, &QDialog::reject);
+    onMethodChanged(m_comboMethod->currentIndex());
+}
+
+DecimationConfig DecimationDialog::config() const
+{
+    DecimationConfig config;
+    config.enabled = m_checkEnabled->isChecked();
+    config.minimumRows = m_spinMinimumRows->value();
+    config.method = (DecimationConfig::Method)m_comboMethod->currentIndex();
+    config.pointsPerCycle = m_spinPointsPerCycle->value();
+    config.tolerance = m_spinTolerance->value();
+    config.derivativeTolerance = m_spinDerivativeTolerance->value() / 100.0;
+    return config;
+}
+
+void DecimationDialog::onMethodChanged(int index)
+{
+    m_spinTolerance->setEnabled(index == DecimationConfig::DouglasPeucker);
+    m_spinDerivativeTolerance->setEnabled(index == DecimationConfig::DerivativePreserving);
+}
+
+void DecimationDialog::onPreview()
+{
+    if(!m_model || m_model->rowCount() == 0 || m_model->columnCount() <= qMax(m_timeCol, m_pressureCol)) {
+        m_lblPreview->setText("没有可预览的数据");
+        return;
+    }
+    QElapsedTimer timer;
+    timer.start();
+    LogTimeDecimator decimator(config());
+    double pInitial = 0.0;
+    bool hasInitial = false;
+    for(int r = 0; r < m_model->rowCount(); ++r) {
+        double p = m_model->value(r, m_pressureCol);
+        if(!hasInitial && std::abs(p) > 1e-6) { pInitial = p; hasInitial = true; }
+        decimator.append(m_model->value(r, m_timeCol), std::abs(p - pInitial));
+    }
+    decimator.finish();
+    m_lblPreview->setText(QString("%1 点 → %2 点 (%3 ms)")
+                              .arg(decimator.inputCount()).arg(decimator.time().size()).arg(timer.elapsed()));
+}
@@ -0,0 +1,49 @@
+/*
+ * decimationdialog.h
+ * 文件作用：对数时间抽稀设置对话框头文件
+ * 功能描述：
+ * 1. 设置是否抽稀、触发行数、抽稀方法与各方法参数
+ * 2. 预览: 用当前数据的时间列和压差 (相对首个非零压力) 试算抽稀后的点数
+ */
+
+#ifndef DECIMATIONDIALOG_H
+#define DECIMATIONDIALOG_H
+
+#include <QDialog>
+#include <QCheckBox>
+#include <QComboBox>
+#include <QSpinBox>
+#include <QDoubleSpinBox>
+#include <QLabel>
+#include "columnartablemodel.h"
+#include "logtimedecimator.h"
+
+class DecimationDialog : public QDialog
+{
+    Q_OBJECT
+
+public:
+    // timeCol/pressureCol 为预览使用的列，-1 时取第 1、2 列
+    DecimationDialog(const DecimationConfig& config, ColumnarTableModel* model, int timeCol, int pressureCol, QWidget* parent = nullptr);
+
+    DecimationConfig config() const;
+
+private slots:
+    void onMethodChanged(int index);
+    void onPreview();
+
+private:
+    ColumnarTableModel* m_model;
+    int m_timeCol;
+    int m_pressureCol;
+
+    QCheckBox* m_checkEnabled;
+    QSpinBox* m_spinMinimumRows;
+    QComboBox* m_comboMethod;
+    QSpinBox* m_spinPointsPerCycle;
+    QDoubleSpinBox* m_spinTolerance;
+    QDoubleSpinBox* m_spinDerivativeTolerance;
+    QLabel* m_lblPreview;
+};
+
+#endif // DECIMATIONDIALOG_H
@@ -0,0 +1,284 @@
+/*
+ * deconvolutiondialog.cpp
+ * 文件作用：压力-产量反褶积对话框实现文件
+ * 功能描述：
+ * 1. 数据模型只在界面线程读取为数组，产量整理与反褶积都在工作线程中进行
+ * 2. 产量整理: 流动段检测后每段取平均产量 (关井段为 0)，避免噪声产量产生大量产量变化
+ * 3. 关闭对话框时请求引擎停止并等待工作线程结束
+ */
+
+#include "deconvolutiondialog.h"
+
+#include <QVBoxLayout>
+#include <QHBoxLayout>
+#include <QGridLayout>
+#include <QGroupBox>
+#include <QSplitter>
+#include <QMessageBox>
+#include <QtConcurrent>
+#include <algorithm>
+
+namespace {
+// 按时间排序后的产量史: 整理模式按流动段取段平均产量，否则直接使用产量列的阶梯变化
+RateHistory buildRateHistory(const QVector<double>& t, const QVector<double>& p, const QVector<double>& q, bool clean)
+{
+    if(clean) {
+        const QVector<FlowPeriod> periods = FlowPeriodDetector::detect(t, p, q, FlowPeriodConfig());
+        QVector<double> starts, rates;
+        for(const FlowPeriod& period : periods) {
+            starts.append(period.startTime);
+            rates.append(period.kind == FlowPeriod::ShutIn ? 0.0 : period.rate);
+        }
+        return RateHistory::fromSamples(starts, rates);
+    }
+    QVector<int> order(t.size());
+    for(int i = 0; i < order.size(); ++i) order[i] = i;
+    std::stable_sort(order.begin(), order.end(), [&t](int a, int b) { return t[a] < t[b]; });
+    QVector<double> st(order.size()), sq(order.size());
+    for(int i = 0; i < order.size(); ++i) { st[i] = t[order[i]]; sq[i] = q[order[i]]; }
+    return RateHistory::fromSamples(st, sq);
+}
+
+void setLogAxis(QCPAxis* axis)
+{
+    axis->setScaleType(QCPAxis::stLogarithmic);
+    QSharedPointer<QCPAxisTickerLog> logTicker(new QCPAxisTickerLog);
+    axis->setTicker(logTicker);
+    axis->setNumberFormat("eb");
+    axis->setNumberPrecision(0);
+}
+}
+
+DeconvolutionDialog::DeconvolutionDialog(ColumnarTableModel* model, int timeCol, int pressureCol, int rateCol, QWidget* parent)
+    : QDialog(parent), m_model(model)
+{
+    setWindowTitle("压力-产量反褶积"); resize(1100, 720);
+
+    this->setStyleSheet(
+        "QDialog { background-color: #ffffff; color: #000000; font-family: 'Microsoft YaHei'; }"
+        "QLabel, QGroupBox, QComboBox, QCheckBox, QSpinBox, QDoubleSpinBox { color: #000000; }"
+        "QPushButton { background-color: #ffffff; border: 1px solid #c0c0c0; border-radius: 4px; padding: 5px 15px; color: #333333; }"
+        "QPushButton:hover { background-color: #f2f2f2; border-color: #a0a0a0; color: #000000; }"
+        "QPushButton:pressed { background-color: #e0e0e0; }"
+        "QPushButton:disabled { color: #a0a0a0; }"
+        );
+
+    QVBoxLayout* layout = new QVBoxLayout(this);
+
+    // 数据列与反褶积参数
+    QGroupBox* group = new QGroupBox("数据与参数", this);
+    QGridLayout* grid = new QGridLayout(group);
+    QStringList headers;
+    for(int i = 0; i < m_model->columnCount(); ++i) {
+        const QString header = m_model->headerText(i);
+        headers << (header.isEmpty() ? QString("列 %1").arg(i + 1) : header);
+    }
+    m_comboTime = new QComboBox(group); m_comboTime->addItems(headers);
+    m_comboPressure = new QComboBox(group); m_comboPressure->addItems(headers);
+    m_comboRate = new QComboBox(group); m_comboRate->addItems(headers);
+    if(timeCol >= 0) m_comboTime->setCurrentIndex(timeCol);
+    if(pressureCol >= 0) m_comboPressure->setCurrentIndex(pressureCol);
+    // 未识别产量列时默认取时间、压力以外的第一列
+    for(int i = 0; rateCol < 0 && i < headers.size(); ++i) if(i != timeCol && i != pressureCol) rateCol = i;
+    if(rateCol >= 0) m_comboRate->setCurrentIndex(rateCol);
+    m_checkCleanRates = new QCheckBox("按流动段整理产量", group);
+    m_checkCleanRates->setChecked(true);
+    m_checkCleanRates->setToolTip("先自动划分流动段，每段取平均产量 (关井为 0)；产量列已是阶梯数据时可取消");
+
+    DeconvolutionConfig defaults;
+    m_spinNodes = new QSpinBox(group);
+    m_spinNodes->setRange(2, 40); m_spinNodes->setValue(defaults.nodesPerCycle);
+    m_spinNodes->setToolTip("单位响应每个对数周期的节点数");
+    m_spinRegularization = new QDoubleSpinBox(group);
+    m_spinRegularization->setDecimals(4); m_spinRegularization->setRange(0.0001, 10000.0);
+    m_spinRegularization->setValue(defaults.regularization);
+    m_spinRegularization->setToolTip("曲率正则权重 (相对压力噪声能量)，越大导数越平滑");
+    m_spinObservations = new QSpinBox(group);
+    m_spinObservations->setRange(5, 1000); m_spinObservations->setValue(defaults.observationsPerCycle);
+    m_spinObservations->setToolTip("观测压缩: 每个流动段每个对数周期保留的平均点数");
+    m_spinIterations = new QSpinBox(group);
+    m_spinIterations->setRange(1, 500); m_spinIterations->setValue(defaults.maxIterations);
+    m_spinReferenceRate = new QDoubleSpinBox(group);
+    m_spinReferenceRate->setRange(0.0, 1e9); m_spinReferenceRate->setDecimals(3); m_spinReferenceRate->setValue(0.0);
+    m_spinReferenceRate->setSpecialValueText("最大产量");
+
+    grid->addWidget(new QLabel("时间列:", group), 0, 0); grid->addWidget(m_comboTime, 0, 1);
+    grid->addWidget(new QLabel("压力列:", group), 0, 2); grid->addWidget(m_comboPressure, 0, 3);
+    grid->addWidget(new QLabel("产量列:", group), 0, 4); grid->addWidget(m_comboRate, 0, 5);
+    grid->addWidget(m_checkCleanRates, 0, 6);
+    grid->addWidget(new QLabel("每周期节点数:", group), 1, 0); grid->addWidget(m_spinNodes, 1, 1);
+    grid->addWidget(new QLabel("正则权重:", group), 1, 2); grid->addWidget(m_spinRegularization, 1, 3);
+    grid->addWidget(new QLabel("每周期观测数:", group), 1, 4); grid->addWidget(m_spinObservations, 1, 5);
+    grid->addWidget(new QLabel("最大迭代次数:", group), 2, 0); grid->addWidget(m_spinIterations, 2, 1);
+    grid->addWidget(new QLabel("参考产量:", group), 2, 2); grid->addWidget(m_spinReferenceRate, 2, 3);
+    layout->addWidget(group);
+
+    QHBoxLayout* ctrl = new QHBoxLayout;
+    m_btnRun = new QPushButton("开始反褶积", this);
+    m_btnStop = new QPushButton("停止", this); m_btnStop->setEnabled(false);
+    m_progress = new QProgressBar(this); m_progress->setRange(0, 100); m_progress->setValue(0);
+    ctrl->addWidget(m_btnRun); ctrl->addWidget(m_btnStop); ctrl->addWidget(m_progress, 1);
+    layout->addLayout(ctrl);
+
+    QSplitter* split = new QSplitter(Qt::Horizontal, this);
+    m_plotResponse = new QCustomPlot(split);
+    m_plotResponse->setInteractions(QCP::iRangeDrag | QCP::iRangeZoom);
+    m_plotResponse->setMinimumWidth(360);
+    m_plotMatch = new QCustomPlot(split);
+    m_plotMatch->setInteractions(QCP::iRangeDrag | QCP::iRangeZoom);
+    m_plotMatch->setMinimumWidth(360);
+    split->addWidget(m_plotResponse);
+    split->addWidget(m_plotMatch);
+    layout->addWidget(split, 1);
+
+    QHBoxLayout* btns = new QHBoxLayout;
+    m_lblStatus = new QLabel(this);
+    m_btnCreate = new QPushButton("创建拟合分析", this); m_btnCreate->setEnabled(false);
+    QPushButton* close = new QPushButton("关闭", this);
+    btns->addWidget(m_lblStatus, 1); btns->addWidget(m_btnCreate); btns->addWidget(close);
+    layout->addLayout(btns);
+
+    connect(m_btnRun, &QPushButton::clicked, this, &DeconvolutionDialog::onRun);
+    connect(m_btnStop, &QPushButton::clicked, this, &DeconvolutionDialog::onStop);
+    connect(m_btnCreate, &QPushButton::clicked, this, &DeconvolutionDialog::onAccept);
+    connect(close, &QPushButton::clicked, this, &QDialog::reject);
+    connect(&m_watcher, &QFutureWatcher<void>::finished, this, &DeconvolutionDialog::onFinished);
+}
+
+DeconvolutionDialog::~DeconvolutionDialog()
+{
+    if(m_engine) m_engine->requestStop();
+    m_watcher.waitForFinished();
+}
+
+FlowPeriodDataset DeconvolutionDialog::dataset() const { return m_dataset; }
+
+bool DeconvolutionDialog::readColumns()
+{
+    // 只保留时间、压力、产量均为数值的行
+    const int tc = m_comboTime->currentIndex();
+    const int pc = m_comboPressure->currentIndex();
+    const int qc = m_comboRate->currentIndex();
+    m_t.clear(); m_p.clear(); m_q.clear();
+    for(int r = 0; r < m_model->rowCount(); ++r) {
+        bool okT = false, okP = false, okQ = false;
+        double t = m_model->value(r, tc, &okT);
+        double p = m_model->value(r, pc, &okP);
+        double q = m_model->value(r, qc, &okQ);
+        if(!okT || !okP || !okQ) continue;
+        m_t.append(t); m_p.append(p); m_q.append(q);
+    }
+    return m_t.size() >= 10;
+}
+
+void DeconvolutionDialog::onRun()
+{
+    if(m_watcher.isRunning()) return;
+    if(!readColumns()) {
+        QMessageBox::warning(this, "提示", "有效数据点不足，无法反褶积。");
+        return;
+    }
+
+    DeconvolutionConfig config;
+    config.nodesPerCycle = m_spinNodes->value();
+    config.regularization = m_spinRegularization->value();
+    config.observationsPerCycle = m_spinObservations->value();
+    config.maxIterations = m_spinIterations->value();
+    config.referenceRate = m_spinReferenceRate->value();
+
+    m_result = DeconvolutionResult();
+    m_engine.reset(new DeconvolutionEngine, &QObject::deleteLater);
+    m_engine->setConfig(config);
+    connect(m_engine.data(), &DeconvolutionEngine::sigProgress, m_progress, &QProgressBar::setValue, Qt::QueuedConnection);
+    connect(m_engine.data(), &DeconvolutionEngine::sigIterationUpdated, this, [this](double rms) {
+        m_lblStatus->setText(QString("正在反褶积... 压力均方根误差 %1").arg(rms, 0, 'g', 4));
+    }, Qt::QueuedConnection);
+
+    m_btnRun->setEnabled(false); m_btnStop->setEnabled(true); m_btnCreate->setEnabled(false);
+    m_progress->setValue(0);
+    m_lblStatus->setText(QString("正在整理产量 (%1 个数据点)...").arg(m_t.size()));
+    QSharedPointer<DeconvolutionEngine> engine = m_engine;
+    QVector<double> t = m_t, p = m_p, q = m_q;
+    const bool clean = m_checkCleanRates->isChecked();
+    m_watcher.setFuture(QtConcurrent::run([engine, t, p, q, clean]() {
+        engine->setData(t, p, buildRateHistory(t, p, q, clean));
+        engine->run();
+    }));
+}
+
+void DeconvolutionDialog::onStop()
+{
+    if(m_engine) m_engine->requestStop();
+}
+
+void DeconvolutionDialog::onFinished()
+{
+    m_btnRun->setEnabled(true); m_btnStop->setEnabled(false);
+    if(!m_engine) return;
+    m_result = m_engine->result();
+    if(!m_result.completed) {
+        m_lblStatus->setText("反褶积未完成 (已停止，或产量史与压力记录不足以确定单位响应)");
+        return;
+    }
+    plotResult();
+    m_lblStatus->setText(QString("观测点 %1 个 (压缩后)，迭代 %2 次，初始压力 %3，压力均方根误差 %4")
+                             .arg(m_result.observationCount).arg(m_result.iterations)
+                             .arg(m_result.initialPressure, 0, 'g', 6).arg(m_result.rms, 0, 'g', 4));
+    m_btnCreate->setEnabled(true);
+}
+
+void DeconvolutionDialog::plotResult()
+{
+    // 单位响应: 双对数压降与导数
+    m_plotResponse->clearGraphs();
+    setLogAxis(m_plotResponse->xAxis);
+    setLogAxis(m_plotResponse->yAxis);
+    m_plotResponse->xAxis->setLabel("时间");
+    m_plotResponse->yAxis->setLabel(QString("压降 / 导数 (q = %1)").arg(m_result.referenceRate, 0, 'g', 5));
+    QCPGraph* gp = m_plotResponse->addGraph();
+    gp->setData(m_result.tau, m_result.pressure);
+    gp->setPen(QPen(Qt::red, 2));
+    gp->setName("压降");
+    QCPGraph* gd = m_plotResponse->addGraph();
+    gd->setData(m_result.tau, m_result.derivative);
+    gd->setPen(QPen(Qt::blue, 2));
+    gd->setName("导数");
+    m_plotResponse->legend->setVisible(true);
+    m_plotResponse->rescaleAxes();
+    m_plotResponse->replot();
+
+    // 压力历史: 压缩后的实测点与反褶积模型重构压力
+    m_plotMatch->clearGraphs();
+    m_plotMatch->xAxis->setLabel("时间");
+    m_plotMatch->yAxis->setLabel("压力");
+    QCPGraph* go = m_plotMatch->addGraph();
+    go->setData(m_result.obsTime, m_result.obsPressure);
+    go->setLineStyle(QCPGraph::lsNone);
+    go->setScatterStyle(QCPScatterStyle(QCPScatterStyle::ssCircle, Qt::red, 4));
+    go->setName("实测");
+    QCPGraph* gf = m_plotMatch->addGraph();
+    gf->setData(m_result.obsTime, m_result.fittedPressure);
+    gf->setPen(QPen(Qt::black, 1));
+    gf->setName("重构");
+    m_plotMatch->legend->setVisible(true);
+    m_plotMatch->rescaleAxes();
+    m_plotMatch->replot();
+}
+
+void DeconvolutionDialog::onAccept()
+{
+    if(!m_result.completed) return;
+    m_dataset = FlowPeriodDataset();
+    m_dataset.name = QString("反褶积响应 (q=%1)").arg(m_result.referenceRate, 0, 'g', 5);
+    for(int i = 0; i < m_result.tau.size(); ++i) {
+        if(!(m_result.pressure[i] > 0) || !(m_result.derivative[i] > 0)) continue;
+        m_dataset.t.append(m_result.tau[i]);
+        m_dataset.p.append(m_result.pressure[i]);
+        m_dataset.d.append(m_result.derivative[i]);
+    }
+    if(m_dataset.t.size() < 3) {
+        QMessageBox::warning(this, "提示", "反褶积响应有效点不足。");
+        return;
+    }
+    accept();
+}
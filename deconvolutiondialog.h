@@ -0,0 +1,79 @@
+/*
+ * deconvolutiondialog.h
+ * 文件作用：压力-产量反褶积对话框头文件
+ * 功能描述：
+ * 1. 选择时间、压力、产量列与反褶积参数 (节点密度、正则权重、观测压缩密度、参考产量)
+ * 2. 产量可先经流动段检测整理为分段常产量，也可直接按产量列的阶梯变化使用
+ * 3. 后台运行 DeconvolutionEngine，双对数图显示单位响应压降与导数，另一图对比实测与重构压力
+ * 4. 结果作为拟合数据集返回，由调用方新建拟合分析页
+ */
+
+#ifndef DECONVOLUTIONDIALOG_H
+#define DECONVOLUTIONDIALOG_H
+
+#include <QDialog>
+#include <QComboBox>
+#include <QCheckBox>
+#include <QSpinBox>
+#include <QDoubleSpinBox>
+#include <QPushButton>
+#include <QProgressBar>
+#include <QLabel>
+#include <QFutureWatcher>
+#include <QSharedPointer>
+#include "columnartablemodel.h"
+#include "qcustomplot.h"
+#include "deconvolutionengine.h"
+#include "flowperioddetector.h"
+
+class DeconvolutionDialog : public QDialog
+{
+    Q_OBJECT
+
+public:
+    // timeCol/pressureCol/rateCol 为自动识别的默认列，-1 表示未识别
+    DeconvolutionDialog(ColumnarTableModel* model, int timeCol, int pressureCol, int rateCol, QWidget* parent = nullptr);
+    ~DeconvolutionDialog();
+
+    // 反褶积响应数据集 (接受对话框后有效)
+    FlowPeriodDataset dataset() const;
+
+private slots:
+    void onRun();
+    void onStop();
+    void onFinished();
+    void onAccept();
+
+private:
+    bool readColumns();
+    void plotResult();
+
+private:
+    ColumnarTableModel* m_model;
+
+    QComboBox* m_comboTime;
+    QComboBox* m_comboPressure;
+    QComboBox* m_comboRate;
+    QCheckBox* m_checkCleanRates;
+    QSpinBox* m_spinNodes;
+    QDoubleSpinBox* m_spinRegularization;
+    QSpinBox* m_spinObservations;
+    QSpinBox* m_spinIterations;
+    QDoubleSpinBox* m_spinReferenceRate;
+    QPushButton* m_btnRun;
+    QPushButton* m_btnStop;
+    QPushButton* m_btnCreate;
+    QProgressBar* m_progress;
+    QLabel* m_lblStatus;
+    QCustomPlot* m_plotResponse;
+    QCustomPlot* m_plotMatch;
+
+    QVector<double> m_t, m_p, m_q;
+    DeconvolutionResult m_result;
+    FlowPeriodDataset m_dataset;
+
+    QSharedPointer<DeconvolutionEngine> m_engine;
+    QFutureWatcher<void> m_watcher;
+};
+
+#endif // DECONVOLUTIONDIALOG_H
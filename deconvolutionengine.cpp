@@ -0,0 +1,421 @@
+/*
+ * deconvolutionengine.cpp
+ * 文件作用：压力-产量反褶积引擎实现文件
+ * 功能描述：
+ * 1. 单位响应 Pu(σ) = ∫ exp(z) dσ，σ = ln τ；首节点之前按单位斜率 (井筒储集) 外推，
+ *    末节点之后按 z 不变外推；节点间 z 线性，段积分与其对两端节点的偏导均有解析式
+ * 2. 观测 k 处模型压力 p0 - Σj Δqj·Pu(tk - Tj)，各产量变化只在所在段及其右端节点产生局部偏导，
+ *    早于所在段的节点偏导为与时间无关的常数，乘以 Δq 的后缀和即得整行
+ * 3. 正则项为 ∫ (d²z/dσ²)² dσ 的差分近似，权重 = 正则系数 × 观测点数 × 压力噪声方差
+ */
+
+#include "deconvolutionengine.h"
+#include "flowperioddetector.h"
+
+#include <QtConcurrent>
+#include <QPair>
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <Eigen/Dense>
+
+namespace {
+
+const int kChunkRows = 256;   // 并行累加的数据块行数
+
+// E(x) = (e^x - 1) / x 及其导数，小 x 用级数避免抵消
+inline double expRatio(double x)
+{
+    if (std::abs(x) < 1e-4) return 1.0 + x / 2.0 + x * x / 6.0;
+    return std::expm1(x) / x;
+}
+
+inline double expRatioDerivative(double x)
+{
+    if (std::abs(x) < 1e-3) return 0.5 + x / 3.0 + x * x / 8.0;
+    return (x * std::exp(x) - std::expm1(x)) / (x * x);
+}
+
+QVector<QPair<int, int>> chunkRanges(int n)
+{
+    QVector<QPair<int, int>> ranges;
+    for (int from = 0; from < n; from += kChunkRows) ranges.append(qMakePair(from, qMin(n, from + kChunkRows)));
+    return ranges;
+}
+
+} // namespace
+
+DeconvolutionEngine::DeconvolutionEngine(QObject* parent)
+    : QObject(parent)
+    , m_sigma0(0.0)
+    , m_h(1.0)
+    , m_nodes(0)
+    , m_nu(0.0)
+{
+}
+
+void DeconvolutionEngine::setData(const QVector<double>& t, const QVector<double>& p, const RateHistory& rates)
+{
+    m_rawT = t;
+    m_rawP = p;
+    m_rates = rates;
+    m_dq.resize(rates.periodCount());
+    for (int j = 0; j < rates.periodCount(); ++j) m_dq[j] = rates.rates[j] - (j > 0 ? rates.rates[j - 1] : 0.0);
+}
+
+void DeconvolutionEngine::setConfig(const DeconvolutionConfig& config) { m_config = config; }
+void DeconvolutionEngine::requestStop() { m_token.cancel(); }
+DeconvolutionResult DeconvolutionEngine::result() const { return m_result; }
+
+void DeconvolutionEngine::compressObservations()
+{
+    // 按时间排序后单遍扫描: 同一段、同一对数经过时间箱内的点取平均
+    const int n = qMin(m_rawT.size(), m_rawP.size());
+    QVector<int> order(n);
+    for (int i = 0; i < n; ++i) order[i] = i;
+    bool sorted = true;
+    for (int i = 1; i < n && sorted; ++i) sorted = m_rawT[i] >= m_rawT[i - 1];
+    if (!sorted) std::stable_sort(order.begin(), order.end(), [this](int a, int b) { return m_rawT[a] < m_rawT[b]; });
+
+    m_t.clear(); m_p.clear(); m_period.clear();
+    const double binsPerLn = qMax(m_config.observationsPerCycle, 1) / std::log(10.0);
+    int curPeriod = -1;
+    long long curBin = std::numeric_limits<long long>::min();
+    double sumT = 0, sumP = 0;
+    int count = 0;
+    auto flush = [&]() {
+        if (count == 0) return;
+        m_t.append(sumT / count); m_p.append(sumP / count); m_period.append(curPeriod);
+        sumT = sumP = 0; count = 0;
+    };
+    int k = -1;
+    for (int idx : order) {
+        const double t = m_rawT[idx];
+        while (k + 1 < m_rates.periodCount() && m_rates.startTimes[k + 1] <= t) ++k;
+        if (k < 0) continue;
+        const double elapsed = t - m_rates.startTimes[k];
+        if (!(elapsed > 0)) continue;
+        const long long bin = (long long)std::floor(std::log(elapsed) * binsPerLn);
+        if (k != curPeriod || bin != curBin) { flush(); curPeriod = k; curBin = bin; }
+        sumT += t; sumP += m_rawP[idx]; ++count;
+    }
+    flush();
+}
+
+void DeconvolutionEngine::buildNodes()
+{
+    m_nodes = 0;
+    if (m_t.isEmpty()) return;
+    double tauMin = std::numeric_limits<double>::infinity();
+    for (int k = 0; k < m_t.size(); ++k) tauMin = qMin(tauMin, m_t[k] - m_rates.startTimes[m_period[k]]);
+    if (m_config.minTime > 0) tauMin = m_config.minTime;
+    const double tauMax = m_t.last() - m_rates.startTimes[0];
+    if (!(tauMin > 0) || !(tauMax > tauMin)) return;
+
+    m_sigma0 = std::log(tauMin);
+    const double span = std::log(tauMax) - m_sigma0;
+    m_nodes = qMax(3, int(std::ceil(span / std::log(10.0) * qMax(m_config.nodesPerCycle, 1))) + 1);
+    m_h = span / (m_nodes - 1);
+}
+
+DeconvolutionEngine::Response DeconvolutionEngine::prepare(const QVector<double>& z) const
+{
+    const int N = m_nodes;
+    Response r;
+    r.z = z;
+    r.cumulative.fill(0.0, N);
+    r.nodeDeriv.fill(0.0, N);
+    r.fullDeriv.fill(0.0, N);
+
+    // 首节点之前: exp(z0)·exp(σ - σ0)，积分到 σ0 为 exp(z0)
+    const double e0 = std::exp(z[0]);
+    r.cumulative[0] = e0;
+    r.nodeDeriv[0] = e0;
+    for (int s = 0; s + 1 < N; ++s) {
+        const double ea = std::exp(z[s]);
+        const double d = z[s + 1] - z[s];
+        const double integral = m_h * ea * expRatio(d);
+        const double dRight = m_h * ea * expRatioDerivative(d);
+        r.cumulative[s + 1] = r.cumulative[s] + integral;
+        r.fullDeriv[s] = r.nodeDeriv[s] + (integral - dRight);   // 节点 s 的左侧部分 + 作为段 s 左端
+        r.nodeDeriv[s + 1] = dRight;                              // 作为段 s 右端
+    }
+    r.fullDeriv[N - 1] = r.nodeDeriv[N - 1];
+    return r;
+}
+
+int DeconvolutionEngine::responseTerms(const Response& r, double sigma, double& value, double& dLeft, double& dRight) const
+{
+    const int N = m_nodes;
+    dRight = 0.0;
+    if (sigma < m_sigma0) {
+        value = r.cumulative[0] * std::exp(sigma - m_sigma0);
+        dLeft = value;
+        return -1;
+    }
+    const double x = (sigma - m_sigma0) / m_h;
+    int m = int(std::floor(x));
+    if (m >= N - 1) {
+        // 末节点之后 z 不变
+        const double tail = std::exp(r.z[N - 1]) * (sigma - (m_sigma0 + (N - 1) * m_h));
+        value = r.cumulative[N - 1] + tail;
+        dLeft = tail;
+        return N - 1;
+    }
+    const double f = x - m;
+    const double ea = std::exp(r.z[m]);
+    const double fd = f * (r.z[m + 1] - r.z[m]);
+    const double partial = m_h * f * ea * expRatio(fd);
+    dRight = m_h * f * f * ea * expRatioDerivative(fd);
+    dLeft = partial - dRight;
+    value = r.cumulative[m] + partial;
+    return m;
+}
+
+double DeconvolutionEngine::responseAt(const Response& r, double sigma) const
+{
+    double value, dLeft, dRight;
+    responseTerms(r, sigma, value, dLeft, dRight);
+    return value;
+}
+
+double DeconvolutionEngine::modelPressure(const Response& r, double p0, int k) const
+{
+    double sum = 0.0;
+    for (int j = 0; j <= m_period[k]; ++j) {
+        const double tau = m_t[k] - m_rates.startTimes[j];
+        if (tau > 0) sum += m_dq[j] * responseAt(r, std::log(tau));
+    }
+    return p0 - sum;
+}
+
+DeconvolutionEngine::NormalBlock DeconvolutionEngine::accumulate(const Response& r, double p0, int from, int to) const
+{
+    const int N = m_nodes;
+    const int cols = N + 1;
+    Eigen::MatrixXd B = Eigen::MatrixXd::Zero(to - from, cols);
+    Eigen::VectorXd res(to - from);
+    QVector<double> suffix(N + 1, 0.0);   // suffix[m]: 所在段为 m 的 Δq 之和
+
+    for (int k = from; k < to; ++k) {
+        const int row = k - from;
+        std::fill(suffix.begin(), suffix.end(), 0.0);
+        double sum = 0.0;
+        for (int j = 0; j <= m_period[k]; ++j) {
+            const double tau = m_t[k] - m_rates.startTimes[j];
+            if (!(tau > 0)) continue;
+            double value, dLeft, dRight;
+            const int m = responseTerms(r, std::log(tau), value, dLeft, dRight);
+            const double dq = m_dq[j];
+            sum += dq * value;
+            if (m < 0) { B(row, 0) += dq * dLeft; continue; }
+            B(row, m) += dq * (r.nodeDeriv[m] + dLeft);
+            if (m + 1 < N) B(row, m + 1) += dq * dRight;
+            suffix[m] += dq;
+        }
+        // 节点 i 早于所在段 (i < m) 时偏导为 fullDeriv[i]，系数为 m > i 的 Δq 之和
+        double after = 0.0;
+        for (int i = N - 1; i >= 0; --i) {
+            after += suffix[i + 1];
+            B(row, i) += r.fullDeriv[i] * after;
+        }
+        // 残差 p - (p0 - Σ Δq·Pu)，对 z 的偏导为 Σ Δq·∂Pu/∂z，对 p0 为 -1
+        B(row, N) = -1.0;
+        res(row) = m_p[k] - (p0 - sum);
+    }
+
+    NormalBlock block;
+    Eigen::MatrixXd H = B.transpose() * B;
+    Eigen::VectorXd g = B.transpose() * res;
+    block.H.resize(cols * cols);
+    block.g.resize(cols);
+    for (int a = 0; a < cols; ++a) {
+        block.g[a] = g(a);
+        for (int c = 0; c < cols; ++c) block.H[a * cols + c] = H(a, c);
+    }
+    block.sse = res.squaredNorm();
+    return block;
+}
+
+double DeconvolutionEngine::sumSquares(const Response& r, double p0) const
+{
+    const QVector<QPair<int, int>> ranges = chunkRanges(m_t.size());
+    const QList<double> parts = QtConcurrent::blockingMapped<QList<double>>(ranges, [this, &r, p0](const QPair<int, int>& range) {
+        double sse = 0.0;
+        for (int k = range.first; k < range.second; ++k) {
+            const double e = m_p[k] - modelPressure(r, p0, k);
+            sse += e * e;
+        }
+        return sse;
+    });
+    double sse = 0.0;
+    for (double v : parts) sse += v;
+    return sse;
+}
+
+double DeconvolutionEngine::regularizationEnergy(const QVector<double>& z) const
+{
+    double energy = 0.0;
+    const double scale = 1.0 / (m_h * m_h * m_h);   // (Δ²z / h²)²·h
+    for (int i = 1; i + 1 < z.size(); ++i) {
+        const double c = z[i - 1] - 2.0 * z[i] + z[i + 1];
+        energy += c * c * scale;
+    }
+    return m_nu * energy;
+}
+
+void DeconvolutionEngine::initialGuess(QVector<double>& z, double& p0) const
+{
+    // z 取常数 c 时 Pu = exp(c)·φ(σ)，p = p0 - exp(c)·Σ Δq·φ 对 (p0, exp(c)) 线性，直接回归
+    const int n = m_t.size();
+    QVector<double> F(n, 0.0);
+    for (int k = 0; k < n; ++k) {
+        for (int j = 0; j <= m_period[k]; ++j) {
+            const double tau = m_t[k] - m_rates.startTimes[j];
+            if (!(tau > 0)) continue;
+            const double s = std::log(tau) - m_sigma0;
+            F[k] += m_dq[j] * (s < 0 ? std::exp(s) : 1.0 + s);
+        }
+    }
+    double mf = 0, mp = 0;
+    for (int k = 0; k < n; ++k) { mf += F[k]; mp += m_p[k]; }
+    mf /= n; mp /= n;
+    double cov = 0, var = 0, fMax = 0, pMin = m_p[0], pMax = m_p[0];
+    for (int k = 0; k < n; ++k) {
+        cov += (F[k] - mf) * (m_p[k] - mp);
+        var += (F[k] - mf) * (F[k] - mf);
+        fMax = qMax(fMax, std::abs(F[k]));
+        pMin = qMin(pMin, m_p[k]); pMax = qMax(pMax, m_p[k]);
+    }
+    double A = (var > 0) ? -cov / var : 0.0;
+    if (!(A > 0) || !std::isfinite(A)) A = (fMax > 0 && pMax > pMin) ? (pMax - pMin) / fMax : 1.0;
+    z.fill(std::log(A), m_nodes);
+    p0 = mp + A * mf;
+}
+
+void DeconvolutionEngine::run()
+{
+    m_result = DeconvolutionResult();
+    if (m_rates.periodCount() == 0) { emit finished(); return; }
+
+    compressObservations();
+    buildNodes();
+    const int n = m_t.size();
+    const int N = m_nodes;
+    if (N < 3 || n < N + 1) { emit finished(); return; }
+
+    // 正则权重: 压力噪声由原始记录的二阶差分估计，无噪声数据取压力变化幅度的万分之一
+    QVector<double> sortedP = m_rawP;
+    {
+        QVector<int> order(m_rawT.size());
+        for (int i = 0; i < order.size(); ++i) order[i] = i;
+        std::stable_sort(order.begin(), order.end(), [this](int a, int b) { return m_rawT[a] < m_rawT[b]; });
+        for (int i = 0; i < order.size() && i < m_rawP.size(); ++i) sortedP[i] = m_rawP[order[i]];
+    }
+    const auto range = std::minmax_element(m_p.begin(), m_p.end());
+    const double sigma = qMax(FlowPeriodDetector::noiseSigma(sortedP, 2), 1e-4 * (*range.second - *range.first));
+    m_nu = m_config.regularization * n * sigma * sigma;
+
+    QVector<double> z;
+    double p0 = 0.0;
+    initialGuess(z, p0);
+    Response resp = prepare(z);
+    double sse = sumSquares(resp, p0);
+    double objective = sse + regularizationEnergy(z);
+    emit sigIterationUpdated(std::sqrt(sse / n));
+
+    const QVector<QPair<int, int>> ranges = chunkRanges(n);
+    const int cols = N + 1;
+    const double regScale = m_nu / (m_h * m_h * m_h);
+    double lambda = 0.01;
+    int iter = 0;
+    for (; iter < m_config.maxIterations; ++iter) {
+        if (m_token.isCancelled()) break;
+        emit sigProgress(iter * 100 / qMax(m_config.maxIterations, 1));
+
+        // 1. 各数据块并行计算结构化雅可比并累加法方程
+        const QList<NormalBlock> blocks = QtConcurrent::blockingMapped<QList<NormalBlock>>(ranges, [this, &resp, p0](const QPair<int, int>& r) {
+            return accumulate(resp, p0, r.first, r.second);
+        });
+        Eigen::MatrixXd H = Eigen::MatrixXd::Zero(cols, cols);
+        Eigen::VectorXd g = Eigen::VectorXd::Zero(cols);
+        for (const NormalBlock& b : blocks) {
+            for (int a = 0; a < cols; ++a) {
+                g(a) += b.g[a];
+                for (int c = 0; c < cols; ++c) H(a, c) += b.H[a * cols + c];
+            }
+        }
+        // 2. 曲率正则: νs·DᵀD (D 为二阶差分)
+        for (int i = 1; i + 1 < N; ++i) {
+            const int idx[3] = { i - 1, i, i + 1 };
+            const double w[3] = { 1.0, -2.0, 1.0 };
+            const double c = z[i - 1] - 2.0 * z[i] + z[i + 1];
+            for (int a = 0; a < 3; ++a) {
+                g(idx[a]) += regScale * w[a] * c;
+                for (int b = 0; b < 3; ++b) H(idx[a], idx[b]) += regScale * w[a] * w[b];
+            }
+        }
+
+        // 3. LM 步 (阻尼方式与拟合模块一致)，单步 z 变化限制在 ±2 以内防止指数溢出
+        bool accepted = false;
+        for (int tryIter = 0; tryIter < 6; ++tryIter) {
+            if (m_token.isCancelled()) break;
+            Eigen::MatrixXd Hl = H;
+            for (int a = 0; a < cols; ++a) Hl(a, a) += lambda * (1.0 + std::abs(H(a, a)));
+            Eigen::VectorXd delta = Hl.ldlt().solve(-g);
+            if (!delta.allFinite()) { lambda *= 10.0; continue; }
+
+            QVector<double> zTrial = z;
+            for (int i = 0; i < N; ++i) zTrial[i] += qBound(-2.0, delta(i), 2.0);
+            const double p0Trial = p0 + delta(N);
+            Response trialResp = prepare(zTrial);
+            const double trialSse = sumSquares(trialResp, p0Trial);
+            const double trialObjective = trialSse + regularizationEnergy(zTrial);
+            if (std::isfinite(trialObjective) && trialObjective < objective) {
+                const double improvement = (objective - trialObjective) / qMax(objective, 1e-300);
+                z = zTrial; p0 = p0Trial; resp = trialResp; sse = trialSse; objective = trialObjective;
+                lambda = qMax(lambda / 10.0, 1e-12);
+                accepted = true;
+                emit sigIterationUpdated(std::sqrt(sse / n));
+                if (improvement < 1e-9) iter = m_config.maxIterations;   // 已收敛
+                break;
+            }
+            lambda *= 10.0;
+        }
+        if (!accepted && (lambda > 1e10 || m_token.isCancelled())) break;
+    }
+    if (m_token.isCancelled()) { emit finished(); return; }
+
+    // 4. 结果: 每段 4 个子点输出参考产量下的压降与导数
+    double qRef = m_config.referenceRate;
+    if (!(qRef > 0)) for (double q : m_rates.rates) qRef = qMax(qRef, std::abs(q));
+    if (!(qRef > 0)) qRef = 1.0;
+    const int sub = 4;
+    for (int i = 0; i + 1 < N; ++i) {
+        for (int s = 0; s < sub; ++s) {
+            const double f = double(s) / sub;
+            const double sig = m_sigma0 + (i + f) * m_h;
+            m_result.tau.append(std::exp(sig));
+            m_result.pressure.append(qRef * responseAt(resp, sig));
+            m_result.derivative.append(qRef * std::exp(z[i] + f * (z[i + 1] - z[i])));
+        }
+    }
+    const double sigEnd = m_sigma0 + (N - 1) * m_h;
+    m_result.tau.append(std::exp(sigEnd));
+    m_result.pressure.append(qRef * responseAt(resp, sigEnd));
+    m_result.derivative.append(qRef * std::exp(z[N - 1]));
+
+    m_result.obsTime = m_t;
+    m_result.obsPressure = m_p;
+    m_result.fittedPressure.resize(n);
+    for (int k = 0; k < n; ++k) m_result.fittedPressure[k] = modelPressure(resp, p0, k);
+
+    m_result.initialPressure = p0;
+    m_result.referenceRate = qRef;
+    m_result.rms = std::sqrt(sse / n);
+    m_result.iterations = qMin(iter, m_config.maxIterations);
+    m_result.observationCount = n;
+    m_result.completed = true;
+    emit sigProgress(100);
+    emit finished();
+}
@@ -0,0 +1,127 @@
+/*
+ * deconvolutionengine.h
+ * 文件作用：压力-产量反褶积引擎头文件
+ * 功能描述：
+ * 1. 由变产量压力史与产量史反求定产量单位响应 (von Schroeter / Levitan 方法)
+ * 2. 未知量为对数时间节点上的 z = ln(dPu/d ln τ) (节点间线性) 与初始压力 p0，
+ *    目标函数为压力残差平方和 + 曲率正则项，Levenberg-Marquardt 求解
+ * 3. 雅可比行按结构计算: 节点早于当前段的偏导只与节点有关，按产量变化的后缀和合并，
+ *    每行代价 O(节点数 + 产量变化数)；法方程按数据块并行累加，不存储完整雅可比
+ * 4. 观测数据按各流动段内的对数经过时间分箱平均，百万级记录压缩到数千点
+ * 5. 结果 (单位响应 × 参考产量) 可直接作为拟合页的观测数据
+ */
+
+#ifndef DECONVOLUTIONENGINE_H
+#define DECONVOLUTIONENGINE_H
+
+#include <QObject>
+#include <QVector>
+#include "superpositiontime.h"
+#include "cancellationtoken.h"
+
+struct DeconvolutionConfig {
+    int nodesPerCycle;          // 每个对数周期的节点数
+    double minTime;             // 响应最早时间，<= 0 时取观测中最小的段内经过时间
+    double regularization;      // 曲率正则权重 (相对噪声能量)
+    int maxIterations;
+    int observationsPerCycle;   // 观测压缩: 每段每个对数周期的分箱数
+    double referenceRate;       // 输出响应对应的产量，<= 0 时取最大产量
+
+    DeconvolutionConfig() :
+        nodesPerCycle(8),
+        minTime(0.0),
+        regularization(1.0),
+        maxIterations(30),
+        observationsPerCycle(30),
+        referenceRate(0.0) {}
+};
+
+struct DeconvolutionResult {
+    bool completed;
+    int iterations;
+    int observationCount;
+    double initialPressure;
+    double referenceRate;
+    double rms;                         // 压力拟合均方根误差
+
+    QVector<double> tau;                // 响应时间
+    QVector<double> pressure;           // 参考产量下的压降
+    QVector<double> derivative;         // 参考产量下的 Bourdet 导数
+
+    QVector<double> obsTime;            // 压缩后的观测时间
+    QVector<double> obsPressure;        // 压缩后的观测压力
+    QVector<double> fittedPressure;     // 反褶积模型重构的压力
+
+    DeconvolutionResult() : completed(false), iterations(0), observationCount(0),
+        initialPressure(0), referenceRate(0), rms(0) {}
+};
+
+class DeconvolutionEngine : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit DeconvolutionEngine(QObject* parent = nullptr);
+
+    // t、p 为压力记录 (顺序不限)，rates 为分段常产量史
+    void setData(const QVector<double>& t, const QVector<double>& p, const RateHistory& rates);
+    void setConfig(const DeconvolutionConfig& config);
+    void requestStop();
+    DeconvolutionResult result() const;
+
+    // 在工作线程中调用
+    void run();
+
+signals:
+    void sigProgress(int percent);
+    void sigIterationUpdated(double rms);
+    void finished();
+
+private:
+    // 某一组节点值下的响应缓存: 各节点处累计值与节点偏导
+    struct Response {
+        QVector<double> z;
+        QVector<double> cumulative;   // Pu(σi)
+        QVector<double> nodeDeriv;    // ∂Pu(σi)/∂zi (首节点前外推或前一段右端)
+        QVector<double> fullDeriv;    // 节点早于所在段时 ∂Pu/∂zi
+    };
+    // 法方程的一个数据块
+    struct NormalBlock {
+        QVector<double> H;            // (N+1)² 行主序
+        QVector<double> g;
+        double sse;
+    };
+
+    void compressObservations();
+    void buildNodes();
+    Response prepare(const QVector<double>& z) const;
+    double responseAt(const Response& r, double sigma) const;
+    // 单点响应及其对节点的偏导 (只写 i = m, m+1 的分段项；返回所在段 m，-1 为首节点之前)
+    int responseTerms(const Response& r, double sigma, double& value, double& dLeft, double& dRight) const;
+    double modelPressure(const Response& r, double p0, int k) const;
+    NormalBlock accumulate(const Response& r, double p0, int from, int to) const;
+    double sumSquares(const Response& r, double p0) const;
+    double regularizationEnergy(const QVector<double>& z) const;
+    void initialGuess(QVector<double>& z, double& p0) const;
+
+private:
+    QVector<double> m_rawT, m_rawP;
+    RateHistory m_rates;
+    QVector<double> m_dq;             // 各产量变化量
+    DeconvolutionConfig m_config;
+
+    // 压缩后的观测与其所在的段
+    QVector<double> m_t, m_p;
+    QVector<int> m_period;
+
+    // 节点 σi = σ0 + i·h
+    double m_sigma0;
+    double m_h;
+    int m_nodes;
+    double m_nu;                      // 正则系数 (绝对值)
+
+    CancellationToken m_token;
+    DeconvolutionResult m_result;
+};
+
+#endif // DECONVOLUTIONENGINE_H
@@ -0,0 +1,128 @@
+/*
+ * derivativeengine.cpp
+ * 文件作用：Bourdet 压力导数统一计算引擎实现文件
+ * 功能描述：
+ * 1. 左邻点: 满足 ln ti - ln tj >= L 的最近点 j；右邻点: 满足 ln tk - ln ti >= L 的最近点 k
+ * 2. 时间递增时两个邻点都随 i 单调右移，双指针扫描总移动次数不超过 2n
+ * 3. 邻点确定后，两侧均有邻点的内部点在一个无分支的紧凑循环中计算加权斜率
+ */
+
+#include "derivativeengine.h"
+
+#include <cmath>
+#include <limits>
+
+namespace {
+// 单边导数 (pa - pb) / (ln ta - ln tb)
+inline double slope(const double* x, const double* p, int a, int b)
+{
+    if (!std::isfinite(x[a]) || !std::isfinite(x[b])) return 0.0;
+    double dx = x[a] - x[b];
+    return std::abs(dx) < 1e-10 ? 0.0 : (p[a] - p[b]) / dx;
+}
+}
+
+QVector<double> DerivativeEngine::logTime(const QVector<double>& t)
+{
+    QVector<double> lnT(t.size());
+    for (int i = 0; i < t.size(); ++i) lnT[i] = t[i] > 0 ? std::log(t[i]) : -std::numeric_limits<double>::infinity();
+    return lnT;
+}
+
+void DerivativeEngine::findNeighbours(const QVector<double>& lnT, int first, double lSpacing,
+                                      QVector<int>& left, QVector<int>& right)
+{
+    const int n = lnT.size();
+    left.fill(-1, n);
+    right.fill(-1, n);
+    int a = first;       // 第一个与当前点距离 < L 的左侧点
+    int b = first + 1;   // 右侧候选点
+    for (int i = first; i < n; ++i) {
+        while (a < i && lnT[i] - lnT[a] >= lSpacing) ++a;
+        if (a - 1 >= first) left[i] = a - 1;
+        if (b <= i) b = i + 1;
+        while (b < n && lnT[b] - lnT[i] < lSpacing) ++b;
+        if (b < n) right[i] = b;
+    }
+}
+
+double DerivativeEngine::pointDerivative(const QVector<double>& lnT, const QVector<double>& dp, int i, int left, int right)
+{
+    const double* x = lnT.constData();
+    const double* p = dp.constData();
+    const int n = lnT.size();
+    if (left >= 0 && right >= 0) {
+        double dxl = x[i] - x[left];
+        double dxr = x[right] - x[i];
+        if (!(dxl + dxr > 1e-12)) return 0.0;
+        return (slope(x, p, i, left) * dxr + slope(x, p, right, i) * dxl) / (dxl + dxr);
+    }
+    if (left >= 0) return slope(x, p, i, left);
+    if (right >= 0) return slope(x, p, right, i);
+    // L-Spacing 范围内点不足时以相邻点差分保底
+    if (i > 0) return slope(x, p, i, i - 1);
+    if (i < n - 1) return slope(x, p, i + 1, i);
+    return 0.0;
+}
+
+QVector<double> DerivativeEngine::bourdet(const QVector<double>& t, const QVector<double>& dp, double lSpacing)
+{
+    const int n = qMin(t.size(), dp.size());
+    return bourdetOnAxis(logTime(t.mid(0, n)), dp, lSpacing);
+}
+
+QVector<double> DerivativeEngine::bourdetOnAxis(const QVector<double>& axis, const QVector<double>& dp, double lSpacing)
+{
+    const int n = qMin(axis.size(), dp.size());
+    QVector<double> out(n, 0.0);
+    if (n == 0) return out;
+
+    const QVector<double> lnT = axis.mid(0, n);
+    const QVector<double> p = dp.mid(0, n);
+
+    // 横坐标单调不减时无效点 (-inf) 只可能出现在开头
+    bool sorted = true;
+    for (int i = 1; i < n && sorted; ++i) sorted = lnT[i] >= lnT[i - 1];
+    int first = 0;
+    while (first < n && !std::isfinite(lnT[first])) ++first;
+
+    QVector<int> left, right;
+    if (sorted) {
+        findNeighbours(lnT, first, lSpacing, left, right);
+    } else {
+        // 乱序数据: 逐点向两侧扫描最近的满足条件的点 (跳过无效点)
+        left.fill(-1, n);
+        right.fill(-1, n);
+        for (int i = 0; i < n; ++i) {
+            if (!std::isfinite(lnT[i])) continue;
+            for (int j = i - 1; j >= 0; --j) {
+                if (std::isfinite(lnT[j]) && lnT[i] - lnT[j] >= lSpacing) { left[i] = j; break; }
+            }
+            for (int k = i + 1; k < n; ++k) {
+                if (std::isfinite(lnT[k]) && lnT[k] - lnT[i] >= lSpacing) { right[i] = k; break; }
+            }
+        }
+    }
+
+    // 内部点: 两侧斜率加权 (紧凑循环，便于编译器优化)
+    const double* x = lnT.constData();
+    const double* pp = p.constData();
+    const int* L = left.constData();
+    const int* R = right.constData();
+    double* d = out.data();
+    for (int i = 0; i < n; ++i) {
+        const int j = L[i], k = R[i];
+        if (j < 0 || k < 0) continue;
+        const double dxl = x[i] - x[j];
+        const double dxr = x[k] - x[i];
+        const double mL = std::abs(dxl) < 1e-10 ? 0.0 : (pp[i] - pp[j]) / dxl;
+        const double mR = std::abs(dxr) < 1e-10 ? 0.0 : (pp[k] - pp[i]) / dxr;
+        d[i] = (dxl + dxr > 1e-12) ? (mL * dxr + mR * dxl) / (dxl + dxr) : 0.0;
+    }
+    // 边界点与非正时间点
+    for (int i = 0; i < n; ++i) {
+        if (L[i] >= 0 && R[i] >= 0) continue;
+        d[i] = std::isfinite(x[i]) ? pointDerivative(lnT, p, i, L[i], R[i]) : 0.0;
+    }
+    return out;
+}
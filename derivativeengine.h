@@ -0,0 +1,51 @@
+/*
+ * derivativeengine.h
+ * 文件作用：Bourdet 压力导数统一计算引擎头文件
+ * 功能描述：
+ * 1. 绘图、数据处理、拟合与模型预览共用同一套 L-Spacing 加权导数算法，保证各处结果一致
+ * 2. ln t 只计算一次；时间递增时用双指针一次扫描确定左右 L-Spacing 邻点，整体 O(n)
+ * 3. 时间非递增的数据退回逐点扫描，结果与原算法逐点一致
+ * 4. 全部为静态无状态接口，可在工作线程中并发调用
+ */
+
+#ifndef DERIVATIVEENGINE_H
+#define DERIVATIVEENGINE_H
+
+#include <QVector>
+
+class DerivativeEngine
+{
+public:
+    /**
+     * @brief Bourdet 导数 dΔp/d(ln t)
+     * @param t 时间 (非正值处导数为 0)
+     * @param dp 压降
+     * @param lSpacing L-Spacing (自然对数单位)，0 表示取相邻点
+     * @return 与输入等长的导数
+     */
+    static QVector<double> bourdet(const QVector<double>& t, const QVector<double>& dp, double lSpacing);
+
+    /**
+     * @brief 以给定横坐标 (ln t、ln Δte 或叠加时间函数) 为自变量的 Bourdet 导数 dΔp/dx
+     * @param axis 横坐标，-inf/NaN 视为无效点 (导数为 0)
+     */
+    static QVector<double> bourdetOnAxis(const QVector<double>& axis, const QVector<double>& dp, double lSpacing);
+
+    // ln t，非正时间记为 -inf
+    static QVector<double> logTime(const QVector<double>& t);
+
+    /**
+     * @brief 双指针确定 L-Spacing 邻点 (要求 lnT 从 first 起单调不减，first 之前为非正时间)
+     * @param left/right 输出：各点左/右邻点序号，不存在为 -1
+     */
+    static void findNeighbours(const QVector<double>& lnT, int first, double lSpacing,
+                               QVector<int>& left, QVector<int>& right);
+
+    /**
+     * @brief 单点导数: 两侧都有邻点时取两侧斜率按对数距离加权，只有一侧时取单侧斜率，
+     *        两侧都没有时取相邻点差分
+     */
+    static double pointDerivative(const QVector<double>& lnT, const QVector<double>& dp, int i, int left, int right);
+};
+
+#endif // DERIVATIVEENGINE_H
@@ -0,0 +1,236 @@
+/*
+ * derivativesmoother.cpp
+ * 文件作用：压力导数平滑处理实现文件
+ * 功能描述：
+ * 1. 对数域滤波器在 ln t 上按固定对数宽度取窗口，双指针滑动，避免按点数取窗在稀疏段过度平滑
+ * 2. Savitzky-Golay 的窗口矩和随窗口增量更新；窗口中心漂移较远时以当前点为原点重建，保证数值稳定
+ * 3. 中值滤波使用大顶堆/小顶堆 + 延迟删除
+ */
+
+#include "derivativesmoother.h"
+#include "slidingmedian.h"
+
+#include <QtGlobal>
+#include <vector>
+#include <algorithm>
+#include <cmath>
+#include <Eigen/Dense>
+
+namespace {
+
+inline double tricube(double r)
+{
+    r = std::abs(r);
+    if (r >= 1.0) return 0.0;
+    double a = 1.0 - r * r * r;
+    return a * a * a;
+}
+
+} // namespace
+
+QStringList DerivativeSmoothingConfig::methodNames()
+{
+    return QStringList() << "不平滑" << "移动平均" << "Savitzky-Golay (ln t)" << "LOWESS (对数分箱)" << "中值滤波";
+}
+
+QVector<double> DerivativeSmoother::apply(const QVector<double>& t, const QVector<double>& y, const DerivativeSmoothingConfig& config)
+{
+    switch (config.method) {
+    case DerivativeSmoothingConfig::MovingAverage: return movingAverage(y, config.span);
+    case DerivativeSmoothingConfig::SavitzkyGolay: return savitzkyGolay(t, y, config.logWindow, config.order);
+    case DerivativeSmoothingConfig::Lowess:        return lowess(t, y, config.logWindow);
+    case DerivativeSmoothingConfig::Median:        return median(y, config.span);
+    default:                                       return y;
+    }
+}
+
+QVector<double> DerivativeSmoother::movingAverage(const QVector<double>& y, int span)
+{
+    const int n = y.size();
+    if (n == 0 || span <= 1) return y;
+    if (span % 2 == 0) span++;
+    const int half = (span - 1) / 2;
+
+    // 前缀和: 窗口和 = prefix[end + 1] - prefix[start]
+    QVector<double> prefix(n + 1, 0.0);
+    for (int i = 0; i < n; ++i) prefix[i + 1] = prefix[i] + y[i];
+
+    QVector<double> out(n);
+    for (int i = 0; i < n; ++i) {
+        int start = qMax(0, i - half);
+        int end = qMin(n - 1, i + half);
+        out[i] = (prefix[end + 1] - prefix[start]) / (end - start + 1);
+    }
+    return out;
+}
+
+QVector<double> DerivativeSmoother::median(const QVector<double>& y, int span)
+{
+    const int n = y.size();
+    if (n == 0 || span <= 1) return y;
+    if (span % 2 == 0) span++;
+    const int half = (span - 1) / 2;
+
+    QVector<double> out(n);
+    SlidingMedian window;
+    int lo = 0, hi = -1;   // 当前窗口 [lo, hi]
+    for (int i = 0; i < n; ++i) {
+        const int newHi = qMin(n - 1, i + half);
+        const int newLo = qMax(0, i - half);
+        while (hi < newHi) window.insert(y[++hi]);
+        while (lo < newLo) window.erase(y[lo++]);
+        out[i] = window.median();
+    }
+    return out;
+}
+
+QVector<int> DerivativeSmoother::positiveOrder(const QVector<double>& t, int n)
+{
+    QVector<int> order;
+    order.reserve(n);
+    for (int i = 0; i < n; ++i) if (t[i] > 0) order.append(i);
+    bool sorted = true;
+    for (int k = 1; k < order.size() && sorted; ++k) sorted = t[order[k]] >= t[order[k - 1]];
+    if (!sorted) std::stable_sort(order.begin(), order.end(), [&t](int a, int b) { return t[a] < t[b]; });
+    return order;
+}
+
+QVector<double> DerivativeSmoother::savitzkyGolay(const QVector<double>& t, const QVector<double>& y, double halfWidth, int order)
+{
+    const int n = qMin(t.size(), y.size());
+    QVector<double> out = y.mid(0, n);
+    const QVector<int> idx = positiveOrder(t, n);
+    const int m = idx.size();
+    if (m == 0) return out;
+
+    QVector<double> x(m), v(m);
+    for (int k = 0; k < m; ++k) { x[k] = std::log(t[idx[k]]); v[k] = y[idx[k]]; }
+
+    const double h = qMax(halfWidth, 0.0);
+    const double scale = qMax(h, 1e-6);
+    const int P = qBound(0, order, 3);
+
+    // 窗口矩: S[k] = Σu^k，T[k] = Σu^k·y，u = (x - c) / scale
+    double S[7] = { 0 }, T[4] = { 0 };
+    double c = x[0];
+    int lo = 0, hi = 0;   // 窗口 [lo, hi)
+    auto accumulate = [&](int j, double sign) {
+        double u = (x[j] - c) / scale, pw = 1.0;
+        for (int k = 0; k <= 2 * P; ++k) {
+            S[k] += sign * pw;
+            if (k <= P) T[k] += sign * pw * v[j];
+            pw *= u;
+        }
+    };
+    auto rebuild = [&](double center) {
+        c = center;
+        std::fill(S, S + 7, 0.0);
+        std::fill(T, T + 4, 0.0);
+        for (int j = lo; j < hi; ++j) accumulate(j, 1.0);
+    };
+
+    for (int i = 0; i < m; ++i) {
+        while (hi < m && x[hi] - x[i] <= h) accumulate(hi++, 1.0);
+        while (x[i] - x[lo] > h) accumulate(lo++, -1.0);
+        // 原点离当前点超过一个窗口宽度时重建，重建代价由窗口滑过的点数均摊
+        if (std::abs(x[i] - c) > 2.0 * scale) rebuild(x[i]);
+
+        const int p = qMin(P, hi - lo - 1);
+        double value = v[i];
+        if (p > 0) {
+            // 最大 4x4，栈上分配
+            Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic, 0, 4, 4> A(p + 1, p + 1);
+            Eigen::Matrix<double, Eigen::Dynamic, 1, 0, 4, 1> b(p + 1);
+            for (int a = 0; a <= p; ++a) {
+                b(a) = T[a];
+                for (int k = 0; k <= p; ++k) A(a, k) = S[a + k];
+            }
+            Eigen::Matrix<double, Eigen::Dynamic, 1, 0, 4, 1> coef = A.ldlt().solve(b);
+            double u = (x[i] - c) / scale, fit = 0.0;
+            for (int a = p; a >= 0; --a) fit = fit * u + coef(a);
+            if (std::isfinite(fit)) value = fit;
+        } else if (S[0] > 0) {
+            value = T[0] / S[0];
+        }
+        out[idx[i]] = value;
+    }
+    return out;
+}
+
+QVector<double> DerivativeSmoother::lowess(const QVector<double>& t, const QVector<double>& y, double bandwidth,
+                                           int binsPerCycle, int robustIterations)
+{
+    const int n = qMin(t.size(), y.size());
+    QVector<double> out = y.mid(0, n);
+    const QVector<int> idx = positiveOrder(t, n);
+    const int m = idx.size();
+    if (m < 3) return out;
+
+    QVector<double> x(m);
+    for (int k = 0; k < m; ++k) x[k] = std::log(t[idx[k]]);
+
+    // 1. 对数等间距分箱 (只保留非空箱)，箱的位置取箱内点的平均 ln t
+    const double width = std::log(10.0) / qMax(binsPerCycle, 1);
+    QVector<double> bx, by, bw;
+    int currentBin = -1;
+    for (int k = 0; k < m; ++k) {
+        int bin = int(std::floor((x[k] - x[0]) / width));
+        if (bin != currentBin) {
+            if (!bw.isEmpty()) { bx.last() /= bw.last(); by.last() /= bw.last(); }
+            bx.append(0.0); by.append(0.0); bw.append(0.0);
+            currentBin = bin;
+        }
+        bx.last() += x[k]; by.last() += y[idx[k]]; bw.last() += 1.0;
+    }
+    bx.last() /= bw.last(); by.last() /= bw.last();
+    const int B = bx.size();
+
+    // 2. 分箱上的三次权局部线性回归，箱内点数作为权重
+    const double h = qMax(bandwidth, width);
+    QVector<double> fit(B), robust(B, 1.0);
+    for (int iter = 0; iter <= robustIterations; ++iter) {
+        int lo = 0, hi = 0;
+        for (int b = 0; b < B; ++b) {
+            while (hi < B && bx[hi] - bx[b] <= h) ++hi;
+            while (bx[b] - bx[lo] > h) ++lo;
+            double W = 0, Wx = 0, Wy = 0, Wxx = 0, Wxy = 0;
+            for (int j = lo; j < hi; ++j) {
+                double u = bx[j] - bx[b];
+                double w = bw[j] * robust[j] * tricube(u / (h * (1.0 + 1e-9)));
+                W += w; Wx += w * u; Wy += w * by[j]; Wxx += w * u * u; Wxy += w * u * by[j];
+            }
+            if (!(W > 0)) { fit[b] = by[b]; continue; }
+            double denom = W * Wxx - Wx * Wx;
+            double slope = (denom > 1e-12 * W * W) ? (W * Wxy - Wx * Wy) / denom : 0.0;
+            fit[b] = (Wy - slope * Wx) / W;
+        }
+        if (iter == robustIterations) break;
+
+        // 稳健权重: 残差除以 6 倍残差绝对值中位数后取双平方权
+        QVector<double> absRes(B);
+        for (int b = 0; b < B; ++b) absRes[b] = std::abs(by[b] - fit[b]);
+        QVector<double> sortedRes = absRes;
+        std::nth_element(sortedRes.begin(), sortedRes.begin() + B / 2, sortedRes.end());
+        double s = sortedRes[B / 2];
+        if (!(s > 0)) break;
+        for (int b = 0; b < B; ++b) {
+            double r = absRes[b] / (6.0 * s);
+            robust[b] = r < 1.0 ? (1.0 - r * r) * (1.0 - r * r) : 0.0;
+        }
+    }
+
+    // 3. 各点按 ln t 在分箱拟合值之间线性插值
+    int b = 0;
+    for (int k = 0; k < m; ++k) {
+        while (b + 1 < B && bx[b + 1] < x[k]) ++b;
+        double value;
+        if (B == 1 || x[k] <= bx[0]) value = fit[0];
+        else if (b + 1 >= B) value = fit[B - 1];
+        else {
+            double f = (x[k] - bx[b]) / (bx[b + 1] - bx[b]);
+            value = fit[b] + qBound(0.0, f, 1.0) * (fit[b + 1] - fit[b]);
+        }
+        out[idx[k]] = value;
+    }
+    return out;
+}
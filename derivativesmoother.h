@@ -0,0 +1,69 @@
+/*
+ * derivativesmoother.h
+ * 文件作用：压力导数平滑处理头文件
+ * 功能描述：
+ * 1. 移动平均: 前缀和实现，O(n)，窗口按点数计，边缘处窗口自动缩小
+ * 2. Savitzky-Golay: 在 ln t 上按固定对数半宽做局部多项式最小二乘，适用于非等间距采样，O(n)
+ * 3. LOWESS: 数据先归并到对数等间距的分箱，在分箱上做三次权局部线性回归 (含稳健迭代)，再插值回各点
+ * 4. 中值滤波: 双堆滑动窗口，O(n log w)，对孤立毛刺不敏感
+ * 5. 绘图导数对话框与拟合数据加载共用同一平滑配置
+ */
+
+#ifndef DERIVATIVESMOOTHER_H
+#define DERIVATIVESMOOTHER_H
+
+#include <QVector>
+#include <QString>
+#include <QStringList>
+
+// 导数平滑配置
+struct DerivativeSmoothingConfig {
+    enum Method { None = 0, MovingAverage, SavitzkyGolay, Lowess, Median };
+
+    Method method;
+    int span;           // 移动平均/中值: 窗口点数 (奇数)
+    double logWindow;   // Savitzky-Golay: ln t 半宽；LOWESS: ln t 带宽 (半宽)
+    int order;          // Savitzky-Golay 多项式阶数 (0-3)
+
+    DerivativeSmoothingConfig() :
+        method(None),
+        span(5),
+        logWindow(0.3),
+        order(2) {}
+
+    // 各方法的显示名称 (顺序与 Method 一致)
+    static QStringList methodNames();
+};
+
+class DerivativeSmoother
+{
+public:
+    // 按配置平滑；t 仅用于对数域滤波器 (Savitzky-Golay、LOWESS)
+    static QVector<double> apply(const QVector<double>& t, const QVector<double>& y, const DerivativeSmoothingConfig& config);
+
+    static QVector<double> movingAverage(const QVector<double>& y, int span);
+    static QVector<double> median(const QVector<double>& y, int span);
+
+    /**
+     * @brief ln t 上的 Savitzky-Golay (局部多项式) 平滑
+     * @param halfWidth 窗口半宽 (自然对数单位)
+     * @param order 多项式阶数，窗口内点数不足时自动降阶
+     * 非正时间的点原样保留
+     */
+    static QVector<double> savitzkyGolay(const QVector<double>& t, const QVector<double>& y, double halfWidth, int order);
+
+    /**
+     * @brief 对数分箱上的 LOWESS
+     * @param bandwidth 局部回归半宽 (自然对数单位)
+     * @param binsPerCycle 每个对数周期的分箱数
+     * @param robustIterations 稳健迭代次数 (双平方权)
+     */
+    static QVector<double> lowess(const QVector<double>& t, const QVector<double>& y, double bandwidth,
+                                  int binsPerCycle = 20, int robustIterations = 2);
+
+private:
+    // 正时间点按时间升序的序号
+    static QVector<int> positiveOrder(const QVector<double>& t, int n);
+};
+
+#endif // DERIVATIVESMOOTHER_H
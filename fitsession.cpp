@@ -0,0 +1,504 @@
+/*
+ * fitsession.cpp
+ * 文件作用：单次拟合会话类实现文件
+ * 功能描述：
+ * 1. 实现 LM 非线性回归 (对数残差、压力/导数加权)
+ * 2. 残差使用网格模式理论曲线，雅可比矩阵采用中心差分
+ * 3. 反演精度通过参数表中的 "N" 显式传入模型，不再切换共享模型对象的精度开关
+ * 4. 取消令牌传入模型计算内部；被中断的残差计算结果一律丢弃，保证返回的参数总是完整评估过的最优值
+ * 5. 可选的代理模型全局搜索: 少量并行真实计算训练 RBF 响应面，在响应面上做大范围搜索后以真实模型确认
+ * 6. 可选的贝叶斯优化模式: 高斯过程 + 期望改进量成批选点，在固定的真实模型调用次数内搜索
+ */
+
+#include "fitsession.h"
+
+#include "surrogatemodel.h"
+#include "bayesianoptimizer.h"
+#include "curveinterpolator.h"
+
+#include <QDebug>
+#include <QtConcurrent>
+#include <QThread>
+#include <cmath>
+#include <Eigen/Dense>
+
+FitSession::FitSession(ModelManager* modelManager, QObject* parent)
+    : QObject(parent)
+    , m_modelManager(modelManager)
+    , m_modelType(ModelManager::Model_1)
+    , m_weight(0.5)
+    , m_iterationN(4)
+    , m_finalN(8)
+    , m_useSurrogate(false)
+    , m_method(Method_LM)
+    , m_forwardBudget(80)
+    , m_timeBudget(0)
+    , m_resultError(0.0)
+    , m_resultSSE(0.0)
+    , m_residualCount(0)
+    , m_fittedCount(0)
+    , m_deadlineHit(false)
+{
+}
+
+void FitSession::setModelType(ModelManager::ModelType type) { m_modelType = type; }
+void FitSession::setParameters(const QList<FitParameter>& params) { m_params = params; }
+void FitSession::setWeight(double weight) { m_weight = weight; }
+
+void FitSession::setObservedData(const QVector<double>& t, const QVector<double>& p, const QVector<double>& d)
+{
+    m_obsTime = t; m_obsPressure = p; m_obsDerivative = d;
+}
+
+void FitSession::setStehfestOrder(int iterationN, int finalN)
+{
+    m_iterationN = iterationN;
+    m_finalN = finalN;
+}
+
+void FitSession::setTimeBudget(qint64 msecs) { m_timeBudget = msecs; }
+void FitSession::setSurrogateSearch(bool enabled) { m_useSurrogate = enabled; }
+void FitSession::setMethod(FitMethod method) { m_method = method; }
+void FitSession::setForwardBudget(int calls) { m_forwardBudget = calls; }
+
+void FitSession::requestStop() { m_token.cancel(); }
+bool FitSession::isStopRequested() const { return m_token.isCancelled(); }
+bool FitSession::isDeadlineReached() const { return m_deadlineHit; }
+
+ModelManager::ModelType FitSession::modelType() const { return m_modelType; }
+QMap<QString, double> FitSession::resultParameters() const { return m_resultParams; }
+double FitSession::resultError() const { return m_resultError; }
+double FitSession::resultSSE() const { return m_resultSSE; }
+int FitSession::residualCount() const { return m_residualCount; }
+int FitSession::fittedParameterCount() const { return m_fittedCount; }
+ModelCurveData FitSession::resultCurve() const { return m_resultCurve; }
+
+QMap<QString, double> FitSession::prepareParams(const QMap<QString, double>& params, int N) const
+{
+    QMap<QString, double> map = params;
+    map["N"] = N;
+    if(map.contains("L") && map.contains("Lf") && map["L"] > 1e-9) map["LfD"] = map["Lf"] / map["L"];
+    return map;
+}
+
+ModelCurveData FitSession::emitCurve(double error, const QMap<QString, double>& params, int N, const CancellationToken* token)
+{
+    QMap<QString, double> curveParams = prepareParams(params, N);
+    ModelCurveData curve = m_modelManager->calculateTheoreticalCurve(m_modelType, curveParams, QVector<double>(), token);
+    if(CancellationToken::cancelled(token)) return curve;
+    publishCurve(error, params, curve);
+    return curve;
+}
+
+void FitSession::publishCurve(double error, const QMap<QString, double>& params, const ModelCurveData& curve)
+{
+    QMap<QString, double> shown = params;
+    shown.remove("N");
+    m_lastCurve = curve;
+    m_lastCurveParams = shown;
+    emit sigIterationUpdated(error, shown, std::get<0>(curve), std::get<1>(curve), std::get<2>(curve));
+}
+
+void FitSession::run()
+{
+    // 时间预算从本会话实际开始运行时计时，线程池中排队等待的时间不计入
+    m_token.setTimeBudget(m_timeBudget);
+
+    QVector<int> fitIndices;
+    for(int i=0; i<m_params.size(); ++i) if(m_params[i].isFit) fitIndices.append(i);
+    int nParams = fitIndices.size();
+    m_fittedCount = nParams;
+    if(!m_modelManager || nParams == 0 || m_obsTime.isEmpty()) { emit finished(); return; }
+
+    double lambda = 0.01; int maxIter = 50; double currentSSE = 1e15;
+    QMap<QString, double> currentParamMap;
+    for(const auto& p : m_params) currentParamMap.insert(p.name, p.value);
+    currentParamMap = prepareParams(currentParamMap, m_iterationN);
+
+    const bool bayesian = (m_method == Method_Bayesian);
+    ModelCurveData baseCurve = evaluateCurve(currentParamMap);
+    QVector<double> residuals = residualsFromCurve(m_obsPressure, m_obsDerivative, std::get<1>(baseCurve), std::get<2>(baseCurve), m_weight);
+    currentSSE = calculateSumSquaredError(residuals);
+    // 初始评估即被中断时没有可信的误差值，直接返回初始参数
+    bool haveBaseline = !isStopRequested() && !residuals.isEmpty();
+    // 贝叶斯优化模式直接显示实测时刻上的评估曲线，不为显示另做一次真实计算
+    if(haveBaseline && bayesian) publishCurve(currentSSE/residuals.size(), currentParamMap, baseCurve);
+    else if(haveBaseline) emitCurve(currentSSE/residuals.size(), currentParamMap, m_iterationN, &m_token);
+
+    // 代理模型全局搜索只替换初值，随后仍由 LM 在真实模型上收敛；
+    // 其抽样计算不受调用次数约束，贝叶斯优化模式下不启用
+    if(haveBaseline && m_useSurrogate && !bayesian && !isStopRequested()) {
+        if(surrogateGlobalSearch(fitIndices, currentParamMap, residuals, currentSSE)) {
+            emitCurve(currentSSE/residuals.size(), currentParamMap, m_iterationN, &m_token);
+        }
+    }
+
+    // 贝叶斯优化在固定调用次数内完成全部搜索，不再进入 LM 迭代
+    if(haveBaseline && bayesian && !isStopRequested()) {
+        bayesianSearch(fitIndices, currentParamMap, residuals, currentSSE);
+    }
+
+    for(int iter = 0; iter < maxIter && haveBaseline && m_method == Method_LM; ++iter) {
+        if(isStopRequested()) break;
+        if (!residuals.isEmpty() && (currentSSE / residuals.size()) < 3e-3) break;
+
+        emit sigProgress(iter * 100 / maxIter);
+        QVector<QVector<double>> J = computeJacobian(currentParamMap, residuals, fitIndices);
+        if(isStopRequested()) break;
+        int nRes = residuals.size();
+
+        QVector<QVector<double>> H(nParams, QVector<double>(nParams, 0.0));
+        QVector<double> g(nParams, 0.0);
+        for(int k=0; k<nRes; ++k) {
+            for(int i=0; i<nParams; ++i) {
+                g[i] += J[k][i] * residuals[k];
+                for(int j=0; j<=i; ++j) H[i][j] += J[k][i] * J[k][j];
+            }
+        }
+        for(int i=0; i<nParams; ++i) for(int j=i+1; j<nParams; ++j) H[i][j] = H[j][i];
+
+        bool stepAccepted = false;
+        for(int tryIter=0; tryIter<5; ++tryIter) {
+            if(isStopRequested()) break;
+            QVector<QVector<double>> H_lm = H;
+            for(int i=0; i<nParams; ++i) H_lm[i][i] += lambda * (1.0 + std::abs(H[i][i]));
+            QVector<double> negG(nParams); for(int i=0;i<nParams;++i) negG[i] = -g[i];
+            QVector<double> delta = solveLinearSystem(H_lm, negG);
+
+            QMap<QString, double> trialMap = currentParamMap;
+            for(int i=0; i<nParams; ++i) {
+                int pIdx = fitIndices[i];
+                QString pName = m_params[pIdx].name;
+                double oldVal = currentParamMap[pName];
+                bool isLog = (oldVal > 1e-12 && pName != "S" && pName != "nf");
+                double newVal;
+                if(isLog) {
+                    double logVal = log10(oldVal) + delta[i];
+                    newVal = pow(10.0, logVal);
+                } else {
+                    newVal = oldVal + delta[i];
+                }
+                newVal = qMax(m_params[pIdx].min, qMin(newVal, m_params[pIdx].max));
+                trialMap[pName] = newVal;
+            }
+            trialMap = prepareParams(trialMap, m_iterationN);
+
+            QVector<double> newRes = calculateResiduals(trialMap);
+            if(isStopRequested()) break;
+            double newSSE = calculateSumSquaredError(newRes);
+            if(newSSE < currentSSE) {
+                currentSSE = newSSE; currentParamMap = trialMap; residuals = newRes; lambda /= 10.0; stepAccepted = true;
+                emitCurve(currentSSE/nRes, currentParamMap, m_iterationN, &m_token);
+                break;
+            } else { lambda *= 10.0; }
+        }
+        if(!stepAccepted && lambda > 1e10) break;
+    }
+
+    // 参数表中不保留内部使用的 N
+    currentParamMap.remove("N");
+    m_resultParams = currentParamMap;
+    m_resultError = haveBaseline ? currentSSE/residuals.size() : 0.0;
+    m_resultSSE = haveBaseline ? currentSSE : 0.0;
+    m_residualCount = haveBaseline ? residuals.size() : 0;
+    m_deadlineHit = !m_token.isCancelRequested() && m_token.isDeadlineReached();
+
+    // 正常结束时以高精度阶数重新计算最终曲线；停止或到达时限后不再做高阶反演:
+    // 最后发送的曲线即对应当前参数时直接沿用，否则以迭代阶数补算一次，没有可信结果时不计算
+    if(!isStopRequested()) {
+        m_resultCurve = emitCurve(m_resultError, currentParamMap, m_finalN);
+    } else if(haveBaseline && m_lastCurveParams == currentParamMap) {
+        m_resultCurve = m_lastCurve;
+        emit sigIterationUpdated(m_resultError, currentParamMap, std::get<0>(m_lastCurve), std::get<1>(m_lastCurve), std::get<2>(m_lastCurve));
+    } else if(haveBaseline) {
+        m_resultCurve = emitCurve(m_resultError, currentParamMap, m_iterationN);
+    }
+    emit finished();
+}
+
+ModelCurveData FitSession::evaluateCurve(const QMap<QString, double>& params)
+{
+    if(!m_modelManager || m_obsTime.isEmpty()) return ModelCurveData();
+    // 网格模式: 每次残差计算的拉普拉斯反演次数与实测点数无关
+    return m_modelManager->calculateTheoreticalCurveOnGrid(m_modelType, params, m_obsTime, &m_token);
+}
+
+QVector<double> FitSession::calculateResiduals(const QMap<QString, double>& params)
+{
+    ModelCurveData res = evaluateCurve(params);
+    return residualsFromCurve(m_obsPressure, m_obsDerivative, std::get<1>(res), std::get<2>(res), m_weight);
+}
+
+QVector<double> FitSession::residualsFromCurve(const QVector<double>& obsP, const QVector<double>& obsD,
+                                               const QVector<double>& pCal, const QVector<double>& dpCal, double weight)
+{
+    QVector<double> r; double wp = weight; double wd = 1.0 - weight;
+    int count = qMin(obsP.size(), pCal.size());
+    for(int i=0; i<count; ++i) {
+        if(obsP[i] > 1e-10 && pCal[i] > 1e-10) r.append( (log(obsP[i]) - log(pCal[i])) * wp ); else r.append(0.0);
+    }
+    int dCount = qMin(obsD.size(), dpCal.size()); dCount = qMin(dCount, count);
+    for(int i=0; i<dCount; ++i) {
+        if(obsD[i] > 1e-10 && dpCal[i] > 1e-10) r.append( (log(obsD[i]) - log(dpCal[i])) * wd ); else r.append(0.0);
+    }
+    return r;
+}
+
+bool FitSession::buildUnitBox(const QVector<int>& fitIndices, UnitBox& box) const
+{
+    const int d = fitIndices.size();
+    box.isLog.resize(d); box.lo.resize(d); box.hi.resize(d);
+    for(int j = 0; j < d; ++j) {
+        const FitParameter& fp = m_params[fitIndices[j]];
+        box.isLog[j] = fp.min > 0 && fp.name != "S" && fp.name != "nf";
+        box.lo[j] = box.isLog[j] ? log10(fp.min) : fp.min;
+        box.hi[j] = box.isLog[j] ? log10(fp.max) : fp.max;
+        if(!(box.hi[j] > box.lo[j])) return false;
+    }
+    return d > 0;
+}
+
+QVector<double> FitSession::toUnit(const UnitBox& box, const QVector<int>& fitIndices, const QMap<QString, double>& params) const
+{
+    QVector<double> u(fitIndices.size());
+    for(int j = 0; j < fitIndices.size(); ++j) {
+        const FitParameter& fp = m_params[fitIndices[j]];
+        double v = params.value(fp.name);
+        double s = box.isLog[j] ? log10(qMax(v, fp.min)) : v;
+        u[j] = qBound(0.0, (s - box.lo[j]) / (box.hi[j] - box.lo[j]), 1.0);
+    }
+    return u;
+}
+
+QMap<QString, double> FitSession::fromUnit(const UnitBox& box, const QVector<int>& fitIndices, const QMap<QString, double>& base, const QVector<double>& u) const
+{
+    QMap<QString, double> p = base;
+    for(int j = 0; j < fitIndices.size(); ++j) {
+        double s = box.lo[j] + u[j] * (box.hi[j] - box.lo[j]);
+        p[m_params[fitIndices[j]].name] = box.isLog[j] ? pow(10.0, s) : s;
+    }
+    return prepareParams(p, m_iterationN);
+}
+
+bool FitSession::bayesianSearch(const QVector<int>& fitIndices, QMap<QString, double>& params, QVector<double>& residuals, double& sse)
+{
+    UnitBox box;
+    if(!buildUnitBox(fitIndices, box)) return false;
+    const int d = fitIndices.size();
+    const QMap<QString, double> base = params;
+    // 初值评估与结束时的高阶曲线各计一次调用，其余全部用于搜索
+    const int budget = qMax(m_forwardBudget - 2, 0);
+    const int batchSize = qBound(1, QThread::idealThreadCount(), 8);
+
+    // 目标取 log SSE，动态范围更小，高斯过程更易拟合
+    BayesianOptimizer optimizer(d);
+    optimizer.addObservation(toUnit(box, fitIndices, base), log(qMax(sse, 1e-300)));
+
+    // 初始设计: 拉丁超立方
+    QVector<QVector<double>> batch = SurrogateModel::latinHypercube(qMin(budget, qMax(2 * d + 2, batchSize)), d, 20240601u);
+    int used = 0;
+    bool improved = false;
+    while(!batch.isEmpty() && !isStopRequested()) {
+        QVector<ModelCurveData> curves = QtConcurrent::blockingMapped<QVector<ModelCurveData>>(batch, [&](const QVector<double>& u) {
+            return evaluateCurve(fromUnit(box, fitIndices, base, u));
+        });
+        // 被中断的一批结果不完整，整批丢弃
+        if(isStopRequested()) break;
+        used += batch.size();
+
+        int bestIndex = -1;
+        for(int i = 0; i < batch.size(); ++i) {
+            QVector<double> r = residualsFromCurve(m_obsPressure, m_obsDerivative, std::get<1>(curves[i]), std::get<2>(curves[i]), m_weight);
+            if(r.size() != residuals.size()) continue;
+            double s = sumSquaredError(r);
+            if(!std::isfinite(s)) continue;
+            optimizer.addObservation(batch[i], log(qMax(s, 1e-300)));
+            if(s < sse) {
+                sse = s; residuals = r;
+                params = fromUnit(box, fitIndices, base, batch[i]);
+                bestIndex = i;
+                improved = true;
+            }
+        }
+        // 新的最优点直接显示已算出的曲线，不额外调用模型
+        if(bestIndex >= 0) publishCurve(sse/residuals.size(), params, curves[bestIndex]);
+        emit sigProgress(used * 100 / qMax(1, budget));
+
+        int remaining = budget - used;
+        if(remaining <= 0) break;
+        batch = optimizer.proposeBatch(qMin(batchSize, remaining));
+    }
+    return improved;
+}
+
+bool FitSession::surrogateGlobalSearch(const QVector<int>& fitIndices, QMap<QString, double>& params, QVector<double>& residuals, double& sse)
+{
+    const int nodeCount = 40;            // 代理模型输出的对数时间节点数
+    const int rounds = 3;                // 训练-寻优-确认轮数
+    const int confirmPerRound = 3;       // 每轮用真实模型确认的候选点数
+    const int candidateCount = 1000;     // 每轮在响应面上评估的随机候选点数
+
+    const int d = fitIndices.size();
+    double tMin = 0.0, tMax = 0.0;
+    for(double t : m_obsTime) {
+        if(t <= 0) continue;
+        if(tMin <= 0 || t < tMin) tMin = t;
+        if(t > tMax) tMax = t;
+    }
+    if(d == 0 || tMin <= 0 || !(tMax > tMin) || m_obsTime.size() < 8) return false;
+
+    UnitBox box;
+    if(!buildUnitBox(fitIndices, box)) return false;
+    const QMap<QString, double> base = params;
+    QVector<double> startUnit = toUnit(box, fitIndices, base);
+    auto toParams = [&](const QVector<double>& u) { return fromUnit(box, fitIndices, base, u); };
+
+    QVector<double> nodeT(nodeCount), logNode(nodeCount), logObs(m_obsTime.size());
+    for(int i = 0; i < nodeCount; ++i) {
+        logNode[i] = log10(tMin) + (log10(tMax) - log10(tMin)) * i / (nodeCount - 1);
+        nodeT[i] = pow(10.0, logNode[i]);
+    }
+    for(int i = 0; i < m_obsTime.size(); ++i) logObs[i] = log10(qMax(m_obsTime[i], 1e-300));
+
+    // 一次真实计算同时给出: 节点上的 log10 压力/导数 (训练数据) 与实测点上的残差 (真实误差)
+    struct Sample { QVector<double> u; QVector<double> y; QVector<double> residuals; double sse = 0.0; bool valid = false; };
+    auto forward = [&](const QVector<double>& u) -> Sample {
+        Sample s; s.u = u;
+        if(isStopRequested()) return s;
+        QMap<QString, double> p = toParams(u);
+        double tScale = ModelWidget01_06::dimensionlessTimeScale(p);
+        if(!(tScale > 0) || std::isinf(tScale)) return s;
+        QVector<double> gx, gy;
+        m_modelManager->buildDimensionlessGrid(m_modelType, p, log10(tMin * tScale) - 0.05, log10(tMax * tScale) + 0.05, gx, gy, &m_token);
+        if(isStopRequested() || gx.size() < 2) return s;
+        ModelCurveData nodes = m_modelManager->curveFromDimensionlessGrid(m_modelType, p, gx, gy, nodeT);
+        ModelCurveData obs = m_modelManager->curveFromDimensionlessGrid(m_modelType, p, gx, gy, m_obsTime);
+        s.y.reserve(2 * nodeCount);
+        for(double v : std::get<1>(nodes)) s.y.append(log10(qMax(v, 1e-10)));
+        for(double v : std::get<2>(nodes)) s.y.append(log10(qMax(v, 1e-10)));
+        s.residuals = residualsFromCurve(m_obsPressure, m_obsDerivative, std::get<1>(obs), std::get<2>(obs), m_weight);
+        s.sse = sumSquaredError(s.residuals);
+        s.valid = s.residuals.size() == residuals.size() && std::isfinite(s.sse);
+        return s;
+    };
+
+    SurrogateModel model;
+    auto surrogateSSE = [&](const QVector<double>& u) -> double {
+        QVector<double> y = model.predict(u);
+        QVector<double> lp = CurveInterpolator::monotoneCubic(logNode, y.mid(0, nodeCount), logObs);
+        QVector<double> ld = CurveInterpolator::monotoneCubic(logNode, y.mid(nodeCount), logObs);
+        QVector<double> pCal(m_obsTime.size()), dCal(m_obsTime.size());
+        for(int i = 0; i < m_obsTime.size(); ++i) {
+            bool valid = m_obsTime[i] > 0;
+            pCal[i] = valid ? pow(10.0, lp[i]) : 0.0;
+            dCal[i] = valid ? pow(10.0, ld[i]) : 0.0;
+        }
+        return sumSquaredError(residualsFromCurve(m_obsPressure, m_obsDerivative, pCal, dCal, m_weight));
+    };
+    // 响应面上的坐标模式搜索
+    auto localSearch = [&](QVector<double> u) {
+        double f = surrogateSSE(u);
+        for(double step = 0.1; step > 1e-3; ) {
+            bool improved = false;
+            for(int k = 0; k < d; ++k) {
+                for(double sgn : { -1.0, 1.0 }) {
+                    QVector<double> v = u; v[k] = qBound(0.0, u[k] + sgn * step, 1.0);
+                    double fv = surrogateSSE(v);
+                    if(fv < f) { u = v; f = fv; improved = true; }
+                }
+            }
+            if(!improved) step *= 0.5;
+        }
+        return u;
+    };
+
+    // 初始样本: 拉丁超立方 + 当前初值，并行计算
+    int sampleCount = qBound(20, 10 * d, 120);
+    QVector<QVector<double>> units = SurrogateModel::latinHypercube(sampleCount - 1, d, 20240601u);
+    units.prepend(startUnit);
+    QVector<Sample> samples = QtConcurrent::blockingMapped<QVector<Sample>>(units, forward);
+
+    Sample best; best.sse = sse;
+    QVector<QVector<double>> X, Y;
+    auto absorb = [&](const QVector<Sample>& batch) {
+        for(const Sample& s : batch) {
+            if(!s.valid) continue;
+            X.append(s.u); Y.append(s.y);
+            if(s.sse < best.sse) best = s;
+        }
+    };
+    absorb(samples);
+
+    for(int round = 0; round < rounds && !isStopRequested(); ++round) {
+        emit sigProgress(round * 100 / rounds);
+        if(!model.train(X, Y)) break;
+
+        // 全局: 大量随机候选点只在响应面上评估
+        QVector<QVector<double>> cand = SurrogateModel::latinHypercube(candidateCount, d, 7919u * (round + 1));
+        if(best.valid) cand.append(best.u);
+        QVector<QPair<double, int>> ranked;
+        for(int i = 0; i < cand.size(); ++i) ranked.append(qMakePair(surrogateSSE(cand[i]), i));
+        std::sort(ranked.begin(), ranked.end(), [](const QPair<double, int>& a, const QPair<double, int>& b) { return a.first < b.first; });
+
+        // 取互不相近的前几名做局部精化，再用真实模型并行确认
+        QVector<QVector<double>> picks;
+        for(const auto& r : ranked) {
+            if(picks.size() >= confirmPerRound) break;
+            QVector<double> u = localSearch(cand[r.second]);
+            bool distinct = true;
+            for(const auto& q : picks) {
+                double dist = 0.0; for(int k = 0; k < d; ++k) dist += (u[k] - q[k]) * (u[k] - q[k]);
+                if(std::sqrt(dist) < 0.02) { distinct = false; break; }
+            }
+            if(distinct) picks.append(u);
+        }
+        absorb(QtConcurrent::blockingMapped<QVector<Sample>>(picks, forward));
+    }
+
+    if(isStopRequested() || !best.valid || !(best.sse < sse)) return false;
+    params = toParams(best.u);
+    residuals = best.residuals;
+    sse = best.sse;
+    return true;
+}
+
+QVector<QVector<double>> FitSession::computeJacobian(const QMap<QString, double>& params, const QVector<double>& baseResiduals, const QVector<int>& fitIndices)
+{
+    int nRes = baseResiduals.size(); int nParams = fitIndices.size();
+    QVector<QVector<double>> J(nRes, QVector<double>(nParams));
+    for(int j = 0; j < nParams; ++j) {
+        if(isStopRequested()) break;
+        int idx = fitIndices[j]; QString pName = m_params[idx].name;
+        double val = params.value(pName); bool isLog = (val > 1e-12 && pName != "S" && pName != "nf");
+        double h; QMap<QString, double> pPlus = params; QMap<QString, double> pMinus = params;
+        if(isLog) { h = 0.01; double valLog = log10(val); pPlus[pName] = pow(10.0, valLog + h); pMinus[pName] = pow(10.0, valLog - h); }
+        else { h = 1e-4; pPlus[pName] = val + h; pMinus[pName] = val - h; }
+        if(pName == "L" || pName == "Lf") { pPlus = prepareParams(pPlus, m_iterationN); pMinus = prepareParams(pMinus, m_iterationN); }
+        QVector<double> rPlus = calculateResiduals(pPlus);
+        QVector<double> rMinus = calculateResiduals(pMinus);
+        if(rPlus.size() == nRes && rMinus.size() == nRes) {
+            for(int i=0; i<nRes; ++i) J[i][j] = (rPlus[i] - rMinus[i]) / (2.0 * h);
+        }
+    }
+    return J;
+}
+
+QVector<double> FitSession::solveLinearSystem(const QVector<QVector<double>>& A, const QVector<double>& b)
+{
+    int n = b.size(); if (n == 0) return QVector<double>();
+    Eigen::MatrixXd matA(n, n); Eigen::VectorXd vecB(n);
+    for (int i = 0; i < n; ++i) { vecB(i) = b[i]; for (int j = 0; j < n; ++j) matA(i, j) = A[i][j]; }
+    Eigen::VectorXd x = matA.ldlt().solve(vecB);
+    QVector<double> res(n); for (int i = 0; i < n; ++i) res[i] = x(i);
+    return res;
+}
+
+double FitSession::calculateSumSquaredError(const QVector<double>& residuals)
+{
+    return sumSquaredError(residuals);
+}
+
+double FitSession::sumSquaredError(const QVector<double>& residuals)
+{
+    double sse = 0.0; for(double v : residuals) sse += v*v; return sse;
+}
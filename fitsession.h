@@ -0,0 +1,149 @@
+/*
+ * fitsession.h
+ * 文件作用：单次拟合会话类头文件
+ * 功能描述：
+ * 1. 一次拟合所需的全部状态 (模型类型、参数、权重、观测数据快照、反演精度) 均由会话自身持有
+ * 2. 实现 Levenberg-Marquardt 非线性回归，可在工作线程中运行
+ * 3. 通过取消令牌支持跨线程停止请求与限时拟合，通过信号输出迭代进度
+ * 4. 不修改 ModelManager 中共享模型对象的任何状态，多个会话可同时运行
+ */
+
+#ifndef FITSESSION_H
+#define FITSESSION_H
+
+#include <QObject>
+#include <QMap>
+#include <QVector>
+#include <QList>
+#include "modelmanager.h"
+#include "fittingparameterchart.h"
+#include "cancellationtoken.h"
+
+class FitSession : public QObject
+{
+    Q_OBJECT
+
+public:
+    // 拟合方法
+    enum FitMethod {
+        Method_LM = 0,   // Levenberg-Marquardt 迭代
+        Method_Bayesian  // 高斯过程贝叶斯优化，真实模型调用次数受硬上限约束
+    };
+
+    explicit FitSession(ModelManager* modelManager, QObject* parent = nullptr);
+
+    // --- 会话配置 (须在 run() 之前于主线程设置) ---
+    void setModelType(ModelManager::ModelType type);
+    void setParameters(const QList<FitParameter>& params);
+    void setWeight(double weight);
+    // 复制一份观测数据快照，拟合过程中界面数据的变化不会影响本会话
+    void setObservedData(const QVector<double>& t, const QVector<double>& p, const QVector<double>& d);
+    // 迭代阶段与最终曲线使用的 Stehfest 阶数
+    void setStehfestOrder(int iterationN, int finalN);
+    // 时间预算 (毫秒)，<= 0 表示不限时；从 run() 开始计时，到达时限后返回当前最优参数
+    void setTimeBudget(qint64 msecs);
+    // LM 迭代前先用代理模型做全局搜索，以得到更好的初值 (贝叶斯优化模式下不启用)
+    void setSurrogateSearch(bool enabled);
+    void setMethod(FitMethod method);
+    // 贝叶斯优化的真实模型调用次数上限 (含初值评估与最终曲线)
+    void setForwardBudget(int calls);
+
+    // 执行拟合 (阻塞，通常在 QtConcurrent 工作线程中调用)
+    void run();
+
+    // 请求停止 (任意线程可调用)
+    void requestStop();
+    // 是否应当停止 (用户停止或到达时间预算)
+    bool isStopRequested() const;
+    // 本次拟合是否因到达时间预算而结束
+    bool isDeadlineReached() const;
+
+    // 拟合结果
+    ModelManager::ModelType modelType() const;
+    QMap<QString, double> resultParameters() const;
+    double resultError() const;       // 均方误差 SSE/n
+    double resultSSE() const;         // 残差平方和
+    int residualCount() const;        // 残差个数 n
+    int fittedParameterCount() const; // 参与拟合的参数个数 k
+    ModelCurveData resultCurve() const;
+
+    // 由理论曲线计算加权对数残差 (压力残差在前，导数残差在后)；拟合与目标函数分布图共用
+    static QVector<double> residualsFromCurve(const QVector<double>& obsP, const QVector<double>& obsD,
+                                              const QVector<double>& pCal, const QVector<double>& dpCal, double weight);
+    // 残差平方和
+    static double sumSquaredError(const QVector<double>& residuals);
+
+signals:
+    // 迭代更新信号 (误差、当前参数、理论曲线)
+    void sigIterationUpdated(double error, QMap<QString, double> currentParams, QVector<double> t, QVector<double> p, QVector<double> d);
+    // 进度信号
+    void sigProgress(int progress);
+    // 会话结束信号
+    void finished();
+
+private:
+    // 在参数表中写入 Stehfest 阶数和依赖参数 LfD
+    QMap<QString, double> prepareParams(const QMap<QString, double>& params, int N) const;
+    // 在实测时刻上计算理论曲线 (网格模式)
+    ModelCurveData evaluateCurve(const QMap<QString, double>& params);
+    // 计算残差
+    QVector<double> calculateResiduals(const QMap<QString, double>& params);
+    // 计算雅可比矩阵
+    QVector<QVector<double>> computeJacobian(const QMap<QString, double>& params, const QVector<double>& residuals, const QVector<int>& fitIndices);
+    // 求解线性方程组 (Eigen)
+    QVector<double> solveLinearSystem(const QVector<QVector<double>>& A, const QVector<double>& b);
+    // 计算平方误差和
+    double calculateSumSquaredError(const QVector<double>& residuals);
+    // 拟合参数与 [0,1] 超立方体之间的映射: 正值参数在 log10 空间归一化
+    struct UnitBox { QVector<bool> isLog; QVector<double> lo, hi; };
+    bool buildUnitBox(const QVector<int>& fitIndices, UnitBox& box) const;
+    QVector<double> toUnit(const UnitBox& box, const QVector<int>& fitIndices, const QMap<QString, double>& params) const;
+    QMap<QString, double> fromUnit(const UnitBox& box, const QVector<int>& fitIndices, const QMap<QString, double>& base, const QVector<double>& u) const;
+
+    // 代理模型全局搜索: 抽样训练 RBF 响应面，在响应面上寻优后以真实模型确认
+    // params/residuals/sse 为输入初值，找到更优点时原地更新并返回 true
+    bool surrogateGlobalSearch(const QVector<int>& fitIndices, QMap<QString, double>& params, QVector<double>& residuals, double& sse);
+    // 贝叶斯优化 (代替 LM 迭代)，参数语义同 surrogateGlobalSearch
+    bool bayesianSearch(const QVector<int>& fitIndices, QMap<QString, double>& params, QVector<double>& residuals, double& sse);
+    // 计算并发送当前参数对应的理论曲线；传入令牌且计算被中断时不发送
+    ModelCurveData emitCurve(double error, const QMap<QString, double>& params, int N, const CancellationToken* token = nullptr);
+    // 发送已算好的曲线，不再调用模型
+    void publishCurve(double error, const QMap<QString, double>& params, const ModelCurveData& curve);
+
+private:
+    ModelManager* m_modelManager;
+    ModelManager::ModelType m_modelType;
+    QList<FitParameter> m_params;
+    double m_weight;
+
+    // 观测数据快照
+    QVector<double> m_obsTime;
+    QVector<double> m_obsPressure;
+    QVector<double> m_obsDerivative;
+
+    // 本会话的反演精度
+    int m_iterationN;
+    int m_finalN;
+    bool m_useSurrogate;
+    FitMethod m_method;
+    int m_forwardBudget;
+    qint64 m_timeBudget;   // 毫秒，run() 开始时才启动计时
+
+    // 取消令牌，向下传递到反演循环
+    CancellationToken m_token;
+
+    // 结果
+    QMap<QString, double> m_resultParams;
+    double m_resultError;
+    double m_resultSSE;
+    int m_residualCount;
+    int m_fittedCount;
+    ModelCurveData m_resultCurve;
+    bool m_deadlineHit;
+
+    // 最近一次发送的曲线及其参数，停止后据此避免重复反演
+    ModelCurveData m_lastCurve;
+    QMap<QString, double> m_lastCurveParams;
+};
+
+#endif // FITSESSION_H
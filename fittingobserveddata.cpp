@@ -1,5 +1,6 @@
 #include "fittingobserveddata.h"
 #include "pressurederivativecalculator.h"
+#include "derivativesmoother.h"
 
 #include <QFileDialog>
 #include <QFile>
@@ -53,6 +54,7 @@ FittingDataLoadDialog::FittingDataLoadDialog(const QList<QStringList>& previewDa
     grid->addWidget(new QLabel("导数列:",this), 1, 0); m_comboDeriv = new QComboBox(this); m_comboDeriv->addItem("自动计算 (Bourdet)",-1); m_comboDeriv->addItems(opts); grid->addWidget(m_comboDeriv, 1, 1);
     grid->addWidget(new QLabel("跳过首行数:",this), 1, 2); m_comboSkipRows = new QComboBox(this); for(int i=0;i<=20;++i) m_comboSkipRows->addItem(QString::number(i),i); m_comboSkipRows->setCurrentIndex(1); grid->addWidget(m_comboSkipRows, 1, 3);
     grid->addWidget(new QLabel("压力数据类型:",this), 2, 0); m_comboPressureType = new QComboBox(this); m_comboPressureType->addItem("原始压力 (自动计算压差 |P-Pi|)", 0); m_comboPressureType->addItem("压差数据 (直接使用 ΔP)", 1); grid->addWidget(m_comboPressureType, 2, 1, 1, 3);
+    grid->addWidget(new QLabel("导数平滑:",this), 3, 0); m_comboSmooth = new QComboBox(this); m_comboSmooth->addItems(DerivativeSmoothingConfig::methodNames()); m_comboSmooth->setToolTip("仅作用于自动计算的 Bourdet 导数"); grid->addWidget(m_comboSmooth, 3, 1, 1, 3);
 
     layout->addWidget(grp);
     QHBoxLayout* btns = new QHBoxLayout; QPushButton* ok = new QPushButton("确定",this); QPushButton* cancel = new QPushButton("取消",this);
@@ -65,6 +67,11 @@ int FittingDataLoadDialog::getPressureColumnIndex() const { return m_comboPressu
 int FittingDataLoadDialog::getDerivativeColumnIndex() const { return m_comboDeriv->currentIndex()-1; }
 int FittingDataLoadDialog::getSkipRows() const { return m_comboSkipRows->currentData().toInt(); }
 int FittingDataLoadDialog::getPressureDataType() const { return m_comboPressureType->currentData().toInt(); }
+DerivativeSmoothingConfig FittingDataLoadDialog::getSmoothingConfig() const {
+    DerivativeSmoothingConfig config;
+    config.method = (DerivativeSmoothingConfig::Method)m_comboSmooth->currentIndex();
+    return config;
+}
 
 // ===========================================================================
 // FittingObservedData 实现
@@ -142,6 +149,7 @@ bool FittingObservedData::loadDataFromFile(QWidget* parentWidget)
         }
     } else {
         m_obsDerivative = PressureDerivativeCalculator::calculateBourdetDerivative(m_obsTime, m_obsPressure, 0.15);
+        m_obsDerivative = DerivativeSmoother::apply(m_obsTime, m_obsDerivative, dlg.getSmoothingConfig());
     }
 
     return true;
@@ -6,6 +6,7 @@
 #include <QVector>
 #include <QTableWidget>
 #include <QComboBox>
+#include "derivativesmoother.h"
 
 // ===========================================================================
 // 数据加载对话框 (从 fittingwidget.h 移动至此)
@@ -19,9 +20,10 @@ public:
     int getDerivativeColumnIndex() const;
     int getSkipRows() const;
     int getPressureDataType() const;
+    DerivativeSmoothingConfig getSmoothingConfig() const;
 private:
     QTableWidget* m_previewTable;
-    QComboBox *m_comboTime, *m_comboPressure, *m_comboDeriv, *m_comboSkipRows, *m_comboPressureType;
+    QComboBox *m_comboTime, *m_comboPressure, *m_comboDeriv, *m_comboSkipRows, *m_comboPressureType, *m_comboSmooth;
     void validateSelection();
 };
 
@@ -2,6 +2,7 @@
 #include "ui_fittingpage.h" // 【关键】必须包含这个由 uic 自动生成的头文件
 #include "wt_fittingwidget.h" // 【关键】引用改名后的拟合控件头文件
 #include "modelparameter.h"
+#include "jointfitdialog.h"
 #include <QInputDialog>
 #include <QMessageBox>
 #include <QJsonArray>
@@ -34,6 +35,8 @@ void FittingPage::setObservedDataToCurrent(const QVector<double> &t, const QVect
 {
     FittingWidget* current = qobject_cast<FittingWidget*>(ui->tabWidget->currentWidget());
     if (current) {
+        // 流动段分析页保留自己的数据
+        if (current->isObservedDataLocked()) return;
         current->setObservedData(t, p, d);
     } else {
         // 如果当前没有页签，先创建一个
@@ -43,6 +46,13 @@ void FittingPage::setObservedDataToCurrent(const QVector<double> &t, const QVect
     }
 }
 
+void FittingPage::addObservedDataAnalysis(const QString &name, const QVector<double> &t, const QVector<double> &p, const QVector<double> &d)
+{
+    FittingWidget* w = createNewTab(generateUniqueName(name));
+    w->setObservedData(t, p, d);
+    w->setObservedDataLocked(true);
+}
+
 void FittingPage::updateBasicParameters()
 {
     for(int i = 0; i < ui->tabWidget->count(); ++i) {
@@ -146,6 +156,39 @@ void FittingPage::on_btnDeleteAnalysis_clicked()
     }
 }
 
+void FittingPage::on_btnJointFit_clicked()
+{
+    if(!m_modelManager) return;
+
+    // 收集已加载观测数据的分析页
+    QList<FittingWidget*> widgets;
+    QList<JointFitDataset> datasets;
+    for(int i=0; i<ui->tabWidget->count(); ++i) {
+        FittingWidget* w = qobject_cast<FittingWidget*>(ui->tabWidget->widget(i));
+        if(!w || !w->hasObservedData()) continue;
+        if(w->isFitting()) {
+            QMessageBox::warning(this, "提示", QString("分析页 \"%1\" 正在拟合，请先停止。").arg(ui->tabWidget->tabText(i)));
+            return;
+        }
+        JointFitDataset ds = w->jointFitDataset();
+        ds.name = ui->tabWidget->tabText(i);
+        datasets.append(ds);
+        widgets.append(w);
+    }
+    if(datasets.size() < 2) {
+        QMessageBox::warning(this, "提示", "联合拟合至少需要两个已加载观测数据的分析页。");
+        return;
+    }
+
+    JointFitDialog dlg(m_modelManager, datasets, this);
+    if(dlg.exec() != QDialog::Accepted) return;
+    JointFitResult res = dlg.result();
+    QVector<int> used = dlg.usedDatasets();
+    for(int j=0; j<used.size() && j<res.params.size(); ++j) {
+        widgets[used[j]]->applyFittedParameters(res.params[j]);
+    }
+}
+
 void FittingPage::saveAllFittingStates()
 {
     QJsonArray analysesArray;
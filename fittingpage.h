@@ -27,6 +27,9 @@ public:
     // 接收来自 MainWindow 的数据，传递给当前激活的 FittingWidget
     void setObservedDataToCurrent(const QVector<double>& t, const QVector<double>& p, const QVector<double>& d);
 
+    // 新建一个载入给定观测数据的分析页 (数据锁定，不随数据页刷新)，如流动段自动划分的结果
+    void addObservedDataAnalysis(const QString& name, const QVector<double>& t, const QVector<double>& p, const QVector<double>& d);
+
     // 初始化/重置基本参数
     void updateBasicParameters();
 
@@ -40,6 +43,7 @@ private slots:
     void on_btnNewAnalysis_clicked();
     void on_btnRenameAnalysis_clicked();
     void on_btnDeleteAnalysis_clicked();
+    void on_btnJointFit_clicked();
     void onChildRequestSave();
 
 private:
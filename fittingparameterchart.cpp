@@ -55,11 +55,7 @@ void FittingParameterChart::resetParams(ModelManager::ModelType type)
         p.value = it.value();
         p.isFit = false; // 默认不拟合
 
-        if (p.value > 0) {
-            p.min = p.value * 0.01; p.max = p.value * 100.0;
-        } else {
-            p.min = 0.0; p.max = 100.0;
-        }
+        defaultBounds(p.name, p.value, p.min, p.max);
 
         QString symbol, uniSym, unit;
         getParamDisplayInfo(p.name, p.displayName, symbol, uniSym, unit);
@@ -69,6 +65,17 @@ void FittingParameterChart::resetParams(ModelManager::ModelType type)
     refreshParamTable();
 }
 
+void FittingParameterChart::defaultBounds(const QString& name, double value, double& min, double& max)
+{
+    if (name == "S") {
+        min = -10.0; max = 100.0;
+    } else if (value > 0) {
+        min = value * 0.01; max = value * 100.0;
+    } else {
+        min = 0.0; max = 100.0;
+    }
+}
+
 QList<FitParameter> FittingParameterChart::getParameters() const
 {
     return m_params;
@@ -48,6 +48,9 @@ public:
     // 静态辅助函数：获取规范的参数显示信息
     static void getParamDisplayInfo(const QString& name, QString& chName, QString& symbol, QString& uniSymbol, QString& unit);
 
+    // 静态辅助函数：参数的默认拟合上下限 (表皮系数可为负，取有符号区间)
+    static void defaultBounds(const QString& name, double value, double& min, double& max);
+
 private:
     QTableWidget* m_table;
     ModelManager* m_modelManager;
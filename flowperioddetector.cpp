@@ -0,0 +1,263 @@
+/*
+ * flowperioddetector.cpp
+ * 文件作用：长期压力计记录的流动段自动划分实现文件
+ * 功能描述：
+ * 1. 二分分割: 段 [a, b) 的代价为 Σq² - (Σq)²/(b - a)，最优切分点一次扫描求得；
+ *    收益超过惩罚才切分，每层总扫描量 O(n)，层数 O(log n)
+ * 2. 惩罚下限按产量容差换算，避免无噪声的计量产量被无限细分
+ * 3. 斜率窗口拟合以当前点为原点，避免长记录上时间平方和的数值抵消
+ */
+
+#include "flowperioddetector.h"
+#include "derivativeengine.h"
+
+#include <QtGlobal>
+#include <QPair>
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace {
+
+// 中位数 (会重排输入)
+double medianOf(QVector<double>& v)
+{
+    if (v.isEmpty()) return 0.0;
+    const int mid = v.size() / 2;
+    std::nth_element(v.begin(), v.begin() + mid, v.end());
+    return v[mid];
+}
+
+// 非极大值抑制: 阈值以上、半径 radius 内得分最高的点 (得分相同时取靠前者)
+QVector<int> pickPeaks(const QVector<double>& score, double threshold, int radius)
+{
+    QVector<int> order;
+    for (int i = 0; i < score.size(); ++i) if (score[i] > threshold) order.append(i);
+    std::stable_sort(order.begin(), order.end(), [&score](int a, int b) { return score[a] > score[b]; });
+
+    // 按得分从高到低贪心选取，已选点半径内的点不再入选
+    QVector<int> picked;
+    QVector<bool> blocked(score.size(), false);
+    for (int i : order) {
+        if (blocked[i]) continue;
+        picked.append(i);
+        for (int j = qMax(0, i - radius); j <= qMin(score.size() - 1, i + radius); ++j) blocked[j] = true;
+    }
+    std::sort(picked.begin(), picked.end());
+    return picked;
+}
+
+} // namespace
+
+QString FlowPeriod::kindName(Kind kind)
+{
+    return kind == ShutIn ? QString("关井恢复") : QString("生产压降");
+}
+
+double FlowPeriodDetector::noiseSigma(const QVector<double>& y, int differenceOrder)
+{
+    // k 阶差分的方差为噪声方差的 C(2k, k) 倍: 1 阶 2 倍，2 阶 6 倍
+    QVector<double> diff;
+    if (differenceOrder <= 1) {
+        for (int i = 1; i < y.size(); ++i) diff.append(y[i] - y[i - 1]);
+    } else {
+        for (int i = 2; i < y.size(); ++i) diff.append(y[i] - 2.0 * y[i - 1] + y[i - 2]);
+    }
+    if (diff.isEmpty()) return 0.0;
+    QVector<double> absDiff = diff;
+    for (double& v : absDiff) v = std::abs(v);
+    const double mad = medianOf(absDiff) / 0.6745;
+    return mad / std::sqrt(differenceOrder <= 1 ? 2.0 : 6.0);
+}
+
+QVector<int> FlowPeriodDetector::rateChangePoints(const QVector<double>& q, double penalty, int minPoints,
+                                                  const CancellationToken* token)
+{
+    const int n = q.size();
+    const int minLen = qMax(minPoints, 1);
+    QVector<double> s1(n + 1, 0.0), s2(n + 1, 0.0);
+    for (int i = 0; i < n; ++i) { s1[i + 1] = s1[i] + q[i]; s2[i + 1] = s2[i] + q[i] * q[i]; }
+    auto cost = [&](int a, int b) {
+        const double sum = s1[b] - s1[a];
+        return (s2[b] - s2[a]) - sum * sum / (b - a);
+    };
+
+    // 显式栈代替递归
+    QVector<int> changes;
+    QVector<QPair<int, int>> stack;
+    stack.append(qMakePair(0, n));
+    while (!stack.isEmpty()) {
+        if (CancellationToken::cancelled(token)) return QVector<int>();
+        const QPair<int, int> seg = stack.takeLast();
+        const int a = seg.first, b = seg.second;
+        if (b - a < 2 * minLen) continue;
+
+        const double whole = cost(a, b);
+        double bestGain = 0.0;
+        int best = -1;
+        for (int s = a + minLen; s <= b - minLen; ++s) {
+            const double gain = whole - cost(a, s) - cost(s, b);
+            if (gain > bestGain) { bestGain = gain; best = s; }
+        }
+        if (best < 0 || bestGain <= penalty) continue;
+        changes.append(best);
+        stack.append(qMakePair(a, best));
+        stack.append(qMakePair(best, b));
+    }
+    std::sort(changes.begin(), changes.end());
+    return changes;
+}
+
+QVector<double> FlowPeriodDetector::slopeBreakScore(const QVector<double>& t, const QVector<double>& p, int window,
+                                                    const CancellationToken* token)
+{
+    const int n = qMin(t.size(), p.size());
+    QVector<double> score(n, 0.0);
+    const int w = qMax(window, 2);
+    if (n < 2 * w + 1) return score;
+
+    // 斜率标准差由压力噪声 (二阶差分估计，不受线性趋势影响) 和窗口内时间离散度换算
+    const double sigma = noiseSigma(p.mid(0, n), 2);
+
+    // 以 t[i] 为原点的单侧窗口最小二乘斜率及其方差因子 1/Σ(t - t̄)²
+    auto fit = [&](int from, int to, int origin, double& slope, double& inverseSpread) {
+        double st = 0, sp = 0, stt = 0, stp = 0;
+        const int m = to - from + 1;
+        for (int j = from; j <= to; ++j) {
+            const double u = t[j] - t[origin];
+            st += u; sp += p[j]; stt += u * u; stp += u * p[j];
+        }
+        const double spread = stt - st * st / m;
+        if (!(spread > 0)) { slope = 0; inverseSpread = std::numeric_limits<double>::infinity(); return; }
+        slope = (stp - st * sp / m) / spread;
+        inverseSpread = 1.0 / spread;
+    };
+
+    for (int i = w; i < n - w; ++i) {
+        if ((i & 1023) == 0 && CancellationToken::cancelled(token)) return QVector<double>();
+        double sL, vL, sR, vR;
+        fit(i - w, i, i, sL, vL);
+        fit(i, i + w, i, sR, vR);
+        const double noise = sigma * std::sqrt(vL + vR);
+        double value = (noise > 0) ? std::abs(sR - sL) / noise
+                                   : (sR != sL ? std::numeric_limits<double>::max() : 0.0);
+        if (!std::isfinite(vL) || !std::isfinite(vR)) value = 0.0;
+        // 开关井时压力趋势反转；同号只说明斜率变化，标记为负
+        score[i] = (sL * sR < 0) ? value : -value;
+    }
+    return score;
+}
+
+QVector<FlowPeriod> FlowPeriodDetector::detect(const QVector<double>& tIn, const QVector<double>& pIn, const QVector<double>& qIn,
+                                               const FlowPeriodConfig& config, const CancellationToken* token)
+{
+    const bool hasRate = !qIn.isEmpty();
+    int n = qMin(tIn.size(), pIn.size());
+    if (hasRate) n = qMin(n, qIn.size());
+    QVector<FlowPeriod> periods;
+    if (n < 2) return periods;
+
+    // 1. 按时间排序 (已有序时跳过)
+    QVector<int> order(n);
+    for (int i = 0; i < n; ++i) order[i] = i;
+    bool sorted = true;
+    for (int i = 1; i < n && sorted; ++i) sorted = tIn[i] >= tIn[i - 1];
+    if (!sorted) std::stable_sort(order.begin(), order.end(), [&tIn](int a, int b) { return tIn[a] < tIn[b]; });
+    QVector<double> t(n), p(n), q(hasRate ? n : 0);
+    for (int i = 0; i < n; ++i) {
+        t[i] = tIn[order[i]];
+        p[i] = pIn[order[i]];
+        if (hasRate) q[i] = qIn[order[i]];
+    }
+
+    const int minLen = qMax(config.minPoints, 2);
+    const int w = qMax(config.slopeWindow, 2);
+    const QVector<double> score = slopeBreakScore(t, p, w, token);
+    if (CancellationToken::cancelled(token)) return periods;
+
+    // 2. 分界点: 段 k 为 (c[k-1], c[k]]，c 为上一段最后一点的序号
+    QVector<int> cuts;
+    double qMaxAbs = 0.0;
+    if (hasRate) {
+        for (double v : q) qMaxAbs = qMax(qMaxAbs, std::abs(v));
+        const double sigma = noiseSigma(q);
+        const double step = config.rateTolerance * qMaxAbs;
+        // 惩罚下限: 两侧各 minPoints 点、产量差为容差时的切分收益
+        const double penalty = qMax(config.sensitivity * sigma * sigma * std::log(double(n)), 0.5 * minLen * step * step);
+        const QVector<int> changes = rateChangePoints(q, penalty, minLen, token);
+        if (CancellationToken::cancelled(token)) return periods;
+
+        // 产量变点校准到附近最显著的压力拐点 (产量记录常滞后或按时段汇总)
+        for (int s : changes) {
+            int cut = s - 1;
+            double best = config.slopeThreshold;
+            for (int j = qMax(0, s - 1 - w); j <= qMin(n - 1, s - 1 + w); ++j) {
+                if (std::abs(score[j]) > best) { best = std::abs(score[j]); cut = j; }
+            }
+            if (cut >= 0 && (cuts.isEmpty() || cut - cuts.last() >= minLen)) cuts.append(cut);
+        }
+    } else {
+        cuts = pickPeaks(score, config.slopeThreshold, qMax(w, minLen));
+    }
+
+    // 3. 组装流动段；无产量列时按段内压力趋势判断开关井
+    QVector<double> rateSum(n + 1, 0.0);
+    if (hasRate) for (int i = 0; i < n; ++i) rateSum[i + 1] = rateSum[i] + q[i];
+    QVector<int> bounds;
+    bounds.append(0);
+    for (int c : cuts) if (c > bounds.last() && c < n - 1) bounds.append(c);
+    bounds.append(n - 1);
+
+    for (int k = 0; k + 1 < bounds.size(); ++k) {
+        const int a = bounds[k], b = bounds[k + 1];   // 段点为 (a, b]，首段含第 0 点
+        const int first = (k == 0) ? 0 : a + 1;
+        FlowPeriod period;
+        period.startTime = t[a];
+        period.endTime = t[b];
+        period.referencePressure = p[a];
+        period.pointCount = b - first + 1;
+        if (hasRate) {
+            period.rate = (rateSum[b + 1] - rateSum[first]) / period.pointCount;
+            period.kind = (std::abs(period.rate) <= config.rateTolerance * qMaxAbs) ? FlowPeriod::ShutIn : FlowPeriod::Drawdown;
+        } else {
+            period.kind = (p[b] > p[a]) ? FlowPeriod::ShutIn : FlowPeriod::Drawdown;
+        }
+        periods.append(period);
+    }
+
+    // 4. 相邻同类且产量相近的段合并 (二分分割可能把渐变产量切成多段)
+    QVector<FlowPeriod> merged;
+    for (const FlowPeriod& period : periods) {
+        if (!merged.isEmpty()) {
+            FlowPeriod& last = merged.last();
+            bool similar = last.kind == period.kind &&
+                           (!hasRate || std::abs(last.rate - period.rate) <= config.rateTolerance * qMaxAbs);
+            if (similar && hasRate) {
+                const int count = last.pointCount + period.pointCount;
+                last.rate = (last.rate * last.pointCount + period.rate * period.pointCount) / count;
+                last.pointCount = count;
+                last.endTime = period.endTime;
+                continue;
+            }
+        }
+        merged.append(period);
+    }
+    return merged;
+}
+
+FlowPeriodDataset FlowPeriodDetector::extractDataset(const QVector<double>& t, const QVector<double>& p,
+                                                     const FlowPeriod& period, double lSpacing)
+{
+    FlowPeriodDataset ds;
+    const int n = qMin(t.size(), p.size());
+    QVector<QPair<double, double>> points;
+    for (int i = 0; i < n; ++i) {
+        if (t[i] <= period.startTime || t[i] > period.endTime) continue;
+        const double dp = std::abs(p[i] - period.referencePressure);
+        if (dp > 0) points.append(qMakePair(t[i] - period.startTime, dp));
+    }
+    std::sort(points.begin(), points.end());
+    for (const QPair<double, double>& pt : points) { ds.t.append(pt.first); ds.p.append(pt.second); }
+    ds.d = DerivativeEngine::bourdet(ds.t, ds.p, lSpacing);
+    return ds;
+}
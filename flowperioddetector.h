@@ -0,0 +1,94 @@
+/*
+ * flowperioddetector.h
+ * 文件作用：长期压力计记录的流动段自动划分头文件
+ * 功能描述：
+ * 1. 有产量列时: 对产量做分段常数变点检测 (二分分割，前缀和 O(1) 求段代价)，
+ *    产量接近零的段判为关井
+ * 2. 压力斜率突变: 逐点比较左右窗口的线性拟合斜率，斜率反号且显著的局部极大值即开关井时刻；
+ *    有产量列时用于把产量变点校准到压力响应的实际拐点
+ * 3. 整体 O(n log n)，可在工作线程中调用并通过 CancellationToken 中断
+ * 4. 每个流动段可直接提取为拟合数据集 (段内经过时间、压差、Bourdet 导数)
+ */
+
+#ifndef FLOWPERIODDETECTOR_H
+#define FLOWPERIODDETECTOR_H
+
+#include <QVector>
+#include <QString>
+#include "cancellationtoken.h"
+
+// 检测参数
+struct FlowPeriodConfig {
+    double sensitivity;     // 变点惩罚系数 (×噪声方差×ln n)，越小越敏感
+    int minPoints;          // 流动段最少点数
+    double rateTolerance;   // 相对产量容差: 低于最大产量此比例视为关井，段间产量差低于此比例则合并
+    int slopeWindow;        // 压力斜率拟合窗口点数 (单侧)
+    double slopeThreshold;  // 斜率突变阈值 (倍斜率标准差)
+
+    FlowPeriodConfig() :
+        sensitivity(3.0),
+        minPoints(20),
+        rateTolerance(0.02),
+        slopeWindow(15),
+        slopeThreshold(8.0) {}
+};
+
+// 一个流动段: 时间区间 (startTime, endTime]，段起点为上一段最后一点
+struct FlowPeriod {
+    enum Kind { Drawdown = 0, ShutIn };
+
+    Kind kind;
+    double startTime;
+    double endTime;
+    double referencePressure;   // 段起点压力，压差的基准
+    double rate;                // 段内平均产量 (无产量列时为 0)
+    int pointCount;
+
+    FlowPeriod() : kind(Drawdown), startTime(0), endTime(0), referencePressure(0), rate(0), pointCount(0) {}
+
+    static QString kindName(Kind kind);
+};
+
+// 可直接加载到拟合页的数据集
+struct FlowPeriodDataset {
+    QString name;
+    QVector<double> t;   // 段内经过时间
+    QVector<double> p;   // 压差
+    QVector<double> d;   // Bourdet 导数
+};
+
+class FlowPeriodDetector
+{
+public:
+    /**
+     * @brief 划分流动段
+     * @param t 时间 (乱序时内部先排序)
+     * @param p 压力
+     * @param q 产量，为空时只用压力斜率突变划分
+     * @return 按时间排列的流动段；被取消时返回空
+     */
+    static QVector<FlowPeriod> detect(const QVector<double>& t, const QVector<double>& p, const QVector<double>& q,
+                                      const FlowPeriodConfig& config, const CancellationToken* token = nullptr);
+
+    /**
+     * @brief 分段常数变点 (二分分割)
+     * @return 各新段的第一点序号 (升序)
+     */
+    static QVector<int> rateChangePoints(const QVector<double>& q, double penalty, int minPoints,
+                                         const CancellationToken* token = nullptr);
+
+    /**
+     * @brief 各点左右窗口斜率差的显著性 |sR - sL| / σ，两侧斜率同号时为负 (只用于校准)
+     */
+    static QVector<double> slopeBreakScore(const QVector<double>& t, const QVector<double>& p, int window,
+                                           const CancellationToken* token = nullptr);
+
+    // 基于一阶差分中位数绝对偏差的噪声标准差
+    static double noiseSigma(const QVector<double>& y, int differenceOrder = 1);
+
+    // 提取流动段数据集 (t、p 为原始数据，顺序不限)
+    static FlowPeriodDataset extractDataset(const QVector<double>& t, const QVector<double>& p,
+                                            const FlowPeriod& period, double lSpacing = 0.15);
+};
+
+#endif // FLOWPERIODDETECTOR_H
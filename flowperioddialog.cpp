@@ -0,0 +1,267 @@
+/*
+ * flowperioddialog.cpp
+ * 文件作用：流动段自动划分对话框实现文件
+ * 功能描述：
+ * 1. 数据模型只在界面线程读取为数组，检测在工作线程中进行，关闭对话框时通过取消令牌中断
+ * 2. 压力曲线 (左轴) 与产量曲线 (右轴) 叠加显示，流动段分界以竖线标出，关井段浅色填充
+ * 3. 数据集名称含段序号、类型与起止时间，便于在拟合页区分
+ */
+
+#include "flowperioddialog.h"
+
+#include <QVBoxLayout>
+#include <QHBoxLayout>
+#include <QGridLayout>
+#include <QGroupBox>
+#include <QHeaderView>
+#include <QSplitter>
+#include <QMessageBox>
+#include <QtConcurrent>
+
+FlowPeriodDialog::FlowPeriodDialog(ColumnarTableModel* model, int timeCol, int pressureCol, int rateCol, QWidget* parent)
+    : QDialog(parent), m_model(model)
+{
+    setWindowTitle("流动段自动划分"); resize(1000, 720);
+
+    this->setStyleSheet(
+        "QDialog { background-color: #ffffff; color: #000000; font-family: 'Microsoft YaHei'; }"
+        "QLabel, QTableWidget, QGroupBox, QComboBox, QSpinBox, QDoubleSpinBox { color: #000000; }"
+        "QTableWidget { gridline-color: #d0d0d0; border: 1px solid #c0c0c0; }"
+        "QHeaderView::section { background-color: #f0f0f0; border: 1px solid #d0d0d0; color: #000000; }"
+        "QPushButton { background-color: #ffffff; border: 1px solid #c0c0c0; border-radius: 4px; padding: 5px 15px; color: #333333; }"
+        "QPushButton:hover { background-color: #f2f2f2; border-color: #a0a0a0; color: #000000; }"
+        "QPushButton:pressed { background-color: #e0e0e0; }"
+        "QPushButton:disabled { color: #a0a0a0; }"
+        );
+
+    QVBoxLayout* layout = new QVBoxLayout(this);
+
+    // 数据列与检测参数
+    QGroupBox* group = new QGroupBox("数据与参数", this);
+    QGridLayout* grid = new QGridLayout(group);
+    QStringList headers;
+    for(int i = 0; i < m_model->columnCount(); ++i) {
+        const QString header = m_model->headerText(i);
+        headers << (header.isEmpty() ? QString("列 %1").arg(i + 1) : header);
+    }
+    m_comboTime = new QComboBox(group); m_comboTime->addItems(headers);
+    m_comboPressure = new QComboBox(group); m_comboPressure->addItems(headers);
+    m_comboRate = new QComboBox(group); m_comboRate->addItem("无 (仅按压力斜率划分)"); m_comboRate->addItems(headers);
+    if(timeCol >= 0) m_comboTime->setCurrentIndex(timeCol);
+    if(pressureCol >= 0) m_comboPressure->setCurrentIndex(pressureCol);
+    m_comboRate->setCurrentIndex(rateCol >= 0 ? rateCol + 1 : 0);
+
+    FlowPeriodConfig defaults;
+    m_spinSensitivity = new QDoubleSpinBox(group);
+    m_spinSensitivity->setRange(0.1, 100.0); m_spinSensitivity->setSingleStep(0.5); m_spinSensitivity->setValue(defaults.sensitivity);
+    m_spinSensitivity->setToolTip("产量变点惩罚系数，越小检测到的变点越多");
+    m_spinMinPoints = new QSpinBox(group);
+    m_spinMinPoints->setRange(3, 100000); m_spinMinPoints->setValue(defaults.minPoints);
+    m_spinRateTolerance = new QDoubleSpinBox(group);
+    m_spinRateTolerance->setRange(0.1, 50.0); m_spinRateTolerance->setSuffix(" %"); m_spinRateTolerance->setValue(defaults.rateTolerance * 100.0);
+    m_spinRateTolerance->setToolTip("低于最大产量此比例视为关井；相邻段产量差低于此比例时合并");
+    m_spinSlopeWindow = new QSpinBox(group);
+    m_spinSlopeWindow->setRange(2, 10000); m_spinSlopeWindow->setValue(defaults.slopeWindow);
+    m_spinSlopeThreshold = new QDoubleSpinBox(group);
+    m_spinSlopeThreshold->setRange(1.0, 1000.0); m_spinSlopeThreshold->setValue(defaults.slopeThreshold);
+    m_spinSlopeThreshold->setToolTip("左右窗口压力斜率之差超过斜率标准差的倍数");
+
+    grid->addWidget(new QLabel("时间列:", group), 0, 0); grid->addWidget(m_comboTime, 0, 1);
+    grid->addWidget(new QLabel("压力列:", group), 0, 2); grid->addWidget(m_comboPressure, 0, 3);
+    grid->addWidget(new QLabel("产量列:", group), 0, 4); grid->addWidget(m_comboRate, 0, 5);
+    grid->addWidget(new QLabel("变点灵敏度:", group), 1, 0); grid->addWidget(m_spinSensitivity, 1, 1);
+    grid->addWidget(new QLabel("最少点数:", group), 1, 2); grid->addWidget(m_spinMinPoints, 1, 3);
+    grid->addWidget(new QLabel("产量容差:", group), 1, 4); grid->addWidget(m_spinRateTolerance, 1, 5);
+    grid->addWidget(new QLabel("斜率窗口点数:", group), 2, 0); grid->addWidget(m_spinSlopeWindow, 2, 1);
+    grid->addWidget(new QLabel("斜率突变阈值:", group), 2, 2); grid->addWidget(m_spinSlopeThreshold, 2, 3);
+    layout->addWidget(group);
+
+    QHBoxLayout* ctrl = new QHBoxLayout;
+    m_btnDetect = new QPushButton("开始检测", this);
+    m_progress = new QProgressBar(this); m_progress->setRange(0, 1); m_progress->setValue(0);
+    ctrl->addWidget(m_btnDetect); ctrl->addWidget(m_progress, 1);
+    layout->addLayout(ctrl);
+
+    QSplitter* split = new QSplitter(Qt::Vertical, this);
+    m_plot = new QCustomPlot(split);
+    m_plot->setInteractions(QCP::iRangeDrag | QCP::iRangeZoom);
+    m_plot->setMinimumHeight(260);
+    m_table = new QTableWidget(0, 8, split);
+    m_table->setHorizontalHeaderLabels(QStringList() << "选用" << "序号" << "类型" << "起始时间" << "结束时间" << "时长" << "平均产量" << "点数");
+    m_table->setEditTriggers(QAbstractItemView::NoEditTriggers);
+    m_table->verticalHeader()->setVisible(false);
+    m_table->horizontalHeader()->setStretchLastSection(true);
+    split->addWidget(m_plot);
+    split->addWidget(m_table);
+    layout->addWidget(split, 1);
+
+    QHBoxLayout* btns = new QHBoxLayout;
+    m_lblStatus = new QLabel(this);
+    m_btnCreate = new QPushButton("创建拟合分析", this); m_btnCreate->setEnabled(false);
+    QPushButton* close = new QPushButton("关闭", this);
+    btns->addWidget(m_lblStatus, 1); btns->addWidget(m_btnCreate); btns->addWidget(close);
+    layout->addLayout(btns);
+
+    connect(m_btnDetect, &QPushButton::clicked, this, &FlowPeriodDialog::onDetect);
+    connect(m_btnCreate, &QPushButton::clicked, this, &FlowPeriodDialog::onAccept);
+    connect(close, &QPushButton::clicked, this, &QDialog::reject);
+    connect(&m_watcher, &QFutureWatcher<QVector<FlowPeriod>>::finished, this, &FlowPeriodDialog::onFinished);
+}
+
+FlowPeriodDialog::~FlowPeriodDialog()
+{
+    if(m_token) m_token->cancel();
+    m_watcher.waitForFinished();
+}
+
+QList<FlowPeriodDataset> FlowPeriodDialog::datasets() const { return m_datasets; }
+
+void FlowPeriodDialog::readColumns()
+{
+    // 只保留时间、压力 (及产量) 均为数值的行
+    const int tc = m_comboTime->currentIndex();
+    const int pc = m_comboPressure->currentIndex();
+    const int qc = m_comboRate->currentIndex() - 1;
+    m_t.clear(); m_p.clear(); m_q.clear();
+    for(int r = 0; r < m_model->rowCount(); ++r) {
+        bool okT = false, okP = false, okQ = true;
+        double t = m_model->value(r, tc, &okT);
+        double p = m_model->value(r, pc, &okP);
+        double q = 0.0;
+        if(qc >= 0) q = m_model->value(r, qc, &okQ);
+        if(!okT || !okP || !okQ) continue;
+        m_t.append(t); m_p.append(p);
+        if(qc >= 0) m_q.append(q);
+    }
+}
+
+void FlowPeriodDialog::onDetect()
+{
+    if(m_watcher.isRunning()) return;
+    readColumns();
+    if(m_t.size() < 2 * m_spinMinPoints->value()) {
+        QMessageBox::warning(this, "提示", "有效数据点不足，无法划分流动段。");
+        return;
+    }
+
+    FlowPeriodConfig config;
+    config.sensitivity = m_spinSensitivity->value();
+    config.minPoints = m_spinMinPoints->value();
+    config.rateTolerance = m_spinRateTolerance->value() / 100.0;
+    config.slopeWindow = m_spinSlopeWindow->value();
+    config.slopeThreshold = m_spinSlopeThreshold->value();
+
+    m_token.reset(new CancellationToken);
+    QSharedPointer<CancellationToken> token = m_token;
+    QVector<double> t = m_t, p = m_p, q = m_q;
+
+    m_btnDetect->setEnabled(false); m_btnCreate->setEnabled(false);
+    m_progress->setRange(0, 0);
+    m_lblStatus->setText(QString("正在检测 (%1 个数据点)...").arg(m_t.size()));
+    m_watcher.setFuture(QtConcurrent::run([t, p, q, config, token]() {
+        return FlowPeriodDetector::detect(t, p, q, config, token.data());
+    }));
+}
+
+void FlowPeriodDialog::onFinished()
+{
+    m_btnDetect->setEnabled(true);
+    m_progress->setRange(0, 1); m_progress->setValue(1);
+    m_periods = m_watcher.result();
+    fillTable();
+    plotPeriods();
+    int shutIns = 0;
+    for(const FlowPeriod& period : m_periods) if(period.kind == FlowPeriod::ShutIn) ++shutIns;
+    m_lblStatus->setText(QString("检测到 %1 个流动段，其中关井 %2 个").arg(m_periods.size()).arg(shutIns));
+    m_btnCreate->setEnabled(!m_periods.isEmpty());
+}
+
+void FlowPeriodDialog::fillTable()
+{
+    const bool hasRate = !m_q.isEmpty();
+    m_table->setRowCount(m_periods.size());
+    for(int k = 0; k < m_periods.size(); ++k) {
+        const FlowPeriod& period = m_periods[k];
+        QTableWidgetItem* check = new QTableWidgetItem;
+        check->setFlags(Qt::ItemIsUserCheckable | Qt::ItemIsEnabled);
+        check->setCheckState(Qt::Checked);
+        m_table->setItem(k, 0, check);
+        m_table->setItem(k, 1, new QTableWidgetItem(QString::number(k + 1)));
+        QTableWidgetItem* kind = new QTableWidgetItem(FlowPeriod::kindName(period.kind));
+        if(period.kind == FlowPeriod::ShutIn) kind->setBackground(QColor(222, 235, 247));
+        m_table->setItem(k, 2, kind);
+        m_table->setItem(k, 3, new QTableWidgetItem(QString::number(period.startTime, 'g', 6)));
+        m_table->setItem(k, 4, new QTableWidgetItem(QString::number(period.endTime, 'g', 6)));
+        m_table->setItem(k, 5, new QTableWidgetItem(QString::number(period.endTime - period.startTime, 'g', 6)));
+        m_table->setItem(k, 6, new QTableWidgetItem(hasRate ? QString::number(period.rate, 'g', 5) : QString("-")));
+        m_table->setItem(k, 7, new QTableWidgetItem(QString::number(period.pointCount)));
+    }
+    m_table->resizeColumnsToContents();
+}
+
+void FlowPeriodDialog::plotPeriods()
+{
+    m_plot->clearGraphs();
+    m_plot->clearItems();
+
+    QCPGraph* gp = m_plot->addGraph(m_plot->xAxis, m_plot->yAxis);
+    gp->setData(m_t, m_p);
+    gp->setPen(QPen(Qt::red, 1));
+    m_plot->xAxis->setLabel("时间");
+    m_plot->yAxis->setLabel("压力");
+
+    if(!m_q.isEmpty()) {
+        m_plot->yAxis2->setVisible(true);
+        m_plot->yAxis2->setLabel("产量");
+        QCPGraph* gq = m_plot->addGraph(m_plot->xAxis, m_plot->yAxis2);
+        gq->setData(m_t, m_q);
+        gq->setPen(QPen(QColor(0, 128, 0), 1));
+        gq->setLineStyle(QCPGraph::lsStepLeft);
+    } else {
+        m_plot->yAxis2->setVisible(false);
+    }
+    m_plot->rescaleAxes();
+
+    // 关井段浅色填充，段分界画竖线
+    for(int k = 0; k < m_periods.size(); ++k) {
+        const FlowPeriod& period = m_periods[k];
+        if(period.kind == FlowPeriod::ShutIn) {
+            QCPItemRect* rect = new QCPItemRect(m_plot);
+            rect->topLeft->setTypeX(QCPItemPosition::ptPlotCoords);
+            rect->topLeft->setTypeY(QCPItemPosition::ptAxisRectRatio);
+            rect->bottomRight->setTypeX(QCPItemPosition::ptPlotCoords);
+            rect->bottomRight->setTypeY(QCPItemPosition::ptAxisRectRatio);
+            rect->topLeft->setCoords(period.startTime, 0);
+            rect->bottomRight->setCoords(period.endTime, 1);
+            rect->setPen(Qt::NoPen);
+            rect->setBrush(QColor(222, 235, 247, 120));
+            rect->setLayer("background");
+        }
+        if(k > 0) {
+            QCPItemStraightLine* line = new QCPItemStraightLine(m_plot);
+            line->point1->setCoords(period.startTime, 0);
+            line->point2->setCoords(period.startTime, 1);
+            line->setPen(QPen(Qt::gray, 1, Qt::DashLine));
+        }
+    }
+    m_plot->replot();
+}
+
+void FlowPeriodDialog::onAccept()
+{
+    m_datasets.clear();
+    for(int k = 0; k < m_periods.size(); ++k) {
+        if(m_table->item(k, 0)->checkState() != Qt::Checked) continue;
+        const FlowPeriod& period = m_periods[k];
+        FlowPeriodDataset ds = FlowPeriodDetector::extractDataset(m_t, m_p, period);
+        if(ds.t.size() < 3) continue;
+        ds.name = QString("流动段 %1 %2 (%3-%4)").arg(k + 1).arg(FlowPeriod::kindName(period.kind))
+                      .arg(period.startTime, 0, 'g', 5).arg(period.endTime, 0, 'g', 5);
+        m_datasets.append(ds);
+    }
+    if(m_datasets.isEmpty()) {
+        QMessageBox::warning(this, "提示", "没有可用的流动段 (勾选的段有效数据点不足)。");
+        return;
+    }
+    accept();
+}
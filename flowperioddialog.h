@@ -0,0 +1,75 @@
+/*
+ * flowperioddialog.h
+ * 文件作用：流动段自动划分对话框头文件
+ * 功能描述：
+ * 1. 选择时间、压力、产量列 (产量列可不选) 与检测参数
+ * 2. 检测在工作线程中进行，结果以表格和压力曲线上的分界线显示
+ * 3. 勾选的流动段提取为拟合数据集 (段内经过时间、压差、导数)，由调用方各建一个拟合分析页
+ */
+
+#ifndef FLOWPERIODDIALOG_H
+#define FLOWPERIODDIALOG_H
+
+#include <QDialog>
+#include <QComboBox>
+#include <QSpinBox>
+#include <QDoubleSpinBox>
+#include <QPushButton>
+#include <QProgressBar>
+#include <QLabel>
+#include <QTableWidget>
+#include <QFutureWatcher>
+#include <QSharedPointer>
+#include "columnartablemodel.h"
+#include "qcustomplot.h"
+#include "flowperioddetector.h"
+
+class FlowPeriodDialog : public QDialog
+{
+    Q_OBJECT
+
+public:
+    // timeCol/pressureCol/rateCol 为自动识别的默认列，-1 表示未识别
+    FlowPeriodDialog(ColumnarTableModel* model, int timeCol, int pressureCol, int rateCol, QWidget* parent = nullptr);
+    ~FlowPeriodDialog();
+
+    // 勾选的流动段数据集 (接受对话框后有效)
+    QList<FlowPeriodDataset> datasets() const;
+
+private slots:
+    void onDetect();
+    void onFinished();
+    void onAccept();
+
+private:
+    void readColumns();
+    void fillTable();
+    void plotPeriods();
+
+private:
+    ColumnarTableModel* m_model;
+
+    QComboBox* m_comboTime;
+    QComboBox* m_comboPressure;
+    QComboBox* m_comboRate;
+    QDoubleSpinBox* m_spinSensitivity;
+    QSpinBox* m_spinMinPoints;
+    QDoubleSpinBox* m_spinRateTolerance;
+    QSpinBox* m_spinSlopeWindow;
+    QDoubleSpinBox* m_spinSlopeThreshold;
+    QPushButton* m_btnDetect;
+    QPushButton* m_btnCreate;
+    QProgressBar* m_progress;
+    QLabel* m_lblStatus;
+    QTableWidget* m_table;
+    QCustomPlot* m_plot;
+
+    QVector<double> m_t, m_p, m_q;
+    QVector<FlowPeriod> m_periods;
+    QList<FlowPeriodDataset> m_datasets;
+
+    QSharedPointer<CancellationToken> m_token;
+    QFutureWatcher<QVector<FlowPeriod>> m_watcher;
+};
+
+#endif // FLOWPERIODDIALOG_H
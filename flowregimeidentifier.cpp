@@ -0,0 +1,288 @@
+/*
+ * flowregimeidentifier.cpp
+ * 文件作用：双对数导数曲线流动段自动识别实现文件
+ * 功能描述：
+ * 1. 分箱用计数排序按箱号归并，箱内中值用 nth_element，整体 O(n)
+ * 2. 节点前缀和 (Σx、Σy、Σx²、Σxy、Σy²) 使任一段在给定斜率或自由斜率下的残差平方和 O(1) 得到
+ * 3. 噪声方差由节点二阶差分的 MAD 稳健估计 (白噪声下二阶差分方差为 6σ²)，不低于 noiseFloor²
+ * 4. 参数换算与模型一致: Δp = 1.842e-3 q μ B / (kf h) · pD，tD = 14.4 kf t / (φ μ Ct L²)
+ *    - 井储段 pD = tD / cD，导数 Δp' = Δp = c·t，得 cD = 1.842e-3 × 14.4 q B / (h φ Ct L² c)，与 kf 无关
+ *    - 径向流段按均质径向流 pD' = 0.5，得 k = 0.921e-3 q μ B / (h Δp')
+ */
+
+#include "flowregimeidentifier.h"
+
+#include <QtGlobal>
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace {
+// 特征斜率，下标即 DP 中的标签；kFreeSlope 为自由斜率
+const double kSlopes[] = { 1.0, 0.5, 0.25, 0.0 };
+const int kSlopeCount = 4;
+const int kFreeSlope = kSlopeCount;
+const double kLevelRatio = 1.2;   // 后续径向流段水平相差超过此倍数才视为外区径向流
+
+// 节点前缀和，区间 [i, j)
+struct PrefixSums {
+    QVector<double> n, x, y, xx, xy, yy;
+
+    PrefixSums(const QVector<double>& px, const QVector<double>& py)
+    {
+        const int m = px.size();
+        n.fill(0.0, m + 1); x.fill(0.0, m + 1); y.fill(0.0, m + 1);
+        xx.fill(0.0, m + 1); xy.fill(0.0, m + 1); yy.fill(0.0, m + 1);
+        for (int k = 0; k < m; ++k) {
+            n[k + 1] = n[k] + 1.0;
+            x[k + 1] = x[k] + px[k];
+            y[k + 1] = y[k] + py[k];
+            xx[k + 1] = xx[k] + px[k] * px[k];
+            xy[k + 1] = xy[k] + px[k] * py[k];
+            yy[k + 1] = yy[k] + py[k] * py[k];
+        }
+    }
+
+    // 给定斜率 s 时最优截距下的残差平方和，截距写入 intercept
+    double fixedSlope(int i, int j, double s, double& intercept) const
+    {
+        const double cnt = n[j] - n[i];
+        const double sr = (y[j] - y[i]) - s * (x[j] - x[i]);
+        const double srr = (yy[j] - yy[i]) - 2.0 * s * (xy[j] - xy[i]) + s * s * (xx[j] - xx[i]);
+        intercept = sr / cnt;
+        return qMax(0.0, srr - sr * sr / cnt);
+    }
+
+    // 自由斜率最小二乘
+    double freeSlope(int i, int j, double& slope, double& intercept) const
+    {
+        const double cnt = n[j] - n[i];
+        const double mx = (x[j] - x[i]) / cnt, my = (y[j] - y[i]) / cnt;
+        const double sxx = (xx[j] - xx[i]) - cnt * mx * mx;
+        const double sxy = (xy[j] - xy[i]) - cnt * mx * my;
+        const double syy = (yy[j] - yy[i]) - cnt * my * my;
+        slope = sxx > 0 ? sxy / sxx : 0.0;
+        intercept = my - slope * mx;
+        return qMax(0.0, syy - slope * sxy);
+    }
+};
+
+double median(QVector<double>& v)
+{
+    if (v.isEmpty()) return 0.0;
+    std::nth_element(v.begin(), v.begin() + v.size() / 2, v.end());
+    return v[v.size() / 2];
+}
+}
+
+double FlowRegimeSegment::valueAt(double t) const
+{
+    return std::pow(10.0, intercept + slope * std::log10(t));
+}
+
+QString FlowRegimeSegment::regimeName(Regime regime)
+{
+    switch (regime) {
+    case WellboreStorage: return "井储";
+    case Bilinear:        return "双线性流";
+    case Linear:          return "线性流";
+    case Radial:          return "径向流";
+    case Boundary:        return "边界";
+    case Transition:      return "过渡段";
+    }
+    return QString();
+}
+
+QVector<FlowRegimeSegment> FlowRegimeIdentifier::identify(const QVector<double>& t, const QVector<double>& d,
+                                                          const FlowRegimeConfig& config)
+{
+    QVector<FlowRegimeSegment> segments;
+    const int ppc = qMax(config.pointsPerCycle, 2);
+
+    // 1. 有效点取对数
+    const int n = qMin(t.size(), d.size());
+    QVector<double> lt, ld;
+    lt.reserve(n); ld.reserve(n);
+    double ltMin = std::numeric_limits<double>::infinity(), ltMax = -ltMin;
+    for (int i = 0; i < n; ++i) {
+        if (!(t[i] > 0) || !(d[i] > 0) || !std::isfinite(t[i]) || !std::isfinite(d[i])) continue;
+        lt.append(std::log10(t[i]));
+        ld.append(std::log10(d[i]));
+        ltMin = qMin(ltMin, lt.last());
+        ltMax = qMax(ltMax, lt.last());
+    }
+    if (lt.isEmpty() || !(ltMax > ltMin)) return segments;
+
+    // 2. 对数时间分箱: 计数排序归并，箱内时间取均值、导数取中值
+    const int bins = int((ltMax - ltMin) * ppc) + 1;
+    QVector<int> offset(bins + 1, 0);
+    auto binOf = [&](double x) { return qMin(bins - 1, int((x - ltMin) * ppc)); };
+    for (double x : lt) ++offset[binOf(x) + 1];
+    for (int b = 0; b < bins; ++b) offset[b + 1] += offset[b];
+    QVector<double> sortedT(lt.size()), sortedD(lt.size());
+    QVector<int> fill = offset;
+    for (int i = 0; i < lt.size(); ++i) {
+        const int pos = fill[binOf(lt[i])]++;
+        sortedT[pos] = lt[i];
+        sortedD[pos] = ld[i];
+    }
+    QVector<double> x, y;
+    for (int b = 0; b < bins; ++b) {
+        const int count = offset[b + 1] - offset[b];
+        if (count == 0) continue;
+        double sum = 0.0;
+        for (int k = offset[b]; k < offset[b + 1]; ++k) sum += sortedT[k];
+        QVector<double> values(sortedD.begin() + offset[b], sortedD.begin() + offset[b + 1]);
+        x.append(sum / count);
+        y.append(median(values));
+    }
+
+    const int m = x.size();
+    const int minLen = qMax(3, qRound(config.minSegmentCycles * ppc));
+    const int maxLen = qMax(2 * minLen, qRound(config.maxSegmentCycles * ppc));
+    if (m < minLen) return segments;
+
+    // 3. 噪声水平
+    double sigma = config.noiseFloor;
+    if (m >= 5) {
+        QVector<double> second;
+        second.reserve(m - 2);
+        for (int k = 1; k + 1 < m; ++k) second.append(std::abs(y[k + 1] - 2.0 * y[k] + y[k - 1]));
+        sigma = qMax(sigma, 1.4826 * median(second) / std::sqrt(6.0));
+    }
+    const double invVar = 1.0 / (sigma * sigma);
+    const double logM = std::log(double(qMax(m, 2)));
+    const double penalty = config.segmentPenalty * logM;
+    const double freePenalty = config.freeSlopePenalty * logM;
+
+    // 4. 分段动态规划: cost[j] 为前 j 个节点的最优代价
+    // 节点时间以首节点为原点，减小前缀和的舍入误差
+    const double x0 = x.first();
+    QVector<double> xc(m);
+    for (int k = 0; k < m; ++k) xc[k] = x[k] - x0;
+    const PrefixSums sums(xc, y);
+    const double inf = std::numeric_limits<double>::infinity();
+    QVector<double> cost(m + 1, inf);
+    QVector<int> prev(m + 1, -1), label(m + 1, -1);
+    cost[0] = 0.0;
+    for (int j = minLen; j <= m; ++j) {
+        for (int len = minLen; len <= maxLen && len <= j; ++len) {
+            const int i = j - len;
+            if (!std::isfinite(cost[i])) continue;
+            double intercept, slope;
+            for (int s = 0; s < kSlopeCount; ++s) {
+                const double c = cost[i] + sums.fixedSlope(i, j, kSlopes[s], intercept) * invVar + penalty;
+                if (c < cost[j]) { cost[j] = c; prev[j] = i; label[j] = s; }
+            }
+            const double c = cost[i] + sums.freeSlope(i, j, slope, intercept) * invVar + penalty + freePenalty;
+            if (c < cost[j]) { cost[j] = c; prev[j] = i; label[j] = kFreeSlope; }
+        }
+    }
+    if (!std::isfinite(cost[m])) return segments;
+
+    // 5. 回溯；相邻同一特征斜率的段在合并后代价增加不超过一段惩罚时合并 (水平不同的两个径向流段保持分开)
+    QVector<int> starts, labels;
+    for (int j = m; j > 0; j = prev[j]) { starts.prepend(prev[j]); labels.prepend(label[j]); }
+    QVector<int> mergedStarts, mergedLabels;
+    for (int k = 0; k < starts.size(); ++k) {
+        if (!mergedLabels.isEmpty() && labels[k] != kFreeSlope && labels[k] == mergedLabels.last()) {
+            const int i = mergedStarts.last(), mid = starts[k];
+            const int j = (k + 1 < starts.size()) ? starts[k + 1] : m;
+            const double s = kSlopes[labels[k]];
+            double intercept;
+            const double separate = sums.fixedSlope(i, mid, s, intercept) + sums.fixedSlope(mid, j, s, intercept);
+            if ((sums.fixedSlope(i, j, s, intercept) - separate) * invVar <= penalty) continue;
+        }
+        mergedStarts.append(starts[k]);
+        mergedLabels.append(labels[k]);
+    }
+
+    // 6. 重新拟合并按斜率与先后顺序标注
+    bool seenFlow = false, seenRadial = false;
+    for (int k = 0; k < mergedStarts.size(); ++k) {
+        const int i = mergedStarts[k];
+        const int j = (k + 1 < mergedStarts.size()) ? mergedStarts[k + 1] : m;
+        const bool last = (k + 1 == mergedStarts.size());
+        FlowRegimeSegment seg;
+        double sse, intercept;
+        if (mergedLabels[k] == kFreeSlope) {
+            sse = sums.freeSlope(i, j, seg.slope, intercept);
+        } else {
+            seg.slope = kSlopes[mergedLabels[k]];
+            sse = sums.fixedSlope(i, j, seg.slope, intercept);
+        }
+        seg.intercept = intercept - seg.slope * x0;
+        seg.points = j - i;
+        seg.rms = std::sqrt(sse / seg.points);
+        seg.tStart = std::pow(10.0, i == 0 ? ltMin : 0.5 * (x[i - 1] + x[i]));
+        seg.tEnd = std::pow(10.0, j == m ? ltMax : 0.5 * (x[j - 1] + x[j]));
+
+        switch (mergedLabels[k]) {
+        case 0:
+            seg.regime = seenFlow ? FlowRegimeSegment::Boundary : FlowRegimeSegment::WellboreStorage;
+            break;
+        case 1:
+            seg.regime = seenRadial ? FlowRegimeSegment::Boundary : FlowRegimeSegment::Linear;
+            seenFlow = true;
+            break;
+        case 2:
+            seg.regime = FlowRegimeSegment::Bilinear;
+            seenFlow = true;
+            break;
+        case 3:
+            seg.regime = FlowRegimeSegment::Radial;
+            seenFlow = seenRadial = true;
+            break;
+        default: {
+            // 径向流之后明显上翘 (封闭/断层) 或下掉 (定压) 为边界；曲线末尾的下掉段同样视为定压边界
+            const bool bend = seg.slope > 0.35 || seg.slope < -0.3;
+            const bool late = seenRadial || (last && seenFlow && seg.slope < -0.3);
+            seg.regime = (bend && late) ? FlowRegimeSegment::Boundary : FlowRegimeSegment::Transition;
+            break;
+        }
+        }
+        segments.append(seg);
+    }
+
+    // 井储驼峰顶部会短暂经过 1/2、1/4 斜率，其后紧接下降段时归为过渡段
+    for (int k = 0; k + 1 < segments.size(); ++k) {
+        FlowRegimeSegment& seg = segments[k];
+        const FlowRegimeSegment& next = segments[k + 1];
+        if ((seg.regime == FlowRegimeSegment::Linear || seg.regime == FlowRegimeSegment::Bilinear)
+            && next.regime == FlowRegimeSegment::Transition && next.slope < -0.2) {
+            seg.regime = FlowRegimeSegment::Transition;
+        }
+    }
+    return segments;
+}
+
+QMap<QString, double> FlowRegimeIdentifier::estimateParameters(const QVector<FlowRegimeSegment>& segments,
+                                                               const QMap<QString, double>& baseParams)
+{
+    QMap<QString, double> estimates;
+    const double phi = baseParams.value("phi", 0.05), h = baseParams.value("h", 20.0), mu = baseParams.value("mu", 0.5);
+    const double B = baseParams.value("B", 1.05), Ct = baseParams.value("Ct", 5e-4), q = baseParams.value("q", 5.0);
+    const double L = baseParams.value("L", 1000.0);
+    if (!(h > 0) || !(phi > 0) || !(Ct > 0) || !(L > 0) || !(q > 0)) return estimates;
+
+    double radialLevel = 0.0;
+    for (const FlowRegimeSegment& seg : segments) {
+        if (seg.regime == FlowRegimeSegment::WellboreStorage && !estimates.contains("cD")) {
+            // 单位斜率: Δp' = c·t
+            const double c = std::pow(10.0, seg.intercept);
+            const double cD = 1.842e-3 * 14.4 * q * B / (h * phi * Ct * L * L * c);
+            if (std::isfinite(cD) && cD > 0) estimates["cD"] = cD;
+        } else if (seg.regime == FlowRegimeSegment::Radial) {
+            const double level = std::pow(10.0, seg.intercept);
+            const double k = 0.921e-3 * q * mu * B / (h * level);
+            if (!std::isfinite(k) || k <= 0) continue;
+            if (radialLevel <= 0) {
+                radialLevel = level;
+                estimates["kf"] = k;
+            } else if (!estimates.contains("km") && (level > radialLevel * kLevelRatio || level * kLevelRatio < radialLevel)) {
+                estimates["km"] = k;
+            }
+        }
+    }
+    return estimates;
+}
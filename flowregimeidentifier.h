@@ -0,0 +1,71 @@
+/*
+ * flowregimeidentifier.h
+ * 文件作用：双对数导数曲线流动段自动识别头文件
+ * 功能描述：
+ * 1. 导数按对数时间分箱 (每周期固定箱数，箱内取中值) 得到等间距的 lg t - lg Δp' 节点
+ * 2. 分段动态规划: 每段取特征斜率 (1、1/2、1/4、0) 或自由斜率，代价为残差平方和/噪声方差 + 段惩罚，
+ *    段长上限固定，因此总计算量 O(n)；相邻同斜率段合并
+ * 3. 按斜率与出现先后标注: 井储 (单位斜率)、线性流、双线性流、径向流、边界与过渡段
+ * 4. 由井储段与径向流段水平反求 cD、kf (及复合外区 km)，作为拟合初值
+ */
+
+#ifndef FLOWREGIMEIDENTIFIER_H
+#define FLOWREGIMEIDENTIFIER_H
+
+#include <QVector>
+#include <QMap>
+#include <QString>
+
+// 识别参数
+struct FlowRegimeConfig {
+    int pointsPerCycle;        // 每个对数周期的分箱数
+    double minSegmentCycles;   // 最短段长 (对数周期)
+    double maxSegmentCycles;   // 单段最长 (对数周期)，更长的流动段由相邻同斜率段合并得到
+    double noiseFloor;         // lg 导数噪声标准差下限
+    double segmentPenalty;     // 每段惩罚 (乘以 ln 节点数)
+    double freeSlopePenalty;   // 自由斜率段的额外惩罚 (乘以 ln 节点数)
+
+    FlowRegimeConfig() :
+        pointsPerCycle(10),
+        minSegmentCycles(0.3),
+        maxSegmentCycles(2.0),
+        noiseFloor(0.02),
+        segmentPenalty(2.0),
+        freeSlopePenalty(2.0) {}
+};
+
+// 识别出的流动段
+struct FlowRegimeSegment {
+    enum Regime { WellboreStorage, Bilinear, Linear, Radial, Boundary, Transition };
+
+    Regime regime;
+    double tStart;
+    double tEnd;
+    double slope;       // 双对数斜率 (特征段为理论值)
+    double intercept;   // lg Δp' = intercept + slope * lg t
+    double rms;         // lg 单位的拟合残差
+    int points;         // 节点数
+
+    FlowRegimeSegment() : regime(Transition), tStart(0), tEnd(0), slope(0), intercept(0), rms(0), points(0) {}
+
+    double valueAt(double t) const;
+    static QString regimeName(Regime regime);
+};
+
+class FlowRegimeIdentifier
+{
+public:
+    // t 与 d 等长，只使用两者均为正的点；点数不足时返回空
+    static QVector<FlowRegimeSegment> identify(const QVector<double>& t, const QVector<double>& d,
+                                               const FlowRegimeConfig& config = FlowRegimeConfig());
+
+    /**
+     * @brief 由流动段反求参数初值
+     * @param baseParams 当前参数表 (提供 phi、h、mu、B、Ct、q、L 等换算参数)
+     * @return 只含能够估计的参数: cD (井储段)、kf (首个径向流段)、km (水平不同的后续径向流段)
+     */
+    static QMap<QString, double> estimateParameters(const QVector<FlowRegimeSegment>& segments,
+                                                    const QMap<QString, double>& baseParams);
+};
+
+#endif // FLOWREGIMEIDENTIFIER_H
@@ -0,0 +1,66 @@
+/*
+ * flowregimeoverlay.cpp
+ * 文件作用：双对数图流动段标注实现文件
+ * 功能描述：
+ * 1. 拟合直线画在段的起止时刻之间，标签放在段的几何中点上方
+ * 2. 过渡段只画细虚线不加标签，避免标签拥挤
+ */
+
+#include "flowregimeoverlay.h"
+
+#include <cmath>
+
+namespace {
+const char* kItemName = "flowRegimeOverlay";
+}
+
+QColor FlowRegimeOverlay::regimeColor(FlowRegimeSegment::Regime regime)
+{
+    switch (regime) {
+    case FlowRegimeSegment::WellboreStorage: return QColor(148, 103, 189);
+    case FlowRegimeSegment::Bilinear:        return QColor(255, 127, 14);
+    case FlowRegimeSegment::Linear:          return QColor(44, 160, 44);
+    case FlowRegimeSegment::Radial:          return QColor(31, 119, 180);
+    case FlowRegimeSegment::Boundary:        return QColor(214, 39, 40);
+    case FlowRegimeSegment::Transition:      return QColor(127, 127, 127);
+    }
+    return Qt::gray;
+}
+
+void FlowRegimeOverlay::clear(QCustomPlot* plot)
+{
+    for (int i = plot->itemCount() - 1; i >= 0; --i) {
+        QCPAbstractItem* item = plot->item(i);
+        if (item->objectName() == kItemName) plot->removeItem(item);
+    }
+}
+
+void FlowRegimeOverlay::draw(QCustomPlot* plot, QCPAxis* keyAxis, QCPAxis* valueAxis, const QVector<FlowRegimeSegment>& segments)
+{
+    clear(plot);
+    for (const FlowRegimeSegment& seg : segments) {
+        const QColor color = regimeColor(seg.regime);
+        const bool transition = seg.regime == FlowRegimeSegment::Transition;
+
+        QCPItemLine* line = new QCPItemLine(plot);
+        line->setObjectName(kItemName);
+        line->setClipAxisRect(keyAxis->axisRect());
+        line->start->setAxes(keyAxis, valueAxis);
+        line->end->setAxes(keyAxis, valueAxis);
+        line->start->setCoords(seg.tStart, seg.valueAt(seg.tStart));
+        line->end->setCoords(seg.tEnd, seg.valueAt(seg.tEnd));
+        line->setPen(QPen(color, transition ? 1 : 3, transition ? Qt::DashLine : Qt::SolidLine));
+        if (transition) continue;
+
+        const double tMid = std::sqrt(seg.tStart * seg.tEnd);
+        QCPItemText* label = new QCPItemText(plot);
+        label->setObjectName(kItemName);
+        label->setClipAxisRect(keyAxis->axisRect());
+        label->position->setAxes(keyAxis, valueAxis);
+        label->position->setCoords(tMid, seg.valueAt(tMid) * 1.25);
+        label->setPositionAlignment(Qt::AlignBottom | Qt::AlignHCenter);
+        label->setText(FlowRegimeSegment::regimeName(seg.regime));
+        label->setFont(QFont("Microsoft YaHei", 9, QFont::Bold));
+        label->setColor(color);
+    }
+}
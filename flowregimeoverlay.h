@@ -0,0 +1,25 @@
+/*
+ * flowregimeoverlay.h
+ * 文件作用：双对数图流动段标注头文件
+ * 功能描述：
+ * 1. 在给定坐标轴上按流动段绘制拟合直线与名称标签，颜色按流态区分
+ * 2. 标注项统一命名，重绘前可一次清除，不影响图上其他标注
+ */
+
+#ifndef FLOWREGIMEOVERLAY_H
+#define FLOWREGIMEOVERLAY_H
+
+#include "qcustomplot.h"
+#include "flowregimeidentifier.h"
+
+class FlowRegimeOverlay
+{
+public:
+    // 清除已有流动段标注后重新绘制，不调用 replot
+    static void draw(QCustomPlot* plot, QCPAxis* keyAxis, QCPAxis* valueAxis, const QVector<FlowRegimeSegment>& segments);
+    static void clear(QCustomPlot* plot);
+
+    static QColor regimeColor(FlowRegimeSegment::Regime regime);
+};
+
+#endif // FLOWREGIMEOVERLAY_H
@@ -0,0 +1,113 @@
+/*
+ * hampelfilter.cpp
+ * 文件作用：滑动 Hampel (中值/MAD) 异常值检测实现文件
+ * 功能描述：
+ * 1. 点按时间排序后，窗口左右边界随中心点单调右移，每点进出窗口各一次
+ * 2. 第一遍得到各点窗口中值 m 与偏差 r = |y - m|；第二遍对 r 做同一窗口的滑动中值作为 MAD
+ *    (各点偏差以自身窗口中值为基准，是精确 MAD 的常用近似，保持 O(n log w))
+ */
+
+#include "hampelfilter.h"
+#include "slidingmedian.h"
+
+#include <QtGlobal>
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace {
+const double kMadScale = 1.4826;   // 正态分布下 MAD 与标准差之比
+
+// 对 v 做时间窗滑动中值 (t 已升序)，count 返回各窗口点数
+bool slidingMedian(const QVector<double>& t, const QVector<double>& v, double halfWidth,
+                   QVector<double>& out, QVector<int>& count, const CancellationToken* token)
+{
+    const int n = t.size();
+    out.resize(n);
+    count.resize(n);
+    SlidingMedian window;
+    int lo = 0, hi = -1;   // 当前窗口 [lo, hi]
+    for (int i = 0; i < n; ++i) {
+        if ((i & 4095) == 0 && CancellationToken::cancelled(token)) return false;
+        while (hi + 1 < n && t[hi + 1] <= t[i] + halfWidth) window.insert(v[++hi]);
+        while (t[lo] < t[i] - halfWidth) window.erase(v[lo++]);
+        out[i] = window.median();
+        count[i] = hi - lo + 1;
+    }
+    return true;
+}
+}
+
+double HampelFilter::suggestedHalfWidth(const QVector<double>& t, int points)
+{
+    QVector<double> sorted;
+    sorted.reserve(t.size());
+    for (double v : t) if (std::isfinite(v)) sorted.append(v);
+    if (sorted.size() < 2) return 0.0;
+    std::sort(sorted.begin(), sorted.end());
+    QVector<double> steps;
+    steps.reserve(sorted.size() - 1);
+    for (int i = 1; i < sorted.size(); ++i) if (sorted[i] > sorted[i - 1]) steps.append(sorted[i] - sorted[i - 1]);
+    if (steps.isEmpty()) return 0.0;
+    std::nth_element(steps.begin(), steps.begin() + steps.size() / 2, steps.end());
+    return steps[steps.size() / 2] * qMax(points, 1);
+}
+
+HampelResult HampelFilter::detect(const QVector<double>& t, const QVector<double>& y, const HampelConfig& config,
+                                  const CancellationToken* token)
+{
+    HampelResult result;
+    const int n = qMin(t.size(), y.size());
+
+    // 1. 有效点按时间排序
+    QVector<int> order;
+    order.reserve(n);
+    for (int i = 0; i < n; ++i) if (std::isfinite(t[i]) && std::isfinite(y[i])) order.append(i);
+    bool sorted = true;
+    for (int k = 1; k < order.size() && sorted; ++k) sorted = t[order[k]] >= t[order[k - 1]];
+    if (!sorted) std::stable_sort(order.begin(), order.end(), [&t](int a, int b) { return t[a] < t[b]; });
+    const int m = order.size();
+    if (m < qMax(config.minPoints, 3)) return result;
+
+    QVector<double> ts(m), ys(m);
+    for (int k = 0; k < m; ++k) { ts[k] = t[order[k]]; ys[k] = y[order[k]]; }
+    result.halfWidth = config.halfWidth > 0 ? config.halfWidth : suggestedHalfWidth(ts);
+
+    // 2. 数据分辨率: 相邻值的最小非零差
+    double resolution = std::numeric_limits<double>::infinity();
+    for (int k = 1; k < m; ++k) {
+        const double d = std::abs(ys[k] - ys[k - 1]);
+        if (d > 0 && d < resolution) resolution = d;
+    }
+    if (!std::isfinite(resolution)) return result;   // 全部相同
+
+    // 3. 窗口中值与偏差的窗口中值
+    QVector<double> median, deviation(m), mad;
+    QVector<int> count;
+    if (!slidingMedian(ts, ys, result.halfWidth, median, count, token)) return HampelResult();
+    for (int k = 0; k < m; ++k) deviation[k] = std::abs(ys[k] - median[k]);
+    if (!slidingMedian(ts, deviation, result.halfWidth, mad, count, token)) return HampelResult();
+
+    // 4. 判定
+    for (int k = 0; k < m; ++k) {
+        if (count[k] < config.minPoints) continue;
+        const double scale = qMax(kMadScale * mad[k], resolution);
+        if (deviation[k] > config.threshold * scale) {
+            result.indices.append(order[k]);
+            result.medians.append(median[k]);
+        }
+    }
+
+    // 按输入序号升序返回
+    if (!sorted) {
+        QVector<int> perm(result.indices.size());
+        for (int i = 0; i < perm.size(); ++i) perm[i] = i;
+        std::sort(perm.begin(), perm.end(), [&result](int a, int b) { return result.indices[a] < result.indices[b]; });
+        QVector<int> indices(perm.size());
+        QVector<double> medians(perm.size());
+        for (int i = 0; i < perm.size(); ++i) { indices[i] = result.indices[perm[i]]; medians[i] = result.medians[perm[i]]; }
+        result.indices = indices;
+        result.medians = medians;
+    }
+    return result;
+}
@@ -0,0 +1,54 @@
+/*
+ * hampelfilter.h
+ * 文件作用：滑动 Hampel (中值/MAD) 异常值检测头文件
+ * 功能描述：
+ * 1. 以时间窗 [t - w, t + w] 内的中值为局部基准，偏差超过 k 倍稳健标准差 (1.4826 × MAD) 判为异常
+ * 2. 基准随趋势移动，趋势性压力数据上的局部毛刺可被识别，早期快速变化段不会被整体误判
+ * 3. 两遍双指针滑动中值 (窗口中值、偏差的窗口中值)，O(n log w)，可处理数百万行的列
+ * 4. 稳健标准差不低于数据分辨率 (相邻值最小非零差)，量化的压力计数据不会把单个台阶判为异常
+ */
+
+#ifndef HAMPELFILTER_H
+#define HAMPELFILTER_H
+
+#include <QVector>
+#include "cancellationtoken.h"
+
+// 检测参数
+struct HampelConfig {
+    double halfWidth;   // 时间窗半宽 (与时间列同单位)，<= 0 时自动取约 25 个采样间隔
+    double threshold;   // 阈值 (倍稳健标准差)
+    int minPoints;      // 窗口内少于此点数时不判断
+
+    HampelConfig() :
+        halfWidth(0.0),
+        threshold(3.0),
+        minPoints(5) {}
+};
+
+// 检测结果: 异常点在输入数组中的序号 (升序) 及对应的窗口中值
+struct HampelResult {
+    QVector<int> indices;
+    QVector<double> medians;
+    double halfWidth;   // 实际使用的时间窗半宽
+
+    HampelResult() : halfWidth(0) {}
+};
+
+class HampelFilter
+{
+public:
+    /**
+     * @brief 检测异常值
+     * @param t 时间 (顺序不限，非有限值的点不参与)
+     * @param y 数值
+     * @return 被取消时返回空结果
+     */
+    static HampelResult detect(const QVector<double>& t, const QVector<double>& y, const HampelConfig& config,
+                               const CancellationToken* token = nullptr);
+
+    // 约 points 个采样间隔的时间窗半宽 (采样间隔取中位数)
+    static double suggestedHalfWidth(const QVector<double>& t, int points = 25);
+};
+
+#endif // HAMPELFILTER_H
@@ -0,0 +1,230 @@
+/*
+ * jointfitdialog.cpp
+ * 文件作用：多数据集联合拟合对话框实现文件
+ * 功能描述：
+ * 1. 参数表列出任一数据集参与拟合的参数；默认共享描述储层本身的参数 (km、omega、lambda)，
+ *    描述井筒与近井条件的参数 (cD、S 等) 默认各自独立
+ * 2. 拟合在工作线程中进行，进度信号以排队连接更新进度条
+ * 3. 结果表以参数为行、数据集为列，末行为各数据集的均方误差
+ */
+
+#include "jointfitdialog.h"
+#include "fittingparameterchart.h"
+
+#include <QVBoxLayout>
+#include <QHBoxLayout>
+#include <QHeaderView>
+#include <QSplitter>
+#include <QMessageBox>
+#include <QtConcurrent>
+
+namespace {
+const QStringList kDefaultShared = { "km", "omega1", "omega2", "lambda1" };
+}
+
+JointFitDialog::JointFitDialog(ModelManager* modelManager, const QList<JointFitDataset>& datasets, QWidget* parent)
+    : QDialog(parent), m_modelManager(modelManager), m_datasets(datasets)
+{
+    setWindowTitle("多数据集联合拟合"); resize(900, 680);
+
+    this->setStyleSheet(
+        "QDialog { background-color: #ffffff; color: #000000; font-family: 'Microsoft YaHei'; }"
+        "QLabel, QTableWidget { color: #000000; }"
+        "QTableWidget { gridline-color: #d0d0d0; border: 1px solid #c0c0c0; }"
+        "QHeaderView::section { background-color: #f0f0f0; border: 1px solid #d0d0d0; color: #000000; }"
+        "QPushButton { background-color: #ffffff; border: 1px solid #c0c0c0; border-radius: 4px; padding: 5px 15px; color: #333333; }"
+        "QPushButton:hover { background-color: #f2f2f2; border-color: #a0a0a0; color: #000000; }"
+        "QPushButton:pressed { background-color: #e0e0e0; }"
+        "QPushButton:disabled { color: #a0a0a0; }"
+        );
+
+    QVBoxLayout* layout = new QVBoxLayout(this);
+    layout->addWidget(new QLabel("勾选参与联合拟合的分析页与共享参数。共享参数各数据集取同一值 (初值与上下限取第一个含该参数的分析页)，"
+                                 "其余参与拟合的参数各自独立:", this));
+
+    QSplitter* top = new QSplitter(Qt::Horizontal, this);
+    m_datasetTable = new QTableWidget(m_datasets.size(), 4, top);
+    m_datasetTable->setHorizontalHeaderLabels(QStringList() << "参与" << "分析页" << "模型" << "数据点数");
+    m_datasetTable->setEditTriggers(QAbstractItemView::NoEditTriggers);
+    m_datasetTable->verticalHeader()->setVisible(false);
+    for(int i = 0; i < m_datasets.size(); ++i) {
+        const JointFitDataset& ds = m_datasets[i];
+        QTableWidgetItem* check = new QTableWidgetItem;
+        check->setFlags(Qt::ItemIsUserCheckable | Qt::ItemIsEnabled);
+        check->setCheckState(Qt::Checked);
+        m_datasetTable->setItem(i, 0, check);
+        m_datasetTable->setItem(i, 1, new QTableWidgetItem(ds.name));
+        m_datasetTable->setItem(i, 2, new QTableWidgetItem(ModelManager::getModelTypeName(ds.type)));
+        m_datasetTable->setItem(i, 3, new QTableWidgetItem(QString::number(ds.t.size())));
+    }
+    m_datasetTable->resizeColumnsToContents();
+    m_datasetTable->horizontalHeader()->setStretchLastSection(true);
+
+    m_paramTable = new QTableWidget(0, 3, top);
+    m_paramTable->setHorizontalHeaderLabels(QStringList() << "参数" << "共享" << "所在分析页数");
+    m_paramTable->setEditTriggers(QAbstractItemView::NoEditTriggers);
+    m_paramTable->verticalHeader()->setVisible(false);
+    top->addWidget(m_datasetTable);
+    top->addWidget(m_paramTable);
+    layout->addWidget(top, 1);
+    fillParameterTable();
+
+    QHBoxLayout* ctrl = new QHBoxLayout;
+    m_btnRun = new QPushButton("开始联合拟合", this);
+    m_btnStop = new QPushButton("停止", this); m_btnStop->setEnabled(false);
+    m_progress = new QProgressBar(this); m_progress->setRange(0, 100); m_progress->setValue(0);
+    ctrl->addWidget(m_btnRun); ctrl->addWidget(m_btnStop); ctrl->addWidget(m_progress, 1);
+    layout->addLayout(ctrl);
+
+    m_resultTable = new QTableWidget(this);
+    m_resultTable->setEditTriggers(QAbstractItemView::NoEditTriggers);
+    layout->addWidget(m_resultTable, 1);
+
+    QHBoxLayout* btns = new QHBoxLayout;
+    m_lblStatus = new QLabel(this);
+    m_btnApply = new QPushButton("应用到各分析页", this); m_btnApply->setEnabled(false);
+    QPushButton* close = new QPushButton("关闭", this);
+    btns->addWidget(m_lblStatus, 1); btns->addWidget(m_btnApply); btns->addWidget(close);
+    layout->addLayout(btns);
+
+    connect(m_btnRun, &QPushButton::clicked, this, &JointFitDialog::onRun);
+    connect(m_btnStop, &QPushButton::clicked, this, &JointFitDialog::onStop);
+    connect(m_btnApply, &QPushButton::clicked, this, &QDialog::accept);
+    connect(close, &QPushButton::clicked, this, &QDialog::reject);
+    connect(&m_watcher, &QFutureWatcher<void>::finished, this, &JointFitDialog::onFinished);
+}
+
+JointFitDialog::~JointFitDialog()
+{
+    if(m_engine) m_engine->requestStop();
+    m_watcher.waitForFinished();
+}
+
+JointFitResult JointFitDialog::result() const { return m_result; }
+QVector<int> JointFitDialog::usedDatasets() const { return m_used; }
+
+void JointFitDialog::fillParameterTable()
+{
+    // 任一数据集参与拟合的参数，按首次出现的顺序列出
+    QStringList names;
+    QMap<QString, int> presence;
+    for(const JointFitDataset& ds : m_datasets) {
+        for(const FitParameter& fp : ds.params) {
+            presence[fp.name] += 1;
+            if(fp.isFit && !names.contains(fp.name)) names << fp.name;
+        }
+    }
+    m_paramTable->setRowCount(names.size());
+    for(int j = 0; j < names.size(); ++j) {
+        QString chName, symbol, uniSymbol, unit;
+        FittingParameterChart::getParamDisplayInfo(names[j], chName, symbol, uniSymbol, unit);
+        QTableWidgetItem* label = new QTableWidgetItem(QString("%1 (%2)").arg(chName, uniSymbol));
+        label->setData(Qt::UserRole, names[j]);
+        m_paramTable->setItem(j, 0, label);
+        QTableWidgetItem* check = new QTableWidgetItem;
+        check->setFlags(Qt::ItemIsUserCheckable | Qt::ItemIsEnabled);
+        check->setCheckState(kDefaultShared.contains(names[j]) && presence[names[j]] > 1 ? Qt::Checked : Qt::Unchecked);
+        m_paramTable->setItem(j, 1, check);
+        m_paramTable->setItem(j, 2, new QTableWidgetItem(QString::number(presence[names[j]])));
+    }
+    m_paramTable->resizeColumnsToContents();
+    m_paramTable->horizontalHeader()->setStretchLastSection(true);
+}
+
+void JointFitDialog::onRun()
+{
+    if(m_watcher.isRunning() || !m_modelManager) return;
+
+    QVector<int> used;
+    QList<JointFitDataset> selected;
+    for(int i = 0; i < m_datasets.size(); ++i) {
+        if(m_datasetTable->item(i, 0)->checkState() != Qt::Checked) continue;
+        used.append(i);
+        selected.append(m_datasets[i]);
+    }
+    if(selected.size() < 2) { QMessageBox::warning(this, "提示", "请至少勾选两个分析页。"); return; }
+
+    QStringList shared;
+    for(int j = 0; j < m_paramTable->rowCount(); ++j) {
+        if(m_paramTable->item(j, 1)->checkState() == Qt::Checked) shared << m_paramTable->item(j, 0)->data(Qt::UserRole).toString();
+    }
+
+    m_used = used;
+    m_sharedNames = shared;
+    m_result = JointFitResult();
+    m_engine.reset(new JointFitSession(m_modelManager), &QObject::deleteLater);
+    m_engine->setDatasets(selected);
+    m_engine->setSharedParameters(shared);
+    connect(m_engine.data(), &JointFitSession::sigProgress, m_progress, &QProgressBar::setValue, Qt::QueuedConnection);
+    connect(m_engine.data(), &JointFitSession::sigIterationUpdated, this, [this](double error) {
+        m_lblStatus->setText(QString("正在拟合... 总均方误差 %1").arg(error, 0, 'e', 3));
+    }, Qt::QueuedConnection);
+
+    m_btnRun->setEnabled(false); m_btnStop->setEnabled(true); m_btnApply->setEnabled(false);
+    m_datasetTable->setEnabled(false); m_paramTable->setEnabled(false);
+    m_progress->setValue(0);
+    m_lblStatus->setText("正在拟合...");
+    QSharedPointer<JointFitSession> engine = m_engine;
+    m_watcher.setFuture(QtConcurrent::run([engine]() { engine->run(); }));
+}
+
+void JointFitDialog::onStop()
+{
+    if(m_engine) m_engine->requestStop();
+}
+
+void JointFitDialog::onFinished()
+{
+    m_btnRun->setEnabled(true); m_btnStop->setEnabled(false);
+    m_datasetTable->setEnabled(true); m_paramTable->setEnabled(true);
+    if(!m_engine) return;
+    m_result = m_engine->result();
+    if(!m_result.completed) {
+        m_lblStatus->setText(QString("已停止 (正演计算 %1 次)，无结果").arg(m_result.forwardCalls));
+        return;
+    }
+    fillResultTable();
+    int nRes = 0;
+    for(int n : m_result.datasetCount) nRes += n;
+    m_lblStatus->setText(QString("未知量 %1 个，迭代 %2 次，正演计算 %3 次，总均方误差 %4")
+                             .arg(m_result.unknownCount).arg(m_result.iterations).arg(m_result.forwardCalls)
+                             .arg(nRes > 0 ? m_result.sse / nRes : 0.0, 0, 'e', 3));
+    m_btnApply->setEnabled(true);
+}
+
+void JointFitDialog::fillResultTable()
+{
+    // 行: 任一数据集参与拟合的参数 + 均方误差；列: 参与的数据集
+    QStringList names;
+    for(int i : m_used) {
+        for(const FitParameter& fp : m_datasets[i].params) {
+            if(fp.isFit && !names.contains(fp.name)) names << fp.name;
+        }
+    }
+    QStringList headers, rowLabels;
+    for(int i : m_used) headers << m_datasets[i].name;
+    for(const QString& name : names) {
+        QString chName, symbol, uniSymbol, unit;
+        FittingParameterChart::getParamDisplayInfo(name, chName, symbol, uniSymbol, unit);
+        rowLabels << (m_sharedNames.contains(name) ? QString("%1 (共享)").arg(uniSymbol) : uniSymbol);
+    }
+    rowLabels << "均方误差";
+
+    m_resultTable->clear();
+    m_resultTable->setColumnCount(headers.size());
+    m_resultTable->setRowCount(rowLabels.size());
+    m_resultTable->setHorizontalHeaderLabels(headers);
+    m_resultTable->setVerticalHeaderLabels(rowLabels);
+    for(int c = 0; c < m_used.size() && c < m_result.params.size(); ++c) {
+        const QMap<QString, double>& params = m_result.params[c];
+        for(int j = 0; j < names.size(); ++j) {
+            if(!params.contains(names[j])) continue;
+            QTableWidgetItem* item = new QTableWidgetItem(QString::number(params[names[j]], 'g', 5));
+            if(m_sharedNames.contains(names[j])) item->setBackground(QColor(222, 235, 247));
+            m_resultTable->setItem(j, c, item);
+        }
+        double mse = m_result.datasetCount[c] > 0 ? m_result.datasetSSE[c] / m_result.datasetCount[c] : 0.0;
+        m_resultTable->setItem(names.size(), c, new QTableWidgetItem(QString::number(mse, 'e', 3)));
+    }
+    m_resultTable->resizeColumnsToContents();
+}
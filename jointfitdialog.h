@@ -0,0 +1,64 @@
+/*
+ * jointfitdialog.h
+ * 文件作用：多数据集联合拟合对话框头文件
+ * 功能描述：
+ * 1. 勾选参与联合拟合的分析页，勾选各数据集共享的参数
+ * 2. 后台运行 JointFitSession，可随时停止
+ * 3. 结果表: 各数据集拟合后的参数与均方误差，共享参数行高亮；可一键回写到各分析页
+ */
+
+#ifndef JOINTFITDIALOG_H
+#define JOINTFITDIALOG_H
+
+#include <QDialog>
+#include <QProgressBar>
+#include <QPushButton>
+#include <QLabel>
+#include <QTableWidget>
+#include <QFutureWatcher>
+#include <QSharedPointer>
+#include "jointfitsession.h"
+
+class JointFitDialog : public QDialog
+{
+    Q_OBJECT
+
+public:
+    JointFitDialog(ModelManager* modelManager, const QList<JointFitDataset>& datasets, QWidget* parent = nullptr);
+    ~JointFitDialog();
+
+    // 拟合结果 (params 与 usedDatasets() 一一对应)
+    JointFitResult result() const;
+    // 参与拟合的数据集在构造参数 datasets 中的序号
+    QVector<int> usedDatasets() const;
+
+private slots:
+    void onRun();
+    void onStop();
+    void onFinished();
+
+private:
+    void fillParameterTable();
+    void fillResultTable();
+
+private:
+    ModelManager* m_modelManager;
+    QList<JointFitDataset> m_datasets;
+
+    QTableWidget* m_datasetTable;
+    QTableWidget* m_paramTable;
+    QTableWidget* m_resultTable;
+    QPushButton* m_btnRun;
+    QPushButton* m_btnStop;
+    QPushButton* m_btnApply;
+    QProgressBar* m_progress;
+    QLabel* m_lblStatus;
+
+    QSharedPointer<JointFitSession> m_engine;
+    QFutureWatcher<void> m_watcher;
+    QVector<int> m_used;
+    QStringList m_sharedNames;
+    JointFitResult m_result;
+};
+
+#endif // JOINTFITDIALOG_H
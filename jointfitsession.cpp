@@ -0,0 +1,245 @@
+/*
+ * jointfitsession.cpp
+ * 文件作用：多数据集联合拟合会话实现文件
+ * 功能描述：
+ * 1. 未知量排列: 参与拟合的共享参数在前，各数据集的独立参数依次在后
+ * 2. 残差计算与单数据集拟合相同 (网格模式理论曲线 + 对数加权残差)，各数据集并行计算
+ * 3. 雅可比矩阵按数据集分块，每个差分任务只重算一个数据集，全部任务一次并行提交
+ * 4. 法方程 JᵀJ 与 Jᵀr 由各块累加: 独立参数之间跨数据集的项恒为零，无需存储
+ */
+
+#include "jointfitsession.h"
+#include "fitsession.h"
+
+#include <QtConcurrent>
+#include <cmath>
+#include <algorithm>
+#include <Eigen/Dense>
+
+JointFitSession::JointFitSession(ModelManager* modelManager, QObject* parent)
+    : QObject(parent)
+    , m_modelManager(modelManager)
+    , m_iterationN(4)
+    , m_forwardCalls(0)
+{
+}
+
+void JointFitSession::setDatasets(const QList<JointFitDataset>& datasets) { m_datasets = datasets; }
+void JointFitSession::setSharedParameters(const QStringList& names) { m_shared = names; }
+void JointFitSession::setStehfestOrder(int N) { m_iterationN = N; }
+void JointFitSession::setTimeBudget(qint64 msecs) { m_token.setTimeBudget(msecs); }
+void JointFitSession::requestStop() { m_token.cancel(); }
+JointFitResult JointFitSession::result() const { return m_result; }
+
+bool JointFitSession::isLogUnknown(int k, double value) const
+{
+    const QString& name = m_unknowns[k].name;
+    return value > 1e-12 && name != "S" && name != "nf";
+}
+
+double JointFitSession::totalSSE(const QList<QVector<double>>& residuals)
+{
+    double sse = 0.0;
+    for (const QVector<double>& r : residuals) sse += FitSession::sumSquaredError(r);
+    return sse;
+}
+
+QMap<QString, double> JointFitSession::datasetParams(int i, const QVector<double>& x) const
+{
+    QMap<QString, double> map;
+    for (const FitParameter& fp : m_datasets[i].params) map.insert(fp.name, fp.value);
+    // 共享参数先统一为基准值，参与拟合的再由未知量覆盖
+    for (auto it = m_sharedBase.constBegin(); it != m_sharedBase.constEnd(); ++it) {
+        if (map.contains(it.key())) map[it.key()] = it.value();
+    }
+    for (int k : m_blockColumns[i]) map[m_unknowns[k].name] = x[k];
+
+    map["N"] = m_iterationN;
+    if (map.contains("L") && map.contains("Lf") && map["L"] > 1e-9) map["LfD"] = map["Lf"] / map["L"];
+    return map;
+}
+
+QVector<double> JointFitSession::datasetResiduals(int i, const QMap<QString, double>& params)
+{
+    const JointFitDataset& ds = m_datasets[i];
+    m_forwardCalls.fetch_add(1, std::memory_order_relaxed);
+    ModelCurveData res = m_modelManager->calculateTheoreticalCurveOnGrid(ds.type, params, ds.t, &m_token);
+    return FitSession::residualsFromCurve(ds.p, ds.d, std::get<1>(res), std::get<2>(res), ds.weight);
+}
+
+bool JointFitSession::evaluateAll(const QVector<double>& x, QList<QVector<double>>& residuals)
+{
+    QVector<int> indices;
+    for (int i = 0; i < m_datasets.size(); ++i) indices.append(i);
+    residuals = QtConcurrent::blockingMapped<QList<QVector<double>>>(indices, [this, &x](int i) {
+        return datasetResiduals(i, datasetParams(i, x));
+    });
+    // 被中断的计算结果不可信，一律丢弃
+    return !m_token.isCancelled();
+}
+
+QList<JointFitSession::JacobianBlock> JointFitSession::computeJacobian(const QVector<double>& x,
+                                                                       const QList<QVector<double>>& residuals)
+{
+    // 差分任务: (数据集, 块内列, 方向)。独立参数只出现在所属数据集的块中，
+    // 共享参数在每个含该参数的数据集上各差分一次
+    struct Task { int dataset; int column; double sign; };
+    QVector<Task> tasks;
+    for (int i = 0; i < m_datasets.size(); ++i) {
+        for (int c = 0; c < m_blockColumns[i].size(); ++c) {
+            tasks.append({ i, c, 1.0 });
+            tasks.append({ i, c, -1.0 });
+        }
+    }
+
+    QVector<double> steps(x.size());
+    for (int k = 0; k < x.size(); ++k) steps[k] = isLogUnknown(k, x[k]) ? 0.01 : 1e-4;
+
+    QList<QVector<double>> perturbed = QtConcurrent::blockingMapped<QList<QVector<double>>>(tasks, [this, &x, &steps](const Task& task) {
+        int k = m_blockColumns[task.dataset][task.column];
+        QVector<double> xp = x;
+        if (isLogUnknown(k, x[k])) xp[k] = pow(10.0, log10(x[k]) + task.sign * steps[k]);
+        else xp[k] = x[k] + task.sign * steps[k];
+        return datasetResiduals(task.dataset, datasetParams(task.dataset, xp));
+    });
+
+    QList<JacobianBlock> blocks;
+    int t = 0;
+    for (int i = 0; i < m_datasets.size(); ++i) {
+        JacobianBlock block;
+        block.columns = m_blockColumns[i];
+        const int nRows = residuals[i].size();
+        block.J = QVector<QVector<double>>(nRows, QVector<double>(block.columns.size(), 0.0));
+        for (int c = 0; c < block.columns.size(); ++c, t += 2) {
+            const QVector<double>& rPlus = perturbed[t];
+            const QVector<double>& rMinus = perturbed[t + 1];
+            if (rPlus.size() != nRows || rMinus.size() != nRows) continue;
+            double h = steps[block.columns[c]];
+            for (int row = 0; row < nRows; ++row) block.J[row][c] = (rPlus[row] - rMinus[row]) / (2.0 * h);
+        }
+        blocks.append(block);
+    }
+    return blocks;
+}
+
+void JointFitSession::run()
+{
+    m_result = JointFitResult();
+    m_forwardCalls = 0;
+    m_unknowns.clear();
+    m_sharedBase.clear();
+    m_blockColumns.clear();
+    if (!m_modelManager || m_datasets.isEmpty()) { emit finished(); return; }
+
+    // 1. 共享参数: 初值、上下限与是否参与拟合以第一个含该参数的数据集为准
+    QVector<double> x;
+    for (const QString& name : m_shared) {
+        for (const JointFitDataset& ds : m_datasets) {
+            auto it = std::find_if(ds.params.begin(), ds.params.end(), [&](const FitParameter& fp) { return fp.name == name; });
+            if (it == ds.params.end()) continue;
+            m_sharedBase.insert(name, it->value);
+            if (it->isFit) {
+                m_unknowns.append({ name, -1, it->min, it->max });
+                x.append(it->value);
+            }
+            break;
+        }
+    }
+    const int sharedCount = m_unknowns.size();
+
+    // 2. 各数据集的块: 所含共享参数列 + 本数据集的独立参数列 (列序号递增)
+    m_blockColumns.resize(m_datasets.size());
+    for (int i = 0; i < m_datasets.size(); ++i) {
+        const QList<FitParameter>& params = m_datasets[i].params;
+        for (int k = 0; k < sharedCount; ++k) {
+            bool present = std::any_of(params.begin(), params.end(), [&](const FitParameter& fp) { return fp.name == m_unknowns[k].name; });
+            if (present) m_blockColumns[i].append(k);
+        }
+        for (const FitParameter& fp : params) {
+            if (!fp.isFit || m_shared.contains(fp.name)) continue;
+            m_blockColumns[i].append(m_unknowns.size());
+            m_unknowns.append({ fp.name, i, fp.min, fp.max });
+            x.append(fp.value);
+        }
+    }
+    const int nUnknowns = m_unknowns.size();
+    m_result.unknownCount = nUnknowns;
+
+    // 3. 初始评估；被中断或没有可用残差时直接返回
+    QList<QVector<double>> residuals;
+    if (!evaluateAll(x, residuals)) { emit finished(); return; }
+    int nRes = 0;
+    for (const QVector<double>& r : residuals) nRes += r.size();
+    if (nRes == 0) { emit finished(); return; }
+    double currentSSE = totalSSE(residuals);
+    emit sigIterationUpdated(currentSSE / nRes);
+
+    // 4. LM 迭代 (阻尼、步长与边界处理与单数据集拟合一致)
+    double lambda = 0.01;
+    const int maxIter = 50;
+    int iter = 0;
+    for (; iter < maxIter && nUnknowns > 0; ++iter) {
+        if (m_token.isCancelled()) break;
+        if (currentSSE / nRes < 3e-3) break;
+
+        emit sigProgress(iter * 100 / maxIter);
+        QList<JacobianBlock> blocks = computeJacobian(x, residuals);
+        if (m_token.isCancelled()) break;
+
+        // 按块累加下三角: 块内列序号递增，全局下标同样满足 行 >= 列
+        Eigen::MatrixXd H = Eigen::MatrixXd::Zero(nUnknowns, nUnknowns);
+        Eigen::VectorXd g = Eigen::VectorXd::Zero(nUnknowns);
+        for (int i = 0; i < blocks.size(); ++i) {
+            const JacobianBlock& block = blocks[i];
+            const QVector<double>& r = residuals[i];
+            const int nCols = block.columns.size();
+            for (int row = 0; row < r.size(); ++row) {
+                const QVector<double>& Jrow = block.J[row];
+                for (int a = 0; a < nCols; ++a) {
+                    g(block.columns[a]) += Jrow[a] * r[row];
+                    for (int c = 0; c <= a; ++c) H(block.columns[a], block.columns[c]) += Jrow[a] * Jrow[c];
+                }
+            }
+        }
+        for (int a = 0; a < nUnknowns; ++a) for (int c = a + 1; c < nUnknowns; ++c) H(a, c) = H(c, a);
+
+        bool stepAccepted = false;
+        for (int tryIter = 0; tryIter < 5; ++tryIter) {
+            if (m_token.isCancelled()) break;
+            Eigen::MatrixXd H_lm = H;
+            for (int k = 0; k < nUnknowns; ++k) H_lm(k, k) += lambda * (1.0 + std::abs(H(k, k)));
+            Eigen::VectorXd delta = H_lm.ldlt().solve(-g);
+
+            QVector<double> trial = x;
+            for (int k = 0; k < nUnknowns; ++k) {
+                double newVal = isLogUnknown(k, x[k]) ? pow(10.0, log10(x[k]) + delta(k)) : x[k] + delta(k);
+                trial[k] = qMax(m_unknowns[k].min, qMin(newVal, m_unknowns[k].max));
+            }
+
+            QList<QVector<double>> trialResiduals;
+            if (!evaluateAll(trial, trialResiduals)) break;
+            double newSSE = totalSSE(trialResiduals);
+            if (newSSE < currentSSE) {
+                x = trial; residuals = trialResiduals; currentSSE = newSSE; lambda /= 10.0; stepAccepted = true;
+                emit sigIterationUpdated(currentSSE / nRes);
+                break;
+            } else { lambda *= 10.0; }
+        }
+        if (!stepAccepted && lambda > 1e10) break;
+    }
+
+    // 5. 结果: 各数据集的完整参数表 (不保留内部使用的 N)
+    for (int i = 0; i < m_datasets.size(); ++i) {
+        QMap<QString, double> params = datasetParams(i, x);
+        params.remove("N");
+        m_result.params.append(params);
+        m_result.datasetSSE.append(FitSession::sumSquaredError(residuals[i]));
+        m_result.datasetCount.append(residuals[i].size());
+    }
+    m_result.sse = currentSSE;
+    m_result.iterations = iter;
+    m_result.forwardCalls = m_forwardCalls.load();
+    m_result.completed = true;
+    emit sigProgress(100);
+    emit finished();
+}
@@ -0,0 +1,116 @@
+/*
+ * jointfitsession.h
+ * 文件作用：多数据集联合拟合会话头文件
+ * 功能描述：
+ * 1. 多个拟合分析 (同一井的压降/恢复段，或同一区块的多口井) 联合求解，
+ *    共享参数 (如 km、omega、lambda) 各数据集取同一值，其余参与拟合的参数 (如 cD、S) 各自独立
+ * 2. 各数据集可使用不同模型、权重与观测数据，残差按数据集依次拼接
+ * 3. 雅可比矩阵按数据集分块存储: 独立参数只影响本数据集的残差，
+ *    差分时只需重算该数据集；全部差分计算并行进行
+ * 4. LM 迭代的法方程由各块累加而成，步长更新与边界处理与单数据集拟合一致
+ */
+
+#ifndef JOINTFITSESSION_H
+#define JOINTFITSESSION_H
+
+#include <QObject>
+#include <QMap>
+#include <QVector>
+#include <QList>
+#include <QStringList>
+#include <atomic>
+#include "modelmanager.h"
+#include "fittingparameterchart.h"
+#include "cancellationtoken.h"
+
+// 联合拟合中的单个数据集 (对应一个拟合分析页)
+struct JointFitDataset {
+    QString name;                                   // 分析页名称
+    ModelManager::ModelType type = ModelManager::Model_1;
+    QList<FitParameter> params;                     // 参数配置 (isFit 表示参与拟合)
+    double weight = 0.5;                            // 压力残差权重
+    QVector<double> t, p, d;                        // 观测数据快照
+};
+
+// 联合拟合结果
+struct JointFitResult {
+    QList<QMap<QString, double>> params;            // 各数据集拟合后的参数
+    QVector<double> datasetSSE;                     // 各数据集残差平方和
+    QVector<int> datasetCount;                      // 各数据集残差个数
+    double sse = 0.0;                               // 总残差平方和
+    int unknownCount = 0;                           // 联合未知量个数
+    int iterations = 0;
+    int forwardCalls = 0;                           // 正演计算次数
+    bool completed = false;                         // 是否得到有效结果
+};
+
+class JointFitSession : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit JointFitSession(ModelManager* modelManager, QObject* parent = nullptr);
+
+    // --- 会话配置 (须在 run() 之前于主线程设置) ---
+    void setDatasets(const QList<JointFitDataset>& datasets);
+    // 共享参数名: 各数据集取同一值，初值与上下限以第一个含该参数的数据集为准
+    void setSharedParameters(const QStringList& names);
+    // 迭代使用的 Stehfest 阶数
+    void setStehfestOrder(int N);
+    // 时间预算 (毫秒)，<= 0 表示不限时
+    void setTimeBudget(qint64 msecs);
+
+    // 执行拟合 (阻塞，通常在 QtConcurrent 工作线程中调用，内部并行)
+    void run();
+
+    // 请求停止 (任意线程可调用)，返回当前最优参数
+    void requestStop();
+
+    JointFitResult result() const;
+
+signals:
+    // 迭代进度与当前总均方误差
+    void sigProgress(int progress);
+    void sigIterationUpdated(double error);
+    void finished();
+
+private:
+    // 联合参数向量中的一个未知量
+    struct Unknown {
+        QString name;
+        int dataset;      // 所属数据集，共享参数为 -1
+        double min, max;
+    };
+    // 一个数据集的雅可比块: columns 为块内各列对应的未知量序号
+    struct JacobianBlock {
+        QVector<int> columns;
+        QVector<QVector<double>> J;   // J[行][块内列]
+    };
+
+    // 由未知量取值生成第 i 个数据集的参数表
+    QMap<QString, double> datasetParams(int i, const QVector<double>& x) const;
+    // 单个数据集的加权对数残差
+    QVector<double> datasetResiduals(int i, const QMap<QString, double>& params);
+    // 全部数据集的残差 (并行)；计算被中断时返回 false
+    bool evaluateAll(const QVector<double>& x, QList<QVector<double>>& residuals);
+    // 分块雅可比矩阵 (全部差分计算并行)
+    QList<JacobianBlock> computeJacobian(const QVector<double>& x, const QList<QVector<double>>& residuals);
+    bool isLogUnknown(int k, double value) const;
+    static double totalSSE(const QList<QVector<double>>& residuals);
+
+private:
+    ModelManager* m_modelManager;
+    QList<JointFitDataset> m_datasets;
+    QStringList m_shared;
+    int m_iterationN;
+
+    QVector<Unknown> m_unknowns;
+    QMap<QString, double> m_sharedBase;     // 共享参数的基准值 (不参与拟合时即为最终值)
+    QVector<QVector<int>> m_blockColumns;   // 各数据集依赖的未知量序号
+
+    CancellationToken m_token;
+    std::atomic<int> m_forwardCalls;
+    JointFitResult m_result;
+};
+
+#endif // JOINTFITSESSION_H
@@ -0,0 +1,274 @@
+/*
+ * logtimedecimator.cpp
+ * 文件作用：长期压力计数据对数时间抽稀实现文件
+ * 功能描述：
+ * 1. 箱号 = floor(lg t × 每周期箱数)，箱号变化时输出上一箱，时间递增的数据只需当前箱的累加量
+ * 2. Douglas-Peucker 与保导数抽稀在 4 倍密度的细分箱平均值上进行，噪声先被箱内平均压低
+ * 3. Douglas-Peucker 按对数周期分批化简，相邻两批共用端点；点距超过最大点距的段强制再分，
+ *    保证直线段 (如单位斜率) 仍有足够的点供拟合
+ * 4. 保导数抽稀以前后相邻细分箱的中心差分作局部导数，与上一保留点的导数相差超过阈值或点距
+ *    超过最大点距时保留当前点
+ */
+
+#include "logtimedecimator.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace {
+const int kFineFactor = 4;       // DP/保导数抽稀的细分箱密度倍数
+const int kMedianBase = 15;      // 流式中值每层缓冲大小
+
+double middleValue(QVector<double> v)
+{
+    const int n = v.size();
+    std::nth_element(v.begin(), v.begin() + n / 2, v.end());
+    double upper = v[n / 2];
+    if (n % 2 == 1) return upper;
+    double lower = *std::max_element(v.begin(), v.begin() + n / 2);
+    return 0.5 * (lower + upper);
+}
+}
+
+QStringList DecimationConfig::methodNames()
+{
+    return QStringList() << "对数分箱-平均" << "对数分箱-中值" << "对数分箱-最小值" << "对数分箱-最大值"
+                         << "双对数 Douglas-Peucker" << "保导数抽稀";
+}
+
+// ---------------------------------------------------------------------------
+// StreamingMedian
+
+void LogTimeDecimator::StreamingMedian::clear() { m_levels.clear(); }
+
+void LogTimeDecimator::StreamingMedian::add(double v)
+{
+    if (m_levels.isEmpty()) m_levels.append(QVector<double>());
+    m_levels[0].append(v);
+    for (int level = 0; level < m_levels.size() && m_levels[level].size() == kMedianBase; ++level) {
+        const double m = middleValue(m_levels[level]);
+        m_levels[level].clear();
+        if (level + 1 == m_levels.size()) m_levels.append(QVector<double>());
+        m_levels[level + 1].append(m);
+    }
+}
+
+double LogTimeDecimator::StreamingMedian::median() const
+{
+    if (m_levels.isEmpty() || (m_levels.size() == 1 && m_levels[0].isEmpty())) return 0.0;
+    if (m_levels.size() == 1) return middleValue(m_levels[0]);
+
+    // 各层剩余值按代表的样本数 (基数的层数次幂) 加权取中值
+    QVector<std::pair<double, double>> weighted;
+    double total = 0.0, weight = 1.0;
+    for (const QVector<double>& level : m_levels) {
+        for (double v : level) { weighted.append(std::make_pair(v, weight)); total += weight; }
+        weight *= kMedianBase;
+    }
+    std::sort(weighted.begin(), weighted.end());
+    double cumulative = 0.0;
+    for (const auto& item : weighted) {
+        cumulative += item.second;
+        if (cumulative >= 0.5 * total) return item.first;
+    }
+    return weighted.last().first;
+}
+
+// ---------------------------------------------------------------------------
+// LogTimeDecimator
+
+LogTimeDecimator::LogTimeDecimator(const DecimationConfig& config)
+    : m_config(config)
+{
+    m_config.pointsPerCycle = qMax(1, m_config.pointsPerCycle);
+    const bool fine = m_config.method == DecimationConfig::DouglasPeucker || m_config.method == DecimationConfig::DerivativePreserving;
+    m_binsPerDecade = m_config.pointsPerCycle * (fine ? kFineFactor : 1);
+    reset();
+}
+
+void LogTimeDecimator::reset()
+{
+    m_inputCount = 0;
+    m_binKey = 0;
+    m_binCount = 0;
+    m_sumT = m_sumP = 0.0;
+    m_minT = m_minP = m_maxT = m_maxP = 0.0;
+    m_median.clear();
+    m_cycleT.clear(); m_cycleP.clear();
+    m_cycleKey = 0;
+    m_pending = 0;
+    m_prevT = m_prevP = m_curT = m_curP = 0.0;
+    m_keptLnT = 0.0;
+    m_keptDerivative = std::numeric_limits<double>::quiet_NaN();
+    m_hasKept = false;
+    m_outT.clear(); m_outP.clear();
+}
+
+void LogTimeDecimator::append(double t, double p)
+{
+    if (!(t > 0) || !std::isfinite(t) || !std::isfinite(p)) return;
+    ++m_inputCount;
+    const long long key = (long long)std::floor(std::log10(t) * m_binsPerDecade);
+    if (m_binCount > 0 && key != m_binKey) emitBin();
+    m_binKey = key;
+
+    if (m_binCount == 0) {
+        m_minT = m_maxT = t;
+        m_minP = m_maxP = p;
+    } else {
+        if (p < m_minP) { m_minP = p; m_minT = t; }
+        if (p > m_maxP) { m_maxP = p; m_maxT = t; }
+    }
+    m_sumT += t; m_sumP += p;
+    ++m_binCount;
+    if (m_config.method == DecimationConfig::BinMedian) m_median.add(p);
+}
+
+void LogTimeDecimator::finish()
+{
+    emitBin();
+    if (m_config.method == DecimationConfig::DouglasPeucker) {
+        simplifyCycle();
+        m_cycleT.clear(); m_cycleP.clear();
+    } else if (m_config.method == DecimationConfig::DerivativePreserving) {
+        if (m_pending == 2) output(m_curT, m_curP);
+        m_pending = 0;
+    }
+}
+
+const QVector<double>& LogTimeDecimator::time() const { return m_outT; }
+const QVector<double>& LogTimeDecimator::pressure() const { return m_outP; }
+int LogTimeDecimator::inputCount() const { return m_inputCount; }
+
+void LogTimeDecimator::decimate(const QVector<double>& t, const QVector<double>& p, const DecimationConfig& config,
+                                QVector<double>& outT, QVector<double>& outP)
+{
+    LogTimeDecimator decimator(config);
+    const int n = qMin(t.size(), p.size());
+    for (int i = 0; i < n; ++i) decimator.append(t[i], p[i]);
+    decimator.finish();
+    outT = decimator.time();
+    outP = decimator.pressure();
+}
+
+void LogTimeDecimator::emitBin()
+{
+    if (m_binCount == 0) return;
+    const double meanT = m_sumT / m_binCount;
+    const double meanP = m_sumP / m_binCount;
+    switch (m_config.method) {
+    case DecimationConfig::BinMean: output(meanT, meanP); break;
+    case DecimationConfig::BinMedian: output(meanT, m_median.median()); break;
+    case DecimationConfig::BinMin: output(m_minT, m_minP); break;
+    case DecimationConfig::BinMax: output(m_maxT, m_maxP); break;
+    default: acceptFine(meanT, meanP); break;
+    }
+    m_binCount = 0;
+    m_sumT = m_sumP = 0.0;
+    m_median.clear();
+}
+
+void LogTimeDecimator::acceptFine(double t, double p)
+{
+    if (m_config.method == DecimationConfig::DouglasPeucker) {
+        // 非正压力无法取对数: 作为分界点原样保留
+        if (!(p > 0)) {
+            simplifyCycle();
+            m_cycleT.clear(); m_cycleP.clear();
+            output(t, p);
+            return;
+        }
+        const long long key = (long long)std::floor(std::log10(t));
+        if (!m_cycleT.isEmpty() && key != m_cycleKey) flushCycle();
+        m_cycleKey = key;
+        if (m_cycleT.isEmpty()) output(t, p);   // 批次首点即端点，直接输出
+        m_cycleT.append(t); m_cycleP.append(p);
+        return;
+    }
+
+    // 保导数抽稀: 首点直接保留，其余点在下一点到达后按中心差分导数判断
+    if (m_pending == 0) {
+        output(t, p);
+        m_keptLnT = std::log(t);
+        m_keptDerivative = std::numeric_limits<double>::quiet_NaN();
+        m_hasKept = true;
+        m_prevT = t; m_prevP = p;
+        m_pending = 1;
+        return;
+    }
+    if (m_pending == 1) {
+        m_curT = t; m_curP = p;
+        m_pending = 2;
+        return;
+    }
+
+    const double lnPrev = std::log(m_prevT), lnCur = std::log(m_curT), lnNext = std::log(t);
+    const double derivative = (lnNext - lnPrev) > 0 ? (p - m_prevP) / (lnNext - lnPrev) : 0.0;
+    const double maxGap = std::log(10.0) / m_config.pointsPerCycle;
+    bool keep = m_hasKept && (lnCur - m_keptLnT) >= maxGap;
+    if (std::isnan(m_keptDerivative)) {
+        m_keptDerivative = derivative;
+    } else if (std::abs(derivative - m_keptDerivative) > m_config.derivativeTolerance * qMax(std::abs(derivative), std::abs(m_keptDerivative))) {
+        keep = true;
+    }
+    if (keep) {
+        output(m_curT, m_curP);
+        m_keptLnT = lnCur;
+        m_keptDerivative = derivative;
+    }
+    m_prevT = m_curT; m_prevP = m_curP;
+    m_curT = t; m_curP = p;
+}
+
+void LogTimeDecimator::flushCycle()
+{
+    simplifyCycle();
+    // 末点已输出，作为下一周期的起点
+    const double t = m_cycleT.last(), p = m_cycleP.last();
+    m_cycleT.clear(); m_cycleP.clear();
+    m_cycleT.append(t); m_cycleP.append(p);
+}
+
+void LogTimeDecimator::simplifyCycle()
+{
+    const int n = m_cycleT.size();
+    if (n < 2) return;
+    QVector<double> x(n), y(n);
+    for (int i = 0; i < n; ++i) { x[i] = std::log10(m_cycleT[i]); y[i] = std::log10(m_cycleP[i]); }
+
+    const double maxGap = 1.0 / m_config.pointsPerCycle;
+    QVector<char> keep(n, 0);
+    keep[0] = keep[n - 1] = 1;
+    QVector<std::pair<int, int>> stack;
+    stack.append(std::make_pair(0, n - 1));
+    while (!stack.isEmpty()) {
+        const std::pair<int, int> seg = stack.takeLast();
+        const int a = seg.first, b = seg.second;
+        if (b - a < 2) continue;
+        // 点到弦的垂直距离
+        const double dx = x[b] - x[a], dy = y[b] - y[a];
+        const double len = std::sqrt(dx * dx + dy * dy);
+        int idx = -1;
+        double dmax = -1.0;
+        for (int i = a + 1; i < b; ++i) {
+            const double d = len > 0 ? std::abs(dy * (x[i] - x[a]) - dx * (y[i] - y[a])) / len
+                                     : std::hypot(x[i] - x[a], y[i] - y[a]);
+            if (d > dmax) { dmax = d; idx = i; }
+        }
+        if (dmax <= m_config.tolerance) {
+            if (dx <= maxGap) continue;
+            idx = (a + b) / 2;   // 直线段点距过大，从中间再分
+        }
+        keep[idx] = 1;
+        stack.append(std::make_pair(a, idx));
+        stack.append(std::make_pair(idx, b));
+    }
+    for (int i = 1; i < n; ++i) if (keep[i]) output(m_cycleT[i], m_cycleP[i]);
+}
+
+void LogTimeDecimator::output(double t, double p)
+{
+    m_outT.append(t);
+    m_outP.append(p);
+}
@@ -0,0 +1,106 @@
+/*
+ * logtimedecimator.h
+ * 文件作用：长期压力计数据对数时间抽稀头文件
+ * 功能描述：
+ * 1. 对数周期分箱: 每个对数周期固定箱数，箱内取平均/中值/最小/最大值，早期稀疏数据原样保留
+ * 2. 双对数空间 Douglas-Peucker: 先做细分箱平均，再逐个对数周期在 (lg t, lg Δp) 上按距离容差化简
+ * 3. 保导数抽稀: 细分箱平均后按局部 Bourdet 斜率的变化保留点，导数平直处稀疏、拐点处加密
+ * 4. 逐点输入、单遍流式处理，内存只与每周期点数有关，与原始记录行数无关
+ * 5. 数据处理页统一配置，绘图导数曲线与拟合观测数据共用
+ */
+
+#ifndef LOGTIMEDECIMATOR_H
+#define LOGTIMEDECIMATOR_H
+
+#include <QVector>
+#include <QStringList>
+
+// 抽稀配置
+struct DecimationConfig {
+    enum Method { BinMean = 0, BinMedian, BinMin, BinMax, DouglasPeucker, DerivativePreserving };
+
+    bool enabled;
+    int minimumRows;              // 原始数据超过此行数才抽稀
+    Method method;
+    int pointsPerCycle;           // 分箱: 每个对数周期的箱数；其他方法: 最大点距 (对数周期 / 此值)
+    double tolerance;             // Douglas-Peucker 距离容差 (lg 单位)
+    double derivativeTolerance;   // 保导数抽稀: 相对导数变化阈值
+
+    DecimationConfig() :
+        enabled(true),
+        minimumRows(20000),
+        method(BinMean),
+        pointsPerCycle(30),
+        tolerance(0.005),
+        derivativeTolerance(0.05) {}
+
+    // 行数是否需要抽稀
+    bool appliesTo(int rows) const { return enabled && rows > minimumRows; }
+
+    // 各方法的显示名称 (顺序与 Method 一致)
+    static QStringList methodNames();
+};
+
+class LogTimeDecimator
+{
+public:
+    explicit LogTimeDecimator(const DecimationConfig& config = DecimationConfig());
+
+    void reset();
+    // 逐点输入 (时间应递增；非正时间与非有限值跳过)
+    void append(double t, double p);
+    // 输入结束，输出最后一个箱/周期
+    void finish();
+
+    const QVector<double>& time() const;
+    const QVector<double>& pressure() const;
+    int inputCount() const;
+
+    // 整组数据一次抽稀
+    static void decimate(const QVector<double>& t, const QVector<double>& p, const DecimationConfig& config,
+                         QVector<double>& outT, QVector<double>& outP);
+
+private:
+    // 流式中值 (remedian): 每层缓冲满后取中值上推一层，内存 O(基数 × 层数)
+    class StreamingMedian
+    {
+    public:
+        void clear();
+        void add(double v);
+        double median() const;
+    private:
+        QVector<QVector<double>> m_levels;
+    };
+
+    void emitBin();
+    void acceptFine(double t, double p);
+    void flushCycle();
+    void simplifyCycle();
+    void output(double t, double p);
+
+private:
+    DecimationConfig m_config;
+    double m_binsPerDecade;
+    int m_inputCount;
+
+    // 当前箱
+    long long m_binKey;
+    int m_binCount;
+    double m_sumT, m_sumP;
+    double m_minT, m_minP, m_maxT, m_maxP;
+    StreamingMedian m_median;
+
+    // Douglas-Peucker: 当前对数周期的细分箱点 (首点为上一周期保留的末点)
+    QVector<double> m_cycleT, m_cycleP;
+    long long m_cycleKey;
+
+    // 保导数抽稀: 最近两个细分箱点与上一保留点
+    int m_pending;
+    double m_prevT, m_prevP, m_curT, m_curP;
+    double m_keptLnT, m_keptDerivative;
+    bool m_hasKept;
+
+    QVector<double> m_outT, m_outP;
+};
+
+#endif // LOGTIMEDECIMATOR_H
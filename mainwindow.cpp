@@ -18,11 +18,11 @@
 #include "wt_plottingwidget.h" // 引用图表头文件
 #include "fittingpage.h"
 #include "settingswidget.h"
+#include "derivativeengine.h"
 
 #include <QDateTime>
 #include <QMessageBox>
 #include <QDebug>
-#include <QStandardItemModel>
 #include <QTimer>
 #include <QSpacerItem>
 #include <QStackedWidget>
@@ -171,6 +171,8 @@ void MainWindow::init()
     ui->verticalLayoutHandle->addWidget(m_DataEditorWidget);
     connect(m_DataEditorWidget, &DataEditorWidget::fileChanged, this, &MainWindow::onFileLoaded);
     connect(m_DataEditorWidget, &DataEditorWidget::dataChanged, this, &MainWindow::onDataEditorDataChanged);
+    connect(m_DataEditorWidget, &DataEditorWidget::flowPeriodDatasetsReady, this, &MainWindow::onFlowPeriodDatasetsReady);
+    connect(m_DataEditorWidget, &DataEditorWidget::decimationChanged, this, &MainWindow::onTransferDataToPlotting);
 
     // 3.3 模型管理器
     m_ModelManager = new ModelManager(this);
@@ -345,6 +347,17 @@ void MainWindow::onDataEditorDataChanged()
     m_hasValidData = hasDataLoaded();
 }
 
+void MainWindow::onFlowPeriodDatasetsReady(const QList<FlowPeriodDataset>& datasets)
+{
+    if (!m_FittingPage || datasets.isEmpty()) return;
+    for (const FlowPeriodDataset& ds : datasets) {
+        m_FittingPage->addObservedDataAnalysis(ds.name, ds.t, ds.p, ds.d);
+    }
+    if (this->statusBar()) {
+        this->statusBar()->showMessage(QString("已建立 %1 个拟合分析").arg(datasets.size()), 5000);
+    }
+}
+
 void MainWindow::onModelCalculationCompleted(const QString &analysisType, const QMap<QString, double> &results)
 {
     qDebug() << "模型计算完成：" << analysisType;
@@ -354,7 +367,7 @@ void MainWindow::transferDataToFitting()
 {
     if (!m_FittingPage || !m_DataEditorWidget) return;
 
-    QStandardItemModel* model = m_DataEditorWidget->getDataModel();
+    ColumnarTableModel* model = m_DataEditorWidget->getDataModel();
     if (!model || model->rowCount() == 0) {
         return;
     }
@@ -362,47 +375,39 @@ void MainWindow::transferDataToFitting()
     QVector<double> tVec, pVec, dVec;
     double p_initial = 0.0;
 
-    // 寻找初始压力
+    // 寻找初始压力 (第 0 列为时间、第 1 列为压力，空单元格按 0 处理)
     for(int r=0; r<model->rowCount(); ++r) {
-        QModelIndex idx = model->index(r, 1);
-        if(idx.isValid()) {
-            double p = idx.data().toDouble();
-            if (std::abs(p) > 1e-6) {
-                p_initial = p;
-                break;
-            }
+        double p = model->value(r, 1);
+        if (std::abs(p) > 1e-6) {
+            p_initial = p;
+            break;
         }
     }
 
-    // 提取数据
+    // 提取数据；行数超过抽稀门限时逐行送入抽稀器，拟合只接收抽稀后的点
+    DecimationConfig decimation = m_DataEditorWidget->decimationConfig();
+    const bool decimate = decimation.appliesTo(model->rowCount());
+    LogTimeDecimator decimator(decimation);
     for(int r=0; r<model->rowCount(); ++r) {
-        double t = model->index(r, 0).data().toDouble();
-        double p_raw = model->index(r, 1).data().toDouble();
+        double t = model->value(r, 0);
+        double p_raw = model->value(r, 1);
         if (t > 0) {
-            tVec.append(t);
-            pVec.append(std::abs(p_raw - p_initial));
-        }
-    }
-
-    // 计算导数（简单的中心差分示例）
-    dVec.resize(tVec.size());
-    if (tVec.size() > 2) {
-        dVec[0] = 0;
-        dVec[tVec.size()-1] = 0;
-        for(int i=1; i<tVec.size()-1; ++i) {
-            double lnt1 = std::log(tVec[i-1]);
-            double lnt2 = std::log(tVec[i]);
-            double lnt3 = std::log(tVec[i+1]);
-            if (std::abs(lnt2 - lnt1) < 1e-9 || std::abs(lnt3 - lnt2) < 1e-9) {
-                dVec[i] = 0; continue;
+            if (decimate) {
+                decimator.append(t, std::abs(p_raw - p_initial));
+            } else {
+                tVec.append(t);
+                pVec.append(std::abs(p_raw - p_initial));
             }
-            double d1 = (pVec[i] - pVec[i-1]) / (lnt2 - lnt1);
-            double d2 = (pVec[i+1] - pVec[i]) / (lnt3 - lnt2);
-            double w1 = (lnt3 - lnt2) / (lnt3 - lnt1);
-            double w2 = (lnt2 - lnt1) / (lnt3 - lnt1);
-            dVec[i] = d1 * w1 + d2 * w2;
         }
     }
+    if (decimate) {
+        decimator.finish();
+        tVec = decimator.time();
+        pVec = decimator.pressure();
+    }
+
+    // 计算导数（与拟合页加载数据时相同的 Bourdet 算法与 L-Spacing）
+    dVec = DerivativeEngine::bourdet(tVec, pVec, 0.15);
 
     m_FittingPage->setObservedDataToCurrent(tVec, pVec, dVec);
 }
@@ -422,7 +427,7 @@ void MainWindow::onSystemSettingsChanged()
 
 void MainWindow::onPerformanceSettingsChanged() {}
 
-QStandardItemModel* MainWindow::getDataEditorModel() const
+ColumnarTableModel* MainWindow::getDataEditorModel() const
 {
     if (!m_DataEditorWidget) return nullptr;
     return m_DataEditorWidget->getDataModel();
@@ -443,10 +448,11 @@ bool MainWindow::hasDataLoaded()
 void MainWindow::transferDataFromEditorToPlotting()
 {
     if (!m_DataEditorWidget || !m_PlottingWidget) return;
-    QStandardItemModel* model = m_DataEditorWidget->getDataModel();
+    ColumnarTableModel* model = m_DataEditorWidget->getDataModel();
 
-    // 将数据模型传递给新的图表控件
+    // 将数据模型与抽稀配置传递给新的图表控件
     m_PlottingWidget->setDataModel(model);
+    m_PlottingWidget->setDecimationConfig(m_DataEditorWidget->decimationConfig());
 
     if (model && model->rowCount() > 0) {
         m_hasValidData = true;
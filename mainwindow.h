@@ -14,8 +14,9 @@
 #include <QMainWindow>
 #include <QMap>
 #include <QTimer>
-#include <QStandardItemModel>
+#include "columnartablemodel.h"
 #include "modelmanager.h"
+#include "flowperioddetector.h"
 
 // 前向声明子窗口类，减少头文件依赖
 class NavBtn;
@@ -65,6 +66,8 @@ private slots:
     void onTransferDataToPlotting();
     // 数据编辑器内容发生变化时的回调
     void onDataEditorDataChanged();
+    // 流动段划分结果: 每段新建一个拟合分析页
+    void onFlowPeriodDatasetsReady(const QList<FlowPeriodDataset>& datasets);
 
     // --- 设置与模型相关槽函数 ---
     // 系统通用设置变更回调
@@ -106,7 +109,7 @@ private:
     void transferDataToFitting();
 
     // 获取数据编辑器的数据模型
-    QStandardItemModel* getDataEditorModel() const;
+    ColumnarTableModel* getDataEditorModel() const;
     // 获取当前打开的数据文件名
     QString getCurrentFileName() const;
     // 检查是否有数据被加载
@@ -0,0 +1,240 @@
+/*
+ * mcmcdialog.cpp
+ * 文件作用：参数不确定性分析 (MCMC) 对话框实现文件
+ * 功能描述：
+ * 1. 采样在工作线程中进行，进度信号以排队连接更新进度条
+ * 2. 直方图: 对数参数以 log10 值分箱，竖线标出拟合值与 95% 可信区间
+ * 3. 相关系数按数值着色: 正相关为红色，负相关为蓝色，颜色深浅表示绝对值
+ */
+
+#include "mcmcdialog.h"
+#include "fittingparameterchart.h"
+
+#include <QVBoxLayout>
+#include <QHBoxLayout>
+#include <QHeaderView>
+#include <QTabWidget>
+#include <QMessageBox>
+#include <QtConcurrent>
+#include <cmath>
+#include <algorithm>
+
+McmcDialog::McmcDialog(ModelManager* modelManager, ModelManager::ModelType type, const QList<FitParameter>& params, double weight,
+                       const QVector<double>& t, const QVector<double>& p, const QVector<double>& d, QWidget* parent)
+    : QDialog(parent), m_modelManager(modelManager), m_modelType(type), m_params(params), m_weight(weight),
+      m_obsTime(t), m_obsPressure(p), m_obsDerivative(d)
+{
+    setWindowTitle("参数不确定性分析 (MCMC)"); resize(860, 640);
+
+    this->setStyleSheet(
+        "QDialog { background-color: #ffffff; color: #000000; font-family: 'Microsoft YaHei'; }"
+        "QLabel, QComboBox, QSpinBox, QTableWidget { color: #000000; }"
+        "QTableWidget { gridline-color: #d0d0d0; border: 1px solid #c0c0c0; }"
+        "QHeaderView::section { background-color: #f0f0f0; border: 1px solid #d0d0d0; color: #000000; }"
+        "QPushButton { background-color: #ffffff; border: 1px solid #c0c0c0; border-radius: 4px; padding: 5px 15px; color: #333333; }"
+        "QPushButton:hover { background-color: #f2f2f2; border-color: #a0a0a0; color: #000000; }"
+        "QPushButton:pressed { background-color: #e0e0e0; }"
+        );
+
+    QVBoxLayout* layout = new QVBoxLayout(this);
+    layout->addWidget(new QLabel("以当前参数为拟合结果、参数上下限为先验，对参与拟合的参数做后验采样 (建议在拟合完成后运行):", this));
+
+    QHBoxLayout* ctrl = new QHBoxLayout;
+    m_spinSamples = new QSpinBox(this);
+    m_spinSamples->setRange(5000, 200000); m_spinSamples->setSingleStep(5000); m_spinSamples->setValue(40000);
+    m_btnRun = new QPushButton("开始分析", this);
+    m_btnStop = new QPushButton("停止", this); m_btnStop->setEnabled(false);
+    m_progress = new QProgressBar(this); m_progress->setRange(0, 100); m_progress->setValue(0);
+    ctrl->addWidget(new QLabel("后验样本数:", this)); ctrl->addWidget(m_spinSamples);
+    ctrl->addWidget(m_btnRun); ctrl->addWidget(m_btnStop); ctrl->addWidget(m_progress, 1);
+    layout->addLayout(ctrl);
+
+    QTabWidget* tabs = new QTabWidget(this);
+    m_statTable = new QTableWidget(this);
+    m_statTable->setEditTriggers(QAbstractItemView::NoEditTriggers);
+    m_statTable->verticalHeader()->setVisible(false);
+    tabs->addTab(m_statTable, "统计");
+
+    QWidget* histPage = new QWidget(this);
+    QVBoxLayout* histLayout = new QVBoxLayout(histPage);
+    QHBoxLayout* histCtrl = new QHBoxLayout;
+    m_comboHist = new QComboBox(histPage);
+    histCtrl->addWidget(new QLabel("参数:", histPage)); histCtrl->addWidget(m_comboHist); histCtrl->addStretch();
+    histLayout->addLayout(histCtrl);
+    m_histPlot = new QCustomPlot(histPage);
+    m_histPlot->setInteractions(QCP::iRangeDrag | QCP::iRangeZoom);
+    m_histPlot->yAxis->setLabel("频数");
+    histLayout->addWidget(m_histPlot, 1);
+    tabs->addTab(histPage, "后验分布");
+
+    m_corrTable = new QTableWidget(this);
+    m_corrTable->setEditTriggers(QAbstractItemView::NoEditTriggers);
+    tabs->addTab(m_corrTable, "相关系数");
+    layout->addWidget(tabs, 1);
+
+    QHBoxLayout* btns = new QHBoxLayout;
+    m_lblStatus = new QLabel(this);
+    QPushButton* close = new QPushButton("关闭", this);
+    btns->addWidget(m_lblStatus, 1); btns->addWidget(close);
+    layout->addLayout(btns);
+
+    connect(m_btnRun, &QPushButton::clicked, this, &McmcDialog::onRun);
+    connect(m_btnStop, &QPushButton::clicked, this, &McmcDialog::onStop);
+    connect(close, &QPushButton::clicked, this, &QDialog::reject);
+    connect(m_comboHist, QOverload<int>::of(&QComboBox::currentIndexChanged), this, &McmcDialog::onHistogramParamChanged);
+    connect(&m_watcher, &QFutureWatcher<void>::finished, this, &McmcDialog::onFinished);
+}
+
+McmcDialog::~McmcDialog()
+{
+    if(m_engine) m_engine->requestStop();
+    m_watcher.waitForFinished();
+}
+
+void McmcDialog::onRun()
+{
+    if(m_watcher.isRunning() || !m_modelManager) return;
+    bool anyFit = false;
+    for(const FitParameter& fp : m_params) anyFit = anyFit || fp.isFit;
+    if(!anyFit) { QMessageBox::warning(this, "提示", "没有参与拟合的参数。"); return; }
+
+    m_engine.reset(new McmcSampler(m_modelManager), &QObject::deleteLater);
+    m_engine->setModelType(m_modelType);
+    m_engine->setParameters(m_params);
+    m_engine->setWeight(m_weight);
+    m_engine->setObservedData(m_obsTime, m_obsPressure, m_obsDerivative);
+    m_engine->setSampleCount(m_spinSamples->value());
+    connect(m_engine.data(), &McmcSampler::sigProgress, m_progress, &QProgressBar::setValue, Qt::QueuedConnection);
+
+    m_btnRun->setEnabled(false); m_btnStop->setEnabled(true);
+    m_progress->setValue(0);
+    m_lblStatus->setText("正在采样...");
+    QSharedPointer<McmcSampler> engine = m_engine;
+    m_watcher.setFuture(QtConcurrent::run([engine]() { engine->run(); }));
+}
+
+void McmcDialog::onStop()
+{
+    if(m_engine) m_engine->requestStop();
+}
+
+void McmcDialog::onFinished()
+{
+    m_btnRun->setEnabled(true); m_btnStop->setEnabled(false);
+    if(!m_engine) return;
+    m_result = m_engine->result();
+    if(!m_result.completed) {
+        m_lblStatus->setText(QString("已停止 (真实模型计算 %1 次)，无结果").arg(m_result.forwardCalls));
+        return;
+    }
+
+    fillStatistics();
+    fillCorrelation();
+    m_comboHist->blockSignals(true);
+    m_comboHist->clear();
+    for(const QString& name : m_result.names) {
+        QString chName, symbol, uniSymbol, unit;
+        FittingParameterChart::getParamDisplayInfo(name, chName, symbol, uniSymbol, unit);
+        m_comboHist->addItem(QString("%1 (%2)").arg(chName, uniSymbol), name);
+    }
+    m_comboHist->blockSignals(false);
+    onHistogramParamChanged();
+
+    QString status = QString("真实模型计算 %1 次，接受率 %2，代理模型对数似然误差 %3")
+                         .arg(m_result.forwardCalls).arg(m_result.acceptance, 0, 'f', 2).arg(m_result.surrogateError, 0, 'f', 2);
+    if(m_result.truncated) status += "；后验超出代理模型信赖域，区间可能偏窄";
+    m_lblStatus->setText(status);
+}
+
+void McmcDialog::fillStatistics()
+{
+    QStringList headers;
+    headers << "参数" << "拟合值" << "后验均值" << "P2.5" << "P50" << "P97.5" << "R-hat";
+    m_statTable->setColumnCount(headers.size());
+    m_statTable->setHorizontalHeaderLabels(headers);
+    m_statTable->setRowCount(m_result.names.size());
+    for(int j = 0; j < m_result.names.size(); ++j) {
+        QString chName, symbol, uniSymbol, unit;
+        FittingParameterChart::getParamDisplayInfo(m_result.names[j], chName, symbol, uniSymbol, unit);
+        m_statTable->setItem(j, 0, new QTableWidgetItem(unit.isEmpty() ? chName : QString("%1 (%2)").arg(chName, unit)));
+        const double values[] = { m_result.fitted[j], m_result.mean[j], m_result.lower[j], m_result.median[j], m_result.upper[j] };
+        for(int c = 0; c < 5; ++c) m_statTable->setItem(j, c + 1, new QTableWidgetItem(QString::number(values[c], 'g', 5)));
+        QTableWidgetItem* rhat = new QTableWidgetItem(QString::number(m_result.rhat[j], 'f', 3));
+        // R-hat > 1.1 通常视为未收敛
+        if(m_result.rhat[j] > 1.1) rhat->setBackground(QColor(242, 222, 222));
+        m_statTable->setItem(j, 6, rhat);
+    }
+    m_statTable->resizeColumnsToContents();
+    m_statTable->horizontalHeader()->setStretchLastSection(true);
+}
+
+void McmcDialog::fillCorrelation()
+{
+    const int d = m_result.names.size();
+    QStringList labels;
+    for(const QString& name : m_result.names) {
+        QString chName, symbol, uniSymbol, unit;
+        FittingParameterChart::getParamDisplayInfo(name, chName, symbol, uniSymbol, unit);
+        labels << uniSymbol;
+    }
+    m_corrTable->setRowCount(d); m_corrTable->setColumnCount(d);
+    m_corrTable->setHorizontalHeaderLabels(labels); m_corrTable->setVerticalHeaderLabels(labels);
+    for(int a = 0; a < d; ++a) {
+        for(int b = 0; b < d; ++b) {
+            double rho = m_result.correlation[a][b];
+            QTableWidgetItem* item = new QTableWidgetItem(QString::number(rho, 'f', 3));
+            int shade = 255 - int(std::min(std::abs(rho), 1.0) * 150);
+            item->setBackground(rho >= 0 ? QColor(255, shade, shade) : QColor(shade, shade, 255));
+            item->setTextAlignment(Qt::AlignCenter);
+            m_corrTable->setItem(a, b, item);
+        }
+    }
+    m_corrTable->resizeColumnsToContents();
+}
+
+void McmcDialog::onHistogramParamChanged()
+{
+    int j = m_comboHist->currentIndex();
+    m_histPlot->clearPlottables();
+    m_histPlot->clearItems();
+    if(j < 0 || j >= m_result.samples.size() || m_result.samples[j].isEmpty()) { m_histPlot->replot(); return; }
+
+    const bool useLog = m_result.logScale[j];
+    auto coord = [useLog](double v) { return useLog ? std::log10(qMax(v, 1e-300)) : v; };
+    QVector<double> values;
+    values.reserve(m_result.samples[j].size());
+    for(double v : m_result.samples[j]) values.append(coord(v));
+    auto range = std::minmax_element(values.begin(), values.end());
+    double lo = *range.first, hi = *range.second;
+    if(!(hi > lo)) { lo -= 0.5; hi += 0.5; }
+
+    const int binCount = 50;
+    const double width = (hi - lo) / binCount;
+    QVector<double> centers(binCount), counts(binCount, 0.0);
+    for(int b = 0; b < binCount; ++b) centers[b] = lo + (b + 0.5) * width;
+    for(double v : values) counts[qBound(0, int((v - lo) / width), binCount - 1)] += 1.0;
+
+    QCPBars* bars = new QCPBars(m_histPlot->xAxis, m_histPlot->yAxis);
+    bars->setWidth(width);
+    bars->setData(centers, counts);
+    bars->setPen(QPen(QColor(0, 90, 160)));
+    bars->setBrush(QColor(0, 130, 200, 140));
+
+    // 拟合值 (红) 与 95% 可信区间 (灰虚线)
+    const double maxCount = *std::max_element(counts.begin(), counts.end());
+    auto addLine = [&](double x, const QPen& pen) {
+        QCPItemLine* line = new QCPItemLine(m_histPlot);
+        line->start->setCoords(x, 0.0);
+        line->end->setCoords(x, maxCount * 1.05);
+        line->setPen(pen);
+    };
+    addLine(coord(m_result.fitted[j]), QPen(Qt::red, 2));
+    addLine(coord(m_result.lower[j]), QPen(Qt::gray, 1.5, Qt::DashLine));
+    addLine(coord(m_result.upper[j]), QPen(Qt::gray, 1.5, Qt::DashLine));
+
+    const QString name = m_result.names[j];
+    m_histPlot->xAxis->setLabel(useLog ? QString("log10(%1)").arg(name) : name);
+    m_histPlot->xAxis->setRange(lo - width, hi + width);
+    m_histPlot->yAxis->setRange(0.0, maxCount * 1.1);
+    m_histPlot->replot();
+}
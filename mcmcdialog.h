@@ -0,0 +1,66 @@
+/*
+ * mcmcdialog.h
+ * 文件作用：参数不确定性分析 (MCMC) 对话框头文件
+ * 功能描述：
+ * 1. 设置后验样本数，后台运行 McmcSampler，可随时停止
+ * 2. 统计表: 拟合值、后验均值、95% 可信区间、R-hat
+ * 3. 后验直方图 (可切换参数) 与参数相关系数矩阵
+ */
+
+#ifndef MCMCDIALOG_H
+#define MCMCDIALOG_H
+
+#include <QDialog>
+#include <QComboBox>
+#include <QSpinBox>
+#include <QProgressBar>
+#include <QPushButton>
+#include <QLabel>
+#include <QTableWidget>
+#include <QFutureWatcher>
+#include <QSharedPointer>
+#include "qcustomplot.h"
+#include "mcmcsampler.h"
+
+class McmcDialog : public QDialog
+{
+    Q_OBJECT
+
+public:
+    McmcDialog(ModelManager* modelManager, ModelManager::ModelType type, const QList<FitParameter>& params, double weight,
+               const QVector<double>& t, const QVector<double>& p, const QVector<double>& d, QWidget* parent = nullptr);
+    ~McmcDialog();
+
+private slots:
+    void onRun();
+    void onStop();
+    void onFinished();
+    void onHistogramParamChanged();
+
+private:
+    void fillStatistics();
+    void fillCorrelation();
+
+private:
+    ModelManager* m_modelManager;
+    ModelManager::ModelType m_modelType;
+    QList<FitParameter> m_params;
+    double m_weight;
+    QVector<double> m_obsTime, m_obsPressure, m_obsDerivative;
+
+    QSpinBox* m_spinSamples;
+    QPushButton* m_btnRun;
+    QPushButton* m_btnStop;
+    QProgressBar* m_progress;
+    QLabel* m_lblStatus;
+    QTableWidget* m_statTable;
+    QComboBox* m_comboHist;
+    QCustomPlot* m_histPlot;
+    QTableWidget* m_corrTable;
+
+    QSharedPointer<McmcSampler> m_engine;
+    QFutureWatcher<void> m_watcher;
+    McmcResult m_result;
+};
+
+#endif // MCMCDIALOG_H
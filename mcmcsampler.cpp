@@ -0,0 +1,376 @@
+/*
+ * mcmcsampler.cpp
+ * 文件作用：拟合参数后验不确定性分析 (MCMC) 实现文件
+ * 功能描述：
+ * 1. 单位坐标: 对数参数取 log10 后按先验上下限线性映射到 [0,1]
+ * 2. 信赖域半宽取拉普拉斯近似标准差的 5 倍 (限制在 0.02~0.5)，代理模型只在信赖域内使用
+ * 3. 集合采样链数取 max(4d, 16)，步长参数 a = 2；三轮采样，前两轮样本数为最终轮的 1/4
+ * 4. 相关系数在单位坐标上计算，对数参数即 log10 值的相关系数
+ */
+
+#include "mcmcsampler.h"
+#include "fitsession.h"
+
+#include <QtConcurrent>
+#include <cmath>
+#include <random>
+#include <algorithm>
+#include <limits>
+#include <Eigen/Dense>
+
+namespace {
+const double kStretch = 2.0;        // stretch move 步长参数 a
+const double kJacobianStep = 0.01;  // 单位坐标下的差分步长
+const int kRounds = 3;
+}
+
+McmcSampler::McmcSampler(ModelManager* modelManager, QObject* parent)
+    : QObject(parent)
+    , m_modelManager(modelManager)
+    , m_modelType(ModelManager::Model_1)
+    , m_weight(0.5)
+    , m_sampleCount(40000)
+    , m_sigma2(1.0)
+    , m_forwardCalls(0)
+{
+}
+
+void McmcSampler::setModelType(ModelManager::ModelType type) { m_modelType = type; }
+void McmcSampler::setParameters(const QList<FitParameter>& params) { m_params = params; }
+void McmcSampler::setWeight(double weight) { m_weight = weight; }
+void McmcSampler::setSampleCount(int count) { m_sampleCount = qMax(count, 1000); }
+
+void McmcSampler::setObservedData(const QVector<double>& t, const QVector<double>& p, const QVector<double>& d)
+{
+    m_obsTime = t; m_obsPressure = p; m_obsDerivative = d;
+}
+
+void McmcSampler::requestStop() { m_token.cancel(); }
+
+McmcResult McmcSampler::result() const { return m_result; }
+
+QMap<QString, double> McmcSampler::paramsFromUnit(const QVector<double>& u) const
+{
+    QMap<QString, double> p;
+    for(const FitParameter& fp : m_params) p.insert(fp.name, fp.value);
+    for(int j = 0; j < m_fitIndices.size(); ++j) {
+        double s = m_priorLo[j] + u[j] * (m_priorHi[j] - m_priorLo[j]);
+        p[m_params[m_fitIndices[j]].name] = m_isLog[j] ? pow(10.0, s) : s;
+    }
+    // 与拟合迭代相同的反演阶数
+    p["N"] = 4;
+    if(p.contains("L") && p.contains("Lf") && p["L"] > 1e-9) p["LfD"] = p["Lf"] / p["L"];
+    return p;
+}
+
+McmcSampler::Sample McmcSampler::evaluate(const QVector<double>& u)
+{
+    Sample s; s.u = u;
+    if(m_token.isCancelled()) return s;
+    ModelCurveData res = m_modelManager->calculateTheoreticalCurveOnGrid(m_modelType, paramsFromUnit(u), m_obsTime, &m_token);
+    if(m_token.isCancelled()) return s;
+    s.residuals = FitSession::residualsFromCurve(m_obsPressure, m_obsDerivative, std::get<1>(res), std::get<2>(res), m_weight);
+    s.sse = FitSession::sumSquaredError(s.residuals);
+    s.valid = !s.residuals.isEmpty() && std::isfinite(s.sse);
+    return s;
+}
+
+QVector<McmcSampler::Sample> McmcSampler::evaluateBatch(const QVector<QVector<double>>& units)
+{
+    QVector<Sample> out = QtConcurrent::blockingMapped<QVector<Sample>>(units, [this](const QVector<double>& u) { return evaluate(u); });
+    m_forwardCalls += units.size();
+    return out;
+}
+
+double McmcSampler::logPosterior(const SurrogateModel& model, const QVector<double>& u) const
+{
+    // 均匀先验: 信赖域 (先验范围的子集) 外概率为 0
+    for(int j = 0; j < u.size(); ++j) {
+        if(u[j] < m_boxLo[j] || u[j] > m_boxHi[j]) return -std::numeric_limits<double>::infinity();
+    }
+    QVector<double> r = model.predict(u);
+    if(r.isEmpty()) return -std::numeric_limits<double>::infinity();
+    return -0.5 * FitSession::sumSquaredError(r) / m_sigma2;
+}
+
+bool McmcSampler::runEnsemble(const SurrogateModel& model, QVector<QVector<double>> walkers, int steps,
+                              QVector<QVector<QVector<double>>>& chain, double& acceptance, int progressLo, int progressHi)
+{
+    const int W = walkers.size();
+    const int d = walkers.first().size();
+    const int burn = steps / 2;
+    std::mt19937 rng(20240601u + (unsigned)m_forwardCalls);
+    std::uniform_real_distribution<double> uni(0.0, 1.0);
+
+    QVector<double> logP(W);
+    for(int w = 0; w < W; ++w) logP[w] = logPosterior(model, walkers[w]);
+
+    chain.clear();
+    chain.reserve(steps - burn);
+    int accepted = 0, proposed = 0;
+    for(int step = 0; step < steps; ++step) {
+        if(m_token.isCancelled()) return false;
+        // 两半交替: 每半的候选点只依赖另一半的当前位置，可并行计算
+        for(int half = 0; half < 2; ++half) {
+            const int begin = half * (W / 2), end = half ? W : W / 2;
+            const int otherBegin = half ? 0 : W / 2, otherCount = half ? W / 2 : W - W / 2;
+            QVector<QVector<double>> proposals;
+            QVector<double> zs;
+            for(int w = begin; w < end; ++w) {
+                const QVector<double>& partner = walkers[otherBegin + int(uni(rng) * otherCount) % otherCount];
+                double z = std::pow((kStretch - 1.0) * uni(rng) + 1.0, 2) / kStretch;
+                QVector<double> y(d);
+                for(int k = 0; k < d; ++k) y[k] = partner[k] + z * (walkers[w][k] - partner[k]);
+                proposals.append(y); zs.append(z);
+            }
+            QVector<double> logY = QtConcurrent::blockingMapped<QVector<double>>(proposals, [this, &model](const QVector<double>& y) {
+                return logPosterior(model, y);
+            });
+            for(int i = 0; i < proposals.size(); ++i) {
+                const int w = begin + i;
+                double logRatio = (d - 1) * std::log(zs[i]) + logY[i] - logP[w];
+                ++proposed;
+                if(std::isfinite(logY[i]) && std::log(qMax(uni(rng), 1e-300)) < logRatio) {
+                    walkers[w] = proposals[i];
+                    logP[w] = logY[i];
+                    ++accepted;
+                }
+            }
+        }
+        if(step >= burn) chain.append(walkers);
+        if(step % 50 == 0) emit sigProgress(progressLo + (progressHi - progressLo) * step / steps);
+    }
+    acceptance = proposed > 0 ? double(accepted) / proposed : 0.0;
+    return true;
+}
+
+void McmcSampler::run()
+{
+    m_result = McmcResult();
+    m_forwardCalls = 0;
+    m_fitIndices.clear(); m_isLog.clear(); m_priorLo.clear(); m_priorHi.clear();
+    for(int i = 0; i < m_params.size(); ++i) {
+        const FitParameter& fp = m_params[i];
+        if(!fp.isFit) continue;
+        bool isLog = fp.min > 0 && fp.name != "S" && fp.name != "nf";
+        double lo = isLog ? log10(fp.min) : fp.min;
+        double hi = isLog ? log10(fp.max) : fp.max;
+        if(!(hi > lo)) continue;
+        m_fitIndices.append(i); m_isLog.append(isLog); m_priorLo.append(lo); m_priorHi.append(hi);
+    }
+    const int d = m_fitIndices.size();
+    if(!m_modelManager || d == 0 || m_obsTime.isEmpty()) { emit finished(); return; }
+
+    // 1. 最优点 (拟合结果) 与有限差分雅可比，并行计算
+    QVector<double> center(d);
+    for(int j = 0; j < d; ++j) {
+        const FitParameter& fp = m_params[m_fitIndices[j]];
+        double s = m_isLog[j] ? log10(qMax(fp.value, fp.min)) : fp.value;
+        center[j] = qBound(0.0, (s - m_priorLo[j]) / (m_priorHi[j] - m_priorLo[j]), 1.0);
+    }
+    QVector<QVector<double>> units;
+    units.append(center);
+    for(int j = 0; j < d; ++j) {
+        QVector<double> u = center;
+        u[j] += (u[j] + kJacobianStep <= 1.0) ? kJacobianStep : -kJacobianStep;
+        units.append(u);
+    }
+    QVector<Sample> firstBatch = evaluateBatch(units);
+    if(m_token.isCancelled() || !firstBatch[0].valid) { emit finished(); return; }
+    const Sample best = firstBatch[0];
+    const int n = best.residuals.size();
+    m_sigma2 = qMax(best.sse / qMax(n - d, 1), 1e-12);
+
+    // 拉普拉斯近似: Σ = σ² (JᵀJ)⁻¹，决定信赖域半宽
+    Eigen::MatrixXd J = Eigen::MatrixXd::Zero(n, d);
+    for(int j = 0; j < d; ++j) {
+        const Sample& s = firstBatch[j + 1];
+        if(!s.valid || s.residuals.size() != n) continue;
+        double h = s.u[j] - center[j];
+        for(int i = 0; i < n; ++i) J(i, j) = (s.residuals[i] - best.residuals[i]) / h;
+    }
+    Eigen::MatrixXd JtJ = J.transpose() * J;
+    JtJ.diagonal().array() += 1e-9 + 1e-6 * JtJ.diagonal().maxCoeff();
+    Eigen::MatrixXd cov = m_sigma2 * JtJ.inverse();
+    QVector<double> halfWidth(d);
+    m_boxLo.resize(d); m_boxHi.resize(d);
+    for(int j = 0; j < d; ++j) {
+        halfWidth[j] = qBound(0.02, 5.0 * std::sqrt(qMax(cov(j, j), 0.0)), 0.5);
+        m_boxLo[j] = qMax(0.0, center[j] - halfWidth[j]);
+        m_boxHi[j] = qMin(1.0, center[j] + halfWidth[j]);
+    }
+    emit sigProgress(5);
+
+    // 2. 信赖域内拉丁超立方抽样，训练残差向量代理模型
+    QVector<QVector<double>> X, Y;
+    auto absorb = [&](const QVector<Sample>& batch) {
+        for(const Sample& s : batch) {
+            if(s.valid && s.residuals.size() == n) { X.append(s.u); Y.append(s.residuals); }
+        }
+    };
+    auto designInBox = [&](int count, unsigned int seed) {
+        QVector<QVector<double>> pts = SurrogateModel::latinHypercube(count, d, seed);
+        for(auto& u : pts) for(int j = 0; j < d; ++j) u[j] = m_boxLo[j] + u[j] * (m_boxHi[j] - m_boxLo[j]);
+        return pts;
+    };
+    absorb(firstBatch);
+    const int designCount = qBound(30, 10 * d, 120);
+    absorb(evaluateBatch(designInBox(designCount, 20240601u)));
+    if(m_token.isCancelled()) { emit finished(); return; }
+    emit sigProgress(30);
+
+    // 3. 多轮采样: 校验 -> 扩充训练集 -> (必要时扩大信赖域) -> 重新采样
+    const int walkerCount = qMax(4 * d, 16) / 2 * 2;
+    std::mt19937 rng(7919u);
+    std::normal_distribution<double> gauss(0.0, 1.0);
+    QVector<QVector<QVector<double>>> chain;
+    double acceptance = 0.0;
+    double errSum = 0.0; int errCount = 0;
+    bool truncated = false;
+    for(int round = 0; round < kRounds; ++round) {
+        SurrogateModel model;
+        if(!model.train(X, Y)) break;
+
+        // 链的起点: 最优点附近的小扰动 (限制在信赖域内)
+        QVector<QVector<double>> walkers;
+        for(int w = 0; w < walkerCount; ++w) {
+            QVector<double> u = center;
+            for(int j = 0; j < d; ++j) u[j] = qBound(m_boxLo[j], u[j] + 0.05 * halfWidth[j] * gauss(rng), m_boxHi[j]);
+            walkers.append(u);
+        }
+        bool last = (round == kRounds - 1);
+        int kept = last ? m_sampleCount : m_sampleCount / 4;
+        int steps = 2 * qMax(kept / walkerCount, 50);
+        int lo = 30 + 60 * round / kRounds, hi = 30 + 60 * (round + 1) / kRounds;
+        if(!runEnsemble(model, walkers, steps, chain, acceptance, lo, hi)) break;
+        if(last) break;
+
+        // 校验: 随机抽取后验样本做真实计算，统计代理模型误差并加入训练集
+        const int checkCount = qBound(8, 2 * d, 24);
+        QVector<QVector<double>> checks;
+        std::uniform_int_distribution<int> pick(0, chain.size() * walkerCount - 1);
+        for(int c = 0; c < checkCount; ++c) {
+            int idx = pick(rng);
+            checks.append(chain[idx / walkerCount][idx % walkerCount]);
+        }
+        QVector<Sample> exact = evaluateBatch(checks);
+        if(m_token.isCancelled()) break;
+        errSum = 0.0; errCount = 0;
+        for(const Sample& s : exact) {
+            if(!s.valid || s.residuals.size() != n) continue;
+            QVector<double> r = model.predict(s.u);
+            double diff = 0.5 * (FitSession::sumSquaredError(r) - s.sse) / m_sigma2;
+            errSum += diff * diff; ++errCount;
+        }
+        absorb(exact);
+
+        // 贴近信赖域边界 (且该边界不是先验边界) 的样本比例过高时，该维信赖域加倍
+        truncated = false;
+        QVector<int> edgeHits(d, 0);
+        int total = 0;
+        for(const auto& step : chain) {
+            for(const auto& u : step) {
+                ++total;
+                for(int j = 0; j < d; ++j) {
+                    double margin = 0.02 * (m_boxHi[j] - m_boxLo[j]);
+                    if((m_boxLo[j] > 0.0 && u[j] < m_boxLo[j] + margin) || (m_boxHi[j] < 1.0 && u[j] > m_boxHi[j] - margin)) ++edgeHits[j];
+                }
+            }
+        }
+        bool expanded = false;
+        for(int j = 0; j < d; ++j) {
+            if(edgeHits[j] > 0.02 * total && halfWidth[j] < 0.5) {
+                halfWidth[j] = qMin(2.0 * halfWidth[j], 0.5);
+                m_boxLo[j] = qMax(0.0, center[j] - halfWidth[j]);
+                m_boxHi[j] = qMin(1.0, center[j] + halfWidth[j]);
+                expanded = true;
+            } else if(edgeHits[j] > 0.02 * total) {
+                truncated = true;
+            }
+        }
+        if(expanded) absorb(evaluateBatch(designInBox(designCount / 2, 104729u * (round + 1))));
+        if(m_token.isCancelled()) break;
+    }
+
+    m_result.forwardCalls = m_forwardCalls;
+    m_result.surrogateError = errCount > 0 ? std::sqrt(errSum / errCount) : 0.0;
+    m_result.truncated = truncated;
+    if(!m_token.isCancelled() && !chain.isEmpty()) {
+        buildResult(chain, acceptance);
+        m_result.completed = true;
+    }
+    emit sigProgress(100);
+    emit finished();
+}
+
+void McmcSampler::buildResult(const QVector<QVector<QVector<double>>>& chain, double acceptance)
+{
+    const int d = m_fitIndices.size();
+    const int S = chain.size();
+    const int W = chain.first().size();
+    McmcResult& r = m_result;
+    r.acceptance = acceptance;
+    r.logScale = m_isLog;
+    r.samples.resize(d);
+    QVector<QVector<double>> unitSamples(d);
+    for(int j = 0; j < d; ++j) {
+        const FitParameter& fp = m_params[m_fitIndices[j]];
+        r.names.append(fp.name);
+        r.fitted.append(fp.value);
+        unitSamples[j].reserve(S * W);
+        r.samples[j].reserve(S * W);
+        for(const auto& step : chain) {
+            for(const auto& u : step) {
+                unitSamples[j].append(u[j]);
+                double s = m_priorLo[j] + u[j] * (m_priorHi[j] - m_priorLo[j]);
+                r.samples[j].append(m_isLog[j] ? pow(10.0, s) : s);
+            }
+        }
+
+        QVector<double> sorted = r.samples[j];
+        std::sort(sorted.begin(), sorted.end());
+        auto quantile = [&](double q) { return sorted[qBound(0, int(q * (sorted.size() - 1) + 0.5), sorted.size() - 1)]; };
+        double mean = 0.0;
+        for(double v : sorted) mean += v;
+        r.mean.append(mean / sorted.size());
+        r.lower.append(quantile(0.025));
+        r.median.append(quantile(0.5));
+        r.upper.append(quantile(0.975));
+
+        // Gelman-Rubin: 每条链为一个序列
+        QVector<double> chainMean(W, 0.0), chainVar(W, 0.0);
+        for(int w = 0; w < W; ++w) {
+            for(int s = 0; s < S; ++s) chainMean[w] += chain[s][w][j];
+            chainMean[w] /= S;
+            for(int s = 0; s < S; ++s) { double e = chain[s][w][j] - chainMean[w]; chainVar[w] += e * e; }
+            chainVar[w] /= qMax(S - 1, 1);
+        }
+        double grand = 0.0, within = 0.0, between = 0.0;
+        for(int w = 0; w < W; ++w) { grand += chainMean[w]; within += chainVar[w]; }
+        grand /= W; within /= W;
+        for(int w = 0; w < W; ++w) between += (chainMean[w] - grand) * (chainMean[w] - grand);
+        between *= double(S) / qMax(W - 1, 1);
+        double varPlus = (S - 1.0) / S * within + between / S;
+        r.rhat.append(within > 0 ? std::sqrt(varPlus / within) : 1.0);
+    }
+
+    // 相关系数 (单位坐标)
+    r.correlation = QVector<QVector<double>>(d, QVector<double>(d, 0.0));
+    QVector<double> mu(d, 0.0), sd(d, 0.0);
+    const int total = unitSamples.first().size();
+    for(int j = 0; j < d; ++j) {
+        for(double v : unitSamples[j]) mu[j] += v;
+        mu[j] /= total;
+        for(double v : unitSamples[j]) sd[j] += (v - mu[j]) * (v - mu[j]);
+        sd[j] = std::sqrt(sd[j] / total);
+    }
+    for(int a = 0; a < d; ++a) {
+        for(int b = a; b < d; ++b) {
+            double c = 0.0;
+            for(int i = 0; i < total; ++i) c += (unitSamples[a][i] - mu[a]) * (unitSamples[b][i] - mu[b]);
+            c /= total;
+            double rho = (sd[a] > 0 && sd[b] > 0) ? c / (sd[a] * sd[b]) : (a == b ? 1.0 : 0.0);
+            r.correlation[a][b] = r.correlation[b][a] = rho;
+        }
+    }
+}
@@ -0,0 +1,118 @@
+/*
+ * mcmcsampler.h
+ * 文件作用：拟合参数后验不确定性分析 (MCMC) 头文件
+ * 功能描述：
+ * 1. 以拟合参数表的上下限为均匀先验 (对数参数为对数均匀)，以加权对数残差平方和构造高斯似然，
+ *    残差方差取最优点的 SSE/(n-k)
+ * 2. 真实模型过慢，先在最优点附近由有限差分雅可比估计拉普拉斯近似协方差，划定信赖域，
+ *    在信赖域内拉丁超立方抽样计算真实残差，训练残差向量的 RBF 代理模型
+ * 3. 仿射不变集合采样 (stretch move)，多条链分两半交替更新，每半的候选点并行计算
+ * 4. 多轮: 每轮结束后用真实模型校验若干后验样本并加入训练集；链贴近信赖域边界时扩大信赖域
+ * 5. 输出各参数的均值、2.5%/50%/97.5% 分位数、R-hat、相关系数矩阵与后验样本
+ */
+
+#ifndef MCMCSAMPLER_H
+#define MCMCSAMPLER_H
+
+#include <QObject>
+#include <QMap>
+#include <QVector>
+#include <QStringList>
+#include "modelmanager.h"
+#include "fittingparameterchart.h"
+#include "surrogatemodel.h"
+#include "cancellationtoken.h"
+
+// 后验分析结果 (各向量按参与拟合的参数顺序)
+struct McmcResult {
+    QStringList names;                      // 参数名
+    QVector<bool> logScale;                 // 是否按对数处理
+    QVector<double> fitted;                 // 拟合值 (链的起点)
+    QVector<double> mean;                   // 后验均值
+    QVector<double> lower;                  // 2.5% 分位数
+    QVector<double> median;                 // 50% 分位数
+    QVector<double> upper;                  // 97.5% 分位数
+    QVector<double> rhat;                   // Gelman-Rubin 收敛诊断 (接近 1 为收敛)
+    QVector<QVector<double>> samples;       // samples[j]: 第 j 个参数的后验样本 (物理值)
+    QVector<QVector<double>> correlation;   // 相关系数矩阵 (对数参数按 log10 计算)
+    double acceptance = 0.0;                // 接受率
+    int forwardCalls = 0;                   // 真实模型计算次数
+    double surrogateError = 0.0;            // 校验点上代理模型对数似然误差的均方根
+    bool truncated = false;                 // 后验是否仍贴近信赖域边界 (区间可能偏窄)
+    bool completed = false;                 // 是否完整算完
+};
+
+class McmcSampler : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit McmcSampler(ModelManager* modelManager, QObject* parent = nullptr);
+
+    // --- 计算配置 (须在 run() 之前设置) ---
+    void setModelType(ModelManager::ModelType type);
+    // 参数值应为拟合结果；isFit 的参数参与采样，其 min/max 作为先验范围
+    void setParameters(const QList<FitParameter>& params);
+    void setWeight(double weight);
+    void setObservedData(const QVector<double>& t, const QVector<double>& p, const QVector<double>& d);
+    // 保留的后验样本数 (不含预烧期)
+    void setSampleCount(int count);
+
+    // 执行计算 (阻塞，通常在 QtConcurrent 工作线程中调用)
+    void run();
+    // 请求停止 (任意线程可调用)
+    void requestStop();
+
+    McmcResult result() const;
+
+signals:
+    void sigProgress(int progress);
+    void finished();
+
+private:
+    struct Sample { QVector<double> u; QVector<double> residuals; double sse = 0.0; bool valid = false; };
+
+    QMap<QString, double> paramsFromUnit(const QVector<double>& u) const;
+    // 真实模型: 单位坐标 -> 残差
+    Sample evaluate(const QVector<double>& u);
+    QVector<Sample> evaluateBatch(const QVector<QVector<double>>& units);
+    // 代理模型上的对数后验 (信赖域外为 -inf)
+    double logPosterior(const SurrogateModel& model, const QVector<double>& u) const;
+
+    /**
+     * @brief 在代理模型上运行一轮集合采样
+     * @param steps 总步数 (前一半为预烧期)
+     * @param chain 输出: chain[s][w] 为预烧期后第 s 步第 w 条链的位置
+     */
+    bool runEnsemble(const SurrogateModel& model, QVector<QVector<double>> walkers, int steps,
+                     QVector<QVector<QVector<double>>>& chain, double& acceptance, int progressLo, int progressHi);
+    void buildResult(const QVector<QVector<QVector<double>>>& chain, double acceptance);
+
+private:
+    ModelManager* m_modelManager;
+    ModelManager::ModelType m_modelType;
+    QList<FitParameter> m_params;
+    double m_weight;
+    int m_sampleCount;
+
+    QVector<double> m_obsTime;
+    QVector<double> m_obsPressure;
+    QVector<double> m_obsDerivative;
+
+    // 参与采样的参数与先验 (单位坐标换算)
+    QVector<int> m_fitIndices;
+    QVector<bool> m_isLog;
+    QVector<double> m_priorLo;
+    QVector<double> m_priorHi;
+
+    // 似然与信赖域
+    double m_sigma2;
+    QVector<double> m_boxLo;
+    QVector<double> m_boxHi;
+    int m_forwardCalls;
+
+    CancellationToken m_token;
+    McmcResult m_result;
+};
+
+#endif // MCMCSAMPLER_H
@@ -0,0 +1,118 @@
+/*
+ * modelcomparisondialog.cpp
+ * 文件作用：多模型对比结果对话框实现文件
+ * 功能描述：
+ * 1. 计算各候选模型的 AIC/BIC 并排序
+ * 2. 表格展示 SSE、MSE、参数个数、AIC、BIC 及与最优模型的 AIC 差值
+ * 3. 用户可选择一行并采用该模型的拟合结果
+ */
+
+#include "modelcomparisondialog.h"
+
+#include <QVBoxLayout>
+#include <QHBoxLayout>
+#include <QLabel>
+#include <QPushButton>
+#include <QHeaderView>
+#include <QMessageBox>
+#include <cmath>
+#include <algorithm>
+
+ModelComparisonDialog::ModelComparisonDialog(const QList<ModelComparisonResult>& results, QWidget* parent)
+    : QDialog(parent), m_results(results), m_selectedIndex(-1)
+{
+    setWindowTitle("多模型对比结果"); resize(860, 360);
+
+    this->setStyleSheet(
+        "QDialog { background-color: #ffffff; color: #000000; font-family: 'Microsoft YaHei'; }"
+        "QLabel, QTableWidget { color: #000000; }"
+        "QTableWidget { gridline-color: #d0d0d0; border: 1px solid #c0c0c0; }"
+        "QHeaderView::section { background-color: #f0f0f0; border: 1px solid #d0d0d0; color: #000000; }"
+        "QPushButton { background-color: #ffffff; border: 1px solid #c0c0c0; border-radius: 4px; padding: 5px 15px; color: #333333; }"
+        "QPushButton:hover { background-color: #f2f2f2; border-color: #a0a0a0; color: #000000; }"
+        "QPushButton:pressed { background-color: #e0e0e0; }"
+        );
+
+    QVBoxLayout* layout = new QVBoxLayout(this);
+    layout->addWidget(new QLabel("按 AIC 由小到大排序 (AIC/BIC 越小越优，ΔAIC < 2 的模型可视为同等支持):", this));
+
+    m_table = new QTableWidget(this);
+    m_table->setSelectionBehavior(QAbstractItemView::SelectRows);
+    m_table->setSelectionMode(QAbstractItemView::SingleSelection);
+    m_table->setEditTriggers(QAbstractItemView::NoEditTriggers);
+    m_table->verticalHeader()->setVisible(false);
+    layout->addWidget(m_table);
+    fillTable();
+
+    QHBoxLayout* btns = new QHBoxLayout;
+    QPushButton* apply = new QPushButton("采用所选模型", this);
+    QPushButton* close = new QPushButton("关闭", this);
+    connect(apply, &QPushButton::clicked, this, &ModelComparisonDialog::onApply);
+    connect(close, &QPushButton::clicked, this, &QDialog::reject);
+    connect(m_table, &QTableWidget::cellDoubleClicked, this, [this](int, int) { onApply(); });
+    btns->addStretch(); btns->addWidget(apply); btns->addWidget(close);
+    layout->addLayout(btns);
+}
+
+void ModelComparisonDialog::rankResults(QList<ModelComparisonResult>& results)
+{
+    for(auto& r : results) {
+        if(!r.valid || r.n <= 0 || r.sse <= 0) { r.valid = false; continue; }
+        double logLik = r.n * std::log(r.sse / r.n);
+        r.aic = logLik + 2.0 * r.k;
+        r.bic = logLik + r.k * std::log((double)r.n);
+    }
+    std::stable_sort(results.begin(), results.end(), [](const ModelComparisonResult& a, const ModelComparisonResult& b) {
+        if(a.valid != b.valid) return a.valid;
+        return a.aic < b.aic;
+    });
+}
+
+int ModelComparisonDialog::selectedIndex() const { return m_selectedIndex; }
+
+void ModelComparisonDialog::fillTable()
+{
+    QStringList headers;
+    headers << "排名" << "模型" << "SSE" << "MSE" << "参数个数" << "AIC" << "BIC" << "ΔAIC";
+    m_table->setColumnCount(headers.size());
+    m_table->setHorizontalHeaderLabels(headers);
+    m_table->setRowCount(m_results.size());
+
+    double bestAic = 0.0;
+    for(const auto& r : m_results) { if(r.valid) { bestAic = r.aic; break; } }
+
+    for(int i = 0; i < m_results.size(); ++i) {
+        const ModelComparisonResult& r = m_results[i];
+        m_table->setItem(i, 0, new QTableWidgetItem(QString::number(i + 1)));
+        m_table->setItem(i, 1, new QTableWidgetItem(ModelManager::getModelTypeName(r.type)));
+        if(r.valid) {
+            m_table->setItem(i, 2, new QTableWidgetItem(QString::number(r.sse, 'e', 4)));
+            m_table->setItem(i, 3, new QTableWidgetItem(QString::number(r.sse / r.n, 'e', 4)));
+            m_table->setItem(i, 4, new QTableWidgetItem(QString::number(r.k)));
+            m_table->setItem(i, 5, new QTableWidgetItem(QString::number(r.aic, 'f', 2)));
+            m_table->setItem(i, 6, new QTableWidgetItem(QString::number(r.bic, 'f', 2)));
+            m_table->setItem(i, 7, new QTableWidgetItem(QString::number(r.aic - bestAic, 'f', 2)));
+        } else {
+            m_table->setItem(i, 2, new QTableWidgetItem("拟合未完成"));
+        }
+        if(i == 0 && r.valid) {
+            for(int c = 0; c < headers.size(); ++c) {
+                if(m_table->item(i, c)) m_table->item(i, c)->setBackground(QColor(223, 240, 216));
+            }
+        }
+    }
+    m_table->resizeColumnsToContents();
+    m_table->horizontalHeader()->setStretchLastSection(true);
+    if(!m_results.isEmpty()) m_table->selectRow(0);
+}
+
+void ModelComparisonDialog::onApply()
+{
+    int row = m_table->currentRow();
+    if(row < 0 || row >= m_results.size() || !m_results[row].valid) {
+        QMessageBox::warning(this, "提示", "请选择一个有效的拟合结果。");
+        return;
+    }
+    m_selectedIndex = row;
+    accept();
+}
@@ -0,0 +1,54 @@
+/*
+ * modelcomparisondialog.h
+ * 文件作用：多模型对比结果对话框头文件
+ * 功能描述：
+ * 1. 定义单个候选模型的拟合结果结构 (SSE、参数个数、AIC、BIC)
+ * 2. 按信息准则对候选模型排序
+ * 3. 以表格展示排序结果，允许用户采用其中一个模型
+ */
+
+#ifndef MODELCOMPARISONDIALOG_H
+#define MODELCOMPARISONDIALOG_H
+
+#include <QDialog>
+#include <QTableWidget>
+#include <QList>
+#include <QMap>
+#include "modelmanager.h"
+
+// 单个候选模型的拟合结果
+struct ModelComparisonResult {
+    ModelManager::ModelType type;    // 模型类型
+    QMap<QString, double> params;    // 拟合后的参数
+    ModelCurveData curve;            // 拟合后的理论曲线
+    double sse = 0.0;                // 残差平方和
+    int n = 0;                       // 残差个数
+    int k = 0;                       // 拟合参数个数
+    double aic = 0.0;                // AIC = n*ln(SSE/n) + 2k
+    double bic = 0.0;                // BIC = n*ln(SSE/n) + k*ln(n)
+    bool valid = false;              // 是否得到有效结果
+};
+
+class ModelComparisonDialog : public QDialog
+{
+    Q_OBJECT
+
+public:
+    explicit ModelComparisonDialog(const QList<ModelComparisonResult>& results, QWidget* parent = nullptr);
+
+    // 计算 AIC/BIC，并按 AIC 升序排序 (无效结果排在最后)
+    static void rankResults(QList<ModelComparisonResult>& results);
+
+    // 用户选择采用的结果序号，未选择时返回 -1
+    int selectedIndex() const;
+
+private:
+    QTableWidget* m_table;
+    QList<ModelComparisonResult> m_results;
+    int m_selectedIndex;
+
+    void fillTable();
+    void onApply();
+};
+
+#endif // MODELCOMPARISONDIALOG_H
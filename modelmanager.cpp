@@ -221,11 +221,68 @@ QMap<QString, double> ModelManager::getDefaultParameters(ModelType type)
     return p;
 }
 
-ModelCurveData ModelManager::calculateTheoreticalCurve(ModelType type, const QMap<QString, double>& params, const QVector<double>& providedTime)
+ModelCurveData ModelManager::calculateTheoreticalCurve(ModelType type, const QMap<QString, double>& params, const QVector<double>& providedTime,
+                                                      const CancellationToken* token)
 {
     int index = (int)type;
     if (index >= 0 && index < m_modelWidgets.size()) {
-        return m_modelWidgets[index]->calculateTheoreticalCurve(params, providedTime);
+        return m_modelWidgets[index]->calculateTheoreticalCurve(params, providedTime, token);
+    }
+    return ModelCurveData();
+}
+
+ModelCurveData ModelManager::calculateTheoreticalCurveOnGrid(ModelType type, const QMap<QString, double>& params, const QVector<double>& providedTime,
+                                                            const CancellationToken* token)
+{
+    int index = (int)type;
+    if (index >= 0 && index < m_modelWidgets.size()) {
+        return m_modelWidgets[index]->calculateTheoreticalCurveOnGrid(params, providedTime, token);
+    }
+    return ModelCurveData();
+}
+
+ModelCurveData ModelManager::calculatePreviewCurve(ModelType type, const QMap<QString, double>& params, const QVector<double>& providedTime)
+{
+    int index = (int)type;
+    if (index >= 0 && index < m_modelWidgets.size()) {
+        return m_modelWidgets[index]->calculatePreviewCurve(params, providedTime);
+    }
+    return ModelCurveData();
+}
+
+bool ModelManager::cachedPreviewCurve(ModelType type, const QMap<QString, double>& params, const QVector<double>& providedTime, ModelCurveData& curve)
+{
+    int index = (int)type;
+    if (index >= 0 && index < m_modelWidgets.size()) {
+        return m_modelWidgets[index]->cachedPreviewCurve(params, providedTime, curve);
+    }
+    return false;
+}
+
+QMap<QString, double> ModelManager::dimensionlessKey(ModelType type, const QMap<QString, double>& params)
+{
+    int index = (int)type;
+    if (index >= 0 && index < m_modelWidgets.size()) {
+        return m_modelWidgets[index]->dimensionlessKey(params);
+    }
+    return QMap<QString, double>();
+}
+
+void ModelManager::buildDimensionlessGrid(ModelType type, const QMap<QString, double>& params, double lo, double hi,
+                                          QVector<double>& gx, QVector<double>& gy, const CancellationToken* token)
+{
+    int index = (int)type;
+    if (index >= 0 && index < m_modelWidgets.size()) {
+        m_modelWidgets[index]->buildDimensionlessGrid(params, lo, hi, gx, gy, token);
+    }
+}
+
+ModelCurveData ModelManager::curveFromDimensionlessGrid(ModelType type, const QMap<QString, double>& params, const QVector<double>& gx, const QVector<double>& gy,
+                                                        const QVector<double>& providedTime)
+{
+    int index = (int)type;
+    if (index >= 0 && index < m_modelWidgets.size()) {
+        return m_modelWidgets[index]->curveFromDimensionlessGrid(params, gx, gy, providedTime);
     }
     return ModelCurveData();
 }
@@ -36,8 +36,25 @@ public:
     // 获取当前模型类型名称
     static QString getModelTypeName(ModelType type);
 
-    // 计算理论曲线接口 (供 FittingWidget 使用)
-    ModelCurveData calculateTheoreticalCurve(ModelType type, const QMap<QString, double>& params, const QVector<double>& providedTime = QVector<double>());
+    // 计算理论曲线接口 (供 FittingWidget 使用)；token 用于协作式取消
+    ModelCurveData calculateTheoreticalCurve(ModelType type, const QMap<QString, double>& params, const QVector<double>& providedTime = QVector<double>(),
+                                             const CancellationToken* token = nullptr);
+
+    // 网格模式计算理论曲线 (自适应对数网格 + 双对数插值，供拟合残差计算使用)
+    ModelCurveData calculateTheoreticalCurveOnGrid(ModelType type, const QMap<QString, double>& params, const QVector<double>& providedTime,
+                                                   const CancellationToken* token = nullptr);
+
+    // 快速预览曲线 (粗网格 + 无因次缓存，供交互式参数调整使用)
+    ModelCurveData calculatePreviewCurve(ModelType type, const QMap<QString, double>& params, const QVector<double>& providedTime = QVector<double>());
+    // 只用缓存或预制表的预览 (不做反演，可在界面线程调用)，未命中时返回 false
+    bool cachedPreviewCurve(ModelType type, const QMap<QString, double>& params, const QVector<double>& providedTime, ModelCurveData& curve);
+
+    // 无因次曲线分步接口 (见 ModelWidget01_06 同名函数)
+    QMap<QString, double> dimensionlessKey(ModelType type, const QMap<QString, double>& params);
+    void buildDimensionlessGrid(ModelType type, const QMap<QString, double>& params, double lo, double hi,
+                                QVector<double>& gx, QVector<double>& gy, const CancellationToken* token = nullptr);
+    ModelCurveData curveFromDimensionlessGrid(ModelType type, const QMap<QString, double>& params, const QVector<double>& gx, const QVector<double>& gy,
+                                              const QVector<double>& providedTime);
 
     // 获取默认参数 (供 FittingWidget 使用)
     QMap<QString, double> getDefaultParameters(ModelType type);
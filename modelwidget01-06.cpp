@@ -14,39 +14,159 @@
 #include "modelmanager.h"
 #include "pressurederivativecalculator.h"
 #include "modelparameter.h"
+#include "curveinterpolator.h"
+#include "cancellationtoken.h"
 
 #include <Eigen/Dense>
 #include <boost/math/special_functions/bessel.hpp>
 
 #include <cmath>
 #include <algorithm>
+#include <limits>
 #include <QDebug>
 #include <QMessageBox>
 #include <QFileDialog>
 #include <QTextStream>
 #include <QDateTime>
 #include <QCoreApplication>
+#include <QPair>
+#include <QtConcurrent>
+#include <QProgressDialog>
+#include <QEventLoop>
+#include <QTimer>
+#include <QHash>
+#include <QRegularExpression>
+#include <random>
 
 #ifndef M_PI
 #define M_PI 3.14159265358979323846
 #endif
 
+namespace {
+// 参数输入分布: N(均值,标准差)、U(下限,上限)、LN(中值,log10 标准差)、T(最小值,众数,最大值)
+struct InputDistribution {
+    enum Kind { Normal, Uniform, LogNormal, Triangular };
+    Kind kind = Normal;
+    double a = 0.0, b = 0.0, c = 0.0;
+
+    // 代表值: 用于完成信号及依赖参数显示
+    double center() const {
+        switch (kind) {
+        case Uniform: return 0.5 * (a + b);
+        case Triangular: return b;
+        default: return a;
+        }
+    }
+
+    double sample(std::mt19937& rng) const {
+        switch (kind) {
+        case Uniform: return std::uniform_real_distribution<double>(a, b)(rng);
+        case LogNormal: return a * std::pow(10.0, std::normal_distribution<double>(0.0, b)(rng));
+        case Triangular: {
+            double u = std::uniform_real_distribution<double>(0.0, 1.0)(rng);
+            double fc = (b - a) / (c - a);
+            return u < fc ? a + std::sqrt(u * (c - a) * (b - a)) : c - std::sqrt((1.0 - u) * (c - a) * (c - b));
+        }
+        default: return std::normal_distribution<double>(a, b)(rng);
+        }
+    }
+};
+
+// 解析分布写法；普通数值或敏感性逗号列表返回 false
+bool parseDistribution(const QString& text, InputDistribution& dist)
+{
+    static const QRegularExpression re("^\\s*(LN|N|U|T)\\s*[(（](.*)[)）]\\s*$", QRegularExpression::CaseInsensitiveOption);
+    QRegularExpressionMatch match = re.match(text);
+    if (!match.hasMatch()) return false;
+
+    QString args = match.captured(2);
+    args.replace("，", ",");
+    QVector<double> v;
+    for (const QString& part : args.split(",", Qt::SkipEmptyParts)) {
+        bool ok;
+        double x = part.trimmed().toDouble(&ok);
+        if (!ok) return false;
+        v.append(x);
+    }
+
+    QString kind = match.captured(1).toUpper();
+    if (kind == "T") {
+        if (v.size() != 3 || v[1] < v[0] || v[2] < v[1] || !(v[2] > v[0])) return false;
+        dist.kind = InputDistribution::Triangular;
+        dist.c = v[2];
+    } else if (kind == "U") {
+        if (v.size() != 2 || !(v[1] > v[0])) return false;
+        dist.kind = InputDistribution::Uniform;
+    } else {
+        if (v.size() != 2 || !(v[1] > 0)) return false;
+        if (kind == "LN" && !(v[0] > 0)) return false;
+        dist.kind = (kind == "LN") ? InputDistribution::LogNormal : InputDistribution::Normal;
+    }
+    dist.a = v[0];
+    dist.b = v[1];
+    return true;
+}
+
+// 敏感性曲线色表: 单参数时沿色相均匀取色；多参数时每个参数一个色相，同一参数的各取值由浅到深
+QColor sweepColor(int group, int groupCount, int index, int count)
+{
+    if (groupCount <= 1) {
+        double hue = count > 1 ? 0.8 * index / (count - 1) : 0.0;
+        return QColor::fromHsvF(hue, 0.85, 0.85);
+    }
+    double hue = 0.8 * group / (groupCount - 1);
+    double value = count > 1 ? 0.95 - 0.45 * index / (count - 1) : 0.85;
+    return QColor::fromHsvF(hue, 0.85, value);
+}
+
+// 抽样值是否物理可行: 表皮系数可正可负，井储与压敏系数可为零，其余参数须为正
+bool admissibleSample(const QString& key, double value)
+{
+    if (key == "S") return std::isfinite(value);
+    if (key == "cD" || key == "gamaD") return value >= 0.0;
+    return value > 0.0;
+}
+}
+
 ModelWidget01_06::ModelWidget01_06(ModelType type, QWidget *parent)
     : QWidget(parent)
     , ui(new Ui::ModelWidget01_06)
     , m_type(type)
     , m_highPrecision(true)
+    , m_mcSampleCount(0)
 {
+    // 预制表不存在时为未加载状态，预览回退到逐点反演
+    m_typeTable = TypeCurveTable::shared(tableGeometry());
+
     ui->setupUi(this);
-    m_colorList = { Qt::red, Qt::blue, QColor(0,180,0), Qt::magenta, QColor(255,140,0), Qt::cyan };
+    m_mcTimer = new QTimer(this);
+    m_mcTimer->setInterval(200);
 
     initUi();
     initChart();
+    initSensitivityCharts();
     setupConnections();
     onResetParameters();
 }
 
-ModelWidget01_06::~ModelWidget01_06() { delete ui; }
+ModelWidget01_06::~ModelWidget01_06()
+{
+    stopBackgroundTasks();
+    delete ui;
+}
+
+void ModelWidget01_06::stopBackgroundTasks()
+{
+    if (m_refineToken) m_refineToken->cancel();
+    if (m_mcToken) m_mcToken->cancel();
+    m_previewWatcher.waitForFinished();
+    m_refineWatcher.waitForFinished();
+    for (QFuture<ModelCurveData>& f : m_staleRefines) f.waitForFinished();
+    m_staleRefines.clear();
+    m_mcWatcher.waitForFinished();
+    for (QFuture<MonteCarloResult>& f : m_staleMcRuns) f.waitForFinished();
+    m_staleMcRuns.clear();
+}
 
 QString ModelWidget01_06::getModelName() const {
     switch(m_type) {
@@ -129,9 +249,46 @@ void ModelWidget01_06::initChart() {
     m_plot->legend->setBrush(QBrush(QColor(255, 255, 255, 200)));
 }
 
+void ModelWidget01_06::initSensitivityCharts() {
+    QVBoxLayout* layout = new QVBoxLayout(ui->sensitivityContainer);
+    layout->setContentsMargins(0,0,0,0);
+    m_tornadoPlot = new QCustomPlot(this);
+    m_spiderPlot = new QCustomPlot(this);
+    layout->addWidget(m_tornadoPlot);
+    layout->addWidget(m_spiderPlot);
+
+    QFont titleFont("SimHei", 12, QFont::Bold);
+    QFont labelFont("Arial", 10, QFont::Bold);
+
+    // 龙卷风图: 各参数取最小/最大值时末时刻压差相对基准的变化，按影响幅度由上到下排序
+    m_tornadoPlot->setBackground(Qt::white);
+    m_tornadoPlot->plotLayout()->insertRow(0);
+    m_tornadoPlot->plotLayout()->addElement(0, 0, new QCPTextElement(m_tornadoPlot, "龙卷风图", titleFont));
+    m_tornadoPlot->xAxis->setLabel("末时刻压差变化 (%)");
+    m_tornadoPlot->xAxis->setLabelFont(labelFont);
+    m_tornadoPlot->yAxis->grid()->setVisible(false);
+    m_tornadoPlot->legend->setVisible(true);
+    m_tornadoPlot->legend->setFont(QFont("Arial", 9));
+
+    // 蛛网图: 末时刻压差变化随参数相对取值的变化
+    m_spiderPlot->setBackground(Qt::white);
+    m_spiderPlot->plotLayout()->insertRow(0);
+    m_spiderPlot->plotLayout()->addElement(0, 0, new QCPTextElement(m_spiderPlot, "蛛网图", titleFont));
+    QSharedPointer<QCPAxisTickerLog> logTicker(new QCPAxisTickerLog);
+    m_spiderPlot->xAxis->setScaleType(QCPAxis::stLogarithmic);
+    m_spiderPlot->xAxis->setTicker(logTicker);
+    m_spiderPlot->xAxis->setLabel("参数取值 / 基准值");
+    m_spiderPlot->yAxis->setLabel("末时刻压差变化 (%)");
+    m_spiderPlot->xAxis->setLabelFont(labelFont);
+    m_spiderPlot->yAxis->setLabelFont(labelFont);
+    m_spiderPlot->legend->setVisible(true);
+    m_spiderPlot->legend->setFont(QFont("Arial", 9));
+}
+
 void ModelWidget01_06::setupConnections() {
     connect(ui->calculateButton, &QPushButton::clicked, this, &ModelWidget01_06::onCalculateClicked);
     connect(ui->resetButton, &QPushButton::clicked, this, &ModelWidget01_06::onResetParameters);
+    connect(ui->tableButton, &QPushButton::clicked, this, &ModelWidget01_06::onGenerateTable);
     connect(ui->btnExportData, &QPushButton::clicked, this, &ModelWidget01_06::onExportData);
     connect(ui->btnExportImage, &QPushButton::clicked, this, &ModelWidget01_06::onExportImage);
     connect(ui->resetViewButton, &QPushButton::clicked, this, &ModelWidget01_06::onResetView);
@@ -140,6 +297,25 @@ void ModelWidget01_06::setupConnections() {
     connect(ui->LEdit, &QLineEdit::editingFinished, this, &ModelWidget01_06::onDependentParamsChanged);
     connect(ui->LfEdit, &QLineEdit::editingFinished, this, &ModelWidget01_06::onDependentParamsChanged);
     connect(ui->checkShowPoints, &QCheckBox::toggled, this, &ModelWidget01_06::onShowPointsToggled);
+    connect(&m_previewWatcher, &QFutureWatcher<ModelCurveData>::resultReadyAt, this, &ModelWidget01_06::onPreviewResultReady);
+    connect(&m_previewWatcher, &QFutureWatcher<ModelCurveData>::finished, this, &ModelWidget01_06::onPreviewFinished);
+    connect(&m_refineWatcher, &QFutureWatcher<ModelCurveData>::resultReadyAt, this, &ModelWidget01_06::onRefinementResultReady);
+    connect(&m_refineWatcher, &QFutureWatcher<ModelCurveData>::finished, this, &ModelWidget01_06::onRefinementFinished);
+    connect(&m_mcWatcher, &QFutureWatcher<MonteCarloResult>::finished, this, &ModelWidget01_06::onMonteCarloFinished);
+    connect(m_mcTimer, &QTimer::timeout, this, [this]() {
+        if (!m_mcProgress || m_mcSampleCount <= 0) return;
+        int percent = qMin(100, m_mcProgress->load() * 100 / m_mcSampleCount);
+        ui->calculateButton->setText(QString("不确定性计算 %1%").arg(percent));
+    });
+
+    // 参数编辑后自动刷新预览 (已计算过曲线时)
+    const QList<QLineEdit*> paramEdits = { ui->phiEdit, ui->hEdit, ui->muEdit, ui->BEdit, ui->CtEdit, ui->qEdit,
+                                           ui->kfEdit, ui->kmEdit, ui->LEdit, ui->LfEdit, ui->nfEdit, ui->rmDEdit,
+                                           ui->omga1Edit, ui->omga2Edit, ui->remda1Edit, ui->gamaDEdit,
+                                           ui->reDEdit, ui->cDEdit, ui->sEdit };
+    for (QLineEdit* edit : paramEdits) {
+        connect(edit, &QLineEdit::editingFinished, this, &ModelWidget01_06::onParamsEdited);
+    }
 }
 
 void ModelWidget01_06::setHighPrecision(bool high) { m_highPrecision = high; }
@@ -158,6 +334,19 @@ QVector<double> ModelWidget01_06::parseInput(const QString& text) {
     return values;
 }
 
+QList<QPair<QString, QLineEdit*>> ModelWidget01_06::parameterEdits() const {
+    QList<QPair<QString, QLineEdit*>> edits = {
+        { "phi", ui->phiEdit }, { "h", ui->hEdit }, { "mu", ui->muEdit }, { "B", ui->BEdit }, { "Ct", ui->CtEdit }, { "q", ui->qEdit },
+        { "kf", ui->kfEdit }, { "km", ui->kmEdit }, { "L", ui->LEdit }, { "Lf", ui->LfEdit }, { "nf", ui->nfEdit }, { "rmD", ui->rmDEdit },
+        { "omega1", ui->omga1Edit }, { "omega2", ui->omga2Edit }, { "lambda1", ui->remda1Edit }, { "gamaD", ui->gamaDEdit } };
+    if (m_type != Model_1 && m_type != Model_2) edits.append(qMakePair(QString("reD"), ui->reDEdit));
+    if (m_type == Model_1 || m_type == Model_3 || m_type == Model_5) {
+        edits.append(qMakePair(QString("cD"), ui->cDEdit));
+        edits.append(qMakePair(QString("S"), ui->sEdit));
+    }
+    return edits;
+}
+
 void ModelWidget01_06::setInputText(QLineEdit* edit, double value) {
     if(!edit) return;
     edit->setText(QString::number(value, 'g', 8));
@@ -200,8 +389,10 @@ void ModelWidget01_06::onResetParameters() {
 }
 
 void ModelWidget01_06::onDependentParamsChanged() {
-    double L = parseInput(ui->LEdit->text()).first();
-    double Lf = parseInput(ui->LfEdit->text()).first();
+    // 填写分布时按代表值显示
+    InputDistribution dist;
+    double L = parseDistribution(ui->LEdit->text(), dist) ? dist.center() : parseInput(ui->LEdit->text()).first();
+    double Lf = parseDistribution(ui->LfEdit->text(), dist) ? dist.center() : parseInput(ui->LfEdit->text()).first();
     if (L > 1e-9) setInputText(ui->LfDEdit, Lf / L);
     else setInputText(ui->LfDEdit, 0.0);
 }
@@ -224,16 +415,29 @@ void ModelWidget01_06::onShowPointsToggled(bool checked) {
 }
 
 void ModelWidget01_06::onCalculateClicked() {
-    ui->calculateButton->setEnabled(false);
-    ui->calculateButton->setText("计算中...");
-    QCoreApplication::processEvents();
     runCalculation();
-    ui->calculateButton->setEnabled(true);
-    ui->calculateButton->setText("开始计算");
+}
+
+void ModelWidget01_06::onParamsEdited() {
+    // 尚未计算过曲线时不自动触发
+    if (res_tD.isEmpty() && !m_refineToken && !m_mcToken) return;
+    runCalculation();
 }
 
 void ModelWidget01_06::runCalculation() {
-    m_plot->clearGraphs();
+    // 任一参数填写了分布 (如 N(0.05,0.01)) 时转入蒙特卡洛不确定性计算
+    InputDistribution dist;
+    for (const auto& item : parameterEdits()) {
+        if (parseDistribution(item.second->text(), dist)) {
+            runMonteCarlo();
+            return;
+        }
+    }
+    if (m_mcToken) {
+        m_mcToken->cancel();
+        m_mcToken.clear();
+        m_mcTimer->stop();
+    }
 
     QMap<QString, QVector<double>> rawParams;
     rawParams["phi"] = parseInput(ui->phiEdit->text());
@@ -266,18 +470,13 @@ void ModelWidget01_06::runCalculation() {
         rawParams["S"] = {0.0};
     }
 
-    // 敏感性分析检测
-    QString sensitivityKey = "";
-    QVector<double> sensitivityValues;
+    // 敏感性分析检测: 填写了多个取值的参数均参与 (时间除外)，基准值取各列表的第一个值
+    QStringList sweepKeys;
     for(auto it = rawParams.begin(); it != rawParams.end(); ++it) {
         if(it.key() == "t") continue;
-        if(it.value().size() > 1) {
-            sensitivityKey = it.key();
-            sensitivityValues = it.value();
-            break;
-        }
+        if(it.value().size() > 1) sweepKeys.append(it.key());
     }
-    bool isSensitivity = !sensitivityKey.isEmpty();
+    bool isSensitivity = !sweepKeys.isEmpty();
 
     QMap<QString, double> baseParams;
     for(auto it = rawParams.begin(); it != rawParams.end(); ++it) {
@@ -294,37 +493,133 @@ void ModelWidget01_06::runCalculation() {
     if(maxTime < 1e-3) maxTime = 1000.0;
     QVector<double> t = ModelManager::generateLogTimeSteps(nPoints, -3.0, log10(maxTime));
 
-    int iterations = isSensitivity ? sensitivityValues.size() : 1;
-    iterations = qMin(iterations, (int)m_colorList.size());
-
     QString resultTextHeader = QString("计算完成 (%1)\n").arg(getModelName());
-    if(isSensitivity) resultTextHeader += QString("敏感性参数: %1\n").arg(sensitivityKey);
-
-    for(int i = 0; i < iterations; ++i) {
+    if(isSensitivity) resultTextHeader += QString("敏感性参数: %1\n").arg(sweepKeys.join(", "));
+
+    RefineJob job;
+    job.header = resultTextHeader;
+    job.baseParams = baseParams;
+    job.isSensitivity = isSensitivity;
+    job.sweepKeys = sweepKeys;
+    auto addCase = [&](int group, double value, const QString& name, const QColor& color) {
         QMap<QString, double> currentParams = baseParams;
-        double val = 0;
-        if (isSensitivity) {
-            val = sensitivityValues[i];
-            currentParams[sensitivityKey] = val;
-            if (sensitivityKey == "L" || sensitivityKey == "Lf") {
-                if(currentParams["L"] > 1e-9) currentParams["LfD"] = currentParams["Lf"] / currentParams["L"];
+        if (group >= 0) currentParams[sweepKeys[group]] = value;
+        if(currentParams["L"] > 1e-9) currentParams["LfD"] = currentParams["Lf"] / currentParams["L"];
+        job.params.append(currentParams);
+        job.names.append(name);
+        job.colors.append(color);
+        job.caseGroup.append(group);
+        job.caseValues.append(value);
+    };
+    if (sweepKeys.size() == 1) {
+        // 单参数: 列表中每个取值一条曲线
+        const QVector<double>& values = rawParams[sweepKeys.first()];
+        for (int i = 0; i < values.size(); ++i) {
+            addCase(0, values[i], QString("%1 = %2").arg(sweepKeys.first()).arg(values[i]), sweepColor(0, 1, i, values.size()));
+        }
+    } else if (isSensitivity) {
+        // 多参数: 基准工况加各参数逐一单独变化 (龙卷风图 / 蛛网图)
+        addCase(-1, 0.0, QString("基准"), Qt::black);
+        for (int g = 0; g < sweepKeys.size(); ++g) {
+            const QVector<double>& values = rawParams[sweepKeys[g]];
+            for (int i = 1; i < values.size(); ++i) {
+                addCase(g, values[i], QString("%1 = %2").arg(sweepKeys[g]).arg(values[i]),
+                        sweepColor(g, sweepKeys.size(), i - 1, values.size() - 1));
             }
         }
+    } else {
+        addCase(-1, 0.0, QString("理论曲线"), Qt::red);
+    }
 
-        ModelCurveData res = calculateTheoreticalCurve(currentParams, t);
-        res_tD = std::get<0>(res);
-        res_pD = std::get<1>(res);
-        res_dpD = std::get<2>(res);
+    // 第一阶段: 缓存或预制表能直接给出的预览立即绘制，其余工况先占位，由后台粗网格预览逐个填充
+    QList<QMap<QString, double>> pendingParams;
+    job.refined.fill(false, job.params.size());
+    m_plot->clearGraphs();
+    for(int i = 0; i < job.params.size(); ++i) {
+        ModelCurveData preview;
+        if (!cachedPreviewCurve(job.params[i], t, preview)) {
+            job.previewCases.append(i);
+            pendingParams.append(job.params[i]);
+        }
+        plotCurve(preview, job.names[i], job.colors[i], isSensitivity);
+    }
+    onFitToData();
+    onShowPointsToggled(ui->checkShowPoints->isChecked());
+    ui->resultTextEdit->setText(resultTextHeader + (pendingParams.isEmpty() ? "预览曲线已显示" : "正在计算预览曲线") + "，正在后台进行全精度计算...\n");
+
+    // 第二阶段: 各工况并行全精度计算，每完成一个即替换其预览曲线；取消上一次尚未完成的预览与细化
+    if (m_refineToken) m_refineToken->cancel();
+    // 被取代的任务只能在下一次检查令牌时退出，保留其 future 供析构时等待
+    m_staleRefines.append(m_previewWatcher.future());
+    m_staleRefines.append(m_refineWatcher.future());
+    m_staleRefines.erase(std::remove_if(m_staleRefines.begin(), m_staleRefines.end(),
+                                        [](const QFuture<ModelCurveData>& f) { return f.isFinished(); }),
+                         m_staleRefines.end());
+    QSharedPointer<CancellationToken> token(new CancellationToken);
+    m_refineToken = token;
+    m_refineJob = job;
+    ui->calculateButton->setText(QString("精细计算中 0/%1").arg(job.params.size()));
+
+    if (!pendingParams.isEmpty()) {
+        m_previewWatcher.setFuture(QtConcurrent::mapped(pendingParams, [this, t, token](const QMap<QString, double>& p) {
+            if (token->isCancelled()) return ModelCurveData();
+            return calculatePreviewCurve(p, t);
+        }));
+    }
+    m_refineWatcher.setFuture(QtConcurrent::mapped(job.params, [this, t, token](const QMap<QString, double>& p) {
+        if (token->isCancelled()) return ModelCurveData();
+        return calculateTheoreticalCurve(p, t, token.data());
+    }));
+}
 
-        QColor curveColor = isSensitivity ? m_colorList[i] : Qt::red;
-        QString legendName;
-        if (isSensitivity) legendName = QString("%1 = %2").arg(sensitivityKey).arg(val);
-        else legendName = "理论曲线";
+void ModelWidget01_06::onPreviewResultReady(int index) {
+    if (!m_refineToken || m_refineToken->isCancelled()) return;
+    if (index >= m_refineJob.previewCases.size()) return;
+    // 全精度结果已先到达的工况不再用预览覆盖
+    const int caseIndex = m_refineJob.previewCases[index];
+    if (m_refineJob.refined[caseIndex] || 2 * caseIndex + 1 >= m_plot->graphCount()) return;
+    ModelCurveData data = m_previewWatcher.resultAt(index);
+    m_plot->graph(2 * caseIndex)->setData(std::get<0>(data), std::get<1>(data));
+    m_plot->graph(2 * caseIndex + 1)->setData(std::get<0>(data), std::get<2>(data));
+    m_plot->replot(QCustomPlot::rpQueuedReplot);
+}
 
-        plotCurve(res, legendName, curveColor, isSensitivity);
-    }
+void ModelWidget01_06::onPreviewFinished() {
+    if (!m_refineToken || m_refineToken->isCancelled()) return;
+    onFitToData();
+}
 
-    QString resultText = resultTextHeader;
+void ModelWidget01_06::onRefinementResultReady(int index) {
+    if (!m_refineToken || m_refineToken->isCancelled()) return;
+    if (2 * index + 1 >= m_plot->graphCount()) return;
+    m_refineJob.refined[index] = true;
+    ModelCurveData data = m_refineWatcher.resultAt(index);
+    m_plot->graph(2 * index)->setData(std::get<0>(data), std::get<1>(data));
+    m_plot->graph(2 * index + 1)->setData(std::get<0>(data), std::get<2>(data));
+    m_plot->replot(QCustomPlot::rpQueuedReplot);
+    ui->calculateButton->setText(QString("精细计算中 %1/%2").arg(m_refineWatcher.progressValue()).arg(m_refineJob.params.size()));
+}
+
+void ModelWidget01_06::onRefinementFinished() {
+    // 已被新的编辑取代的细化结果直接丢弃
+    if (!m_refineToken || m_refineToken->isCancelled()) return;
+    QList<ModelCurveData> results = m_refineWatcher.future().results();
+    m_refineToken.clear();
+    ui->calculateButton->setText("开始计算");
+    if (results.size() != m_refineJob.params.size()) return;
+
+    m_plot->clearGraphs();
+    for (int i = 0; i < results.size(); ++i) {
+        plotCurve(results[i], m_refineJob.names[i], m_refineJob.colors[i], m_refineJob.isSensitivity);
+    }
+    // 多参数分析时结果表给出基准工况
+    const ModelCurveData& shown = (m_refineJob.sweepKeys.size() > 1) ? results.first() : results.last();
+    res_tD = std::get<0>(shown);
+    res_pD = std::get<1>(shown);
+    res_dpD = std::get<2>(shown);
+    if (m_refineJob.isSensitivity) updateSensitivityRanking(results);
+
+    QString resultText = m_refineJob.header;
     resultText += "t(h)\t\tDp(MPa)\t\tdDp(MPa)\n";
     for(int i=0; i<res_pD.size(); ++i) {
         resultText += QString("%1\t%2\t%3\n").arg(res_tD[i],0,'e',4).arg(res_pD[i],0,'e',4).arg(res_dpD[i],0,'e',4);
@@ -333,7 +628,217 @@ void ModelWidget01_06::runCalculation() {
 
     onFitToData();
     onShowPointsToggled(ui->checkShowPoints->isChecked());
-    emit calculationCompleted(getModelName(), baseParams);
+    emit calculationCompleted(getModelName(), m_refineJob.baseParams);
+}
+
+void ModelWidget01_06::updateSensitivityRanking(const QList<ModelCurveData>& results) {
+    const RefineJob& job = m_refineJob;
+    // 基准工况: 多参数时为第一个工况，单参数时为列表第一个取值
+    const QVector<double>& baseP = std::get<1>(results.first());
+    if (baseP.isEmpty() || !(baseP.last() > 0)) return;
+    const double baseValue = baseP.last();
+    const double tEnd = std::get<0>(results.first()).last();
+
+    struct Swing { QString key; double low; double high; };
+    QVector<Swing> swings;
+    m_spiderPlot->clearGraphs();
+    const int groupCount = job.sweepKeys.size();
+    for (int g = 0; g < groupCount; ++g) {
+        const QString& key = job.sweepKeys[g];
+        const double baseParam = job.baseParams.value(key);
+        Swing swing{ key, 0.0, 0.0 };
+        double lowParam = baseParam, highParam = baseParam;
+        QVector<QPair<double, double>> spider;  // (参数相对取值, 压差变化 %)
+        spider.append(qMakePair(1.0, 0.0));
+        for (int i = 0; i < results.size(); ++i) {
+            if (job.caseGroup[i] != g) continue;
+            const QVector<double>& p = std::get<1>(results[i]);
+            if (p.isEmpty()) continue;
+            double change = 100.0 * (p.last() / baseValue - 1.0);
+            double v = job.caseValues[i];
+            if (v < lowParam) { lowParam = v; swing.low = change; }
+            if (v > highParam) { highParam = v; swing.high = change; }
+            double ratio = (baseParam != 0.0) ? v / baseParam : 0.0;
+            if (ratio > 0 && ratio != 1.0) spider.append(qMakePair(ratio, change));
+        }
+        swings.append(swing);
+
+        std::sort(spider.begin(), spider.end());
+        QVector<double> x, y;
+        for (const auto& pt : spider) { x.append(pt.first); y.append(pt.second); }
+        QCPGraph* graph = m_spiderPlot->addGraph();
+        graph->setData(x, y);
+        graph->setPen(QPen(sweepColor(g, qMax(groupCount, 2), 0, 1), 2));
+        graph->setScatterStyle(QCPScatterStyle(QCPScatterStyle::ssDisc, 6));
+        graph->setName(key);
+    }
+
+    // 影响幅度小的在下，大的在上
+    std::sort(swings.begin(), swings.end(), [](const Swing& a, const Swing& b) {
+        return std::abs(a.high - a.low) < std::abs(b.high - b.low);
+    });
+    m_tornadoPlot->clearPlottables();
+    QCPBars* lowBars = new QCPBars(m_tornadoPlot->yAxis, m_tornadoPlot->xAxis);
+    QCPBars* highBars = new QCPBars(m_tornadoPlot->yAxis, m_tornadoPlot->xAxis);
+    QSharedPointer<QCPAxisTickerText> ticker(new QCPAxisTickerText);
+    QVector<double> keys, lows, highs;
+    double maxAbs = 0.0;
+    for (int i = 0; i < swings.size(); ++i) {
+        keys.append(i + 1);
+        lows.append(swings[i].low);
+        highs.append(swings[i].high);
+        ticker->addTick(i + 1, swings[i].key);
+        maxAbs = qMax(maxAbs, qMax(std::abs(swings[i].low), std::abs(swings[i].high)));
+    }
+    lowBars->setData(keys, lows);
+    highBars->setData(keys, highs);
+    lowBars->setWidth(0.6);
+    highBars->setWidth(0.6);
+    lowBars->setPen(Qt::NoPen);
+    highBars->setPen(Qt::NoPen);
+    lowBars->setBrush(QColor(70, 130, 180));
+    highBars->setBrush(QColor(220, 80, 60));
+    lowBars->setName("参数取最小值");
+    highBars->setName("参数取最大值");
+    m_tornadoPlot->yAxis->setTicker(ticker);
+    m_tornadoPlot->yAxis->setRange(0.4, swings.size() + 0.6);
+    if (!(maxAbs > 0)) maxAbs = 1.0;
+    m_tornadoPlot->xAxis->setRange(-1.1 * maxAbs, 1.1 * maxAbs);
+    m_tornadoPlot->xAxis->setLabel(QString("t = %1 h 压差变化 (%)").arg(tEnd, 0, 'g', 4));
+    m_tornadoPlot->replot();
+
+    m_spiderPlot->rescaleAxes();
+    m_spiderPlot->replot();
+}
+
+void ModelWidget01_06::runMonteCarlo() {
+    // 各参数取分布或固定值 (固定值取逗号列表的第一个值)
+    QMap<QString, InputDistribution> dists;
+    QMap<QString, double> baseParams;
+    QString distText;
+    for (const auto& item : parameterEdits()) {
+        InputDistribution dist;
+        if (parseDistribution(item.second->text(), dist)) {
+            dists.insert(item.first, dist);
+            baseParams[item.first] = dist.center();
+            distText += QString("  %1 ~ %2\n").arg(item.first, item.second->text().trimmed());
+        } else {
+            baseParams[item.first] = parseInput(item.second->text()).first();
+        }
+    }
+    if (!baseParams.contains("reD")) baseParams["reD"] = 0.0;
+    if (!baseParams.contains("cD")) { baseParams["cD"] = 0.0; baseParams["S"] = 0.0; }
+    // 大批量样本统一用 N=4 (与预览精度相同)，其误差远小于参数分布造成的离散
+    baseParams["N"] = 4.0;
+
+    double maxTime = parseInput(ui->tEdit->text()).first();
+    if (maxTime < 1e-3) maxTime = 1000.0;
+    baseParams["t"] = maxTime;
+    int nPoints = ui->pointsEdit->text().toInt();
+    if (nPoints < 5) nPoints = 5;
+    QVector<double> t = ModelManager::generateLogTimeSteps(nPoints, -3.0, log10(maxTime));
+
+    // 固定种子抽样，相同输入得到相同的分位带
+    const int sampleCount = ui->mcCountSpin->value();
+    std::mt19937 rng(20240601u);
+    QVector<QMap<QString, double>> samples;
+    samples.reserve(sampleCount);
+    for (int k = 0; k < sampleCount; ++k) {
+        QMap<QString, double> p = baseParams;
+        for (auto it = dists.constBegin(); it != dists.constEnd(); ++it) {
+            double v = it.value().sample(rng);
+            for (int retry = 0; retry < 100 && !admissibleSample(it.key(), v); ++retry) v = it.value().sample(rng);
+            p[it.key()] = v;
+        }
+        if (dists.contains("nf")) p["nf"] = qMax(1.0, std::round(p["nf"]));
+        p["LfD"] = (p["L"] > 1e-9) ? p["Lf"] / p["L"] : 0.0;
+        samples.append(p);
+    }
+    baseParams["LfD"] = (baseParams["L"] > 1e-9) ? baseParams["Lf"] / baseParams["L"] : 0.0;
+
+    // 取消尚未完成的细化或上一次蒙特卡洛任务
+    if (m_refineToken) {
+        m_refineToken->cancel();
+        m_refineToken.clear();
+    }
+    if (m_mcToken) m_mcToken->cancel();
+    QSharedPointer<CancellationToken> token(new CancellationToken);
+    QSharedPointer<std::atomic<int>> progress(new std::atomic<int>(0));
+    m_mcToken = token;
+    m_mcProgress = progress;
+    m_mcSampleCount = sampleCount;
+    m_mcCenterParams = baseParams;
+    m_mcHeader = QString("不确定性计算完成 (%1)\n样本数: %2\n输入分布:\n%3").arg(getModelName()).arg(sampleCount).arg(distText);
+
+    ui->resultTextEdit->setText(m_mcHeader + "正在后台分批计算...\n");
+    ui->calculateButton->setText("不确定性计算 0%");
+    m_mcTimer->start();
+
+    // 上一次任务已取消但可能仍在运行，保留其 future 供析构时等待
+    m_staleMcRuns.append(m_mcWatcher.future());
+    m_staleMcRuns.erase(std::remove_if(m_staleMcRuns.begin(), m_staleMcRuns.end(),
+                                       [](const QFuture<MonteCarloResult>& f) { return f.isFinished(); }),
+                        m_staleMcRuns.end());
+    m_mcWatcher.setFuture(QtConcurrent::run([this, samples, t, token, progress]() {
+        return computeMonteCarlo(samples, t, token.data(), progress.data());
+    }));
+}
+
+void ModelWidget01_06::onMonteCarloFinished() {
+    // 已被新的计算取代的结果直接丢弃
+    if (!m_mcToken || m_mcToken->isCancelled()) return;
+    m_mcToken.clear();
+    m_mcTimer->stop();
+    ui->calculateButton->setText("开始计算");
+
+    MonteCarloResult r = m_mcWatcher.result();
+    if (r.samples == 0) {
+        ui->resultTextEdit->setText(m_mcHeader + "没有有效样本，请检查分布参数。\n");
+        return;
+    }
+
+    // P50 为实线，P10-P90 之间填充半透明色带
+    m_plot->clearGraphs();
+    auto addBand = [this, &r](const QVector<double>& lo, const QVector<double>& mid, const QVector<double>& hi,
+                              const QColor& color, const QString& name) {
+        QColor fill = color;
+        fill.setAlpha(50);
+        QCPGraph* graphLo = m_plot->addGraph();
+        graphLo->setData(r.t, lo);
+        graphLo->setPen(QPen(fill, 1));
+        graphLo->removeFromLegend();
+        QCPGraph* graphHi = m_plot->addGraph();
+        graphHi->setData(r.t, hi);
+        graphHi->setPen(QPen(fill, 1));
+        graphHi->setBrush(QBrush(fill));
+        graphHi->setChannelFillGraph(graphLo);
+        graphHi->setName(name + " P10-P90");
+        QCPGraph* graphMid = m_plot->addGraph();
+        graphMid->setData(r.t, mid);
+        graphMid->setPen(QPen(color, 2));
+        graphMid->setName(name + " P50");
+    };
+    addBand(r.p10, r.p50, r.p90, Qt::red, "压力");
+    addBand(r.d10, r.d50, r.d90, Qt::blue, "压力导数");
+
+    // 导出与结果表均以 P50 曲线为准
+    res_tD = r.t;
+    res_pD = r.p50;
+    res_dpD = r.d50;
+
+    QString resultText = m_mcHeader;
+    resultText += QString("有效样本: %1, 拉普拉斯求解组数: %2\n").arg(r.samples).arg(r.shapes);
+    resultText += "t(h)\t\tDp_P10\t\tDp_P50\t\tDp_P90\t\tdDp_P10\t\tdDp_P50\t\tdDp_P90\n";
+    for (int i = 0; i < r.t.size(); ++i) {
+        resultText += QString("%1\t%2\t%3\t%4\t%5\t%6\t%7\n").arg(r.t[i],0,'e',4)
+                          .arg(r.p10[i],0,'e',4).arg(r.p50[i],0,'e',4).arg(r.p90[i],0,'e',4)
+                          .arg(r.d10[i],0,'e',4).arg(r.d50[i],0,'e',4).arg(r.d90[i],0,'e',4);
+    }
+    ui->resultTextEdit->setText(resultText);
+
+    onFitToData();
+    onShowPointsToggled(ui->checkShowPoints->isChecked());
+    emit calculationCompleted(getModelName(), m_mcCenterParams);
 }
 
 void ModelWidget01_06::plotCurve(const ModelCurveData& data, const QString& name, QColor color, bool isSensitivity) {
@@ -393,7 +898,8 @@ void ModelWidget01_06::onExportImage() {
     else QMessageBox::critical(this, "错误", "导出图表失败。");
 }
 
-ModelCurveData ModelWidget01_06::calculateTheoreticalCurve(const QMap<QString, double>& params, const QVector<double>& providedTime)
+ModelCurveData ModelWidget01_06::calculateTheoreticalCurve(const QMap<QString, double>& params, const QVector<double>& providedTime,
+                                                          const CancellationToken* token)
 {
     QVector<double> tPoints = providedTime;
     if (tPoints.isEmpty()) {
@@ -417,8 +923,7 @@ ModelCurveData ModelWidget01_06::calculateTheoreticalCurve(const QMap<QString, d
     }
 
     QVector<double> PD_vec, Deriv_vec;
-    auto func = std::bind(&ModelWidget01_06::flaplace_composite, this, std::placeholders::_1, std::placeholders::_2);
-    calculatePDandDeriv(tD_vec, params, func, PD_vec, Deriv_vec);
+    calculatePDandDeriv(tD_vec, params, PD_vec, Deriv_vec, token);
 
     double factor = 1.842e-3 * q * mu * B / (kf * h);
     QVector<double> finalP(tPoints.size()), finalDP(tPoints.size());
@@ -431,47 +936,572 @@ ModelCurveData ModelWidget01_06::calculateTheoreticalCurve(const QMap<QString, d
     return std::make_tuple(tPoints, finalP, finalDP);
 }
 
+ModelCurveData ModelWidget01_06::calculateTheoreticalCurveOnGrid(const QMap<QString, double>& params, const QVector<double>& providedTime,
+                                                                const CancellationToken* token)
+{
+    double tScale = dimensionlessTimeScale(params);
+
+    // 实测时间范围 (无因次)
+    double tMin = 0.0, tMax = 0.0;
+    for (double t : providedTime) {
+        if (t <= 0) continue;
+        if (tMin <= 0 || t < tMin) tMin = t;
+        if (t > tMax) tMax = t;
+    }
+    // 点数太少或时间无效时直接逐点计算
+    if (tMin <= 0 || providedTime.size() < 8 || !(tScale > 0) || std::isinf(tScale)) {
+        return calculateTheoreticalCurve(params, providedTime, token);
+    }
+
+    QVector<double> gx, gy;
+    buildDimensionlessGrid(params, std::log10(tMin * tScale) - 0.05, std::log10(tMax * tScale) + 0.05, gx, gy, token);
+    return curveFromDimensionlessGrid(params, gx, gy, providedTime);
+}
+
+double ModelWidget01_06::dimensionlessTimeScale(const QMap<QString, double>& params)
+{
+    double phi = params.value("phi", 0.05);
+    double mu = params.value("mu", 0.5);
+    double Ct = params.value("Ct", 5e-4);
+    double kf = params.value("kf", 1e-3);
+    double L = params.value("L", 1000.0);
+    return 14.4 * kf / (phi * mu * Ct * pow(L, 2));
+}
+
+double ModelWidget01_06::pressureFactor(const QMap<QString, double>& params)
+{
+    double mu = params.value("mu", 0.5);
+    double B = params.value("B", 1.05);
+    double q = params.value("q", 5.0);
+    double h = params.value("h", 20.0);
+    double kf = params.value("kf", 1e-3);
+    return 1.842e-3 * q * mu * B / (kf * h);
+}
+
+void ModelWidget01_06::buildDimensionlessGrid(const QMap<QString, double>& params, double lo, double hi,
+                                              QVector<double>& gx, QVector<double>& gy, const CancellationToken* token)
+{
+    const double pointsPerDecade = 4.0;   // 初始网格密度
+    const double curvatureTol = 2e-3;     // 单区间插值误差容限 (log10 单位)
+    const int maxGridPoints = 160;
+    const int maxPasses = 4;
+    const int verifyCount = 3;
+    const double verifyTol = 5e-3;        // 校验点处插值相对误差容限 (与 curvatureTol 相当)
+    const int maxVerifyRounds = 3;
+
+    int N = stehfestOrder(params);
+    int nInit = qMax(8, (int)std::ceil((hi - lo) * pointsPerDecade) + 1);
+
+    // 网格节点保存 log10(tD) 与 log10(pD)
+    gx.clear(); gy.clear();
+    gx.reserve(maxGridPoints); gy.reserve(maxGridPoints);
+    auto evalNode = [&](double lx) -> double {
+        double pd = stehfestInversion(std::pow(10.0, lx), params, N, token);
+        return std::log10(qMax(pd, 1e-300));
+    };
+    for (int i = 0; i < nInit; ++i) {
+        double lx = lo + (hi - lo) * i / (nInit - 1);
+        gx.append(lx); gy.append(evalNode(lx));
+    }
+
+    // 估计第 i 个区间的插值误差: 取两端节点二阶差商的较大者 * h^2 / 8
+    auto intervalError = [&](int i) -> double {
+        auto curvature = [&](int k) -> double {
+            if (k <= 0 || k >= gx.size() - 1) return 0.0;
+            double s1 = (gy[k] - gy[k - 1]) / (gx[k] - gx[k - 1]);
+            double s2 = (gy[k + 1] - gy[k]) / (gx[k + 1] - gx[k]);
+            return 2.0 * (s2 - s1) / (gx[k + 1] - gx[k - 1]);
+        };
+        double c = qMax(std::abs(curvature(i)), std::abs(curvature(i + 1)));
+        double w = gx[i + 1] - gx[i];
+        return c * w * w / 8.0;
+    };
+
+    // 按曲率自适应加密：误差超限的区间插入中点
+    for (int pass = 0; pass < maxPasses && gx.size() < maxGridPoints; ++pass) {
+        if (CancellationToken::cancelled(token)) break;
+        QVector<int> split;
+        for (int i = 0; i < gx.size() - 1; ++i) {
+            if (intervalError(i) > curvatureTol) split.append(i);
+        }
+        if (split.isEmpty()) break;
+
+        QVector<double> nx, ny;
+        nx.reserve(gx.size() + split.size()); ny.reserve(gx.size() + split.size());
+        int s = 0;
+        for (int i = 0; i < gx.size(); ++i) {
+            nx.append(gx[i]); ny.append(gy[i]);
+            if (s < split.size() && split[s] == i) {
+                if (nx.size() + (gx.size() - i) < maxGridPoints) {
+                    double mx = 0.5 * (gx[i] + gx[i + 1]);
+                    nx.append(mx); ny.append(evalNode(mx));
+                }
+                ++s;
+            }
+        }
+        gx = nx; gy = ny;
+    }
+
+    // 误差校验：在估计误差最大的几个区间中点做真实反演，与插值结果比较；
+    // 曲率估计偏乐观 (校验误差超限) 时校验点并入网格后再校验下一批
+    for (int round = 0; round < maxVerifyRounds; ++round) {
+        QVector<QPair<double, int>> ranked;
+        for (int i = 0; i < gx.size() - 1; ++i) ranked.append(qMakePair(intervalError(i), i));
+        std::sort(ranked.begin(), ranked.end(), [](const QPair<double, int>& a, const QPair<double, int>& b) { return a.first > b.first; });
+
+        QVector<double> vx, vy;
+        for (int k = 0; k < ranked.size() && k < verifyCount && !CancellationToken::cancelled(token); ++k) {
+            int i = ranked[k].second;
+            double mx = 0.5 * (gx[i] + gx[i + 1]);
+            vx.append(mx); vy.append(evalNode(mx));
+        }
+        if (vx.isEmpty()) break;
+
+        QVector<double> vInterp = CurveInterpolator::monotoneCubic(gx, gy, vx);
+        double maxErr = 0.0;
+        for (int k = 0; k < vx.size(); ++k) {
+            maxErr = qMax(maxErr, std::abs(std::pow(10.0, vInterp[k] - vy[k]) - 1.0));
+        }
+
+        // 校验点已经付出反演代价，并入网格进一步提高精度
+        for (int k = 0; k < vx.size(); ++k) {
+            int pos = int(std::upper_bound(gx.begin(), gx.end(), vx[k]) - gx.begin());
+            gx.insert(pos, vx[k]); gy.insert(pos, vy[k]);
+        }
+        if (maxErr <= verifyTol || gx.size() >= maxGridPoints) break;
+    }
+}
+
+ModelCurveData ModelWidget01_06::curveFromDimensionlessGrid(const QMap<QString, double>& params, const QVector<double>& gx, const QVector<double>& gy,
+                                                            const QVector<double>& providedTime)
+{
+    double tScale = dimensionlessTimeScale(params);
+    double factor = pressureFactor(params);
+
+    // 双对数插值到实测时间；导数由插值斜率给出: dpD/dln(tD) = pD * dln(pD)/dln(tD)
+    QVector<double> gridT(gx.size()), gridPD(gx.size());
+    for (int i = 0; i < gx.size(); ++i) { gridT[i] = std::pow(10.0, gx[i]); gridPD[i] = std::pow(10.0, gy[i]); }
+
+    QVector<double> tD_obs(providedTime.size());
+    for (int i = 0; i < providedTime.size(); ++i) tD_obs[i] = qMax(providedTime[i], 1e-300) * tScale;
+
+    QVector<double> slope;
+    QVector<double> PD_vec = CurveInterpolator::logLogInterpolate(gridT, gridPD, tD_obs, &slope);
+
+    QVector<double> finalP(providedTime.size()), finalDP(providedTime.size());
+    for (int i = 0; i < providedTime.size(); ++i) {
+        bool valid = providedTime[i] > 0;
+        finalP[i] = valid ? factor * PD_vec[i] : 0.0;
+        finalDP[i] = valid ? factor * PD_vec[i] * slope[i] : 0.0;
+    }
+
+    return std::make_tuple(providedTime, finalP, finalDP);
+}
+
+QMap<QString, double> ModelWidget01_06::dimensionlessKey(const QMap<QString, double>& params) const
+{
+    // 换算参数只影响 tD 与压力的比例系数，不改变无因次曲线形状
+    static const QStringList scaleKeys = { "phi", "h", "mu", "B", "Ct", "q", "t", "L", "Lf", "N", "kf", "km" };
+    QMap<QString, double> key;
+    for (auto it = params.constBegin(); it != params.constEnd(); ++it) {
+        if (!scaleKeys.contains(it.key())) key.insert(it.key(), it.value());
+    }
+    double km = params.value("km", 0.0);
+    key.insert("M12", km > 0 ? params.value("kf", 0.0) / km : 0.0);
+    return key;
+}
+
+ModelCurveData ModelWidget01_06::calculatePreviewCurve(const QMap<QString, double>& params, const QVector<double>& providedTime)
+{
+    ModelCurveData curve;
+    previewCurve(params, providedTime, true, curve);
+    return curve;
+}
+
+bool ModelWidget01_06::cachedPreviewCurve(const QMap<QString, double>& params, const QVector<double>& providedTime, ModelCurveData& curve)
+{
+    return previewCurve(params, providedTime, false, curve);
+}
+
+bool ModelWidget01_06::previewCurve(const QMap<QString, double>& params, const QVector<double>& providedTime, bool allowSolve, ModelCurveData& curve)
+{
+    const int previewPoints = 30;
+    const double margin = 0.5; // 缓存网格两端外扩的对数周期
+
+    double tScale = dimensionlessTimeScale(params);
+    double factor = pressureFactor(params);
+
+    double tMin = 0.0, tMax = 0.0;
+    for (double t : providedTime) {
+        if (t <= 0) continue;
+        if (tMin <= 0 || t < tMin) tMin = t;
+        if (t > tMax) tMax = t;
+    }
+    if (tMin <= 0 || tMax <= tMin) { tMin = 1e-3; tMax = 1e3; }
+    QVector<double> tPoints = ModelManager::generateLogTimeSteps(previewPoints, std::log10(tMin), std::log10(tMax));
+
+    QMap<QString, double> p4 = params;
+    p4["N"] = 4;
+    if (!(tScale > 0) || std::isinf(tScale)) {
+        if (!allowSolve) return false;
+        curve = calculateTheoreticalCurve(p4, tPoints);
+        return true;
+    }
+
+    double lo = std::log10(tMin * tScale);
+    double hi = std::log10(tMax * tScale);
+
+    // 命中缓存: 无因次参数相同且缓存网格覆盖所需 tD 范围
+    QMap<QString, double> key = dimensionlessKey(params);
+    QVector<double> gridTD, gridPD;
+    {
+        QMutexLocker locker(&m_previewMutex);
+        if (key == m_previewKey && !m_previewTD.isEmpty()
+            && std::log10(m_previewTD.first()) <= lo + 1e-9 && std::log10(m_previewTD.last()) >= hi - 1e-9) {
+            gridTD = m_previewTD;
+            gridPD = m_previewPD;
+        }
+    }
+
+    if (gridTD.isEmpty()) {
+        // 未命中: 在外扩后的范围内按预览点密度建网格
+        double density = previewPoints / qMax(hi - lo, 1.0);
+        int n = qBound(previewPoints, (int)std::ceil((hi - lo + 2 * margin) * density) + 1, 2 * previewPoints);
+        gridTD = ModelManager::generateLogTimeSteps(n, lo - margin, hi + margin);
+        int N = stehfestOrder(p4);
+
+        // 预制表覆盖该参数组与 Stehfest 所需的 z 范围时直接插值反演，否则各节点并行完整反演
+        LaplaceCurve curve;
+        if (m_typeTable->lookup(key, curve) && curve.covers(std::log(2.0) / gridTD.last(), N * std::log(2.0) / gridTD.first())) {
+            gridPD.resize(gridTD.size());
+            for (int i = 0; i < gridTD.size(); ++i) gridPD[i] = stehfestInversionFromTable(gridTD[i], p4, curve, N);
+        } else {
+            if (!allowSolve) return false;
+            gridPD = QtConcurrent::blockingMapped<QVector<double>>(gridTD, [this, &p4, N](double tD) {
+                return stehfestInversion(tD, p4, N);
+            });
+        }
+
+        QMutexLocker locker(&m_previewMutex);
+        m_previewKey = key;
+        m_previewTD = gridTD;
+        m_previewPD = gridPD;
+    }
+
+    QVector<double> tD_vec(tPoints.size());
+    for (int i = 0; i < tPoints.size(); ++i) tD_vec[i] = tPoints[i] * tScale;
+
+    QVector<double> slope;
+    QVector<double> PD_vec = CurveInterpolator::logLogInterpolate(gridTD, gridPD, tD_vec, &slope);
+
+    QVector<double> finalP(tPoints.size()), finalDP(tPoints.size());
+    for (int i = 0; i < tPoints.size(); ++i) {
+        finalP[i] = factor * PD_vec[i];
+        finalDP[i] = factor * PD_vec[i] * slope[i];
+    }
+    curve = std::make_tuple(tPoints, finalP, finalDP);
+    return true;
+}
+
+ModelWidget01_06::MonteCarloResult ModelWidget01_06::computeMonteCarlo(const QVector<QMap<QString, double>>& samples, const QVector<double>& t,
+                                                                         const CancellationToken* token, std::atomic<int>* progress)
+{
+    const double pointsPerDecade = 6.0;
+    const double margin = 0.3;  // 网格两端外扩的对数周期
+    const int maxGridPoints = 240;
+    const int batchSize = 64;   // 每批拉普拉斯解个数，批间检查取消
+
+    MonteCarloResult res;
+    res.t = t;
+    if (samples.isEmpty() || t.isEmpty()) return res;
+
+    // 1. 公共 tD 网格: 覆盖全部样本的 tD 范围，所有样本共用同一组拉普拉斯 z 节点
+    double lo = std::numeric_limits<double>::infinity();
+    double hi = -std::numeric_limits<double>::infinity();
+    QVector<bool> usable(samples.size(), false);
+    for (int k = 0; k < samples.size(); ++k) {
+        double scale = dimensionlessTimeScale(samples[k]);
+        if (!(scale > 0) || std::isinf(scale)) continue;
+        usable[k] = true;
+        lo = qMin(lo, std::log10(t.first() * scale));
+        hi = qMax(hi, std::log10(t.last() * scale));
+    }
+    if (!(hi >= lo)) return res;
+    lo -= margin;
+    hi += margin;
+    const int nGrid = qBound(30, (int)std::ceil((hi - lo) * pointsPerDecade) + 1, maxGridPoints);
+    const QVector<double> gridTD = ModelManager::generateLogTimeSteps(nGrid, lo, hi);
+    QVector<double> gx(nGrid);
+    for (int i = 0; i < nGrid; ++i) gx[i] = std::log10(gridTD[i]);
+
+    const int N = stehfestOrder(samples.first());
+    const double ln2 = std::log(2.0);
+    QVector<double> zNodes(nGrid * N);
+    for (int i = 0; i < nGrid; ++i) {
+        for (int m = 1; m <= N; ++m) zNodes[i * N + m - 1] = m * ln2 / gridTD[i];
+    }
+    const double zMin = ln2 / gridTD.last();
+    const double zMax = N * ln2 / gridTD.first();
+
+    // 2. 按拉普拉斯解分组: 井储表皮与压敏修正在 z 空间解之后叠加，
+    //    只有换算参数、井储表皮或压敏系数不同的样本共用同一组解
+    QHash<QString, int> shapeIndex;
+    QVector<QMap<QString, double>> shapeKeys;
+    QVector<QVector<int>> shapeSamples;
+    for (int k = 0; k < samples.size(); ++k) {
+        if (!usable[k]) continue;
+        QMap<QString, double> key = dimensionlessKey(samples[k]);
+        key.remove("cD");
+        key.remove("S");
+        key.remove("gamaD");
+        QString id;
+        for (auto it = key.constBegin(); it != key.constEnd(); ++it) id += it.key() + "=" + QString::number(it.value(), 'g', 12) + ";";
+        auto found = shapeIndex.constFind(id);
+        if (found == shapeIndex.constEnd()) {
+            shapeIndex.insert(id, shapeKeys.size());
+            shapeKeys.append(key);
+            shapeSamples.append(QVector<int>{ k });
+        } else {
+            shapeSamples[found.value()].append(k);
+        }
+    }
+    res.shapes = shapeKeys.size();
+
+    // 3. 分批并行: 每组在公共 z 节点上求一次解 (预制表覆盖时直接插值)，再叠加各样本的井储表皮、压敏与换算系数
+    QVector<QVector<double>> sampleP(samples.size()), sampleD(samples.size());
+    for (int start = 0; start < shapeKeys.size(); start += batchSize) {
+        if (CancellationToken::cancelled(token)) return res;
+        QVector<int> batch;
+        for (int s = start; s < qMin(start + batchSize, (int)shapeKeys.size()); ++s) batch.append(s);
+
+        QtConcurrent::blockingMap(batch, [&](const int& s) {
+            QMap<QString, double> raw = samples[shapeSamples[s].first()];
+            raw["cD"] = 0.0;
+            raw["S"] = 0.0;
+
+            // 只求解本组样本 tD 范围内的网格节点 (两端各多取一个)
+            double sLo = hi, sHi = lo;
+            for (int k : shapeSamples[s]) {
+                double scale = dimensionlessTimeScale(samples[k]);
+                sLo = qMin(sLo, std::log10(t.first() * scale));
+                sHi = qMax(sHi, std::log10(t.last() * scale));
+            }
+            int iLo = qMax(0, int(std::lower_bound(gx.begin(), gx.end(), sLo) - gx.begin()) - 2);
+            int iHi = qMin(nGrid, int(std::upper_bound(gx.begin(), gx.end(), sHi) - gx.begin()) + 2);
+
+            LaplaceCurve curve;
+            bool fromTable = m_typeTable->lookup(shapeKeys[s], curve) && curve.covers(zMin, zMax);
+            QVector<double> pf(zNodes.size());
+            for (int j = iLo * N; j < iHi * N; ++j) {
+                if (CancellationToken::cancelled(token)) return;
+                pf[j] = fromTable ? curve.value(zNodes[j]) : flaplace_composite(zNodes[j], raw, token);
+            }
+
+            QVector<double> sx = gx.mid(iLo, iHi - iLo);
+            QVector<double> sy(sx.size());
+            for (int k : shapeSamples[s]) {
+                for (int i = iLo; i < iHi; ++i) {
+                    double pd = stehfestFromLaplace(gridTD[i], pf.constData() + i * N, samples[k], N);
+                    sy[i - iLo] = std::log10(qMax(pd, 1e-300));
+                }
+                ModelCurveData curveData = curveFromDimensionlessGrid(samples[k], sx, sy, t);
+                sampleP[k] = std::get<1>(curveData);
+                sampleD[k] = std::get<2>(curveData);
+            }
+            if (progress) progress->fetch_add(shapeSamples[s].size());
+        });
+    }
+    if (CancellationToken::cancelled(token)) return res;
+
+    // 4. 逐时间点取分位数
+    QVector<int> valid;
+    for (int k = 0; k < samples.size(); ++k) {
+        if (sampleP[k].size() != t.size()) continue;
+        bool finite = true;
+        for (int i = 0; i < t.size() && finite; ++i) finite = std::isfinite(sampleP[k][i]) && std::isfinite(sampleD[k][i]);
+        if (finite) valid.append(k);
+    }
+    res.samples = valid.size();
+    if (valid.isEmpty()) return res;
+
+    auto quantile = [](QVector<double>& v, double q) {
+        int idx = qBound(0, (int)std::round(q * (v.size() - 1)), (int)v.size() - 1);
+        std::nth_element(v.begin(), v.begin() + idx, v.end());
+        return v[idx];
+    };
+    for (auto* vec : { &res.p10, &res.p50, &res.p90, &res.d10, &res.d50, &res.d90 }) vec->resize(t.size());
+    QVector<double> column(valid.size());
+    for (int i = 0; i < t.size(); ++i) {
+        for (int n = 0; n < valid.size(); ++n) column[n] = sampleP[valid[n]][i];
+        res.p10[i] = quantile(column, 0.1);
+        res.p50[i] = quantile(column, 0.5);
+        res.p90[i] = quantile(column, 0.9);
+        for (int n = 0; n < valid.size(); ++n) column[n] = sampleD[valid[n]][i];
+        res.d10[i] = quantile(column, 0.1);
+        res.d50[i] = quantile(column, 0.5);
+        res.d90[i] = quantile(column, 0.9);
+    }
+    res.completed = true;
+    return res;
+}
+
 void ModelWidget01_06::calculatePDandDeriv(const QVector<double>& tD, const QMap<QString, double>& params,
-                                           std::function<double(double, const QMap<QString, double>&)> laplaceFunc,
-                                           QVector<double>& outPD, QVector<double>& outDeriv)
+                                           QVector<double>& outPD, QVector<double>& outDeriv, const CancellationToken* token)
 {
     int numPoints = tD.size();
     outPD.resize(numPoints);
     outDeriv.resize(numPoints);
 
-    int N_param = (int)params.value("N", 4);
-    int N = m_highPrecision ? N_param : 4;
-    if (N % 2 != 0) N = 4;
+    int N = stehfestOrder(params);
+    outPD.fill(0.0);
+    for (int k = 0; k < numPoints; ++k) {
+        if (CancellationToken::cancelled(token)) break;
+        outPD[k] = stehfestInversion(tD[k], params, N, token);
+    }
+    if (numPoints > 2) outDeriv = PressureDerivativeCalculator::calculateBourdetDerivative(tD, outPD, 0.1);
+    else outDeriv.fill(0.0);
+}
+
+int ModelWidget01_06::stehfestOrder(const QMap<QString, double>& params) const
+{
+    // 阶数完全由参数表中的 N 决定 (界面计算时由 m_highPrecision 写入)，
+    // 计算过程不读取可变成员状态，可被多个拟合会话并发调用
+    int N = (int)params.value("N", 4);
+    if (N < 2 || N % 2 != 0) N = 4;
+    return N;
+}
+
+double ModelWidget01_06::stehfestInversion(double t, const QMap<QString, double>& params, int N, const CancellationToken* token)
+{
+    if (t <= 1e-12) return 0.0;
     double ln2 = log(2.0);
 
-    // 获取压敏系数 (MATLAB: gamaD)
-    double gamaD = params.value("gamaD", 0.0);
+    double pd_val = 0.0;
+    for (int m = 1; m <= N; ++m) {
+        // 每一项都需要一次完整的矩阵组装与求解，逐项检查取消
+        if (CancellationToken::cancelled(token)) return 0.0;
+        double z = m * ln2 / t;
+        double pf = flaplace_composite(z, params, token);
+        if (std::isnan(pf) || std::isinf(pf)) pf = 0.0;
+        pd_val += stefestCoefficient(m, N) * pf;
+    }
+    return applyStressSensitivity(pd_val * ln2 / t, params);
+}
 
-    for (int k = 0; k < numPoints; ++k) {
-        double t = tD[k];
-        if (t <= 1e-12) { outPD[k] = 0; continue; }
-        double pd_val = 0.0;
-        for (int m = 1; m <= N; ++m) {
-            double z = m * ln2 / t;
-            double pf = laplaceFunc(z, params);
-            if (std::isnan(pf) || std::isinf(pf)) pf = 0.0;
-            pd_val += stefestCoefficient(m, N) * pf;
+double ModelWidget01_06::stehfestInversionFromTable(double t, const QMap<QString, double>& params, const LaplaceCurve& curve, int N)
+{
+    if (t <= 1e-12) return 0.0;
+    double ln2 = log(2.0);
+
+    QVector<double> pf(N);
+    for (int m = 1; m <= N; ++m) pf[m - 1] = curve.value(m * ln2 / t);
+    return stehfestFromLaplace(t, pf.constData(), params, N);
+}
+
+double ModelWidget01_06::stehfestFromLaplace(double t, const double* pf, const QMap<QString, double>& params, int N)
+{
+    if (t <= 1e-12) return 0.0;
+    double ln2 = log(2.0);
+
+    double pd_val = 0.0;
+    for (int m = 1; m <= N; ++m) {
+        double f = applyWellboreStorage(m * ln2 / t, pf[m - 1], params);
+        if (std::isnan(f) || std::isinf(f)) f = 0.0;
+        pd_val += stefestCoefficient(m, N) * f;
+    }
+    return applyStressSensitivity(pd_val * ln2 / t, params);
+}
+
+double ModelWidget01_06::applyWellboreStorage(double z, double pf, const QMap<QString, double>& params) const
+{
+    // 考虑井筒储存和表皮 (对应 MATLAB: (z*pf+S)/(z+CD*z^2*(z*pf+S)))
+    // 仅对变井储模型 (1, 3, 5) 启用
+    bool hasStorage = (m_type == Model_1 || m_type == Model_3 || m_type == Model_5);
+    if (hasStorage) {
+        double CD = params.value("cD", 0.0);
+        double S = params.value("S", 0.0);
+        if (CD > 1e-12 || std::abs(S) > 1e-12) {
+            pf = (z * pf + S) / (z + CD * z * z * (z * pf + S));
         }
-        outPD[k] = pd_val * ln2 / t;
+    }
+    return pf;
+}
 
-        // 摄动法考虑压敏效应 (对应 MATLAB: -1/gamaD * log(1-gamaD*PD))
-        if (std::abs(gamaD) > 1e-9) {
-            double arg = 1.0 - gamaD * outPD[k];
-            if (arg > 1e-12) {
-                outPD[k] = -1.0 / gamaD * std::log(arg);
-            }
+double ModelWidget01_06::applyStressSensitivity(double pd, const QMap<QString, double>& params)
+{
+    // 摄动法考虑压敏效应 (对应 MATLAB: -1/gamaD * log(1-gamaD*PD))
+    double gamaD = params.value("gamaD", 0.0);
+    if (std::abs(gamaD) > 1e-9) {
+        double arg = 1.0 - gamaD * pd;
+        if (arg > 1e-12) {
+            pd = -1.0 / gamaD * std::log(arg);
         }
     }
-    if (numPoints > 2) outDeriv = PressureDerivativeCalculator::calculateBourdetDerivative(tD, outPD, 0.1);
-    else outDeriv.fill(0.0);
+    return pd;
+}
+
+TypeCurveTable::Geometry ModelWidget01_06::tableGeometry() const
+{
+    // 井储表皮在查表后叠加，变井储与恒定井储模型共用同一张表
+    if (m_type == Model_1 || m_type == Model_2) return TypeCurveTable::Infinite;
+    if (m_type == Model_3 || m_type == Model_4) return TypeCurveTable::Closed;
+    return TypeCurveTable::ConstantPressure;
 }
 
-double ModelWidget01_06::flaplace_composite(double z, const QMap<QString, double>& p) {
+void ModelWidget01_06::onGenerateTable() {
+    const TypeCurveTable::Geometry geometry = tableGeometry();
+    const int total = TypeCurveTable::curveCount(geometry);
+    QString ask = QString("将为当前边界类型生成无因次预制表 (%1 条曲线，耗时较长，仅需生成一次)。\n"
+                          "生成后参数位于表范围内时，预览曲线由查表插值得到。是否继续？").arg(total);
+    if (QMessageBox::question(this, "生成预制表", ask) != QMessageBox::Yes) return;
+
+    // 细化与蒙特卡洛任务在工作线程中查表，生成前先取消并等待其结束；
+    // 共用该表的其他模型的查询由表内部加锁，替换期间等待后改用新表
+    stopBackgroundTasks();
+    m_refineToken.clear();
+    m_mcToken.clear();
+    m_mcTimer->stop();
+    ui->calculateButton->setText("开始计算");
+
+    CancellationToken token;
+    std::atomic<int> progress(0);
+    QProgressDialog dlg("正在生成预制表...", "取消", 0, total, this);
+    dlg.setWindowModality(Qt::WindowModal);
+    dlg.setMinimumDuration(0);
+    connect(&dlg, &QProgressDialog::canceled, this, [&token]() { token.cancel(); });
+
+    // 生成期间旧表照常可查；新表写入临时文件后整体替换，共用该表的其他模型随即使用新表
+    const QString path = TypeCurveTable::defaultFilePath(geometry);
+    TypeCurveTable* table = m_typeTable;
+
+    QFutureWatcher<bool> watcher;
+    QEventLoop loop;
+    QTimer timer;
+    connect(&timer, &QTimer::timeout, &dlg, [&]() { dlg.setValue(progress.load()); });
+    connect(&watcher, &QFutureWatcher<bool>::finished, &loop, &QEventLoop::quit);
+    watcher.setFuture(QtConcurrent::run([this, table, &token, &progress]() {
+        return table->regenerate([this](double z, const QMap<QString, double>& p) {
+            return flaplace_composite(z, p);
+        }, &token, &progress);
+    }));
+    timer.start(200);
+    loop.exec();
+    timer.stop();
+    dlg.reset();
+
+    // 取消或失败时原有表保持不变 (只有全部计算并写完临时文件后才替换)
+    bool ok = watcher.result();
+    {
+        QMutexLocker locker(&m_previewMutex);
+        m_previewKey.clear();
+        m_previewTD.clear();
+        m_previewPD.clear();
+    }
+    if (ok) QMessageBox::information(this, "生成预制表", "预制表已生成: " + path);
+    else if (!token.isCancelRequested()) QMessageBox::warning(this, "生成预制表", "预制表生成失败: " + path);
+}
+
+double ModelWidget01_06::flaplace_composite(double z, const QMap<QString, double>& p, const CancellationToken* token) {
     double kf = p.value("kf");
     double km = p.value("km");
     double LfD = p.value("LfD");
@@ -492,23 +1522,13 @@ double ModelWidget01_06::flaplace_composite(double z, const QMap<QString, double
     double fs2 = M12 * temp;
 
     // 调用通用 PWD 计算内核，内部包含边界判断逻辑
-    double pf = PWD_composite(z, fs1, fs2, M12, LfD, rmD, reD, nf, xwD, m_type);
+    double pf = PWD_composite(z, fs1, fs2, M12, LfD, rmD, reD, nf, xwD, m_type, token);
 
-    // 考虑井筒储存和表皮 (对应 MATLAB: (z*pf+S)/(z+CD*z^2*(z*pf+S)))
-    // 仅对变井储模型 (1, 3, 5) 启用
-    bool hasStorage = (m_type == Model_1 || m_type == Model_3 || m_type == Model_5);
-    if (hasStorage) {
-        double CD = p.value("cD", 0.0);
-        double S = p.value("S", 0.0);
-        if (CD > 1e-12 || std::abs(S) > 1e-12) {
-            pf = (z * pf + S) / (z + CD * z * z * (z * pf + S));
-        }
-    }
-
-    return pf;
+    return applyWellboreStorage(z, pf, p);
 }
 
-double ModelWidget01_06::PWD_composite(double z, double fs1, double fs2, double M12, double LfD, double rmD, double reD, int nf, const QVector<double>& xwD, ModelType type) {
+double ModelWidget01_06::PWD_composite(double z, double fs1, double fs2, double M12, double LfD, double rmD, double reD, int nf, const QVector<double>& xwD, ModelType type,
+                                       const CancellationToken* token) {
     using namespace boost::math;
     QVector<double> ywD(nf, 0.0);
     double gama1 = sqrt(z * fs1);
@@ -587,6 +1607,8 @@ double ModelWidget01_06::PWD_composite(double z, double fs1, double fs2, double
     b_vec.setZero(); b_vec(nf) = 1.0;
 
     for (int i = 0; i < nf; ++i) {
+        // 每行 nf 个自适应积分，按行检查取消
+        if (CancellationToken::cancelled(token)) return 0.0;
         for (int j = 0; j < nf; ++j) {
             // 积分核函数: K0 + Ac*I0
             auto integrand = [&](double a) -> double {
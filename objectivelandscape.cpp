@@ -0,0 +1,158 @@
+/*
+ * objectivelandscape.cpp
+ * 文件作用：目标函数分布图计算类实现文件
+ * 功能描述：
+ * 1. 网格单元按无因次参数键分组，每组在所有成员的 tD 范围并集上构造一次自适应无因次网格
+ * 2. 各组网格并行构造 (拉普拉斯反演的主要开销)，随后各单元并行完成换算、插值与残差计算
+ * 3. 目标函数与 FitSession 一致: 压力/导数加权对数残差平方和
+ */
+
+#include "objectivelandscape.h"
+#include "fitsession.h"
+
+#include <QtConcurrent>
+#include <QHash>
+#include <QtMath>
+#include <atomic>
+#include <cmath>
+#include <numeric>
+
+ObjectiveLandscape::ObjectiveLandscape(ModelManager* modelManager, QObject* parent)
+    : QObject(parent)
+    , m_modelManager(modelManager)
+    , m_modelType(ModelManager::Model_1)
+    , m_weight(0.5)
+    , m_N(4)
+{
+}
+
+void ObjectiveLandscape::setModelType(ModelManager::ModelType type) { m_modelType = type; }
+void ObjectiveLandscape::setBaseParameters(const QMap<QString, double>& params) { m_baseParams = params; }
+void ObjectiveLandscape::setWeight(double weight) { m_weight = weight; }
+
+void ObjectiveLandscape::setObservedData(const QVector<double>& t, const QVector<double>& p, const QVector<double>& d)
+{
+    m_obsTime = t; m_obsPressure = p; m_obsDerivative = d;
+}
+
+void ObjectiveLandscape::setAxes(const LandscapeAxis& x, const LandscapeAxis& y)
+{
+    m_xAxis = x;
+    m_yAxis = y;
+}
+
+void ObjectiveLandscape::setStehfestOrder(int N) { m_N = N; }
+void ObjectiveLandscape::requestStop() { m_token.cancel(); }
+LandscapeResult ObjectiveLandscape::result() const { return m_result; }
+
+QVector<double> ObjectiveLandscape::axisValues(const LandscapeAxis& axis)
+{
+    QVector<double> v;
+    int n = qMax(2, axis.count);
+    bool useLog = axis.logScale && axis.min > 0 && axis.max > 0;
+    double a = useLog ? std::log10(axis.min) : axis.min;
+    double b = useLog ? std::log10(axis.max) : axis.max;
+    v.reserve(n);
+    for (int i = 0; i < n; ++i) {
+        double s = a + (b - a) * i / (n - 1);
+        v.append(useLog ? std::pow(10.0, s) : s);
+    }
+    return v;
+}
+
+QMap<QString, double> ObjectiveLandscape::cellParams(double x, double y) const
+{
+    QMap<QString, double> p = m_baseParams;
+    p[m_xAxis.name] = x;
+    p[m_yAxis.name] = y;
+    p["N"] = m_N;
+    if (p.contains("L") && p.contains("Lf") && p["L"] > 1e-9) p["LfD"] = p["Lf"] / p["L"];
+    return p;
+}
+
+void ObjectiveLandscape::run()
+{
+    m_result = LandscapeResult();
+    m_result.xValues = axisValues(m_xAxis);
+    m_result.yValues = axisValues(m_yAxis);
+    const int nx = m_result.xValues.size();
+    const int ny = m_result.yValues.size();
+    m_result.sse.fill(qQNaN(), nx * ny);
+
+    double tMin = 0.0, tMax = 0.0;
+    for (double t : m_obsTime) {
+        if (t <= 0) continue;
+        if (tMin <= 0 || t < tMin) tMin = t;
+        if (t > tMax) tMax = t;
+    }
+    if (!m_modelManager || tMin <= 0 || m_xAxis.name == m_yAxis.name) { emit finished(); return; }
+
+    // 1. 按无因次参数键分组: 同组单元的无因次曲线相同，只差换算系数
+    struct CurveGroup {
+        QMap<QString, double> params;
+        double lo = 0.0, hi = 0.0;   // log10(tD) 范围 (组内并集)
+        QVector<double> gx, gy;
+        bool done = false;
+    };
+    QVector<CurveGroup> groups;
+    QHash<QString, int> groupIndex;
+    QVector<int> cellGroup(nx * ny, -1);
+    for (int c = 0; c < nx * ny; ++c) {
+        QMap<QString, double> p = cellParams(m_result.xValues[c % nx], m_result.yValues[c / nx]);
+        double tScale = ModelWidget01_06::dimensionlessTimeScale(p);
+        if (!(tScale > 0) || std::isinf(tScale)) continue;
+        double lo = std::log10(tMin * tScale) - 0.05;
+        double hi = std::log10(tMax * tScale) + 0.05;
+
+        QMap<QString, double> key = m_modelManager->dimensionlessKey(m_modelType, p);
+        QString keyText;
+        for (auto it = key.constBegin(); it != key.constEnd(); ++it) {
+            keyText += it.key() + '=' + QString::number(it.value(), 'g', 17) + ';';
+        }
+        auto found = groupIndex.constFind(keyText);
+        if (found == groupIndex.constEnd()) {
+            CurveGroup g;
+            g.params = p; g.lo = lo; g.hi = hi;
+            groups.append(g);
+            groupIndex.insert(keyText, groups.size() - 1);
+            cellGroup[c] = groups.size() - 1;
+        } else {
+            CurveGroup& g = groups[found.value()];
+            g.lo = qMin(g.lo, lo); g.hi = qMax(g.hi, hi);
+            cellGroup[c] = found.value();
+        }
+    }
+    m_result.uniqueCurves = groups.size();
+
+    // 2. 并行构造各组无因次网格 (进度占 0~90%)
+    const int total = qMax(1, (int)groups.size());
+    std::atomic<int> doneCount(0);
+    QtConcurrent::blockingMap(groups, [this, total, &doneCount](CurveGroup& g) {
+        if (m_token.isCancelled()) return;
+        m_modelManager->buildDimensionlessGrid(m_modelType, g.params, g.lo, g.hi, g.gx, g.gy, &m_token);
+        g.done = !m_token.isCancelled() && g.gx.size() >= 2;
+        int k = ++doneCount;
+        emit sigProgress(k * 90 / total);
+    });
+
+    // 3. 并行计算各单元误差: 换算 + 插值 + 残差，开销与实测点数成正比
+    QVector<int> cells(nx * ny);
+    std::iota(cells.begin(), cells.end(), 0);
+    double* out = m_result.sse.data();
+    QtConcurrent::blockingMap(cells, [&](const int& c) {
+        int gi = cellGroup[c];
+        if (gi < 0 || !groups[gi].done) return;
+        QMap<QString, double> p = cellParams(m_result.xValues[c % nx], m_result.yValues[c / nx]);
+        ModelCurveData curve = m_modelManager->curveFromDimensionlessGrid(m_modelType, p, groups[gi].gx, groups[gi].gy, m_obsTime);
+        QVector<double> r = FitSession::residualsFromCurve(m_obsPressure, m_obsDerivative, std::get<1>(curve), std::get<2>(curve), m_weight);
+        if (!r.isEmpty()) out[c] = FitSession::sumSquaredError(r);
+    });
+
+    for (int c = 0; c < m_result.sse.size(); ++c) {
+        double v = m_result.sse[c];
+        if (std::isfinite(v) && (m_result.bestIndex < 0 || v < m_result.sse[m_result.bestIndex])) m_result.bestIndex = c;
+    }
+    m_result.completed = !m_token.isCancelled();
+    emit sigProgress(100);
+    emit finished();
+}
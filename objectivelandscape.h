@@ -0,0 +1,88 @@
+/*
+ * objectivelandscape.h
+ * 文件作用：目标函数分布图计算类头文件
+ * 功能描述：
+ * 1. 在任意两个拟合参数构成的二维网格上计算拟合目标函数 (加权对数残差平方和)，其余参数固定
+ * 2. 按无因次参数键对网格单元分组，每组只构造一次无因次曲线，换算参数 (产量、厚度、kf 等) 的变化直接复用
+ * 3. 无因次曲线与单元误差均并行计算，支持取消令牌与进度信号
+ */
+
+#ifndef OBJECTIVELANDSCAPE_H
+#define OBJECTIVELANDSCAPE_H
+
+#include <QObject>
+#include <QMap>
+#include <QVector>
+#include <QString>
+#include "modelmanager.h"
+#include "cancellationtoken.h"
+
+// 分布图的一个坐标轴
+struct LandscapeAxis {
+    QString name;          // 参数名
+    double min = 0.0;      // 下限
+    double max = 1.0;      // 上限
+    bool logScale = false; // 是否按对数等分
+    int count = 40;        // 网格点数
+};
+
+// 分布图计算结果
+struct LandscapeResult {
+    QVector<double> xValues;   // X 轴参数取值
+    QVector<double> yValues;   // Y 轴参数取值
+    QVector<double> sse;       // 按行存储: sse[iy * nx + ix]，未算完的单元为 NaN
+    int uniqueCurves = 0;      // 实际构造的无因次曲线条数
+    bool completed = false;    // 是否完整算完 (未被取消)
+    int bestIndex = -1;        // 最小误差单元序号
+};
+
+class ObjectiveLandscape : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit ObjectiveLandscape(ModelManager* modelManager, QObject* parent = nullptr);
+
+    // --- 计算配置 (须在 run() 之前设置) ---
+    void setModelType(ModelManager::ModelType type);
+    void setBaseParameters(const QMap<QString, double>& params);
+    void setWeight(double weight);
+    void setObservedData(const QVector<double>& t, const QVector<double>& p, const QVector<double>& d);
+    void setAxes(const LandscapeAxis& x, const LandscapeAxis& y);
+    void setStehfestOrder(int N);
+
+    // 执行计算 (阻塞，通常在 QtConcurrent 工作线程中调用)
+    void run();
+    // 请求停止 (任意线程可调用)
+    void requestStop();
+
+    LandscapeResult result() const;
+
+    // 按轴设置生成参数取值
+    static QVector<double> axisValues(const LandscapeAxis& axis);
+
+signals:
+    void sigProgress(int progress);
+    void finished();
+
+private:
+    QMap<QString, double> cellParams(double x, double y) const;
+
+private:
+    ModelManager* m_modelManager;
+    ModelManager::ModelType m_modelType;
+    QMap<QString, double> m_baseParams;
+    double m_weight;
+    int m_N;
+    LandscapeAxis m_xAxis;
+    LandscapeAxis m_yAxis;
+
+    QVector<double> m_obsTime;
+    QVector<double> m_obsPressure;
+    QVector<double> m_obsDerivative;
+
+    CancellationToken m_token;
+    LandscapeResult m_result;
+};
+
+#endif // OBJECTIVELANDSCAPE_H
@@ -0,0 +1,241 @@
+/*
+ * objectivelandscapedialog.cpp
+ * 文件作用：目标函数分布图对话框实现文件
+ * 功能描述：
+ * 1. 参数选择、范围与网格设置界面，计算在工作线程中进行，可随时停止
+ * 2. 色图显示 log10(SSE)；对数等分的轴以 log10(参数) 为坐标
+ * 3. 十字标记当前参数点，星形标记网格最小点
+ */
+
+#include "objectivelandscapedialog.h"
+
+#include <QVBoxLayout>
+#include <QHBoxLayout>
+#include <QGridLayout>
+#include <QMessageBox>
+#include <QtConcurrent>
+#include <cmath>
+
+ObjectiveLandscapeDialog::ObjectiveLandscapeDialog(ModelManager* modelManager, ModelManager::ModelType type, const QList<FitParameter>& params, double weight,
+                                                   const QVector<double>& t, const QVector<double>& p, const QVector<double>& d, QWidget* parent)
+    : QDialog(parent), m_modelManager(modelManager), m_modelType(type), m_params(params), m_weight(weight),
+      m_obsTime(t), m_obsPressure(p), m_obsDerivative(d)
+{
+    setWindowTitle("目标函数分布图"); resize(820, 680);
+
+    this->setStyleSheet(
+        "QDialog { background-color: #ffffff; color: #000000; font-family: 'Microsoft YaHei'; }"
+        "QLabel, QCheckBox, QComboBox, QLineEdit, QSpinBox { color: #000000; }"
+        "QPushButton { background-color: #ffffff; border: 1px solid #c0c0c0; border-radius: 4px; padding: 5px 15px; color: #333333; }"
+        "QPushButton:hover { background-color: #f2f2f2; border-color: #a0a0a0; color: #000000; }"
+        "QPushButton:pressed { background-color: #e0e0e0; }"
+        );
+
+    QVBoxLayout* layout = new QVBoxLayout(this);
+
+    // 参数与范围设置
+    QGridLayout* grid = new QGridLayout;
+    m_comboX = new QComboBox(this); m_comboY = new QComboBox(this);
+    for(const FitParameter& fp : m_params) {
+        if(!fp.isVisible) continue;
+        QString chName, symbol, uniSymbol, unit;
+        FittingParameterChart::getParamDisplayInfo(fp.name, chName, symbol, uniSymbol, unit);
+        QString text = QString("%1 (%2)").arg(chName, uniSymbol);
+        m_comboX->addItem(text, fp.name); m_comboY->addItem(text, fp.name);
+    }
+    // 默认取前两个参与拟合的参数
+    int first = -1, second = -1;
+    for(int i = 0; i < m_comboX->count(); ++i) {
+        const FitParameter* fp = findParam(m_comboX->itemData(i).toString());
+        if(fp && fp->isFit) { if(first < 0) first = i; else if(second < 0) second = i; }
+    }
+    if(first < 0) first = 0;
+    if(second < 0) second = (first + 1 < m_comboY->count()) ? first + 1 : first;
+    m_comboX->setCurrentIndex(first); m_comboY->setCurrentIndex(second);
+
+    m_editXMin = new QLineEdit(this); m_editXMax = new QLineEdit(this);
+    m_editYMin = new QLineEdit(this); m_editYMax = new QLineEdit(this);
+    m_chkXLog = new QCheckBox("对数等分", this); m_chkYLog = new QCheckBox("对数等分", this);
+    grid->addWidget(new QLabel("X 轴参数:", this), 0, 0); grid->addWidget(m_comboX, 0, 1);
+    grid->addWidget(new QLabel("最小:", this), 0, 2); grid->addWidget(m_editXMin, 0, 3);
+    grid->addWidget(new QLabel("最大:", this), 0, 4); grid->addWidget(m_editXMax, 0, 5);
+    grid->addWidget(m_chkXLog, 0, 6);
+    grid->addWidget(new QLabel("Y 轴参数:", this), 1, 0); grid->addWidget(m_comboY, 1, 1);
+    grid->addWidget(new QLabel("最小:", this), 1, 2); grid->addWidget(m_editYMin, 1, 3);
+    grid->addWidget(new QLabel("最大:", this), 1, 4); grid->addWidget(m_editYMax, 1, 5);
+    grid->addWidget(m_chkYLog, 1, 6);
+    layout->addLayout(grid);
+
+    QHBoxLayout* ctrl = new QHBoxLayout;
+    m_spinGrid = new QSpinBox(this); m_spinGrid->setRange(10, 100); m_spinGrid->setValue(40);
+    m_btnCompute = new QPushButton("计算", this);
+    m_btnStop = new QPushButton("停止", this); m_btnStop->setEnabled(false);
+    m_progress = new QProgressBar(this); m_progress->setRange(0, 100); m_progress->setValue(0);
+    ctrl->addWidget(new QLabel("网格点数:", this)); ctrl->addWidget(m_spinGrid);
+    ctrl->addWidget(m_btnCompute); ctrl->addWidget(m_btnStop); ctrl->addWidget(m_progress, 1);
+    layout->addLayout(ctrl);
+
+    // 色图
+    m_plot = new QCustomPlot(this);
+    m_plot->setInteractions(QCP::iRangeDrag | QCP::iRangeZoom);
+    m_colorMap = new QCPColorMap(m_plot->xAxis, m_plot->yAxis);
+    m_colorScale = new QCPColorScale(m_plot);
+    m_plot->plotLayout()->addElement(0, 1, m_colorScale);
+    m_colorScale->setType(QCPAxis::atRight);
+    m_colorScale->axis()->setLabel("log10(SSE)");
+    m_colorMap->setColorScale(m_colorScale);
+    QCPColorGradient gradient(QCPColorGradient::gpJet);
+    gradient.setNanHandling(QCPColorGradient::nhTransparent);
+    m_colorMap->setGradient(gradient);
+    QCPMarginGroup* marginGroup = new QCPMarginGroup(m_plot);
+    m_plot->axisRect()->setMarginGroup(QCP::msBottom | QCP::msTop, marginGroup);
+    m_colorScale->setMarginGroup(QCP::msBottom | QCP::msTop, marginGroup);
+    layout->addWidget(m_plot, 1);
+
+    QHBoxLayout* btns = new QHBoxLayout;
+    m_lblStatus = new QLabel(this);
+    m_btnApply = new QPushButton("采用最小点", this); m_btnApply->setEnabled(false);
+    QPushButton* close = new QPushButton("关闭", this);
+    btns->addWidget(m_lblStatus, 1); btns->addWidget(m_btnApply); btns->addWidget(close);
+    layout->addLayout(btns);
+
+    connect(m_comboX, QOverload<int>::of(&QComboBox::currentIndexChanged), this, &ObjectiveLandscapeDialog::onAxisParamChanged);
+    connect(m_comboY, QOverload<int>::of(&QComboBox::currentIndexChanged), this, &ObjectiveLandscapeDialog::onAxisParamChanged);
+    connect(m_btnCompute, &QPushButton::clicked, this, &ObjectiveLandscapeDialog::onCompute);
+    connect(m_btnStop, &QPushButton::clicked, this, &ObjectiveLandscapeDialog::onStop);
+    connect(m_btnApply, &QPushButton::clicked, this, &QDialog::accept);
+    connect(close, &QPushButton::clicked, this, &QDialog::reject);
+    connect(&m_watcher, &QFutureWatcher<void>::finished, this, &ObjectiveLandscapeDialog::onFinished);
+
+    onAxisParamChanged();
+}
+
+ObjectiveLandscapeDialog::~ObjectiveLandscapeDialog()
+{
+    if(m_engine) m_engine->requestStop();
+    m_watcher.waitForFinished();
+}
+
+QMap<QString, double> ObjectiveLandscapeDialog::bestParameters() const { return m_best; }
+
+const FitParameter* ObjectiveLandscapeDialog::findParam(const QString& name) const
+{
+    for(const FitParameter& fp : m_params) if(fp.name == name) return &fp;
+    return nullptr;
+}
+
+void ObjectiveLandscapeDialog::fillAxisRange(QComboBox* combo, QLineEdit* editMin, QLineEdit* editMax, QCheckBox* chkLog)
+{
+    const FitParameter* fp = findParam(combo->currentData().toString());
+    if(!fp) return;
+    double lo = fp->min, hi = fp->max;
+    // 上下限缺省或不包含当前值时，以当前值上下各一个数量级为范围
+    if(!(hi > lo) || fp->value < lo || fp->value > hi) {
+        lo = fp->value > 0 ? fp->value / 10.0 : fp->value - 1.0;
+        hi = fp->value > 0 ? fp->value * 10.0 : fp->value + 1.0;
+    }
+    editMin->setText(QString::number(lo, 'g', 6));
+    editMax->setText(QString::number(hi, 'g', 6));
+    chkLog->setChecked(lo > 0 && fp->name != "S" && fp->name != "nf");
+}
+
+void ObjectiveLandscapeDialog::onAxisParamChanged()
+{
+    fillAxisRange(m_comboX, m_editXMin, m_editXMax, m_chkXLog);
+    fillAxisRange(m_comboY, m_editYMin, m_editYMax, m_chkYLog);
+}
+
+void ObjectiveLandscapeDialog::onCompute()
+{
+    if(m_watcher.isRunning() || !m_modelManager) return;
+    m_xAxis.name = m_comboX->currentData().toString();
+    m_yAxis.name = m_comboY->currentData().toString();
+    if(m_xAxis.name.isEmpty() || m_xAxis.name == m_yAxis.name) {
+        QMessageBox::warning(this, "提示", "请选择两个不同的参数。"); return;
+    }
+    bool ok1, ok2, ok3, ok4;
+    m_xAxis.min = m_editXMin->text().toDouble(&ok1); m_xAxis.max = m_editXMax->text().toDouble(&ok2);
+    m_yAxis.min = m_editYMin->text().toDouble(&ok3); m_yAxis.max = m_editYMax->text().toDouble(&ok4);
+    if(!(ok1 && ok2 && ok3 && ok4) || !(m_xAxis.max > m_xAxis.min) || !(m_yAxis.max > m_yAxis.min)) {
+        QMessageBox::warning(this, "提示", "参数范围无效。"); return;
+    }
+    m_xAxis.logScale = m_chkXLog->isChecked() && m_xAxis.min > 0;
+    m_yAxis.logScale = m_chkYLog->isChecked() && m_yAxis.min > 0;
+    m_xAxis.count = m_yAxis.count = m_spinGrid->value();
+
+    QMap<QString, double> base;
+    for(const FitParameter& fp : m_params) base.insert(fp.name, fp.value);
+
+    m_engine.reset(new ObjectiveLandscape(m_modelManager), &QObject::deleteLater);
+    m_engine->setModelType(m_modelType);
+    m_engine->setBaseParameters(base);
+    m_engine->setWeight(m_weight);
+    m_engine->setObservedData(m_obsTime, m_obsPressure, m_obsDerivative);
+    m_engine->setAxes(m_xAxis, m_yAxis);
+    connect(m_engine.data(), &ObjectiveLandscape::sigProgress, m_progress, &QProgressBar::setValue, Qt::QueuedConnection);
+
+    m_best.clear();
+    m_btnCompute->setEnabled(false); m_btnStop->setEnabled(true); m_btnApply->setEnabled(false);
+    m_progress->setValue(0);
+    m_lblStatus->setText("正在计算...");
+    QSharedPointer<ObjectiveLandscape> engine = m_engine;
+    m_watcher.setFuture(QtConcurrent::run([engine]() { engine->run(); }));
+}
+
+void ObjectiveLandscapeDialog::onStop()
+{
+    if(m_engine) m_engine->requestStop();
+}
+
+void ObjectiveLandscapeDialog::onFinished()
+{
+    m_btnCompute->setEnabled(true); m_btnStop->setEnabled(false);
+    if(!m_engine) return;
+    LandscapeResult r = m_engine->result();
+    const int nx = r.xValues.size(), ny = r.yValues.size();
+    if(nx < 2 || ny < 2) return;
+
+    // 对数等分的轴以 log10 值作为绘图坐标
+    auto coord = [](double v, bool useLog) { return useLog ? std::log10(v) : v; };
+    m_colorMap->data()->setSize(nx, ny);
+    m_colorMap->data()->setRange(QCPRange(coord(r.xValues.first(), m_xAxis.logScale), coord(r.xValues.last(), m_xAxis.logScale)),
+                                 QCPRange(coord(r.yValues.first(), m_yAxis.logScale), coord(r.yValues.last(), m_yAxis.logScale)));
+    for(int iy = 0; iy < ny; ++iy) {
+        for(int ix = 0; ix < nx; ++ix) {
+            double v = r.sse[iy * nx + ix];
+            m_colorMap->data()->setCell(ix, iy, (std::isfinite(v) && v > 0) ? std::log10(v) : qQNaN());
+        }
+    }
+    m_colorMap->rescaleDataRange(true);
+
+    m_plot->xAxis->setLabel(m_xAxis.logScale ? QString("log10(%1)").arg(m_xAxis.name) : m_xAxis.name);
+    m_plot->yAxis->setLabel(m_yAxis.logScale ? QString("log10(%1)").arg(m_yAxis.name) : m_yAxis.name);
+
+    // 当前点与最小点标记
+    while(m_plot->graphCount() > 0) m_plot->removeGraph(0);
+    const FitParameter* px = findParam(m_xAxis.name);
+    const FitParameter* py = findParam(m_yAxis.name);
+    if(px && py && (!m_xAxis.logScale || px->value > 0) && (!m_yAxis.logScale || py->value > 0)) {
+        QCPGraph* g = m_plot->addGraph();
+        g->setLineStyle(QCPGraph::lsNone);
+        g->setScatterStyle(QCPScatterStyle(QCPScatterStyle::ssCross, Qt::white, 12));
+        g->addData(coord(px->value, m_xAxis.logScale), coord(py->value, m_yAxis.logScale));
+    }
+    if(r.bestIndex >= 0) {
+        double bx = r.xValues[r.bestIndex % nx], by = r.yValues[r.bestIndex / nx];
+        QCPGraph* g = m_plot->addGraph();
+        g->setLineStyle(QCPGraph::lsNone);
+        g->setScatterStyle(QCPScatterStyle(QCPScatterStyle::ssStar, Qt::white, 14));
+        g->addData(coord(bx, m_xAxis.logScale), coord(by, m_yAxis.logScale));
+        m_best.insert(m_xAxis.name, bx);
+        m_best.insert(m_yAxis.name, by);
+        m_btnApply->setEnabled(r.completed);
+    }
+    m_plot->rescaleAxes();
+    m_plot->replot();
+
+    QString status = QString("无因次曲线 %1 条 / 网格 %2 个").arg(r.uniqueCurves).arg(nx * ny);
+    if(r.bestIndex >= 0) status += QString("，最小 SSE = %1").arg(r.sse[r.bestIndex], 0, 'e', 3);
+    if(!r.completed) status += " (已停止，结果不完整)";
+    m_lblStatus->setText(status);
+}
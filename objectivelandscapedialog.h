@@ -0,0 +1,81 @@
+/*
+ * objectivelandscapedialog.h
+ * 文件作用：目标函数分布图对话框头文件
+ * 功能描述：
+ * 1. 选择两个参数及其取值范围、网格点数，后台计算目标函数分布
+ * 2. 以 QCustomPlot 色图显示 log10(SSE)，标出当前参数点与网格最小点
+ * 3. 可将网格最小点的参数值写回拟合参数表
+ */
+
+#ifndef OBJECTIVELANDSCAPEDIALOG_H
+#define OBJECTIVELANDSCAPEDIALOG_H
+
+#include <QDialog>
+#include <QComboBox>
+#include <QLineEdit>
+#include <QCheckBox>
+#include <QSpinBox>
+#include <QProgressBar>
+#include <QPushButton>
+#include <QLabel>
+#include <QFutureWatcher>
+#include <QSharedPointer>
+#include "qcustomplot.h"
+#include "objectivelandscape.h"
+#include "fittingparameterchart.h"
+
+class ObjectiveLandscapeDialog : public QDialog
+{
+    Q_OBJECT
+
+public:
+    ObjectiveLandscapeDialog(ModelManager* modelManager, ModelManager::ModelType type, const QList<FitParameter>& params, double weight,
+                             const QVector<double>& t, const QVector<double>& p, const QVector<double>& d, QWidget* parent = nullptr);
+    ~ObjectiveLandscapeDialog();
+
+    // 网格最小点对应的两个参数值 (未计算时为空)
+    QMap<QString, double> bestParameters() const;
+
+private slots:
+    void onAxisParamChanged();
+    void onCompute();
+    void onStop();
+    void onFinished();
+
+private:
+    void fillAxisRange(QComboBox* combo, QLineEdit* editMin, QLineEdit* editMax, QCheckBox* chkLog);
+    const FitParameter* findParam(const QString& name) const;
+
+private:
+    ModelManager* m_modelManager;
+    ModelManager::ModelType m_modelType;
+    QList<FitParameter> m_params;
+    double m_weight;
+    QVector<double> m_obsTime, m_obsPressure, m_obsDerivative;
+
+    QComboBox* m_comboX;
+    QComboBox* m_comboY;
+    QLineEdit* m_editXMin;
+    QLineEdit* m_editXMax;
+    QLineEdit* m_editYMin;
+    QLineEdit* m_editYMax;
+    QCheckBox* m_chkXLog;
+    QCheckBox* m_chkYLog;
+    QSpinBox* m_spinGrid;
+    QPushButton* m_btnCompute;
+    QPushButton* m_btnStop;
+    QPushButton* m_btnApply;
+    QProgressBar* m_progress;
+    QLabel* m_lblStatus;
+
+    QCustomPlot* m_plot;
+    QCPColorMap* m_colorMap;
+    QCPColorScale* m_colorScale;
+
+    QSharedPointer<ObjectiveLandscape> m_engine;
+    QFutureWatcher<void> m_watcher;
+    LandscapeAxis m_xAxis, m_yAxis;
+    QMap<QString, double> m_best;
+};
+
+#endif // OBJECTIVELANDSCAPEDIALOG_H
@@ -0,0 +1,230 @@
+/*
+ * outlierdialog.cpp
+ * 文件作用：滑动 Hampel 异常值检测对话框实现文件
+ * 功能描述：
+ * 1. 数据模型只在界面线程读取为数组，检测在工作线程中进行，关闭对话框时通过取消令牌中断
+ * 2. 表格最多列出前 kMaxTableRows 个异常点，曲线上全部标出
+ */
+
+#include "outlierdialog.h"
+
+#include <QVBoxLayout>
+#include <QHBoxLayout>
+#include <QGridLayout>
+#include <QGroupBox>
+#include <QHeaderView>
+#include <QSplitter>
+#include <QMessageBox>
+#include <QtConcurrent>
+
+namespace {
+const int kMaxTableRows = 5000;
+}
+
+OutlierDialog::OutlierDialog(ColumnarTableModel* model, int timeCol, int valueCol, QWidget* parent)
+    : QDialog(parent), m_model(model), m_valueCol(-1)
+{
+    setWindowTitle("异常值检测 (滑动 Hampel)"); resize(1000, 720);
+
+    this->setStyleSheet(
+        "QDialog { background-color: #ffffff; color: #000000; font-family: 'Microsoft YaHei'; }"
+        "QLabel, QTableWidget, QGroupBox, QComboBox, QSpinBox, QDoubleSpinBox { color: #000000; }"
+        "QTableWidget { gridline-color: #d0d0d0; border: 1px solid #c0c0c0; }"
+        "QHeaderView::section { background-color: #f0f0f0; border: 1px solid #d0d0d0; color: #000000; }"
+        "QPushButton { background-color: #ffffff; border: 1px solid #c0c0c0; border-radius: 4px; padding: 5px 15px; color: #333333; }"
+        "QPushButton:hover { background-color: #f2f2f2; border-color: #a0a0a0; color: #000000; }"
+        "QPushButton:pressed { background-color: #e0e0e0; }"
+        "QPushButton:disabled { color: #a0a0a0; }"
+        );
+
+    QVBoxLayout* layout = new QVBoxLayout(this);
+
+    // 数据列与检测参数
+    QGroupBox* group = new QGroupBox("数据与参数", this);
+    QGridLayout* grid = new QGridLayout(group);
+    QStringList headers;
+    for(int i = 0; i < m_model->columnCount(); ++i) {
+        const QString header = m_model->headerText(i);
+        headers << (header.isEmpty() ? QString("列 %1").arg(i + 1) : header);
+    }
+    m_comboTime = new QComboBox(group); m_comboTime->addItems(headers);
+    m_comboValue = new QComboBox(group); m_comboValue->addItems(headers);
+    if(timeCol >= 0) m_comboTime->setCurrentIndex(timeCol);
+    if(valueCol >= 0) m_comboValue->setCurrentIndex(valueCol);
+
+    HampelConfig defaults;
+    m_spinHalfWidth = new QDoubleSpinBox(group);
+    m_spinHalfWidth->setDecimals(4); m_spinHalfWidth->setRange(0.0, 1e9);
+    m_spinHalfWidth->setValue(defaults.halfWidth);
+    m_spinHalfWidth->setSpecialValueText("自动");
+    m_spinHalfWidth->setToolTip("时间窗半宽 (与时间列同单位)，自动时取约 25 个采样间隔");
+    m_spinThreshold = new QDoubleSpinBox(group);
+    m_spinThreshold->setRange(1.0, 50.0); m_spinThreshold->setSingleStep(0.5); m_spinThreshold->setValue(defaults.threshold);
+    m_spinThreshold->setToolTip("偏离窗口中值超过此倍数的稳健标准差 (1.4826 × MAD) 判为异常");
+    m_spinMinPoints = new QSpinBox(group);
+    m_spinMinPoints->setRange(3, 100000); m_spinMinPoints->setValue(defaults.minPoints);
+    m_comboAction = new QComboBox(group);
+    m_comboAction->addItems(QStringList() << "清空单元格" << "替换为窗口中值");
+
+    grid->addWidget(new QLabel("时间列:", group), 0, 0); grid->addWidget(m_comboTime, 0, 1);
+    grid->addWidget(new QLabel("检测列:", group), 0, 2); grid->addWidget(m_comboValue, 0, 3);
+    grid->addWidget(new QLabel("处理方式:", group), 0, 4); grid->addWidget(m_comboAction, 0, 5);
+    grid->addWidget(new QLabel("时间窗半宽:", group), 1, 0); grid->addWidget(m_spinHalfWidth, 1, 1);
+    grid->addWidget(new QLabel("阈值 (倍稳健标准差):", group), 1, 2); grid->addWidget(m_spinThreshold, 1, 3);
+    grid->addWidget(new QLabel("窗口最少点数:", group), 1, 4); grid->addWidget(m_spinMinPoints, 1, 5);
+    layout->addWidget(group);
+
+    QHBoxLayout* ctrl = new QHBoxLayout;
+    m_btnDetect = new QPushButton("检测预览", this);
+    m_progress = new QProgressBar(this); m_progress->setRange(0, 1); m_progress->setValue(0);
+    ctrl->addWidget(m_btnDetect); ctrl->addWidget(m_progress, 1);
+    layout->addLayout(ctrl);
+
+    QSplitter* split = new QSplitter(Qt::Vertical, this);
+    m_plot = new QCustomPlot(split);
+    m_plot->setInteractions(QCP::iRangeDrag | QCP::iRangeZoom);
+    m_plot->setMinimumHeight(260);
+    m_table = new QTableWidget(0, 4, split);
+    m_table->setHorizontalHeaderLabels(QStringList() << "行号" << "时间" << "原值" << "窗口中值");
+    m_table->setEditTriggers(QAbstractItemView::NoEditTriggers);
+    m_table->verticalHeader()->setVisible(false);
+    m_table->horizontalHeader()->setStretchLastSection(true);
+    split->addWidget(m_plot);
+    split->addWidget(m_table);
+    layout->addWidget(split, 1);
+
+    QHBoxLayout* btns = new QHBoxLayout;
+    m_lblStatus = new QLabel(this);
+    m_btnApply = new QPushButton("应用", this); m_btnApply->setEnabled(false);
+    QPushButton* close = new QPushButton("关闭", this);
+    btns->addWidget(m_lblStatus, 1); btns->addWidget(m_btnApply); btns->addWidget(close);
+    layout->addLayout(btns);
+
+    connect(m_btnDetect, &QPushButton::clicked, this, &OutlierDialog::onDetect);
+    connect(m_btnApply, &QPushButton::clicked, this, &QDialog::accept);
+    connect(close, &QPushButton::clicked, this, &QDialog::reject);
+    connect(&m_watcher, &QFutureWatcher<HampelResult>::finished, this, &OutlierDialog::onFinished);
+    // 参数改变后需重新预览才能应用
+    auto invalidate = [this]() { m_btnApply->setEnabled(false); };
+    connect(m_comboTime, QOverload<int>::of(&QComboBox::currentIndexChanged), this, invalidate);
+    connect(m_comboValue, QOverload<int>::of(&QComboBox::currentIndexChanged), this, invalidate);
+    connect(m_spinHalfWidth, QOverload<double>::of(&QDoubleSpinBox::valueChanged), this, invalidate);
+    connect(m_spinThreshold, QOverload<double>::of(&QDoubleSpinBox::valueChanged), this, invalidate);
+    connect(m_spinMinPoints, QOverload<int>::of(&QSpinBox::valueChanged), this, invalidate);
+}
+
+OutlierDialog::~OutlierDialog()
+{
+    if(m_token) m_token->cancel();
+    m_watcher.waitForFinished();
+}
+
+int OutlierDialog::valueColumn() const { return m_valueCol; }
+
+QVector<int> OutlierDialog::flaggedRows() const
+{
+    QVector<int> rows;
+    rows.reserve(m_result.indices.size());
+    for(int i : m_result.indices) rows.append(m_rows[i]);
+    return rows;
+}
+
+QVector<double> OutlierDialog::replacementValues() const { return m_result.medians; }
+bool OutlierDialog::replaceWithMedian() const { return m_comboAction->currentIndex() == 1; }
+
+void OutlierDialog::readColumns()
+{
+    // 只保留时间与检测值均为数值的行，记录其行号
+    const int tc = m_comboTime->currentIndex();
+    const int vc = m_comboValue->currentIndex();
+    m_t.clear(); m_y.clear(); m_rows.clear();
+    for(int r = 0; r < m_model->rowCount(); ++r) {
+        bool okT = false, okV = false;
+        double t = m_model->value(r, tc, &okT);
+        double v = m_model->value(r, vc, &okV);
+        if(!okT || !okV) continue;
+        m_t.append(t); m_y.append(v); m_rows.append(r);
+    }
+}
+
+void OutlierDialog::onDetect()
+{
+    if(m_watcher.isRunning()) return;
+    if(m_comboTime->currentIndex() == m_comboValue->currentIndex()) {
+        QMessageBox::warning(this, "提示", "检测列不能是时间列。");
+        return;
+    }
+    readColumns();
+    if(m_t.size() < m_spinMinPoints->value()) {
+        QMessageBox::warning(this, "提示", "有效数据点不足，无法检测。");
+        return;
+    }
+
+    HampelConfig config;
+    config.halfWidth = m_spinHalfWidth->value();
+    config.threshold = m_spinThreshold->value();
+    config.minPoints = m_spinMinPoints->value();
+
+    m_valueCol = m_comboValue->currentIndex();
+    m_token.reset(new CancellationToken);
+    QSharedPointer<CancellationToken> token = m_token;
+    QVector<double> t = m_t, y = m_y;
+
+    m_btnDetect->setEnabled(false); m_btnApply->setEnabled(false);
+    m_progress->setRange(0, 0);
+    m_lblStatus->setText(QString("正在检测 (%1 个数据点)...").arg(m_t.size()));
+    m_watcher.setFuture(QtConcurrent::run([t, y, config, token]() {
+        return HampelFilter::detect(t, y, config, token.data());
+    }));
+}
+
+void OutlierDialog::onFinished()
+{
+    m_btnDetect->setEnabled(true);
+    m_progress->setRange(0, 1); m_progress->setValue(1);
+    m_result = m_watcher.result();
+    fillTable();
+    plotResult();
+    m_lblStatus->setText(QString("时间窗半宽 %1，检测到 %2 个异常点 (占 %3%)")
+                             .arg(m_result.halfWidth, 0, 'g', 5).arg(m_result.indices.size())
+                             .arg(m_t.isEmpty() ? 0.0 : 100.0 * m_result.indices.size() / m_t.size(), 0, 'f', 3));
+    m_btnApply->setEnabled(!m_result.indices.isEmpty());
+}
+
+void OutlierDialog::fillTable()
+{
+    const int rows = qMin(m_result.indices.size(), kMaxTableRows);
+    m_table->setRowCount(rows);
+    for(int k = 0; k < rows; ++k) {
+        const int i = m_result.indices[k];
+        m_table->setItem(k, 0, new QTableWidgetItem(QString::number(m_rows[i] + 1)));
+        m_table->setItem(k, 1, new QTableWidgetItem(QString::number(m_t[i], 'g', 8)));
+        m_table->setItem(k, 2, new QTableWidgetItem(QString::number(m_y[i], 'g', 8)));
+        m_table->setItem(k, 3, new QTableWidgetItem(QString::number(m_result.medians[k], 'g', 8)));
+    }
+    m_table->resizeColumnsToContents();
+}
+
+void OutlierDialog::plotResult()
+{
+    m_plot->clearGraphs();
+
+    QCPGraph* data = m_plot->addGraph();
+    data->setData(m_t, m_y);
+    data->setPen(QPen(QColor(120, 120, 120), 1));
+    data->setName("数据");
+
+    QVector<double> ft, fy;
+    for(int i : m_result.indices) { ft.append(m_t[i]); fy.append(m_y[i]); }
+    QCPGraph* flagged = m_plot->addGraph();
+    flagged->setData(ft, fy);
+    flagged->setLineStyle(QCPGraph::lsNone);
+    flagged->setScatterStyle(QCPScatterStyle(QCPScatterStyle::ssCircle, Qt::red, 6));
+    flagged->setName("异常点");
+
+    m_plot->xAxis->setLabel(m_comboTime->currentText());
+    m_plot->yAxis->setLabel(m_comboValue->currentText());
+    m_plot->legend->setVisible(true);
+    m_plot->rescaleAxes();
+    m_plot->replot();
+}
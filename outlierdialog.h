@@ -0,0 +1,77 @@
+/*
+ * outlierdialog.h
+ * 文件作用：滑动 Hampel 异常值检测对话框头文件
+ * 功能描述：
+ * 1. 选择时间列、检测列与时间窗、阈值参数，检测在工作线程中进行
+ * 2. 预览: 曲线上标出被判为异常的点，表格列出行号、原值与窗口中值
+ * 3. 确认后由调用方清空这些单元格或替换为窗口中值
+ */
+
+#ifndef OUTLIERDIALOG_H
+#define OUTLIERDIALOG_H
+
+#include <QDialog>
+#include <QComboBox>
+#include <QSpinBox>
+#include <QDoubleSpinBox>
+#include <QPushButton>
+#include <QProgressBar>
+#include <QLabel>
+#include <QTableWidget>
+#include <QFutureWatcher>
+#include <QSharedPointer>
+#include "columnartablemodel.h"
+#include "qcustomplot.h"
+#include "hampelfilter.h"
+
+class OutlierDialog : public QDialog
+{
+    Q_OBJECT
+
+public:
+    // timeCol/valueCol 为默认列，-1 表示未识别
+    OutlierDialog(ColumnarTableModel* model, int timeCol, int valueCol, QWidget* parent = nullptr);
+    ~OutlierDialog();
+
+    // 以下在接受对话框后有效
+    int valueColumn() const;
+    QVector<int> flaggedRows() const;         // 数据模型行号 (升序)
+    QVector<double> replacementValues() const; // 对应的窗口中值
+    bool replaceWithMedian() const;
+
+private slots:
+    void onDetect();
+    void onFinished();
+
+private:
+    void readColumns();
+    void fillTable();
+    void plotResult();
+
+private:
+    ColumnarTableModel* m_model;
+
+    QComboBox* m_comboTime;
+    QComboBox* m_comboValue;
+    QDoubleSpinBox* m_spinHalfWidth;
+    QDoubleSpinBox* m_spinThreshold;
+    QSpinBox* m_spinMinPoints;
+    QComboBox* m_comboAction;
+    QPushButton* m_btnDetect;
+    QPushButton* m_btnApply;
+    QProgressBar* m_progress;
+    QLabel* m_lblStatus;
+    QTableWidget* m_table;
+    QCustomPlot* m_plot;
+
+    // 有效点的时间、数值与所在行
+    QVector<double> m_t, m_y;
+    QVector<int> m_rows;
+    int m_valueCol;
+    HampelResult m_result;
+
+    QSharedPointer<CancellationToken> m_token;
+    QFutureWatcher<HampelResult> m_watcher;
+};
+
+#endif // OUTLIERDIALOG_H
@@ -11,8 +11,8 @@
 #define PLOTTINGDIALOG1_H
 
 #include <QDialog>
-#include <QStandardItemModel>
 #include <QColor>
+#include "columnartablemodel.h"
 #include "qcustomplot.h"
 
 namespace Ui {
@@ -24,7 +24,7 @@ class PlottingDialog1 : public QDialog
     Q_OBJECT
 
 public:
-    explicit PlottingDialog1(QStandardItemModel* model, QWidget *parent = nullptr);
+    explicit PlottingDialog1(ColumnarTableModel* model, QWidget *parent = nullptr);
     ~PlottingDialog1();
 
     // --- 获取用户配置 ---
@@ -54,7 +54,7 @@ private slots:
 
 private:
     Ui::PlottingDialog1 *ui;
-    QStandardItemModel* m_dataModel;
+    ColumnarTableModel* m_dataModel;
     static int s_curveCounter; // 静态计数器，用于生成默认名称
 
     QColor m_pointColor; // 当前选择的点颜色
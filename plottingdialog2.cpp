@@ -13,7 +13,7 @@
 
 int PlottingDialog2::s_counter = 1;
 
-PlottingDialog2::PlottingDialog2(QStandardItemModel* model, QWidget *parent) :
+PlottingDialog2::PlottingDialog2(ColumnarTableModel* model, QWidget *parent) :
     QDialog(parent),
     ui(new Ui::PlottingDialog2),
     m_dataModel(model),
@@ -55,8 +55,8 @@ void PlottingDialog2::populateComboBoxes()
     if (!m_dataModel) return;
     QStringList headers;
     for(int i=0; i<m_dataModel->columnCount(); ++i) {
-        QStandardItem* item = m_dataModel->horizontalHeaderItem(i);
-        headers << (item ? item->text() : QString("列 %1").arg(i+1));
+        const QString header = m_dataModel->headerText(i);
+        headers << (header.isEmpty() ? QString("列 %1").arg(i+1) : header);
     }
     ui->comboPressX->addItems(headers);
     ui->comboPressY->addItems(headers);
@@ -11,8 +11,8 @@
 #define PLOTTINGDIALOG2_H
 
 #include <QDialog>
-#include <QStandardItemModel>
 #include <QColor>
+#include "columnartablemodel.h"
 #include "qcustomplot.h"
 
 namespace Ui {
@@ -24,7 +24,7 @@ class PlottingDialog2 : public QDialog
     Q_OBJECT
 
 public:
-    explicit PlottingDialog2(QStandardItemModel* model, QWidget *parent = nullptr);
+    explicit PlottingDialog2(ColumnarTableModel* model, QWidget *parent = nullptr);
     ~PlottingDialog2();
 
     // --- 全局设置 ---
@@ -66,7 +66,7 @@ private slots:
 
 private:
     Ui::PlottingDialog2 *ui;
-    QStandardItemModel* m_dataModel;
+    ColumnarTableModel* m_dataModel;
     static int s_counter;
 
     // 内部存储选中的颜色
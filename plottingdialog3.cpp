@@ -12,7 +12,7 @@
 
 int PlottingDialog3::s_counter = 1;
 
-PlottingDialog3::PlottingDialog3(QStandardItemModel* model, QWidget *parent) :
+PlottingDialog3::PlottingDialog3(ColumnarTableModel* model, QWidget *parent) :
     QDialog(parent),
     ui(new Ui::PlottingDialog3),
     m_dataModel(model),
@@ -33,10 +33,22 @@ PlottingDialog3::PlottingDialog3(QStandardItemModel* model, QWidget *parent) :
     populateComboBoxes();
     setupStyleOptions();
 
+    // 平滑方法 (序号 + 1 即 DerivativeSmoothingConfig::Method)
+    ui->comboSmoothMethod->addItems(DerivativeSmoothingConfig::methodNames().mid(1));
+
     // 信号连接
     connect(ui->checkSmooth, &QCheckBox::toggled, this, &PlottingDialog3::onSmoothToggled);
+    connect(ui->comboSmoothMethod, QOverload<int>::of(&QComboBox::currentIndexChanged), this, [this]() {
+        onSmoothToggled(ui->checkSmooth->isChecked());
+    });
     onSmoothToggled(ui->checkSmooth->isChecked());
 
+    // 变产量时间函数: 未选择产量曲线时只能用经过时间
+    ui->comboTimeFunction->addItems(SuperpositionTime::timeFunctionNames());
+    ui->comboRateCurve->addItem("不使用");
+    connect(ui->comboRateCurve, QOverload<int>::of(&QComboBox::currentIndexChanged), this, &PlottingDialog3::onRateCurveChanged);
+    onRateCurveChanged(0);
+
     connect(ui->btnPressPointColor, &QPushButton::clicked, this, &PlottingDialog3::selectPressPointColor);
     connect(ui->btnPressLineColor, &QPushButton::clicked, this, &PlottingDialog3::selectPressLineColor);
     connect(ui->btnDerivPointColor, &QPushButton::clicked, this, &PlottingDialog3::selectDerivPointColor);
@@ -53,8 +65,8 @@ void PlottingDialog3::populateComboBoxes()
     if (!m_dataModel) return;
     QStringList headers;
     for(int i=0; i<m_dataModel->columnCount(); ++i) {
-        QStandardItem* item = m_dataModel->horizontalHeaderItem(i);
-        headers << (item ? item->text() : QString("列 %1").arg(i+1));
+        const QString header = m_dataModel->headerText(i);
+        headers << (header.isEmpty() ? QString("列 %1").arg(i+1) : header);
     }
     ui->comboTime->addItems(headers);
     ui->comboPress->addItems(headers);
@@ -93,7 +105,30 @@ void PlottingDialog3::setupStyleOptions()
 
 void PlottingDialog3::onSmoothToggled(bool checked)
 {
-    ui->spinSmooth->setEnabled(checked);
+    // 移动平均/中值按点数取窗，对数域滤波器按 ln t 宽度取窗
+    int method = ui->comboSmoothMethod->currentIndex() + 1;
+    bool logDomain = (method == DerivativeSmoothingConfig::SavitzkyGolay || method == DerivativeSmoothingConfig::Lowess);
+    ui->comboSmoothMethod->setEnabled(checked);
+    ui->spinSmooth->setEnabled(checked && !logDomain);
+    ui->spinSmoothWindow->setEnabled(checked && logDomain);
+}
+
+void PlottingDialog3::onRateCurveChanged(int index)
+{
+    bool hasRate = index > 0;
+    ui->comboTimeFunction->setEnabled(hasRate);
+    ui->spinPeriod->setEnabled(hasRate);
+    if (!hasRate) ui->comboTimeFunction->setCurrentIndex(SuperpositionTime::ElapsedTime);
+}
+
+void PlottingDialog3::setRateCurves(const QStringList& names)
+{
+    ui->comboRateCurve->addItems(names);
+    // 有产量曲线时默认使用叠加时间函数
+    if (!names.isEmpty()) {
+        ui->comboRateCurve->setCurrentIndex(1);
+        ui->comboTimeFunction->setCurrentIndex(SuperpositionTime::SuperpositionFunction);
+    }
 }
 
 void PlottingDialog3::updateColorButton(QPushButton* btn, const QColor& color) {
@@ -127,6 +162,24 @@ bool PlottingDialog3::isMeasuredPressure() const { return ui->radioMeasured->isC
 double PlottingDialog3::getLSpacing() const { return ui->spinL->value(); }
 bool PlottingDialog3::isSmoothEnabled() const { return ui->checkSmooth->isChecked(); }
 int PlottingDialog3::getSmoothFactor() const { return ui->spinSmooth->value(); }
+DerivativeSmoothingConfig PlottingDialog3::getSmoothingConfig() const
+{
+    DerivativeSmoothingConfig config;
+    if (ui->checkSmooth->isChecked())
+        config.method = (DerivativeSmoothingConfig::Method)(ui->comboSmoothMethod->currentIndex() + 1);
+    config.span = ui->spinSmooth->value();
+    config.logWindow = ui->spinSmoothWindow->value();
+    return config;
+}
+QString PlottingDialog3::getRateCurve() const
+{
+    return ui->comboRateCurve->currentIndex() > 0 ? ui->comboRateCurve->currentText() : QString();
+}
+SuperpositionTime::TimeFunction PlottingDialog3::getTimeFunction() const
+{
+    return (SuperpositionTime::TimeFunction)ui->comboTimeFunction->currentIndex();
+}
+int PlottingDialog3::getRatePeriod() const { return ui->spinPeriod->value(); }
 QString PlottingDialog3::getXLabel() const { return ui->lineXLabel->text(); }
 QString PlottingDialog3::getYLabel() const { return ui->lineYLabel->text(); }
 
@@ -2,18 +2,21 @@
  * 文件名: plottingdialog3.h
  * 文件作用: 压力导数曲线配置对话框头文件
  * 功能描述:
- * 1. 包含数据源选择（支持压差计算）、计算参数（L-Spacing, 平滑）。
+ * 1. 包含数据源选择（支持压差计算）、计算参数（L-Spacing, 平滑方法与窗口）。
  * 2. 独立的压力曲线和导数曲线样式设置（调色盘按钮）。
  * 3. 坐标轴标签设置。
+ * 4. 变产量时间函数: 选择产量曲线与流动段，导数横坐标可取 Agarwal 等效时间或叠加时间函数。
  */
 
 #ifndef PLOTTINGDIALOG3_H
 #define PLOTTINGDIALOG3_H
 
 #include <QDialog>
-#include <QStandardItemModel>
 #include <QColor>
+#include "columnartablemodel.h"
 #include "qcustomplot.h"
+#include "derivativesmoother.h"
+#include "superpositiontime.h"
 
 namespace Ui {
 class PlottingDialog3;
@@ -24,7 +27,7 @@ class PlottingDialog3 : public QDialog
     Q_OBJECT
 
 public:
-    explicit PlottingDialog3(QStandardItemModel* model, QWidget *parent = nullptr);
+    explicit PlottingDialog3(ColumnarTableModel* model, QWidget *parent = nullptr);
     ~PlottingDialog3();
 
     // --- 基础信息 ---
@@ -41,6 +44,14 @@ public:
     double getLSpacing() const;
     bool isSmoothEnabled() const;
     int getSmoothFactor() const;
+    DerivativeSmoothingConfig getSmoothingConfig() const;
+
+    // --- 变产量时间函数 ---
+    // 可选的产量曲线 (压力产量图名称)，需在 exec() 前设置
+    void setRateCurves(const QStringList& names);
+    QString getRateCurve() const;   // 未选择时为空
+    SuperpositionTime::TimeFunction getTimeFunction() const;
+    int getRatePeriod() const;      // 从 1 开始，0 表示最后一段
 
     // --- 坐标轴 ---
     QString getXLabel() const;
@@ -62,6 +73,7 @@ public:
 
 private slots:
     void onSmoothToggled(bool checked);
+    void onRateCurveChanged(int index);
     // 颜色按钮槽
     void selectPressPointColor();
     void selectPressLineColor();
@@ -70,7 +82,7 @@ private slots:
 
 private:
     Ui::PlottingDialog3 *ui;
-    QStandardItemModel* m_dataModel;
+    ColumnarTableModel* m_dataModel;
     static int s_counter;
 
     // 颜色存储
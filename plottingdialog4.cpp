@@ -11,7 +11,7 @@
 #include "ui_plottingdialog4.h"
 #include <QColorDialog>
 
-PlottingDialog4::PlottingDialog4(QStandardItemModel* model, QWidget *parent) :
+PlottingDialog4::PlottingDialog4(ColumnarTableModel* model, QWidget *parent) :
     QDialog(parent),
     ui(new Ui::PlottingDialog4),
     m_dataModel(model),
@@ -33,8 +33,8 @@ void PlottingDialog4::populateComboBoxes()
     if (!m_dataModel) return;
     QStringList headers;
     for(int i=0; i<m_dataModel->columnCount(); ++i) {
-        QStandardItem* item = m_dataModel->horizontalHeaderItem(i);
-        headers << (item ? item->text() : QString("Column %1").arg(i+1));
+        const QString header = m_dataModel->headerText(i);
+        headers << (header.isEmpty() ? QString("Column %1").arg(i+1) : header);
     }
     ui->comboXCol->addItems(headers);
     ui->comboYCol->addItems(headers);
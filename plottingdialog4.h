@@ -12,8 +12,8 @@
 #define PLOTTINGDIALOG4_H
 
 #include <QDialog>
-#include <QStandardItemModel>
 #include <QColor>
+#include "columnartablemodel.h"
 #include "qcustomplot.h"
 
 namespace Ui {
@@ -25,7 +25,7 @@ class PlottingDialog4 : public QDialog
     Q_OBJECT
 
 public:
-    explicit PlottingDialog4(QStandardItemModel* model, QWidget *parent = nullptr);
+    explicit PlottingDialog4(ColumnarTableModel* model, QWidget *parent = nullptr);
     ~PlottingDialog4();
 
     // 设置初始数据（回显当前属性）
@@ -49,7 +49,7 @@ private slots:
 
 private:
     Ui::PlottingDialog4 *ui;
-    QStandardItemModel* m_dataModel;
+    ColumnarTableModel* m_dataModel;
     QColor m_pointColor;
     QColor m_lineColor;
 
@@ -5,6 +5,7 @@
  */
 
 #include "pressurederivativecalculator1.h"
+#include "derivativesmoother.h"
 #include <QtMath>
 #include <QDebug>
 
@@ -14,7 +15,7 @@ PressureDerivativeCalculator1::PressureDerivativeCalculator1(QObject *parent)
 }
 
 PressureDerivativeResult PressureDerivativeCalculator1::calculateSmoothedDerivative(
-    QStandardItemModel* model, const PressureDerivativeConfig& config, int smoothFactor)
+    ColumnarTableModel* model, const PressureDerivativeConfig& config, int smoothFactor)
 {
     // 1. 先使用基础计算器计算标准的Bourdet导数
     // 注意：这里我们借用基础计算器的逻辑，但在写入模型前拦截数据进行平滑
@@ -36,16 +37,12 @@ PressureDerivativeResult PressureDerivativeCalculator1::calculateSmoothedDerivat
     pressureData.reserve(rows);
 
     for(int i=0; i<rows; ++i) {
-        QStandardItem* tItem = model->item(i, config.timeColumnIndex);
-        QStandardItem* pItem = model->item(i, config.pressureColumnIndex);
-        if(tItem && pItem) {
-            bool okT, okP;
-            double t = tItem->text().toDouble(&okT);
-            double p = pItem->text().toDouble(&okP);
-            if(okT && okP) {
-                timeData.append(t);
-                pressureData.append(p);
-            }
+        bool okT, okP;
+        double t = model->value(i, config.timeColumnIndex, &okT);
+        double p = model->value(i, config.pressureColumnIndex, &okP);
+        if(okT && okP) {
+            timeData.append(t);
+            pressureData.append(p);
         }
     }
 
@@ -74,11 +71,11 @@ PressureDerivativeResult PressureDerivativeCalculator1::calculateSmoothedDerivat
     int newCol = model->columnCount();
     model->insertColumn(newCol);
     QString header = QString("平滑导数(L=%1, S=%2)").arg(config.lSpacing).arg(smoothFactor);
-    model->setHorizontalHeaderItem(newCol, new QStandardItem(header));
+    model->setHeaderText(newCol, header);
 
-    for(int i=0; i<smoothedDeriv.size() && i<rows; ++i) {
-        model->setItem(i, newCol, new QStandardItem(QString::number(smoothedDeriv[i], 'g', 6)));
-    }
+    QVector<double> column(rows, qQNaN());
+    for(int i=0; i<smoothedDeriv.size() && i<rows; ++i) column[i] = smoothedDeriv[i];
+    model->setColumnValues(newCol, column, 'g', 6);
 
     result.success = true;
     result.addedColumnIndex = newCol;
@@ -90,33 +87,6 @@ PressureDerivativeResult PressureDerivativeCalculator1::calculateSmoothedDerivat
 
 QVector<double> PressureDerivativeCalculator1::smoothData(const QVector<double>& data, int span)
 {
-    int n = data.size();
-    if (n == 0) return QVector<double>();
-    if (span <= 1) return data;
-
-    // 确保span是奇数
-    if (span % 2 == 0) span++;
-
-    QVector<double> result(n);
-    int halfSpan = (span - 1) / 2;
-
-    for (int i = 0; i < n; ++i) {
-        double sum = 0;
-        int count = 0;
-
-        // 简单的移动平均，边缘处窗口自动缩小（类似Matlab默认行为）
-        int start = qMax(0, i - halfSpan);
-        int end = qMin(n - 1, i + halfSpan);
-
-        for (int j = start; j <= end; ++j) {
-            sum += data[j];
-            count++;
-        }
-
-        if (count > 0)
-            result[i] = sum / count;
-        else
-            result[i] = data[i];
-    }
-    return result;
+    // 前缀和移动平均，边缘处窗口自动缩小（类似Matlab默认行为）
+    return DerivativeSmoother::movingAverage(data, span);
 }
@@ -27,7 +27,7 @@ public:
      * @param smoothFactor 平滑因子（窗口大小，奇数）
      * @return 计算结果
      */
-    PressureDerivativeResult calculateSmoothedDerivative(QStandardItemModel* model,
+    PressureDerivativeResult calculateSmoothedDerivative(ColumnarTableModel* model,
                                                          const PressureDerivativeConfig& config,
                                                          int smoothFactor);
 
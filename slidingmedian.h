@@ -0,0 +1,78 @@
+/*
+ * slidingmedian.h
+ * 文件作用：滑动窗口中值
+ * 功能描述：
+ * 1. 双堆 + 延迟删除，插入、删除 O(log w)，取中值 O(1)
+ * 2. 导数中值滤波与 Hampel 异常值检测共用
+ */
+
+#ifndef SLIDINGMEDIAN_H
+#define SLIDINGMEDIAN_H
+
+#include <queue>
+#include <vector>
+#include <unordered_map>
+#include <functional>
+
+// 滑动窗口中值: lower 为大顶堆 (较小一半)，upper 为小顶堆 (较大一半)，删除延迟到元素到达堆顶时执行
+class SlidingMedian
+{
+public:
+    void insert(double v)
+    {
+        if (m_lower.empty() || v <= m_lower.top()) { m_lower.push(v); ++m_lowerSize; }
+        else { m_upper.push(v); ++m_upperSize; }
+        balance();
+    }
+
+    void erase(double v)
+    {
+        ++m_delayed[v];
+        if (v <= m_lower.top()) {
+            --m_lowerSize;
+            if (v == m_lower.top()) prune(m_lower);
+        } else {
+            --m_upperSize;
+            if (v == m_upper.top()) prune(m_upper);
+        }
+        balance();
+    }
+
+    double median() const
+    {
+        return (m_lowerSize > m_upperSize) ? m_lower.top() : 0.5 * (m_lower.top() + m_upper.top());
+    }
+
+private:
+    template <typename Heap>
+    void prune(Heap& heap)
+    {
+        while (!heap.empty()) {
+            auto it = m_delayed.find(heap.top());
+            if (it == m_delayed.end()) break;
+            if (--it->second == 0) m_delayed.erase(it);
+            heap.pop();
+        }
+    }
+
+    void balance()
+    {
+        if (m_lowerSize > m_upperSize + 1) {
+            m_upper.push(m_lower.top()); m_lower.pop();
+            --m_lowerSize; ++m_upperSize;
+            prune(m_lower);
+        } else if (m_lowerSize < m_upperSize) {
+            m_lower.push(m_upper.top()); m_upper.pop();
+            ++m_lowerSize; --m_upperSize;
+            prune(m_upper);
+        }
+    }
+
+    std::priority_queue<double> m_lower;
+    std::priority_queue<double, std::vector<double>, std::greater<double>> m_upper;
+    std::unordered_map<double, int> m_delayed;
+    int m_lowerSize = 0;
+    int m_upperSize = 0;
+};
+
+#endif // SLIDINGMEDIAN_H
@@ -0,0 +1,257 @@
+/*
+ * spectralfilter.cpp
+ * 文件作用：长期压力记录周期性噪声频域滤波实现文件
+ * 功能描述：
+ * 1. 迭代基 2 FFT: 位反转重排 + 逐级蝶形，旋转因子按 N/2 项预先制表
+ * 2. 重采样与回插都是按时间单调的双指针线性插值，O(n + N)
+ * 3. 检测前加 Hann 窗 (1 - cos，均值为 1，幅值无需换算): 记录起点的早期瞬变落在窗口零点附近，
+ *    旁瓣按 1/k³ 衰减，不再以 1/k 谱掩盖潮汐频点；滤波不加窗，陷波直接作用于原谱
+ * 4. 局部背景取 ±kBackgroundBins 个频点的滑动中值
+ * 5. 显示谱按对数周期分箱取最大值，百万级频点压缩到每周期 kDisplayPerCycle 点
+ */
+
+#include "spectralfilter.h"
+#include "slidingmedian.h"
+#include "logtimedecimator.h"
+
+#include <QtMath>
+#include <algorithm>
+#include <cmath>
+
+namespace {
+const int kMinSamples = 16;
+const int kBackgroundBins = 16;
+const int kDisplayPerCycle = 200;
+
+int nextPowerOfTwo(int n)
+{
+    int p = 1;
+    while (p < n && p < (1 << 30)) p <<= 1;
+    return p;
+}
+
+// 单调递增 x 上的线性插值，xq 亦递增 (双指针)
+void interpolateSorted(const QVector<double>& x, const QVector<double>& y,
+                       const QVector<double>& xq, QVector<double>& out)
+{
+    out.resize(xq.size());
+    int j = 0;
+    for (int i = 0; i < xq.size(); ++i) {
+        while (j + 2 < x.size() && x[j + 1] < xq[i]) ++j;
+        const double span = x[j + 1] - x[j];
+        const double f = span > 0 ? qBound(0.0, (xq[i] - x[j]) / span, 1.0) : 0.0;
+        out[i] = y[j] + f * (y[j + 1] - y[j]);
+    }
+}
+}
+
+void SpectralFilter::fft(QVector<std::complex<double>>& a, bool inverse)
+{
+    const int n = a.size();
+    if (n < 2) return;
+
+    for (int i = 1, j = 0; i < n; ++i) {
+        int bit = n >> 1;
+        for (; j & bit; bit >>= 1) j ^= bit;
+        j ^= bit;
+        if (i < j) std::swap(a[i], a[j]);
+    }
+
+    const double sign = inverse ? 1.0 : -1.0;
+    QVector<std::complex<double>> twiddle(n / 2);
+    for (int k = 0; k < n / 2; ++k) {
+        const double angle = sign * 2.0 * M_PI * k / n;
+        twiddle[k] = std::complex<double>(std::cos(angle), std::sin(angle));
+    }
+    for (int len = 2; len <= n; len <<= 1) {
+        const int half = len >> 1;
+        const int stride = n / len;
+        for (int i = 0; i < n; i += len) {
+            for (int k = 0; k < half; ++k) {
+                const std::complex<double> u = a[i + k];
+                const std::complex<double> v = a[i + k + half] * twiddle[k * stride];
+                a[i + k] = u + v;
+                a[i + k + half] = u - v;
+            }
+        }
+    }
+    if (inverse) {
+        const double scale = 1.0 / n;
+        for (std::complex<double>& c : a) c *= scale;
+    }
+}
+
+bool SpectralFilter::resample(const QVector<double>& t, const QVector<double>& y, int maxSamples,
+                              Grid& grid, QVector<int>& order)
+{
+    const int n = qMin(t.size(), y.size());
+    order.clear();
+    order.reserve(n);
+    for (int i = 0; i < n; ++i) if (std::isfinite(t[i]) && std::isfinite(y[i])) order.append(i);
+    bool sorted = true;
+    for (int k = 1; k < order.size() && sorted; ++k) sorted = t[order[k]] >= t[order[k - 1]];
+    if (!sorted) std::stable_sort(order.begin(), order.end(), [&t](int a, int b) { return t[a] < t[b]; });
+    const int m = order.size();
+    if (m < kMinSamples) return false;
+
+    QVector<double> ts(m), ys(m);
+    for (int k = 0; k < m; ++k) { ts[k] = t[order[k]]; ys[k] = y[order[k]]; }
+    if (!(ts.last() > ts.first())) return false;
+
+    const int samples = qMin(nextPowerOfTwo(m), nextPowerOfTwo(qMax(maxSamples, kMinSamples)));
+    grid.t0 = ts.first();
+    grid.dt = (ts.last() - ts.first()) / (samples - 1);
+    QVector<double> tg(samples);
+    for (int j = 0; j < samples; ++j) tg[j] = grid.t0 + j * grid.dt;
+    interpolateSorted(ts, ys, tg, grid.values);
+
+    // 去除首尾连线，周期延拓时首尾相接
+    grid.lineStart = grid.values.first();
+    grid.lineEnd = grid.values.last();
+    for (int j = 0; j < samples; ++j) grid.values[j] -= grid.lineStart + (grid.lineEnd - grid.lineStart) * j / (samples - 1);
+    return true;
+}
+
+QVector<std::complex<double>> SpectralFilter::transform(const Grid& grid, const CancellationToken* token)
+{
+    QVector<std::complex<double>> spectrum(grid.values.size());
+    for (int j = 0; j < grid.values.size(); ++j) spectrum[j] = std::complex<double>(grid.values[j], 0.0);
+    if (CancellationToken::cancelled(token)) return QVector<std::complex<double>>();
+    fft(spectrum, false);
+    return spectrum;
+}
+
+QVector<PeriodicComponent> SpectralFilter::detect(const QVector<double>& t, const QVector<double>& y,
+                                                  const SpectralFilterConfig& config, AmplitudeSpectrum* spectrum,
+                                                  const CancellationToken* token)
+{
+    QVector<PeriodicComponent> components;
+    Grid grid;
+    QVector<int> order;
+    if (!resample(t, y, config.maxSamples, grid, order)) return components;
+
+    const int N = grid.values.size();
+    for (int j = 0; j < N; ++j) grid.values[j] *= 1.0 - std::cos(2.0 * M_PI * j / N);
+    const QVector<std::complex<double>> X = transform(grid, token);
+    if (X.isEmpty()) return components;
+
+    const double span = N * grid.dt;   // 频率分辨率的倒数
+    QVector<double> amplitude(N / 2 + 1);
+    for (int k = 0; k <= N / 2; ++k) amplitude[k] = 2.0 * std::abs(X[k]) / N;
+
+    if (spectrum) {
+        // 周期随频点序号递减，倒序输入使周期递增
+        DecimationConfig display;
+        display.method = DecimationConfig::BinMax;
+        display.pointsPerCycle = kDisplayPerCycle;
+        LogTimeDecimator decimator(display);
+        for (int k = N / 2; k >= 1; --k) decimator.append(span / k, amplitude[k]);
+        decimator.finish();
+        spectrum->period = decimator.time();
+        spectrum->amplitude = decimator.pressure();
+    }
+
+    // 检测频段
+    const double minPeriod = config.minPeriod > 0 ? config.minPeriod : 8.0 * grid.dt;
+    const double maxPeriod = config.maxPeriod > 0 ? config.maxPeriod : 0.25 * span;
+    const int kLo = qMax(2, int(std::ceil(span / maxPeriod)));
+    const int kHi = qMin(N / 2 - 1, int(std::floor(span / minPeriod)));
+    if (kHi - kLo < 2) return components;
+
+    // 局部背景: 滑动中值
+    const int from = qMax(1, kLo - kBackgroundBins), to = qMin(N / 2, kHi + kBackgroundBins);
+    QVector<double> background(to - from + 1);
+    SlidingMedian window;
+    int lo = from, hi = from - 1;
+    for (int k = from; k <= to; ++k) {
+        if (((k - from) & 4095) == 0 && CancellationToken::cancelled(token)) return QVector<PeriodicComponent>();
+        while (hi < qMin(to, k + kBackgroundBins)) window.insert(amplitude[++hi]);
+        while (lo < k - kBackgroundBins) window.erase(amplitude[lo++]);
+        background[k - from] = window.median();
+    }
+
+    QVector<PeriodicComponent> peaks;
+    QVector<double> peakBins;
+    for (int k = kLo; k <= kHi; ++k) {
+        if (amplitude[k] < amplitude[k - 1] || amplitude[k] < amplitude[k + 1]) continue;
+        const double bg = background[k - from];
+        const double ratio = bg > 0 ? amplitude[k] / bg : 0.0;
+        if (ratio < config.detectThreshold) continue;
+        // 对数幅值抛物线插值细化峰位
+        const double a = std::log(qMax(amplitude[k - 1], 1e-300));
+        const double b = std::log(qMax(amplitude[k], 1e-300));
+        const double c = std::log(qMax(amplitude[k + 1], 1e-300));
+        const double denom = a - 2.0 * b + c;
+        const double delta = denom < 0 ? qBound(-0.5, 0.5 * (a - c) / denom, 0.5) : 0.0;
+        PeriodicComponent comp;
+        comp.period = span / (k + delta);
+        comp.amplitude = amplitude[k];
+        comp.ratio = ratio;
+        peaks.append(comp);
+        peakBins.append(k + delta);
+    }
+
+    // 按显著性选取，落在已选分量陷波带内的峰不重复计入
+    QVector<int> rank(peaks.size());
+    for (int i = 0; i < rank.size(); ++i) rank[i] = i;
+    std::sort(rank.begin(), rank.end(), [&peaks](int a, int b) { return peaks[a].ratio > peaks[b].ratio; });
+    QVector<double> chosenBins;
+    for (int i : rank) {
+        if (components.size() >= config.maxComponents) break;
+        bool duplicate = false;
+        for (double bin : chosenBins) {
+            if (std::abs(peakBins[i] - bin) <= qMax(config.notchWidth * bin, 1.5) * 2.0) { duplicate = true; break; }
+        }
+        if (duplicate) continue;
+        chosenBins.append(peakBins[i]);
+        components.append(peaks[i]);
+    }
+    return components;
+}
+
+QVector<double> SpectralFilter::filter(const QVector<double>& t, const QVector<double>& y, const QVector<double>& periods,
+                                       const SpectralFilterConfig& config, const CancellationToken* token)
+{
+    QVector<double> out = y;
+    Grid grid;
+    QVector<int> order;
+    if (periods.isEmpty() || !resample(t, y, config.maxSamples, grid, order)) return out;
+    QVector<std::complex<double>> X = transform(grid, token);
+    if (X.isEmpty()) return QVector<double>();
+
+    // 1. 各周期及谐波处陷波: 带内谱值用带两侧谱值线性插值代替，共轭对称处同步
+    const int N = X.size();
+    const double span = N * grid.dt;
+    for (double period : periods) {
+        if (!(period > 0)) continue;
+        for (int h = 1; h <= qMax(config.harmonics, 1); ++h) {
+            const double center = h * span / period;
+            const double half = qMax(config.notchWidth * center, 1.5);
+            const int kLo = qMax(1, int(std::floor(center - half)));
+            const int kHi = qMin(N / 2, int(std::ceil(center + half)));
+            if (kHi - kLo < 2) continue;
+            const std::complex<double> left = X[kLo], right = X[kHi];
+            for (int k = kLo + 1; k < kHi; ++k) {
+                const double f = double(k - kLo) / (kHi - kLo);
+                X[k] = left + f * (right - left);
+                if (k != N / 2) X[N - k] = std::conj(X[k]);
+            }
+        }
+    }
+    if (CancellationToken::cancelled(token)) return QVector<double>();
+
+    // 2. 逆变换，周期分量 = 原网格值 - 陷波后网格值
+    fft(X, true);
+    QVector<double> removed(N), tg(N);
+    for (int j = 0; j < N; ++j) {
+        removed[j] = grid.values[j] - X[j].real();
+        tg[j] = grid.t0 + j * grid.dt;
+    }
+
+    // 3. 插值回原始时刻扣除
+    QVector<double> ts(order.size()), noise;
+    for (int k = 0; k < order.size(); ++k) ts[k] = t[order[k]];
+    interpolateSorted(tg, removed, ts, noise);
+    for (int k = 0; k < order.size(); ++k) out[order[k]] = y[order[k]] - noise[k];
+    return out;
+}
@@ -0,0 +1,92 @@
+/*
+ * spectralfilter.h
+ * 文件作用：长期压力记录周期性噪声 (潮汐 / 抽油机周期) 频域滤波头文件
+ * 功能描述：
+ * 1. 按时间线性插值到 2 的幂个均匀采样点，减去首尾连线使序列周期延拓连续，基 2 FFT O(n log n)
+ * 2. 自动检测: 加 Hann 窗后在给定周期范围内找幅值显著高于局部背景 (滑动中值) 的谱峰，抛物线插值细化周期
+ * 3. 滤波: 对选定周期及其谐波处的窄带做陷波 (用带两侧的谱值线性插值代替)，逆变换得到周期分量，
+ *    再插值回原始时刻从原始数据中扣除，原始采样与非周期细节不受重采样影响
+ */
+
+#ifndef SPECTRALFILTER_H
+#define SPECTRALFILTER_H
+
+#include <QVector>
+#include <complex>
+#include "cancellationtoken.h"
+
+// 滤波参数
+struct SpectralFilterConfig {
+    int maxSamples;          // 均匀重采样的最大点数 (取 2 的幂)
+    double minPeriod;        // 自动检测的周期范围，<= 0 时取 8 个采样间隔
+    double maxPeriod;        // <= 0 时取记录长度的 1/4
+    double detectThreshold;  // 谱峰与局部背景幅值之比
+    int maxComponents;       // 自动检测的最多分量数
+    double notchWidth;       // 陷波相对半宽 (占中心频率的比例)
+    int harmonics;           // 每个周期同时滤除的谐波数 (1 为只滤基频)
+
+    SpectralFilterConfig() :
+        maxSamples(1 << 22),
+        minPeriod(0.0),
+        maxPeriod(0.0),
+        detectThreshold(8.0),
+        maxComponents(4),
+        notchWidth(0.02),
+        harmonics(1) {}
+};
+
+// 检测到的周期分量
+struct PeriodicComponent {
+    double period;
+    double amplitude;   // 单边幅值
+    double ratio;       // 与局部背景之比
+
+    PeriodicComponent() : period(0), amplitude(0), ratio(0) {}
+};
+
+// 显示用幅值谱 (按对数周期抽稀，周期递增)
+struct AmplitudeSpectrum {
+    QVector<double> period;
+    QVector<double> amplitude;
+};
+
+class SpectralFilter
+{
+public:
+    // 原位基 2 FFT，a 的长度须为 2 的幂；逆变换含 1/N
+    static void fft(QVector<std::complex<double>>& a, bool inverse);
+
+    /**
+     * @brief 自动检测周期分量
+     * @param t 时间 (顺序不限)
+     * @param spectrum 非空时输出显示用幅值谱
+     * @return 按显著性降序；被取消或数据不足时为空
+     */
+    static QVector<PeriodicComponent> detect(const QVector<double>& t, const QVector<double>& y,
+                                             const SpectralFilterConfig& config, AmplitudeSpectrum* spectrum = nullptr,
+                                             const CancellationToken* token = nullptr);
+
+    /**
+     * @brief 滤除给定周期的分量
+     * @return 与 y 等长的滤波结果 (无效点原样返回)；被取消时为空
+     */
+    static QVector<double> filter(const QVector<double>& t, const QVector<double>& y, const QVector<double>& periods,
+                                  const SpectralFilterConfig& config, const CancellationToken* token = nullptr);
+
+private:
+    // 均匀网格: 去除首尾连线后的采样值
+    struct Grid {
+        double t0;
+        double dt;
+        QVector<double> values;
+        double lineStart;
+        double lineEnd;
+    };
+
+    // 有效点按时间排序后插值到网格；有效点少于 16 或时间跨度为零时返回 false
+    static bool resample(const QVector<double>& t, const QVector<double>& y, int maxSamples,
+                         Grid& grid, QVector<int>& order);
+    static QVector<std::complex<double>> transform(const Grid& grid, const CancellationToken* token);
+};
+
+#endif // SPECTRALFILTER_H
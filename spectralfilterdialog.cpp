@@ -0,0 +1,429 @@
+/*
+ * spectralfilterdialog.cpp
+ * 文件作用：周期性噪声频域滤波对话框实现文件
+ * 功能描述：
+ * 1. 数据模型只在界面线程读取为数组，检测与滤波在工作线程中进行，关闭对话框时通过取消令牌中断
+ * 2. 重新检测只替换表格中“自动”来源的分量，手动添加的周期保留
+ * 3. 时间序列曲线按等步长抽点显示，最多 kMaxPlotPoints 点
+ */
+
+#include "spectralfilterdialog.h"
+
+#include <QVBoxLayout>
+#include <QHBoxLayout>
+#include <QGridLayout>
+#include <QGroupBox>
+#include <QHeaderView>
+#include <QSplitter>
+#include <QMessageBox>
+#include <QtConcurrent>
+#include <algorithm>
+#include <cmath>
+
+namespace {
+const int kMaxPlotPoints = 20000;
+const QString kAutoSource = "自动";
+
+// 常用潮汐分潮周期 (小时)
+struct TidalConstituent {
+    const char* name;
+    double hours;
+};
+const TidalConstituent kTidal[] = {
+    { "M2 主太阴半日潮", 12.4206 },
+    { "S2 主太阳半日潮", 12.0000 },
+    { "K1 太阴太阳赤纬日潮", 23.9345 },
+    { "O1 主太阴日潮", 25.8193 },
+};
+
+// 时间列单位与每小时的换算
+const char* kUnitNames[] = { "小时", "分钟", "秒", "天" };
+const double kUnitPerHour[] = { 1.0, 60.0, 3600.0, 1.0 / 24.0 };
+
+void setLogAxis(QCPAxis* axis)
+{
+    axis->setScaleType(QCPAxis::stLogarithmic);
+    QSharedPointer<QCPAxisTickerLog> logTicker(new QCPAxisTickerLog);
+    axis->setTicker(logTicker);
+    axis->setNumberFormat("eb");
+    axis->setNumberPrecision(0);
+}
+}
+
+SpectralFilterDialog::SpectralFilterDialog(ColumnarTableModel* model, int timeCol, int valueCol, QWidget* parent)
+    : QDialog(parent), m_model(model), m_valueCol(-1)
+{
+    setWindowTitle("周期性噪声滤波 (FFT)"); resize(1100, 760);
+
+    this->setStyleSheet(
+        "QDialog { background-color: #ffffff; color: #000000; font-family: 'Microsoft YaHei'; }"
+        "QLabel, QTableWidget, QGroupBox, QComboBox, QSpinBox, QDoubleSpinBox { color: #000000; }"
+        "QTableWidget { gridline-color: #d0d0d0; border: 1px solid #c0c0c0; }"
+        "QHeaderView::section { background-color: #f0f0f0; border: 1px solid #d0d0d0; color: #000000; }"
+        "QPushButton { background-color: #ffffff; border: 1px solid #c0c0c0; border-radius: 4px; padding: 5px 15px; color: #333333; }"
+        "QPushButton:hover { background-color: #f2f2f2; border-color: #a0a0a0; color: #000000; }"
+        "QPushButton:pressed { background-color: #e0e0e0; }"
+        "QPushButton:disabled { color: #a0a0a0; }"
+        );
+
+    QVBoxLayout* layout = new QVBoxLayout(this);
+
+    // 数据列与检测参数
+    QGroupBox* group = new QGroupBox("数据与参数", this);
+    QGridLayout* grid = new QGridLayout(group);
+    QStringList headers;
+    for(int i = 0; i < m_model->columnCount(); ++i) {
+        const QString header = m_model->headerText(i);
+        headers << (header.isEmpty() ? QString("列 %1").arg(i + 1) : header);
+    }
+    m_comboTime = new QComboBox(group); m_comboTime->addItems(headers);
+    m_comboValue = new QComboBox(group); m_comboValue->addItems(headers);
+    if(timeCol >= 0) m_comboTime->setCurrentIndex(timeCol);
+    if(valueCol >= 0) m_comboValue->setCurrentIndex(valueCol);
+    m_comboUnit = new QComboBox(group);
+    for(const char* name : kUnitNames) m_comboUnit->addItem(name);
+    m_comboUnit->setToolTip("时间列的单位，仅用于换算潮汐分潮周期");
+
+    SpectralFilterConfig defaults;
+    m_spinMinPeriod = new QDoubleSpinBox(group);
+    m_spinMinPeriod->setDecimals(4); m_spinMinPeriod->setRange(0.0, 1e9);
+    m_spinMinPeriod->setValue(defaults.minPeriod); m_spinMinPeriod->setSpecialValueText("自动");
+    m_spinMinPeriod->setToolTip("自动检测的最短周期 (与时间列同单位)，自动时取 8 个重采样间隔");
+    m_spinMaxPeriod = new QDoubleSpinBox(group);
+    m_spinMaxPeriod->setDecimals(4); m_spinMaxPeriod->setRange(0.0, 1e9);
+    m_spinMaxPeriod->setValue(defaults.maxPeriod); m_spinMaxPeriod->setSpecialValueText("自动");
+    m_spinMaxPeriod->setToolTip("自动检测的最长周期，自动时取记录长度的 1/4");
+    m_spinThreshold = new QDoubleSpinBox(group);
+    m_spinThreshold->setRange(1.5, 1000.0); m_spinThreshold->setValue(defaults.detectThreshold);
+    m_spinThreshold->setToolTip("谱峰幅值超过局部背景 (滑动中值) 此倍数时判为周期分量");
+    m_spinMaxComponents = new QSpinBox(group);
+    m_spinMaxComponents->setRange(1, 50); m_spinMaxComponents->setValue(defaults.maxComponents);
+    m_spinNotchWidth = new QDoubleSpinBox(group);
+    m_spinNotchWidth->setDecimals(3); m_spinNotchWidth->setRange(0.001, 0.5); m_spinNotchWidth->setSingleStep(0.005);
+    m_spinNotchWidth->setValue(defaults.notchWidth);
+    m_spinNotchWidth->setToolTip("陷波半宽占中心频率的比例，至少 1.5 个频点");
+    m_spinHarmonics = new QSpinBox(group);
+    m_spinHarmonics->setRange(1, 20); m_spinHarmonics->setValue(defaults.harmonics);
+    m_spinHarmonics->setToolTip("抽油机等非正弦周期可同时滤除其谐波");
+
+    grid->addWidget(new QLabel("时间列:", group), 0, 0); grid->addWidget(m_comboTime, 0, 1);
+    grid->addWidget(new QLabel("压力列:", group), 0, 2); grid->addWidget(m_comboValue, 0, 3);
+    grid->addWidget(new QLabel("时间单位:", group), 0, 4); grid->addWidget(m_comboUnit, 0, 5);
+    grid->addWidget(new QLabel("最短周期:", group), 1, 0); grid->addWidget(m_spinMinPeriod, 1, 1);
+    grid->addWidget(new QLabel("最长周期:", group), 1, 2); grid->addWidget(m_spinMaxPeriod, 1, 3);
+    grid->addWidget(new QLabel("检测阈值 (倍背景):", group), 1, 4); grid->addWidget(m_spinThreshold, 1, 5);
+    grid->addWidget(new QLabel("最多分量数:", group), 2, 0); grid->addWidget(m_spinMaxComponents, 2, 1);
+    grid->addWidget(new QLabel("陷波相对半宽:", group), 2, 2); grid->addWidget(m_spinNotchWidth, 2, 3);
+    grid->addWidget(new QLabel("谐波数:", group), 2, 4); grid->addWidget(m_spinHarmonics, 2, 5);
+    layout->addWidget(group);
+
+    QHBoxLayout* ctrl = new QHBoxLayout;
+    m_btnDetect = new QPushButton("自动检测", this);
+    m_comboTidal = new QComboBox(this);
+    for(const TidalConstituent& c : kTidal) m_comboTidal->addItem(QString("%1 (%2 h)").arg(c.name).arg(c.hours, 0, 'f', 2));
+    m_comboTidal->addItem("全部潮汐分潮");
+    QPushButton* btnTidal = new QPushButton("添加潮汐", this);
+    m_spinPeriod = new QDoubleSpinBox(this);
+    m_spinPeriod->setDecimals(4); m_spinPeriod->setRange(1e-6, 1e9); m_spinPeriod->setValue(1.0);
+    m_spinPeriod->setToolTip("手动添加的周期 (与时间列同单位)");
+    QPushButton* btnAdd = new QPushButton("添加周期", this);
+    QPushButton* btnRemove = new QPushButton("删除所选", this);
+    m_btnFilter = new QPushButton("滤波预览", this);
+    m_progress = new QProgressBar(this); m_progress->setRange(0, 1); m_progress->setValue(0);
+    ctrl->addWidget(m_btnDetect); ctrl->addWidget(m_comboTidal); ctrl->addWidget(btnTidal);
+    ctrl->addWidget(m_spinPeriod); ctrl->addWidget(btnAdd); ctrl->addWidget(btnRemove);
+    ctrl->addWidget(m_btnFilter); ctrl->addWidget(m_progress, 1);
+    layout->addLayout(ctrl);
+
+    QSplitter* split = new QSplitter(Qt::Vertical, this);
+    QSplitter* top = new QSplitter(Qt::Horizontal, split);
+    m_table = new QTableWidget(0, 4, top);
+    m_table->setHorizontalHeaderLabels(QStringList() << "周期" << "幅值" << "与背景之比" << "来源");
+    m_table->setEditTriggers(QAbstractItemView::NoEditTriggers);
+    m_table->setSelectionBehavior(QAbstractItemView::SelectRows);
+    m_table->verticalHeader()->setVisible(false);
+    m_table->horizontalHeader()->setStretchLastSection(true);
+    m_plotSpectrum = new QCustomPlot(top);
+    m_plotSpectrum->setInteractions(QCP::iRangeDrag | QCP::iRangeZoom);
+    setLogAxis(m_plotSpectrum->xAxis);
+    setLogAxis(m_plotSpectrum->yAxis);
+    m_plotSpectrum->xAxis->setLabel("周期");
+    m_plotSpectrum->yAxis->setLabel("幅值");
+    top->addWidget(m_table);
+    top->addWidget(m_plotSpectrum);
+    top->setStretchFactor(1, 2);
+    m_plotSeries = new QCustomPlot(split);
+    m_plotSeries->setInteractions(QCP::iRangeDrag | QCP::iRangeZoom);
+    m_plotSeries->setMinimumHeight(240);
+    split->addWidget(top);
+    split->addWidget(m_plotSeries);
+    layout->addWidget(split, 1);
+
+    QHBoxLayout* btns = new QHBoxLayout;
+    m_lblStatus = new QLabel(this);
+    m_btnApply = new QPushButton("生成滤波列", this); m_btnApply->setEnabled(false);
+    QPushButton* close = new QPushButton("关闭", this);
+    btns->addWidget(m_lblStatus, 1); btns->addWidget(m_btnApply); btns->addWidget(close);
+    layout->addLayout(btns);
+
+    connect(m_btnDetect, &QPushButton::clicked, this, &SpectralFilterDialog::onDetect);
+    connect(btnTidal, &QPushButton::clicked, this, &SpectralFilterDialog::onAddTidal);
+    connect(btnAdd, &QPushButton::clicked, this, &SpectralFilterDialog::onAddPeriod);
+    connect(btnRemove, &QPushButton::clicked, this, &SpectralFilterDialog::onRemovePeriod);
+    connect(m_btnFilter, &QPushButton::clicked, this, &SpectralFilterDialog::onFilter);
+    connect(m_btnApply, &QPushButton::clicked, this, &QDialog::accept);
+    connect(close, &QPushButton::clicked, this, &QDialog::reject);
+    connect(&m_detectWatcher, &QFutureWatcher<Detection>::finished, this, &SpectralFilterDialog::onDetectFinished);
+    connect(&m_filterWatcher, &QFutureWatcher<QVector<double>>::finished, this, &SpectralFilterDialog::onFilterFinished);
+    // 数据、参数或分量改变后需重新预览才能应用
+    auto invalidate = [this]() { m_btnApply->setEnabled(false); };
+    connect(m_comboTime, QOverload<int>::of(&QComboBox::currentIndexChanged), this, invalidate);
+    connect(m_comboValue, QOverload<int>::of(&QComboBox::currentIndexChanged), this, invalidate);
+    connect(m_spinNotchWidth, QOverload<double>::of(&QDoubleSpinBox::valueChanged), this, invalidate);
+    connect(m_spinHarmonics, QOverload<int>::of(&QSpinBox::valueChanged), this, invalidate);
+    connect(m_table, &QTableWidget::itemChanged, this, [this]() { m_btnApply->setEnabled(false); plotSpectrum(); });
+}
+
+SpectralFilterDialog::~SpectralFilterDialog()
+{
+    if(m_token) m_token->cancel();
+    m_detectWatcher.waitForFinished();
+    m_filterWatcher.waitForFinished();
+}
+
+int SpectralFilterDialog::valueColumn() const { return m_valueCol; }
+
+QString SpectralFilterDialog::columnName() const
+{
+    const QString header = m_model->headerText(m_valueCol);
+    return QString("%1_滤波").arg(header.isEmpty() ? QString("列 %1").arg(m_valueCol + 1) : header);
+}
+
+QVector<int> SpectralFilterDialog::rows() const { return m_rows; }
+QVector<double> SpectralFilterDialog::filteredValues() const { return m_filtered; }
+
+bool SpectralFilterDialog::readColumns()
+{
+    const int tc = m_comboTime->currentIndex();
+    const int vc = m_comboValue->currentIndex();
+    if(tc == vc) {
+        QMessageBox::warning(this, "提示", "压力列不能是时间列。");
+        return false;
+    }
+    // 只保留时间与压力均为数值的行，记录其行号
+    m_t.clear(); m_y.clear(); m_rows.clear();
+    for(int r = 0; r < m_model->rowCount(); ++r) {
+        bool okT = false, okV = false;
+        double t = m_model->value(r, tc, &okT);
+        double v = m_model->value(r, vc, &okV);
+        if(!okT || !okV) continue;
+        m_t.append(t); m_y.append(v); m_rows.append(r);
+    }
+    if(m_t.size() < 16) {
+        QMessageBox::warning(this, "提示", "有效数据点不足，无法进行频谱分析。");
+        return false;
+    }
+    return true;
+}
+
+SpectralFilterConfig SpectralFilterDialog::currentConfig() const
+{
+    SpectralFilterConfig config;
+    config.minPeriod = m_spinMinPeriod->value();
+    config.maxPeriod = m_spinMaxPeriod->value();
+    config.detectThreshold = m_spinThreshold->value();
+    config.maxComponents = m_spinMaxComponents->value();
+    config.notchWidth = m_spinNotchWidth->value();
+    config.harmonics = m_spinHarmonics->value();
+    return config;
+}
+
+void SpectralFilterDialog::setBusy(bool busy, const QString& message)
+{
+    m_btnDetect->setEnabled(!busy);
+    m_btnFilter->setEnabled(!busy);
+    if(busy) m_btnApply->setEnabled(false);
+    m_progress->setRange(0, busy ? 0 : 1);
+    m_progress->setValue(busy ? 0 : 1);
+    m_lblStatus->setText(message);
+}
+
+void SpectralFilterDialog::addComponent(double period, double amplitude, double ratio, const QString& source)
+{
+    const int row = m_table->rowCount();
+    m_table->blockSignals(true);
+    m_table->insertRow(row);
+    QTableWidgetItem* item = new QTableWidgetItem(QString::number(period, 'g', 6));
+    item->setData(Qt::UserRole, period);
+    item->setFlags(item->flags() | Qt::ItemIsUserCheckable);
+    item->setCheckState(Qt::Checked);
+    m_table->setItem(row, 0, item);
+    m_table->setItem(row, 1, new QTableWidgetItem(amplitude > 0 ? QString::number(amplitude, 'g', 4) : QString("-")));
+    m_table->setItem(row, 2, new QTableWidgetItem(ratio > 0 ? QString::number(ratio, 'f', 1) : QString("-")));
+    m_table->setItem(row, 3, new QTableWidgetItem(source));
+    m_table->blockSignals(false);
+    m_btnApply->setEnabled(false);
+}
+
+QVector<double> SpectralFilterDialog::checkedPeriods() const
+{
+    QVector<double> periods;
+    for(int r = 0; r < m_table->rowCount(); ++r) {
+        QTableWidgetItem* item = m_table->item(r, 0);
+        if(item && item->checkState() == Qt::Checked) periods.append(item->data(Qt::UserRole).toDouble());
+    }
+    return periods;
+}
+
+void SpectralFilterDialog::onDetect()
+{
+    if(m_detectWatcher.isRunning() || m_filterWatcher.isRunning()) return;
+    if(!readColumns()) return;
+
+    const SpectralFilterConfig config = currentConfig();
+    m_token.reset(new CancellationToken);
+    QSharedPointer<CancellationToken> token = m_token;
+    QVector<double> t = m_t, y = m_y;
+
+    setBusy(true, QString("正在计算幅值谱 (%1 个数据点)...").arg(m_t.size()));
+    m_detectWatcher.setFuture(QtConcurrent::run([t, y, config, token]() {
+        Detection detection;
+        detection.components = SpectralFilter::detect(t, y, config, &detection.spectrum, token.data());
+        return detection;
+    }));
+}
+
+void SpectralFilterDialog::onDetectFinished()
+{
+    const Detection detection = m_detectWatcher.result();
+    m_spectrum = detection.spectrum;
+
+    for(int r = m_table->rowCount() - 1; r >= 0; --r) {
+        QTableWidgetItem* source = m_table->item(r, 3);
+        if(source && source->text() == kAutoSource) m_table->removeRow(r);
+    }
+    for(const PeriodicComponent& c : detection.components) addComponent(c.period, c.amplitude, c.ratio, kAutoSource);
+    m_table->resizeColumnsToContents();
+
+    setBusy(false, detection.components.isEmpty() ? QString("未检测到显著的周期分量，可手动添加周期")
+                                                  : QString("检测到 %1 个周期分量").arg(detection.components.size()));
+    plotSpectrum();
+}
+
+void SpectralFilterDialog::onAddTidal()
+{
+    const double perHour = kUnitPerHour[m_comboUnit->currentIndex()];
+    const int count = int(sizeof(kTidal) / sizeof(kTidal[0]));
+    const int index = m_comboTidal->currentIndex();
+    for(int i = 0; i < count; ++i) {
+        if(index < count && i != index) continue;
+        addComponent(kTidal[i].hours * perHour, 0.0, 0.0, QString(kTidal[i].name).section(' ', 0, 0));
+    }
+    m_table->resizeColumnsToContents();
+    plotSpectrum();
+}
+
+void SpectralFilterDialog::onAddPeriod()
+{
+    addComponent(m_spinPeriod->value(), 0.0, 0.0, "手动");
+    m_table->resizeColumnsToContents();
+    plotSpectrum();
+}
+
+void SpectralFilterDialog::onRemovePeriod()
+{
+    QList<int> selected;
+    for(const QModelIndex& index : m_table->selectionModel()->selectedRows()) selected.append(index.row());
+    std::sort(selected.begin(), selected.end());
+    for(int k = selected.size() - 1; k >= 0; --k) m_table->removeRow(selected[k]);
+    m_btnApply->setEnabled(false);
+    plotSpectrum();
+}
+
+void SpectralFilterDialog::onFilter()
+{
+    if(m_detectWatcher.isRunning() || m_filterWatcher.isRunning()) return;
+    const QVector<double> periods = checkedPeriods();
+    if(periods.isEmpty()) {
+        QMessageBox::warning(this, "提示", "请先检测或添加要滤除的周期。");
+        return;
+    }
+    if(!readColumns()) return;
+
+    const SpectralFilterConfig config = currentConfig();
+    m_valueCol = m_comboValue->currentIndex();
+    m_token.reset(new CancellationToken);
+    QSharedPointer<CancellationToken> token = m_token;
+    QVector<double> t = m_t, y = m_y;
+
+    setBusy(true, QString("正在滤除 %1 个周期分量...").arg(periods.size()));
+    m_filterWatcher.setFuture(QtConcurrent::run([t, y, periods, config, token]() {
+        return SpectralFilter::filter(t, y, periods, config, token.data());
+    }));
+}
+
+void SpectralFilterDialog::onFilterFinished()
+{
+    m_filtered = m_filterWatcher.result();
+    const bool ok = m_filtered.size() == m_y.size();
+    double removed = 0.0;
+    for(int i = 0; ok && i < m_y.size(); ++i) removed = qMax(removed, std::abs(m_y[i] - m_filtered[i]));
+    setBusy(false, ok ? QString("滤波完成，最大修正量 %1").arg(removed, 0, 'g', 4) : QString("滤波已取消"));
+    m_btnApply->setEnabled(ok);
+    plotSeries();
+}
+
+void SpectralFilterDialog::plotSpectrum()
+{
+    m_plotSpectrum->clearGraphs();
+    m_plotSpectrum->clearItems();
+
+    QCPGraph* graph = m_plotSpectrum->addGraph();
+    graph->setData(m_spectrum.period, m_spectrum.amplitude);
+    graph->setPen(QPen(QColor(31, 119, 180), 1));
+
+    // 竖线标出表格中的周期，勾选为红色
+    for(int r = 0; r < m_table->rowCount(); ++r) {
+        QTableWidgetItem* item = m_table->item(r, 0);
+        if(!item) continue;
+        const double period = item->data(Qt::UserRole).toDouble();
+        QCPItemLine* line = new QCPItemLine(m_plotSpectrum);
+        line->start->setTypeY(QCPItemPosition::ptAxisRectRatio);
+        line->end->setTypeY(QCPItemPosition::ptAxisRectRatio);
+        line->start->setCoords(period, 0);
+        line->end->setCoords(period, 1);
+        line->setPen(QPen(item->checkState() == Qt::Checked ? Qt::red : Qt::gray, 1, Qt::DashLine));
+    }
+
+    m_plotSpectrum->rescaleAxes();
+    m_plotSpectrum->replot();
+}
+
+void SpectralFilterDialog::plotSeries()
+{
+    m_plotSeries->clearGraphs();
+    const int n = m_t.size();
+    const int step = qMax(1, n / kMaxPlotPoints);
+    QVector<double> t, y, f;
+    for(int i = 0; i < n; i += step) {
+        t.append(m_t[i]); y.append(m_y[i]);
+        if(m_filtered.size() == n) f.append(m_filtered[i]);
+    }
+
+    QCPGraph* original = m_plotSeries->addGraph();
+    original->setData(t, y);
+    original->setPen(QPen(QColor(160, 160, 160), 1));
+    original->setName("原始");
+    if(!f.isEmpty()) {
+        QCPGraph* filtered = m_plotSeries->addGraph();
+        filtered->setData(t, f);
+        filtered->setPen(QPen(QColor(214, 39, 40), 1.5));
+        filtered->setName("滤波后");
+    }
+
+    m_plotSeries->xAxis->setLabel(m_comboTime->currentText());
+    m_plotSeries->yAxis->setLabel(m_comboValue->currentText());
+    m_plotSeries->legend->setVisible(true);
+    m_plotSeries->rescaleAxes();
+    m_plotSeries->replot();
+}
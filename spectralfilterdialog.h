@@ -0,0 +1,102 @@
+/*
+ * spectralfilterdialog.h
+ * 文件作用：周期性噪声 (潮汐 / 抽油机周期) 频域滤波对话框头文件
+ * 功能描述：
+ * 1. 选择时间列、压力列与检测参数，自动检测谱峰或手动添加周期 (含常用潮汐分潮)
+ * 2. 分量表格勾选要滤除的周期，幅值谱 (对数周期轴) 上标出各分量
+ * 3. 滤波预览: 原始与滤波后曲线对比，检测与滤波均在工作线程中进行
+ * 4. 确认后由调用方将滤波结果写入压力列之后的新列
+ */
+
+#ifndef SPECTRALFILTERDIALOG_H
+#define SPECTRALFILTERDIALOG_H
+
+#include <QDialog>
+#include <QComboBox>
+#include <QSpinBox>
+#include <QDoubleSpinBox>
+#include <QPushButton>
+#include <QProgressBar>
+#include <QLabel>
+#include <QTableWidget>
+#include <QFutureWatcher>
+#include <QSharedPointer>
+#include "columnartablemodel.h"
+#include "qcustomplot.h"
+#include "spectralfilter.h"
+
+class SpectralFilterDialog : public QDialog
+{
+    Q_OBJECT
+
+public:
+    // timeCol/valueCol 为默认列，-1 表示未识别
+    SpectralFilterDialog(ColumnarTableModel* model, int timeCol, int valueCol, QWidget* parent = nullptr);
+    ~SpectralFilterDialog();
+
+    // 以下在接受对话框后有效
+    int valueColumn() const;
+    QString columnName() const;             // 新列名: 原列名_滤波
+    QVector<int> rows() const;              // 有效数据所在行
+    QVector<double> filteredValues() const; // 与 rows() 对应
+
+private slots:
+    void onDetect();
+    void onDetectFinished();
+    void onAddTidal();
+    void onAddPeriod();
+    void onRemovePeriod();
+    void onFilter();
+    void onFilterFinished();
+
+private:
+    // 检测结果: 分量与显示谱
+    struct Detection {
+        QVector<PeriodicComponent> components;
+        AmplitudeSpectrum spectrum;
+    };
+
+    bool readColumns();
+    SpectralFilterConfig currentConfig() const;
+    void addComponent(double period, double amplitude, double ratio, const QString& source);
+    QVector<double> checkedPeriods() const;
+    void plotSpectrum();
+    void plotSeries();
+    void setBusy(bool busy, const QString& message);
+
+private:
+    ColumnarTableModel* m_model;
+
+    QComboBox* m_comboTime;
+    QComboBox* m_comboValue;
+    QComboBox* m_comboUnit;
+    QComboBox* m_comboTidal;
+    QDoubleSpinBox* m_spinMinPeriod;
+    QDoubleSpinBox* m_spinMaxPeriod;
+    QDoubleSpinBox* m_spinThreshold;
+    QSpinBox* m_spinMaxComponents;
+    QDoubleSpinBox* m_spinNotchWidth;
+    QSpinBox* m_spinHarmonics;
+    QDoubleSpinBox* m_spinPeriod;
+    QPushButton* m_btnDetect;
+    QPushButton* m_btnFilter;
+    QPushButton* m_btnApply;
+    QProgressBar* m_progress;
+    QLabel* m_lblStatus;
+    QTableWidget* m_table;
+    QCustomPlot* m_plotSpectrum;
+    QCustomPlot* m_plotSeries;
+
+    // 有效点的时间、数值与所在行
+    QVector<double> m_t, m_y;
+    QVector<int> m_rows;
+    int m_valueCol;
+    AmplitudeSpectrum m_spectrum;
+    QVector<double> m_filtered;
+
+    QSharedPointer<CancellationToken> m_token;
+    QFutureWatcher<Detection> m_detectWatcher;
+    QFutureWatcher<QVector<double>> m_filterWatcher;
+};
+
+#endif // SPECTRALFILTERDIALOG_H
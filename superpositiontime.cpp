@@ -0,0 +1,209 @@
+/*
+ * superpositiontime.cpp
+ * 文件作用：变产量叠加时间计算实现文件
+ * 功能描述：
+ * 1. 叠加函数第 j 项 Δqj·ln(aj + Δt)，aj = Tk - Tj 为第 j 次产量变化距当前段起点的时间
+ * 2. aj 不小于当前段最大 Δt 的 4 倍时按 ln aj + Σ (-1)^(r+1)(Δt/aj)^r / r 展开，
+ *    截断 24 项的相对误差低于 1e-16；这些远场项的 Σ Δqj·ln aj 与各阶矩每段只算一次
+ * 3. 近场 (靠近当前段起点) 的产量变化逐项精确计算
+ */
+
+#include "superpositiontime.h"
+
+#include <QtGlobal>
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace {
+const int kSeriesOrder = 24;        // 远场展开阶数
+const double kFarFieldRatio = 4.0;  // aj >= 4·Δt_max 视为远场
+
+inline double logOrInvalid(double x)
+{
+    return x > 0 ? std::log(x) : -std::numeric_limits<double>::infinity();
+}
+}
+
+// ---------------------------------------------------------------------------
+// RateHistory
+// ---------------------------------------------------------------------------
+
+void RateHistory::append(double t, double q)
+{
+    if (!startTimes.isEmpty()) {
+        if (t < startTimes.last()) return;   // 时间倒退的点忽略
+        if (t == startTimes.last()) {
+            // 零时长段: 以后来的产量为准，并与前一段合并相同产量
+            rates.last() = q;
+            const int m = rates.size();
+            if (m >= 2 && rates[m - 2] == q) { startTimes.removeLast(); rates.removeLast(); }
+            return;
+        }
+        if (rates.last() == q) return;       // 产量未变，不是新的段
+    }
+    startTimes.append(t);
+    rates.append(q);
+}
+
+void RateHistory::finish()
+{
+    const int m = startTimes.size();
+    cumulative.fill(0.0, m);
+    for (int j = 1; j < m; ++j) cumulative[j] = cumulative[j - 1] + rates[j - 1] * (startTimes[j] - startTimes[j - 1]);
+}
+
+RateHistory RateHistory::fromDurations(const QVector<double>& durations, const QVector<double>& rates, double t0)
+{
+    RateHistory h;
+    const int n = qMin(durations.size(), rates.size());
+    double t = t0;
+    for (int i = 0; i < n; ++i) {
+        h.append(t, rates[i]);
+        t += qMax(durations[i], 0.0);
+    }
+    h.finish();
+    return h;
+}
+
+RateHistory RateHistory::fromSamples(const QVector<double>& times, const QVector<double>& rates)
+{
+    RateHistory h;
+    const int n = qMin(times.size(), rates.size());
+    for (int i = 0; i < n; ++i) h.append(times[i], rates[i]);
+    h.finish();
+    return h;
+}
+
+int RateHistory::periodCount() const { return startTimes.size(); }
+
+int RateHistory::periodAt(double t) const
+{
+    return int(std::upper_bound(startTimes.begin(), startTimes.end(), t) - startTimes.begin()) - 1;
+}
+
+double RateHistory::periodStart(int k) const
+{
+    return (k >= 0 && k < startTimes.size()) ? startTimes[k] : 0.0;
+}
+
+double RateHistory::producingTime(int k) const
+{
+    if (k <= 0 || k >= startTimes.size()) return 0.0;
+    const double qPrev = rates[k - 1];
+    if (std::abs(qPrev) > 0) return cumulative[k] / qPrev;
+    return startTimes[k] - startTimes[0];
+}
+
+// ---------------------------------------------------------------------------
+// SuperpositionTime
+// ---------------------------------------------------------------------------
+
+QStringList SuperpositionTime::timeFunctionNames()
+{
+    return QStringList() << "经过时间 Δt" << "Agarwal 等效时间" << "叠加时间函数";
+}
+
+double SuperpositionTime::agarwalTime(double dt, double tp)
+{
+    if (!(tp > 0)) return dt;
+    return tp * dt / (tp + dt);
+}
+
+QVector<double> SuperpositionTime::superposition(const RateHistory& history, int k, const QVector<double>& dt)
+{
+    const int n = dt.size();
+    QVector<double> out(n);
+    for (int i = 0; i < n; ++i) out[i] = logOrInvalid(dt[i]);
+
+    const int m = history.periodCount();
+    if (k <= 0 || k >= m) return out;
+    const QVector<double>& T = history.startTimes;
+    const QVector<double>& q = history.rates;
+    const double dqk = q[k] - q[k - 1];
+    if (!(std::abs(dqk) > 0)) return out;
+
+    double dtMax = 0.0;
+    for (double v : dt) if (v > dtMax) dtMax = v;
+    if (!(dtMax > 0)) return out;
+
+    // 远场: aj 随 j 递减，j < farEnd 的产量变化满足 aj >= 4·Δt_max
+    const double Tk = T[k];
+    int farEnd = 0;
+    while (farEnd < k && Tk - T[farEnd] >= kFarFieldRatio * dtMax) ++farEnd;
+    // 远场项数不多于展开阶数时逐项计算更省
+    if (farEnd <= kSeriesOrder) farEnd = 0;
+
+    // 远场常数项与各阶矩，以 u = Δt/Δt_max 为变量: Mr = Σ Δqj·(Δt_max/aj)^r
+    double farConstant = 0.0;
+    double coef[kSeriesOrder + 1] = { 0 };
+    for (int j = 0; j < farEnd; ++j) {
+        const double dq = q[j] - (j > 0 ? q[j - 1] : 0.0);
+        const double a = Tk - T[j];
+        farConstant += dq * std::log(a);
+        const double ratio = dtMax / a;
+        double pw = dq;
+        for (int r = 1; r <= kSeriesOrder; ++r) { pw *= ratio; coef[r] += pw; }
+    }
+    for (int r = 1; r <= kSeriesOrder; ++r) coef[r] *= ((r % 2) ? 1.0 : -1.0) / r;
+
+    for (int i = 0; i < n; ++i) {
+        const double x = dt[i];
+        if (!(x > 0)) continue;
+        double sum = dqk * std::log(x);
+        // 近场: 逐项精确
+        for (int j = farEnd; j < k; ++j) {
+            const double dq = q[j] - (j > 0 ? q[j - 1] : 0.0);
+            sum += dq * std::log(Tk - T[j] + x);
+        }
+        // 远场: 常数项 + 截断级数 (Horner)
+        if (farEnd > 0) {
+            const double u = x / dtMax;
+            double series = 0.0;
+            for (int r = kSeriesOrder; r >= 1; --r) series = (series + coef[r]) * u;
+            sum += farConstant + series;
+        }
+        out[i] = sum / dqk;
+    }
+    return out;
+}
+
+QVector<double> SuperpositionTime::superposition(const RateHistory& history, const QVector<double>& t)
+{
+    const int n = t.size();
+    const int m = history.periodCount();
+    QVector<double> out(n, -std::numeric_limits<double>::infinity());
+    if (m == 0) return out;
+
+    // 各点归入所在段: 时间递增时指针单调前移，否则二分查找
+    bool sorted = true;
+    for (int i = 1; i < n && sorted; ++i) sorted = t[i] >= t[i - 1];
+    QVector<QVector<int>> groups(m);
+    int k = -1;
+    for (int i = 0; i < n; ++i) {
+        if (sorted) { while (k + 1 < m && history.startTimes[k + 1] <= t[i]) ++k; }
+        else k = history.periodAt(t[i]);
+        if (k >= 0) groups[k].append(i);
+    }
+
+    // 只计算含数据点的段
+    for (int p = 0; p < m; ++p) {
+        const QVector<int>& idx = groups[p];
+        if (idx.isEmpty()) continue;
+        QVector<double> dt(idx.size());
+        for (int a = 0; a < idx.size(); ++a) dt[a] = t[idx[a]] - history.startTimes[p];
+        const QVector<double> values = superposition(history, p, dt);
+        for (int a = 0; a < idx.size(); ++a) out[idx[a]] = values[a];
+    }
+    return out;
+}
+
+QVector<double> SuperpositionTime::derivativeAxis(const RateHistory& history, int k, const QVector<double>& dt, TimeFunction function)
+{
+    if (function == SuperpositionFunction) return superposition(history, k, dt);
+
+    QVector<double> axis(dt.size());
+    const double tp = (function == AgarwalTime) ? history.producingTime(k) : 0.0;
+    for (int i = 0; i < dt.size(); ++i) axis[i] = logOrInvalid(agarwalTime(dt[i], tp));
+    return axis;
+}
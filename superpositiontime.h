@@ -0,0 +1,67 @@
+/*
+ * superpositiontime.h
+ * 文件作用：变产量叠加时间计算头文件
+ * 功能描述：
+ * 1. RateHistory: 由堆叠压力/产量图的产量曲线 (阶梯图的时长+产量，或时间点+产量) 构造产量史
+ * 2. 累计产量与产量变化均用前缀和表示，生产时间 tp 按累计产量/末产量 O(1) 查询
+ * 3. Agarwal 等效时间 Δte = tp·Δt/(tp+Δt)
+ * 4. 多产量叠加时间函数 Σ (qj - qj-1)/(qk - qk-1)·ln(Tk - Tj + Δt)
+ *    远离当前段起点的产量变化以截断级数矩合并，单点代价只与近场产量变化数有关
+ */
+
+#ifndef SUPERPOSITIONTIME_H
+#define SUPERPOSITIONTIME_H
+
+#include <QVector>
+#include <QStringList>
+
+// 分段常产量史: 第 j 段从 startTimes[j] 开始，产量为 rates[j]，持续到下一段开始
+struct RateHistory {
+    QVector<double> startTimes;
+    QVector<double> rates;
+    QVector<double> cumulative;   // cumulative[j]: 第 j 段开始时的累计产量 (前缀和)
+
+    // 阶梯图数据: 各段时长与产量，起始时间为 t0
+    static RateHistory fromDurations(const QVector<double>& durations, const QVector<double>& rates, double t0 = 0.0);
+    // 采样数据: 每个时间点起产量变为对应值 (时间须递增)
+    static RateHistory fromSamples(const QVector<double>& times, const QVector<double>& rates);
+
+    int periodCount() const;
+    // t 所在的段 (二分查找)，早于第一段时为 -1
+    int periodAt(double t) const;
+    double periodStart(int k) const;
+    // 第 k 段之前的等效生产时间 = 累计产量 / 上一段产量；上一段关井时取已经过的总时间
+    double producingTime(int k) const;
+
+private:
+    void append(double t, double q);
+    void finish();
+};
+
+class SuperpositionTime
+{
+public:
+    enum TimeFunction { ElapsedTime = 0, AgarwalTime, SuperpositionFunction };
+    // 各时间函数的显示名称 (顺序与 TimeFunction 一致)
+    static QStringList timeFunctionNames();
+
+    // Agarwal 等效时间，tp 非正时返回 Δt
+    static double agarwalTime(double dt, double tp);
+
+    /**
+     * @brief 第 k 段内各点的叠加时间函数
+     * @param dt 自第 k 段开始经过的时间 (非正值结果为 -inf)
+     * @return 与 dt 等长；第 k 段无产量变化时退化为 ln Δt
+     */
+    static QVector<double> superposition(const RateHistory& history, int k, const QVector<double>& dt);
+
+    // 按绝对时间计算各点的叠加时间函数，各点归入所在段 (早于产量史的点为 -inf)
+    static QVector<double> superposition(const RateHistory& history, const QVector<double>& t);
+
+    /**
+     * @brief 导数横坐标: ln Δt、ln Δte 或叠加时间函数，可直接用于 DerivativeEngine::bourdetOnAxis
+     */
+    static QVector<double> derivativeAxis(const RateHistory& history, int k, const QVector<double>& dt, TimeFunction function);
+};
+
+#endif // SUPERPOSITIONTIME_H
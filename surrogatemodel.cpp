@@ -0,0 +1,92 @@
+/*
+ * surrogatemodel.cpp
+ * 文件作用：径向基函数 (RBF) 代理模型实现文件
+ * 功能描述：
+ * 1. 组装 [Phi P; P^T 0] 鞍点系统，列主元 QR 分解后对全部输出分量一次求解
+ * 2. 预测时按样本点逐一累加核函数，开销与样本数 x 输出维数成正比，远小于一次拉普拉斯反演
+ */
+
+#include "surrogatemodel.h"
+
+#include <cmath>
+#include <random>
+#include <algorithm>
+
+SurrogateModel::SurrogateModel() : m_trained(false) {}
+
+bool SurrogateModel::isTrained() const { return m_trained; }
+int SurrogateModel::sampleCount() const { return m_trained ? (int)m_centers.rows() : 0; }
+int SurrogateModel::inputDimension() const { return m_trained ? (int)m_centers.cols() : 0; }
+
+bool SurrogateModel::train(const QVector<QVector<double>>& X, const QVector<QVector<double>>& Y)
+{
+    m_trained = false;
+    int n = X.size();
+    if (n == 0 || Y.size() != n) return false;
+    int d = X[0].size();
+    int m = Y[0].size();
+    // 线性尾项需要至少 d+1 个样本
+    if (d == 0 || m == 0 || n < d + 2) return false;
+
+    m_centers.resize(n, d);
+    Eigen::MatrixXd rhs = Eigen::MatrixXd::Zero(n + d + 1, m);
+    for (int i = 0; i < n; ++i) {
+        if (X[i].size() != d || Y[i].size() != m) return false;
+        for (int k = 0; k < d; ++k) m_centers(i, k) = X[i][k];
+        for (int k = 0; k < m; ++k) rhs(i, k) = Y[i][k];
+    }
+
+    Eigen::MatrixXd A = Eigen::MatrixXd::Zero(n + d + 1, n + d + 1);
+    for (int i = 0; i < n; ++i) {
+        for (int j = i + 1; j < n; ++j) {
+            double r = (m_centers.row(i) - m_centers.row(j)).norm();
+            A(i, j) = A(j, i) = r * r * r;
+        }
+        A(i, n) = A(n, i) = 1.0;
+        for (int k = 0; k < d; ++k) A(i, n + 1 + k) = A(n + 1 + k, i) = m_centers(i, k);
+    }
+
+    Eigen::ColPivHouseholderQR<Eigen::MatrixXd> qr(A);
+    if (qr.rank() < n + d + 1) return false;
+    m_weights = qr.solve(rhs);
+    if (!m_weights.allFinite()) return false;
+    m_trained = true;
+    return true;
+}
+
+QVector<double> SurrogateModel::predict(const QVector<double>& x) const
+{
+    if (!m_trained || x.size() != m_centers.cols()) return QVector<double>();
+    const int n = m_centers.rows();
+    const int d = m_centers.cols();
+
+    Eigen::VectorXd basis(n + d + 1);
+    for (int i = 0; i < n; ++i) {
+        double r2 = 0.0;
+        for (int k = 0; k < d; ++k) { double dx = x[k] - m_centers(i, k); r2 += dx * dx; }
+        double r = std::sqrt(r2);
+        basis(i) = r * r * r;
+    }
+    basis(n) = 1.0;
+    for (int k = 0; k < d; ++k) basis(n + 1 + k) = x[k];
+
+    Eigen::VectorXd y = m_weights.transpose() * basis;
+    QVector<double> out((int)y.size());
+    for (int k = 0; k < y.size(); ++k) out[k] = y(k);
+    return out;
+}
+
+QVector<QVector<double>> SurrogateModel::latinHypercube(int n, int dim, unsigned int seed)
+{
+    QVector<QVector<double>> samples(n, QVector<double>(dim, 0.0));
+    if (n <= 0 || dim <= 0) return samples;
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<double> uni(0.0, 1.0);
+    std::vector<int> perm(n);
+    for (int k = 0; k < dim; ++k) {
+        for (int i = 0; i < n; ++i) perm[i] = i;
+        std::shuffle(perm.begin(), perm.end(), rng);
+        for (int i = 0; i < n; ++i) samples[i][k] = (perm[i] + uni(rng)) / n;
+    }
+    return samples;
+}
@@ -0,0 +1,46 @@
+/*
+ * surrogatemodel.h
+ * 文件作用：径向基函数 (RBF) 代理模型头文件
+ * 功能描述：
+ * 1. 以若干次真实模型计算为样本，拟合从归一化参数到理论曲线 (对数压力、对数导数) 的响应面
+ * 2. 采用三次多调和核 phi(r) = r^3 加线性多项式尾项，无需形状参数，样本较少时也较稳定
+ * 3. 所有输出分量共用同一插值矩阵，一次分解、多右端项求解
+ * 4. 提供拉丁超立方抽样，用于在参数空间中均匀布点
+ */
+
+#ifndef SURROGATEMODEL_H
+#define SURROGATEMODEL_H
+
+#include <QVector>
+#include <Eigen/Dense>
+
+class SurrogateModel
+{
+public:
+    SurrogateModel();
+
+    /**
+     * @brief 训练代理模型
+     * @param X 样本输入，每个元素为一个 d 维归一化参数向量 (建议取 [0,1])
+     * @param Y 样本输出，每个元素为一个 m 维响应向量
+     * @return 样本不足或插值矩阵奇异时返回 false
+     */
+    bool train(const QVector<QVector<double>>& X, const QVector<QVector<double>>& Y);
+
+    // 预测 m 维响应；未训练时返回空向量
+    QVector<double> predict(const QVector<double>& x) const;
+
+    bool isTrained() const;
+    int sampleCount() const;
+    int inputDimension() const;
+
+    // 在 [0,1]^dim 内生成 n 个拉丁超立方样本
+    static QVector<QVector<double>> latinHypercube(int n, int dim, unsigned int seed);
+
+private:
+    Eigen::MatrixXd m_centers;  // n x d 样本点
+    Eigen::MatrixXd m_weights;  // (n + d + 1) x m: 前 n 行为核权重，其后为线性尾项系数
+    bool m_trained;
+};
+
+#endif // SURROGATEMODEL_H
@@ -0,0 +1,305 @@
+/*
+ * typecurvebank.cpp
+ * 文件作用：无因次图版库与图版匹配实现文件
+ * 功能描述：
+ * 1. 抽样范围: M12、omega1、omega2、lambda1、rmD、LfD、cD 按对数均匀，S 按线性均匀，reD 取 rmD 的 1.5~10 倍
+ * 2. 每条图版只做一次自适应网格反演 (buildDimensionlessGrid)，导数由双对数插值斜率给出
+ * 3. 文件格式 (QDataStream): 魔数、版本、参数名表、节点定义、各条图版的参数与定点特征
+ * 4. 匹配先做整节点时间平移扫描，再在节点间细化平移量，几千条图版在毫秒量级内完成
+ */
+
+#include "typecurvebank.h"
+#include "surrogatemodel.h"
+#include "curveinterpolator.h"
+
+#include <QFile>
+#include <QDir>
+#include <QFileInfo>
+#include <QDataStream>
+#include <QStandardPaths>
+#include <QtConcurrent>
+#include <QtMath>
+#include <cmath>
+#include <algorithm>
+
+namespace {
+const quint32 kMagic = 0x57544342;   // "WTCB"
+const quint32 kVersion = 1;
+const qint16 kInvalid = -32768;      // 无效节点
+const double kFixedScale = 1000.0;   // 定点比例: 0.001 个 log10 单位
+const int kMinOverlap = 8;           // 至少需要 2 个对数周期的实测节点
+
+// 抽样参数定义
+struct SampleRange { const char* key; double lo; double hi; bool log; };
+const SampleRange kRanges[] = {
+    { "M12",     1.0,   100.0, true  },
+    { "omega1",  0.01,  0.9,   true  },
+    { "omega2",  0.001, 0.5,   true  },
+    { "lambda1", 1e-5,  1e-1,  true  },
+    { "rmD",     1.5,   20.0,  true  },
+    { "LfD",     0.02,  0.5,   true  },
+    { "cD",      1e-4,  1.0,   true  },
+    { "S",       0.0,   10.0,  false },
+    { "reRatio", 1.5,   10.0,  true  }   // reD = rmD * reRatio
+};
+
+bool hasStorage(ModelManager::ModelType type)
+{
+    return type == ModelManager::Model_1 || type == ModelManager::Model_3 || type == ModelManager::Model_5;
+}
+
+bool hasBoundary(ModelManager::ModelType type)
+{
+    return type != ModelManager::Model_1 && type != ModelManager::Model_2;
+}
+
+qint16 toFixed(double v)
+{
+    if (!std::isfinite(v)) return kInvalid;
+    return (qint16)qBound(-32767.0, std::round(v * kFixedScale), 32767.0);
+}
+}
+
+TypeCurveBank::TypeCurveBank()
+    : m_logTD0(-7.0), m_step(0.25), m_nodeCount(49)
+{
+    for (const SampleRange& r : kRanges) m_keys << QString(r.key);
+}
+
+QString TypeCurveBank::defaultFilePath()
+{
+    QString dir = QStandardPaths::writableLocation(QStandardPaths::AppDataLocation);
+    QDir().mkpath(dir);
+    return dir + "/typecurves.bank";
+}
+
+bool TypeCurveBank::isEmpty() const { return m_entries.isEmpty(); }
+int TypeCurveBank::size() const { return m_entries.size(); }
+
+bool TypeCurveBank::save(const QString& path) const
+{
+    QFile file(path);
+    if (!file.open(QIODevice::WriteOnly)) return false;
+    QDataStream out(&file);
+    out.setVersion(QDataStream::Qt_6_0);
+    out << kMagic << kVersion << m_keys << m_logTD0 << m_step << (qint32)m_nodeCount << (qint32)m_entries.size();
+    for (const Entry& e : m_entries) {
+        out << e.type;
+        for (float v : e.values) out << v;
+        for (qint16 v : e.logP) out << v;
+        for (qint16 v : e.logD) out << v;
+    }
+    return out.status() == QDataStream::Ok;
+}
+
+bool TypeCurveBank::load(const QString& path)
+{
+    m_entries.clear();
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly)) return false;
+    QDataStream in(&file);
+    in.setVersion(QDataStream::Qt_6_0);
+    quint32 magic = 0, version = 0;
+    qint32 nodeCount = 0, entryCount = 0;
+    QStringList keys;
+    in >> magic >> version;
+    if (magic != kMagic || version != kVersion) return false;
+    in >> keys >> m_logTD0 >> m_step >> nodeCount >> entryCount;
+    if (in.status() != QDataStream::Ok || nodeCount <= 0 || entryCount < 0) return false;
+    m_keys = keys;
+    m_nodeCount = nodeCount;
+
+    QVector<Entry> entries(entryCount);
+    for (Entry& e : entries) {
+        in >> e.type;
+        e.values.resize(m_keys.size());
+        e.logP.resize(nodeCount); e.logD.resize(nodeCount);
+        for (float& v : e.values) in >> v;
+        for (qint16& v : e.logP) in >> v;
+        for (qint16& v : e.logD) in >> v;
+    }
+    if (in.status() != QDataStream::Ok) return false;
+    m_entries = entries;
+    return true;
+}
+
+QMap<QString, double> TypeCurveBank::entryParams(ModelManager::ModelType type, const QVector<float>& values) const
+{
+    // 换算参数取名义值，不影响无因次曲线
+    QMap<QString, double> p;
+    p["phi"] = 0.05; p["h"] = 20.0; p["mu"] = 0.5; p["B"] = 1.05; p["Ct"] = 5e-4; p["q"] = 5.0;
+    p["kf"] = 1e-3; p["L"] = 1000.0; p["nf"] = 4.0; p["gamaD"] = 0.02; p["N"] = 4;
+    for (int k = 0; k < m_keys.size() && k < values.size(); ++k) {
+        if (std::isfinite(values[k])) p[m_keys[k]] = values[k];
+    }
+    p["km"] = p["kf"] / qMax(p.value("M12", 10.0), 1e-12);
+    p["Lf"] = p.value("LfD", 0.1) * p["L"];
+    if (!hasStorage(type)) { p["cD"] = 0.0; p["S"] = 0.0; }
+    if (hasBoundary(type)) p["reD"] = p.value("rmD", 4.0) * p.value("reRatio", 3.0);
+    p.remove("M12"); p.remove("reRatio");
+    return p;
+}
+
+bool TypeCurveBank::generate(ModelManager* modelManager, int samplesPerModel, const CancellationToken* token, std::atomic<int>* progress)
+{
+    m_entries.clear();
+    if (!modelManager || samplesPerModel <= 0) return false;
+
+    const QList<ModelManager::ModelType> types = { ModelManager::Model_1, ModelManager::Model_2, ModelManager::Model_3,
+                                                   ModelManager::Model_4, ModelManager::Model_5, ModelManager::Model_6 };
+    const int dim = m_keys.size();
+    QVector<Entry> jobs;
+    for (ModelManager::ModelType type : types) {
+        QVector<QVector<double>> units = SurrogateModel::latinHypercube(samplesPerModel, dim, 1000u + (unsigned int)type);
+        for (const QVector<double>& u : units) {
+            Entry e;
+            e.type = (qint32)type;
+            e.values.resize(dim);
+            for (int k = 0; k < dim; ++k) {
+                const SampleRange& r = kRanges[k];
+                double v = r.log ? std::pow(10.0, std::log10(r.lo) + u[k] * (std::log10(r.hi) - std::log10(r.lo)))
+                                 : r.lo + u[k] * (r.hi - r.lo);
+                bool used = (m_keys[k] == "cD" || m_keys[k] == "S") ? hasStorage(type)
+                          : (m_keys[k] == "reRatio") ? hasBoundary(type) : true;
+                e.values[k] = used ? (float)v : qQNaN();
+            }
+            jobs.append(e);
+        }
+    }
+
+    QVector<double> nodeLogTD(m_nodeCount);
+    for (int j = 0; j < m_nodeCount; ++j) nodeLogTD[j] = m_logTD0 + j * m_step;
+    const double lo = nodeLogTD.first() - 0.05, hi = nodeLogTD.last() + 0.05;
+
+    QtConcurrent::blockingMap(jobs, [&](Entry& e) {
+        if (CancellationToken::cancelled(token)) return;
+        ModelManager::ModelType type = (ModelManager::ModelType)e.type;
+        QVector<double> gx, gy;
+        modelManager->buildDimensionlessGrid(type, entryParams(type, e.values), lo, hi, gx, gy, token);
+        e.logP.fill(kInvalid, m_nodeCount);
+        e.logD.fill(kInvalid, m_nodeCount);
+        if (gx.size() >= 2 && !CancellationToken::cancelled(token)) {
+            QVector<double> slope;
+            QVector<double> lp = CurveInterpolator::monotoneCubic(gx, gy, nodeLogTD, &slope);
+            for (int j = 0; j < m_nodeCount; ++j) {
+                // 双对数斜率即 dln(pD)/dln(tD)，pD' = pD * 斜率
+                e.logP[j] = toFixed(lp[j]);
+                e.logD[j] = slope[j] > 1e-6 ? toFixed(lp[j] + std::log10(slope[j])) : kInvalid;
+            }
+        }
+        if (progress) ++(*progress);
+    });
+    if (CancellationToken::cancelled(token)) return false;
+    m_entries = jobs;
+    return true;
+}
+
+QList<TypeCurveMatch> TypeCurveBank::match(const QVector<double>& t, const QVector<double>& p, const QVector<double>& d,
+                                           const QMap<QString, double>& baseParams, int topK) const
+{
+    QList<TypeCurveMatch> results;
+    if (m_entries.isEmpty()) return results;
+
+    // 1. 实测数据重采样到与图版同间距的 log10(t) 节点
+    QVector<double> lt, lp, ltd, ld;
+    for (int i = 0; i < t.size() && i < p.size(); ++i) {
+        if (t[i] <= 0 || p[i] <= 0) continue;
+        if (!lt.isEmpty() && std::log10(t[i]) <= lt.last()) continue;
+        lt.append(std::log10(t[i])); lp.append(std::log10(p[i]));
+        if (i < d.size() && d[i] > 0) { ltd.append(lt.last()); ld.append(std::log10(d[i])); }
+    }
+    if (lt.size() < 4) return results;
+    double o0 = std::ceil(lt.first() / m_step) * m_step;
+    int obsCount = int(std::floor((lt.last() - o0) / m_step + 1e-9)) + 1;
+    if (obsCount < kMinOverlap || obsCount > m_nodeCount) return results;
+    QVector<double> obsT(obsCount);
+    for (int k = 0; k < obsCount; ++k) obsT[k] = o0 + k * m_step;
+    QVector<double> obsP = CurveInterpolator::monotoneCubic(lt, lp, obsT);
+    QVector<double> obsD(obsCount, qQNaN());
+    if (ltd.size() >= 4) {
+        QVector<double> v = CurveInterpolator::monotoneCubic(ltd, ld, obsT);
+        for (int k = 0; k < obsCount; ++k) if (obsT[k] >= ltd.first() && obsT[k] <= ltd.last()) obsD[k] = v[k];
+    }
+
+    // 2. 每条图版先扫描整节点时间平移，再在最优节点附近做黄金分割细化 (节点间线性插值)；
+    //    压力平移取压力与导数差值的均值 (最小二乘最优)
+    auto evalOffset = [&](const Entry& en, double pos, double& misfit, double& mean) -> bool {
+        int m = (int)std::floor(pos);
+        double w = pos - m;
+        if (m < 0 || m + obsCount + (w > 0 ? 1 : 0) > m_nodeCount) return false;
+        auto node = [&](const QVector<qint16>& v, int j, double& out) -> bool {
+            if (v[j] == kInvalid) return false;
+            if (w <= 0) { out = v[j] / kFixedScale; return true; }
+            if (v[j + 1] == kInvalid) return false;
+            out = ((1.0 - w) * v[j] + w * v[j + 1]) / kFixedScale;
+            return true;
+        };
+        double sum = 0.0, sum2 = 0.0; int n = 0;
+        for (int k = 0; k < obsCount; ++k) {
+            double b;
+            if (node(en.logP, m + k, b)) { double r = obsP[k] - b; sum += r; sum2 += r * r; ++n; }
+            if (std::isfinite(obsD[k]) && node(en.logD, m + k, b)) { double r = obsD[k] - b; sum += r; sum2 += r * r; ++n; }
+        }
+        if (n < obsCount) return false;
+        mean = sum / n;
+        misfit = sum2 / n - mean * mean;
+        return true;
+    };
+    struct Score { int entry; double pos; double misfit; double shift; };
+    QVector<Score> scores;
+    scores.reserve(m_entries.size());
+    const double golden = 0.5 * (std::sqrt(5.0) - 1.0);
+    for (int e = 0; e < m_entries.size(); ++e) {
+        const Entry& en = m_entries[e];
+        Score best = { e, -1.0, 1e300, 0.0 };
+        for (int m = 0; m + obsCount <= m_nodeCount; ++m) {
+            double misfit, mean;
+            if (evalOffset(en, m, misfit, mean) && misfit < best.misfit) best = { e, (double)m, misfit, mean };
+        }
+        if (best.pos < 0) continue;
+
+        double a = qMax(0.0, best.pos - 0.5), b = qMin(double(m_nodeCount - obsCount), best.pos + 0.5);
+        for (int it = 0; it < 8; ++it) {
+            double x1 = b - golden * (b - a), x2 = a + golden * (b - a);
+            double f1, f2, c1, c2;
+            bool ok1 = evalOffset(en, x1, f1, c1), ok2 = evalOffset(en, x2, f2, c2);
+            if (!ok1 || !ok2) break;
+            if (f1 < f2) b = x2; else a = x1;
+        }
+        double misfit, mean;
+        if (evalOffset(en, 0.5 * (a + b), misfit, mean) && misfit < best.misfit) best = { e, 0.5 * (a + b), misfit, mean };
+        scores.append(best);
+    }
+    std::sort(scores.begin(), scores.end(), [](const Score& a, const Score& b) { return a.misfit < b.misfit; });
+
+    // 3. 由平移量反求 kf 与 L
+    //    Δp = 1.842e-3 q μ B / (kf h) * pD  ->  kf
+    //    tD = 14.4 kf t / (φ μ Ct L^2)      ->  L
+    double phi = baseParams.value("phi", 0.05), h = baseParams.value("h", 20.0), mu = baseParams.value("mu", 0.5);
+    double B = baseParams.value("B", 1.05), Ct = baseParams.value("Ct", 5e-4), q = baseParams.value("q", 5.0);
+    for (int i = 0; i < scores.size() && results.size() < topK; ++i) {
+        const Score& s = scores[i];
+        const Entry& en = m_entries[s.entry];
+        TypeCurveMatch r;
+        r.type = (ModelManager::ModelType)en.type;
+        r.misfit = s.misfit;
+        r.pressureShift = s.shift;
+        r.timeShift = (m_logTD0 + s.pos * m_step) - o0;
+
+        QMap<QString, double> dimless = entryParams(r.type, en.values);
+        double kf = 1.842e-3 * q * mu * B / (h * std::pow(10.0, r.pressureShift));
+        double L = std::sqrt(14.4 * kf / (phi * mu * Ct * std::pow(10.0, r.timeShift)));
+        if (!std::isfinite(kf) || !std::isfinite(L) || kf <= 0 || L <= 0) continue;
+        r.params = baseParams;
+        for (const QString& key : { QString("omega1"), QString("omega2"), QString("lambda1"), QString("rmD"),
+                                    QString("LfD"), QString("cD"), QString("S"), QString("reD") }) {
+            if (dimless.contains(key)) r.params[key] = dimless[key];
+        }
+        r.params["kf"] = kf;
+        r.params["km"] = kf * dimless["km"] / dimless["kf"];
+        r.params["L"] = L;
+        r.params["Lf"] = dimless["LfD"] * L;
+        results.append(r);
+    }
+    return results;
+}
@@ -0,0 +1,81 @@
+/*
+ * typecurvebank.h
+ * 文件作用：无因次图版库与图版匹配头文件
+ * 功能描述：
+ * 1. 离线生成: 对每个模型在无因次参数空间拉丁超立方抽样，计算 pD 与导数图版，保存为紧凑二进制文件
+ * 2. 图版以固定 log10(tD) 节点上的 log10(pD)、log10(pD') 表示 (定点 16 位整数存储)
+ * 3. 匹配: 实测数据重采样到同间距的 log10(t) 节点，对每条图版扫描时间平移，压力平移取解析最优值，
+ *    以双对数形状失配度排序，返回前 k 个匹配
+ * 4. 由时间平移与压力平移反求 kf 与 L，得到可直接作为 LM 初值的物理参数
+ */
+
+#ifndef TYPECURVEBANK_H
+#define TYPECURVEBANK_H
+
+#include <QVector>
+#include <QStringList>
+#include <QMap>
+#include <QList>
+#include <atomic>
+#include "modelmanager.h"
+#include "cancellationtoken.h"
+
+// 单个匹配结果
+struct TypeCurveMatch {
+    ModelManager::ModelType type;  // 模型类型
+    QMap<QString, double> params;  // 换算后的物理参数 (含 kf、km、L、Lf 及各无因次参数)
+    double misfit = 0.0;           // 双对数均方失配 (log10 单位)
+    double timeShift = 0.0;        // log10(tD / t)
+    double pressureShift = 0.0;    // log10(Δp / pD)
+};
+
+class TypeCurveBank
+{
+public:
+    TypeCurveBank();
+
+    // 默认图版库文件路径 (应用数据目录)
+    static QString defaultFilePath();
+
+    bool load(const QString& path);
+    bool save(const QString& path) const;
+    bool isEmpty() const;
+    int size() const;
+
+    /**
+     * @brief 生成图版库 (阻塞，通常在工作线程中调用，内部并行)
+     * @param samplesPerModel 每个模型的抽样条数
+     * @param progress 可选：已完成条数计数器，供界面轮询
+     * @return 被取消时返回 false，图版库保持为空
+     */
+    bool generate(ModelManager* modelManager, int samplesPerModel, const CancellationToken* token = nullptr,
+                  std::atomic<int>* progress = nullptr);
+
+    /**
+     * @brief 用实测压力/导数匹配图版库
+     * @param baseParams 当前参数表 (提供 phi、h、mu、B、Ct、q 等换算参数)
+     * @param topK 返回的匹配个数
+     */
+    QList<TypeCurveMatch> match(const QVector<double>& t, const QVector<double>& p, const QVector<double>& d,
+                                const QMap<QString, double>& baseParams, int topK) const;
+
+private:
+    struct Entry {
+        qint32 type;
+        QVector<float> values;   // 与 m_keys 对应的无因次参数值，不适用的参数为 NaN
+        QVector<qint16> logP;    // log10(pD) * 1000，无效节点为 kInvalid
+        QVector<qint16> logD;    // log10(pD') * 1000
+    };
+
+    // 把一组抽样值 (按 m_keys 顺序) 转为模型参数表
+    QMap<QString, double> entryParams(ModelManager::ModelType type, const QVector<float>& values) const;
+
+private:
+    QStringList m_keys;
+    double m_logTD0;    // 第一个节点的 log10(tD)
+    double m_step;      // 节点间距 (log10 单位)
+    int m_nodeCount;
+    QVector<Entry> m_entries;
+};
+
+#endif // TYPECURVEBANK_H
@@ -0,0 +1,99 @@
+/*
+ * typecurvematchdialog.cpp
+ * 文件作用：图版匹配结果对话框实现文件
+ * 功能描述：
+ * 1. 表格列出排名、模型、失配度及 kf、L 与各无因次参数
+ * 2. M12 由 kf/km 给出，缺少的参数显示为 "-"
+ */
+
+#include "typecurvematchdialog.h"
+
+#include <QVBoxLayout>
+#include <QHBoxLayout>
+#include <QLabel>
+#include <QPushButton>
+#include <QHeaderView>
+#include <QMessageBox>
+
+TypeCurveMatchDialog::TypeCurveMatchDialog(const QList<TypeCurveMatch>& matches, QWidget* parent)
+    : QDialog(parent), m_matches(matches), m_selectedIndex(-1), m_fitRequested(false)
+{
+    setWindowTitle("图版匹配结果"); resize(960, 380);
+
+    this->setStyleSheet(
+        "QDialog { background-color: #ffffff; color: #000000; font-family: 'Microsoft YaHei'; }"
+        "QLabel, QTableWidget { color: #000000; }"
+        "QTableWidget { gridline-color: #d0d0d0; border: 1px solid #c0c0c0; }"
+        "QHeaderView::section { background-color: #f0f0f0; border: 1px solid #d0d0d0; color: #000000; }"
+        "QPushButton { background-color: #ffffff; border: 1px solid #c0c0c0; border-radius: 4px; padding: 5px 15px; color: #333333; }"
+        "QPushButton:hover { background-color: #f2f2f2; border-color: #a0a0a0; color: #000000; }"
+        "QPushButton:pressed { background-color: #e0e0e0; }"
+        );
+
+    QVBoxLayout* layout = new QVBoxLayout(this);
+    layout->addWidget(new QLabel("按双对数形状失配度由小到大排序 (形状相近的图版可能对应不同参数组合，建议逐个尝试):", this));
+
+    m_table = new QTableWidget(this);
+    m_table->setSelectionBehavior(QAbstractItemView::SelectRows);
+    m_table->setSelectionMode(QAbstractItemView::SingleSelection);
+    m_table->setEditTriggers(QAbstractItemView::NoEditTriggers);
+    m_table->verticalHeader()->setVisible(false);
+    layout->addWidget(m_table);
+    fillTable();
+
+    QHBoxLayout* btns = new QHBoxLayout;
+    QPushButton* apply = new QPushButton("作为初值", this);
+    QPushButton* applyFit = new QPushButton("作为初值并拟合", this);
+    QPushButton* close = new QPushButton("关闭", this);
+    connect(apply, &QPushButton::clicked, this, [this]() { onApply(false); });
+    connect(applyFit, &QPushButton::clicked, this, [this]() { onApply(true); });
+    connect(close, &QPushButton::clicked, this, &QDialog::reject);
+    connect(m_table, &QTableWidget::cellDoubleClicked, this, [this](int, int) { onApply(false); });
+    btns->addStretch(); btns->addWidget(apply); btns->addWidget(applyFit); btns->addWidget(close);
+    layout->addLayout(btns);
+}
+
+int TypeCurveMatchDialog::selectedIndex() const { return m_selectedIndex; }
+
+bool TypeCurveMatchDialog::fitRequested() const { return m_fitRequested; }
+
+void TypeCurveMatchDialog::fillTable()
+{
+    const QStringList keys = { "kf", "L", "M12", "omega1", "omega2", "lambda1", "rmD", "reD", "cD", "S" };
+    QStringList headers;
+    headers << "排名" << "模型" << "失配度" << keys;
+    m_table->setColumnCount(headers.size());
+    m_table->setHorizontalHeaderLabels(headers);
+    m_table->setRowCount(m_matches.size());
+
+    for(int i = 0; i < m_matches.size(); ++i) {
+        const TypeCurveMatch& m = m_matches[i];
+        m_table->setItem(i, 0, new QTableWidgetItem(QString::number(i + 1)));
+        m_table->setItem(i, 1, new QTableWidgetItem(ModelManager::getModelTypeName(m.type)));
+        m_table->setItem(i, 2, new QTableWidgetItem(QString::number(m.misfit, 'e', 3)));
+        for(int k = 0; k < keys.size(); ++k) {
+            QString text = "-";
+            if(keys[k] == "M12") {
+                if(m.params.value("km") > 0) text = QString::number(m.params["kf"] / m.params["km"], 'g', 4);
+            } else if(m.params.contains(keys[k])) {
+                text = QString::number(m.params[keys[k]], 'g', 4);
+            }
+            m_table->setItem(i, 3 + k, new QTableWidgetItem(text));
+        }
+    }
+    m_table->resizeColumnsToContents();
+    m_table->horizontalHeader()->setStretchLastSection(true);
+    if(!m_matches.isEmpty()) m_table->selectRow(0);
+}
+
+void TypeCurveMatchDialog::onApply(bool runFit)
+{
+    int row = m_table->currentRow();
+    if(row < 0 || row >= m_matches.size()) {
+        QMessageBox::warning(this, "提示", "请选择一个匹配结果。");
+        return;
+    }
+    m_selectedIndex = row;
+    m_fitRequested = runFit;
+    accept();
+}
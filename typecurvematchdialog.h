@@ -0,0 +1,39 @@
+/*
+ * typecurvematchdialog.h
+ * 文件作用：图版匹配结果对话框头文件
+ * 功能描述：
+ * 1. 以表格展示图版库匹配得到的前 k 个候选 (模型、失配度、换算后的主要参数)
+ * 2. 用户可选择一行作为拟合初值，或作为初值并立即开始拟合
+ */
+
+#ifndef TYPECURVEMATCHDIALOG_H
+#define TYPECURVEMATCHDIALOG_H
+
+#include <QDialog>
+#include <QTableWidget>
+#include <QList>
+#include "typecurvebank.h"
+
+class TypeCurveMatchDialog : public QDialog
+{
+    Q_OBJECT
+
+public:
+    explicit TypeCurveMatchDialog(const QList<TypeCurveMatch>& matches, QWidget* parent = nullptr);
+
+    // 用户选择的候选序号，未选择时返回 -1
+    int selectedIndex() const;
+    // 是否要求采用后立即拟合
+    bool fitRequested() const;
+
+private:
+    QTableWidget* m_table;
+    QList<TypeCurveMatch> m_matches;
+    int m_selectedIndex;
+    bool m_fitRequested;
+
+    void fillTable();
+    void onApply(bool runFit);
+};
+
+#endif // TYPECURVEMATCHDIALOG_H
@@ -0,0 +1,358 @@
+/*
+ * typecurvetable.cpp
+ * 文件作用：无因次拉普拉斯解预制表实现文件
+ * 功能描述：
+ * 1. 文件格式 (小端): 魔数、版本、边界类型、轴数、z 节点数、数据偏移、z 节点定义、各轴取值，
+ *    其后为按轴行优先排列的 float 数据，每条曲线 zCount 个 log10(z·pf) 值 (无效值为 NaN)
+ * 2. 轴顺序: nf、M12、omega1、omega2、lambda1、rmD、LfD、reD/rmD；无限大边界的 reD/rmD 轴只有一个占位值
+ * 3. 查询: 各连续轴在 log10 坐标下定位所在单元，对 2^k 个角点加权求和 (k 为落在单元内部的轴数)；
+ *    任一角点的节点无效时该节点结果为 NaN
+ * 4. 写文件经 QSaveFile: 先写临时文件再改名替换，已映射的旧文件在替换前解除映射
+ */
+
+#include "typecurvetable.h"
+
+#include <QDir>
+#include <QDataStream>
+#include <QSaveFile>
+#include <QStandardPaths>
+#include <QtConcurrent>
+#include <QtEndian>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <algorithm>
+
+namespace {
+const quint32 kMagic = 0x57545454;   // "WTTT"
+const quint32 kVersion = 1;
+const double kLogZ0 = -8.0;          // z 节点: 10^-8 ~ 10^9，每对数周期 4 点
+const double kZStep = 0.25;
+const int kZCount = 69;
+
+// 连续参数轴: 对数均匀取点
+struct AxisSpec { const char* key; double lo; double hi; int count; };
+const AxisSpec kAxes[] = {
+    { "M12",     1.0,   100.0, 4 },
+    { "omega1",  0.01,  1.0,   4 },
+    { "omega2",  0.001, 1.0,   4 },
+    { "lambda1", 1e-5,  1e-1,  5 },
+    { "rmD",     1.5,   16.0,  4 },
+    { "LfD",     0.02,  0.5,   3 },
+    { "reRatio", 1.5,   10.0,  3 }   // reD = rmD * reRatio，仅边界模型
+};
+const int kFractureCounts[] = { 2, 4, 6, 8 };
+const int kAxisCount = 1 + int(sizeof(kAxes) / sizeof(kAxes[0]));
+
+// 各轴取值 (连续轴为 log10 值)
+QVector<QVector<double>> axisValues(TypeCurveTable::Geometry geometry)
+{
+    QVector<QVector<double>> out;
+    QVector<double> nf;
+    for (int n : kFractureCounts) nf.append(n);
+    out.append(nf);
+    for (const AxisSpec& a : kAxes) {
+        QVector<double> v;
+        bool single = (geometry == TypeCurveTable::Infinite && QString(a.key) == "reRatio");
+        if (single) { v.append(0.0); out.append(v); continue; }
+        double lo = std::log10(a.lo), hi = std::log10(a.hi);
+        for (int i = 0; i < a.count; ++i) v.append(lo + (hi - lo) * i / (a.count - 1));
+        out.append(v);
+    }
+    return out;
+}
+
+quint32 readU32(const uchar*& p) { quint32 v = qFromLittleEndian<quint32>(p); p += 4; return v; }
+double readF64(const uchar*& p)
+{
+    quint64 bits = qFromLittleEndian<quint64>(p); p += 8;
+    double v; std::memcpy(&v, &bits, sizeof(v));
+    return v;
+}
+}
+
+double LaplaceCurve::value(double z) const
+{
+    if (values.size() < 2 || z <= 0) return qQNaN();
+    double pos = (std::log10(z) - logZ0) / step;
+    if (pos < 0.0 || pos > values.size() - 1) return qQNaN();
+    int i = qMin((int)pos, values.size() - 2);
+    double w = pos - i;
+    double lzpf = (1.0 - w) * values[i] + w * values[i + 1];
+    return std::pow(10.0, lzpf) / z;
+}
+
+bool LaplaceCurve::covers(double zMin, double zMax) const
+{
+    if (values.size() < 2 || zMin <= 0 || zMax < zMin) return false;
+    double p0 = (std::log10(zMin) - logZ0) / step;
+    double p1 = (std::log10(zMax) - logZ0) / step;
+    if (p0 < 0.0 || p1 > values.size() - 1) return false;
+    for (int j = qMax(0, (int)p0); j <= qMin((int)std::ceil(p1), values.size() - 1); ++j) {
+        if (!std::isfinite(values[j])) return false;
+    }
+    return true;
+}
+
+TypeCurveTable::TypeCurveTable()
+    : m_geometry(Infinite), m_map(nullptr), m_data(nullptr), m_zCount(0), m_logZ0(0.0), m_zStep(1.0)
+{
+}
+
+TypeCurveTable::~TypeCurveTable()
+{
+    close();
+}
+
+QString TypeCurveTable::defaultFilePath(Geometry geometry)
+{
+    static const char* names[] = { "infinite", "closed", "constp" };
+    QString dir = QStandardPaths::writableLocation(QStandardPaths::AppDataLocation);
+    QDir().mkpath(dir);
+    return dir + QString("/typecurves_%1.tbl").arg(names[geometry]);
+}
+
+TypeCurveTable* TypeCurveTable::shared(Geometry geometry)
+{
+    static QMutex mutex;
+    static TypeCurveTable* tables[3] = { nullptr, nullptr, nullptr };
+    QMutexLocker locker(&mutex);
+    if (!tables[geometry]) {
+        tables[geometry] = new TypeCurveTable();
+        tables[geometry]->open(defaultFilePath(geometry), geometry);
+    }
+    return tables[geometry];
+}
+
+int TypeCurveTable::curveCount(Geometry geometry)
+{
+    int n = 1;
+    for (const QVector<double>& v : axisValues(geometry)) n *= v.size();
+    return n;
+}
+
+bool TypeCurveTable::computeData(Geometry geometry, const std::function<double(double, const QMap<QString, double>&)>& laplace,
+                                 const CancellationToken* token, std::atomic<int>* progress, QVector<float>& data)
+{
+    const QVector<QVector<double>> axes = axisValues(geometry);
+    const int total = curveCount(geometry);
+
+    // 并行计算各条曲线，每条曲线写入数据数组中自己的区段
+    data.resize(total * kZCount);
+    QVector<int> indices(total);
+    for (int i = 0; i < total; ++i) indices[i] = i;
+    float* dst = data.data();
+    QtConcurrent::blockingMap(indices, [&](int index) {
+        if (CancellationToken::cancelled(token)) return;
+        // 行优先: 最后一轴变化最快
+        QVector<double> v(kAxisCount);
+        int rest = index;
+        for (int k = kAxisCount - 1; k >= 0; --k) {
+            v[k] = axes[k][rest % axes[k].size()];
+            rest /= axes[k].size();
+        }
+        QMap<QString, double> p;
+        p["nf"] = v[0];
+        for (int k = 1; k < kAxisCount; ++k) p[kAxes[k - 1].key] = std::pow(10.0, v[k]);
+        p["kf"] = p["M12"];
+        p["km"] = 1.0;
+        p["reD"] = (geometry == Infinite) ? 0.0 : p["rmD"] * p["reRatio"];
+        p["cD"] = 0.0;
+        p["S"] = 0.0;
+
+        float* row = dst + (qint64)index * kZCount;
+        for (int j = 0; j < kZCount; ++j) {
+            double z = std::pow(10.0, kLogZ0 + kZStep * j);
+            double zpf = z * laplace(z, p);
+            row[j] = (std::isfinite(zpf) && zpf > 0) ? (float)std::log10(zpf) : std::numeric_limits<float>::quiet_NaN();
+        }
+        if (progress) progress->fetch_add(1, std::memory_order_relaxed);
+    });
+    return !CancellationToken::cancelled(token);
+}
+
+bool TypeCurveTable::writeTable(QIODevice* device, Geometry geometry, const QVector<float>& data)
+{
+    const QVector<QVector<double>> axes = axisValues(geometry);
+    QDataStream out(device);
+    out.setByteOrder(QDataStream::LittleEndian);
+    out.setFloatingPointPrecision(QDataStream::DoublePrecision);
+
+    quint32 headerSize = 6 * 4 + 2 * 8;
+    for (const QVector<double>& a : axes) headerSize += 4 + 8 * a.size();
+    quint32 dataOffset = (headerSize + 7) / 8 * 8;
+
+    out << kMagic << kVersion << (quint32)geometry << (quint32)kAxisCount << (quint32)kZCount << dataOffset;
+    out << kLogZ0 << kZStep;
+    for (const QVector<double>& a : axes) {
+        out << (quint32)a.size();
+        for (double v : a) out << v;
+    }
+    for (quint32 i = headerSize; i < dataOffset; ++i) out << (quint8)0;
+    out.setFloatingPointPrecision(QDataStream::SinglePrecision);
+    for (float v : data) out << v;
+    return out.status() == QDataStream::Ok;
+}
+
+bool TypeCurveTable::regenerate(const std::function<double(double, const QMap<QString, double>&)>& laplace,
+                                const CancellationToken* token, std::atomic<int>* progress)
+{
+    QString path;
+    Geometry geometry;
+    {
+        QMutexLocker locker(&m_mutex);
+        path = m_path;
+        geometry = m_geometry;
+    }
+    if (path.isEmpty()) return false;
+
+    // 计算与写临时文件期间旧表照常可查
+    QVector<float> data;
+    if (!computeData(geometry, laplace, token, progress, data)) return false;
+    QSaveFile file(path);
+    // 关闭直写回退: 目标文件仍被映射时不允许就地改写
+    file.setDirectWriteFallback(false);
+    if (!file.open(QIODevice::WriteOnly) || !writeTable(&file, geometry, data)) return false;
+
+    // 替换前解除映射 (Windows 下无法替换已映射的文件)，替换后立即重新打开
+    QMutexLocker locker(&m_mutex);
+    closeLocked();
+    bool committed = file.commit();
+    return openLocked(path, geometry) && committed;
+}
+
+bool TypeCurveTable::open(const QString& path, Geometry geometry)
+{
+    QMutexLocker locker(&m_mutex);
+    closeLocked();
+    return openLocked(path, geometry);
+}
+
+bool TypeCurveTable::openLocked(const QString& path, Geometry geometry)
+{
+    m_path = path;
+    m_geometry = geometry;
+
+    // 数据区直接按本机 float 读取，仅支持小端平台
+    if (QSysInfo::ByteOrder != QSysInfo::LittleEndian) return false;
+    m_file.setFileName(path);
+    if (!m_file.open(QIODevice::ReadOnly)) return false;
+    const qint64 size = m_file.size();
+    uchar* base = (size > 40) ? m_file.map(0, size) : nullptr;
+    if (!base) { m_file.close(); return false; }
+
+    auto fail = [&]() { m_file.unmap(base); m_file.close(); m_axes.clear(); return false; };
+    const uchar* p = base;
+    const uchar* end = base + size;
+    if (readU32(p) != kMagic || readU32(p) != kVersion || readU32(p) != (quint32)geometry) return fail();
+    quint32 axisCount = readU32(p);
+    m_zCount = (int)readU32(p);
+    quint32 dataOffset = readU32(p);
+    m_logZ0 = readF64(p);
+    m_zStep = readF64(p);
+    if ((int)axisCount != kAxisCount || m_zCount < 2 || dataOffset % 4 != 0) return fail();
+
+    qint64 curves = 1;
+    for (quint32 k = 0; k < axisCount; ++k) {
+        if (p + 4 > end) return fail();
+        quint32 n = readU32(p);
+        if (n == 0 || p + 8 * n > end) return fail();
+        Axis axis;
+        for (quint32 i = 0; i < n; ++i) axis.values.append(readF64(p));
+        m_axes.append(axis);
+        curves *= n;
+    }
+    if (p > base + dataOffset || dataOffset + curves * m_zCount * 4 > size) return fail();
+
+    int stride = 1;
+    for (int k = m_axes.size() - 1; k >= 0; --k) {
+        m_axes[k].stride = stride;
+        stride *= m_axes[k].values.size();
+    }
+    m_map = base;
+    m_data = reinterpret_cast<const float*>(base + dataOffset);
+    return true;
+}
+
+void TypeCurveTable::close()
+{
+    QMutexLocker locker(&m_mutex);
+    closeLocked();
+}
+
+void TypeCurveTable::closeLocked()
+{
+    if (m_map) m_file.unmap(m_map);
+    m_file.close();
+    m_map = nullptr;
+    m_data = nullptr;
+    m_axes.clear();
+}
+
+bool TypeCurveTable::isLoaded() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_data != nullptr;
+}
+
+bool TypeCurveTable::lookup(const QMap<QString, double>& key, LaplaceCurve& out) const
+{
+    QMutexLocker locker(&m_mutex);
+    if (!m_data) return false;
+
+    // 各轴定位: 下标 lo 与单元内权重 w (w 为 0 时该轴不参与角点组合)
+    QVector<int> lo(m_axes.size());
+    QVector<double> w(m_axes.size(), 0.0);
+    for (int k = 0; k < m_axes.size(); ++k) {
+        const QVector<double>& v = m_axes[k].values;
+        if (k == 0) {
+            int nf = qRound(key.value("nf", 4.0));
+            int idx = v.indexOf((double)nf);
+            if (idx < 0) return false;
+            lo[k] = idx;
+            continue;
+        }
+        if (v.size() == 1) { lo[k] = 0; continue; }
+
+        const QString name = kAxes[k - 1].key;
+        double x;
+        if (name == "reRatio") {
+            double rmD = key.value("rmD", 0.0);
+            x = rmD > 0 ? key.value("reD", 0.0) / rmD : 0.0;
+        } else {
+            x = key.value(name, 0.0);
+        }
+        if (!(x > 0)) return false;
+        double lx = std::log10(x);
+        if (lx < v.first() - 1e-9 || lx > v.last() + 1e-9) return false;
+        lx = qBound(v.first(), lx, v.last());
+        int i = int(std::upper_bound(v.begin(), v.end(), lx) - v.begin()) - 1;
+        i = qBound(0, i, v.size() - 2);
+        lo[k] = i;
+        w[k] = (lx - v[i]) / (v[i + 1] - v[i]);
+    }
+
+    QVector<int> active;
+    int base = 0;
+    for (int k = 0; k < m_axes.size(); ++k) {
+        base += lo[k] * m_axes[k].stride;
+        if (w[k] > 1e-12) active.append(k);
+    }
+
+    out.logZ0 = m_logZ0;
+    out.step = m_zStep;
+    out.values.fill(0.0, m_zCount);
+    for (int mask = 0; mask < (1 << active.size()); ++mask) {
+        double weight = 1.0;
+        int index = base;
+        for (int a = 0; a < active.size(); ++a) {
+            int k = active[a];
+            if (mask & (1 << a)) { weight *= w[k]; index += m_axes[k].stride; }
+            else weight *= 1.0 - w[k];
+        }
+        if (weight <= 0.0) continue;
+        const float* row = m_data + (qint64)index * m_zCount;
+        for (int j = 0; j < m_zCount; ++j) out.values[j] += weight * row[j];
+    }
+    return true;
+}
@@ -0,0 +1,103 @@
+/*
+ * typecurvetable.h
+ * 文件作用：无因次拉普拉斯解预制表头文件
+ * 功能描述：
+ * 1. 按边界类型 (无限大 / 封闭 / 定压) 各生成一个表文件，表中保存不含井储表皮的
+ *    log10(z·pf(z)) 在 M12、omega1、omega2、lambda1、rmD、LfD、reD/rmD 网格及若干裂缝条数上的取值
+ * 2. 表文件以内存映射方式打开，不整体读入内存；进程内每种边界只有一个共享实例，同一边界的各模型共用
+ * 3. 查询时在参数网格上多线性插值 (对数坐标)，得到一条拉普拉斯空间曲线；
+ *    井储表皮与压敏效应由调用方按原公式叠加，因此 cD、S、gamaD 不占表维度
+ * 4. 参数超出表范围或裂缝条数不在表中时查询失败，由调用方回退到完整求解
+ * 5. 重新生成时先写临时文件，持锁解除映射后整体替换并重新打开，其他持有者随即使用新表
+ */
+
+#ifndef TYPECURVETABLE_H
+#define TYPECURVETABLE_H
+
+#include <QFile>
+#include <QMap>
+#include <QMutex>
+#include <QVector>
+#include <QStringList>
+#include <atomic>
+#include <functional>
+#include "cancellationtoken.h"
+
+// 插值得到的一条拉普拉斯空间曲线: 等间距 log10(z) 节点上的 log10(z·pf)
+struct LaplaceCurve {
+    double logZ0 = 0.0;
+    double step = 1.0;
+    QVector<double> values;
+
+    // 返回 pf(z)；超出节点范围或落在无效节点区间时返回 NaN
+    double value(double z) const;
+    // [zMin, zMax] 是否全部落在有效节点上
+    bool covers(double zMin, double zMax) const;
+};
+
+class TypeCurveTable
+{
+public:
+    enum Geometry { Infinite = 0, Closed = 1, ConstantPressure = 2 };
+
+    TypeCurveTable();
+    ~TypeCurveTable();
+
+    // 默认表文件路径 (应用数据目录，每种边界一个文件)
+    static QString defaultFilePath(Geometry geometry);
+    // 进程内共享的表实例 (首次访问时打开默认表文件，文件不存在时为未加载状态)
+    static TypeCurveTable* shared(Geometry geometry);
+    // 生成表所需计算的曲线条数 (用于进度显示)
+    static int curveCount(Geometry geometry);
+
+    /**
+     * @brief 重新生成本实例最近一次打开的表文件 (阻塞，内部并行)
+     * 计算完成后写入临时文件；替换文件期间持锁解除映射，查询在此期间等待，替换后重新打开
+     * @param laplace 拉普拉斯空间解 pf(z)，参数表含 M12 (以 kf/km 给出)、omega1、omega2、lambda1、rmD、reD、LfD、nf，
+     *                cD、S 为 0；须可被多个线程并发调用
+     * @param progress 可选：已完成曲线条数计数器
+     * @return 被取消或写文件失败时返回 false，原有表保持打开
+     */
+    bool regenerate(const std::function<double(double, const QMap<QString, double>&)>& laplace,
+                    const CancellationToken* token = nullptr, std::atomic<int>* progress = nullptr);
+
+    // 以内存映射方式打开表文件；文件不存在、格式或边界类型不符时返回 false
+    bool open(const QString& path, Geometry geometry);
+    void close();
+    bool isLoaded() const;
+
+    /**
+     * @brief 按无因次参数插值出拉普拉斯空间曲线
+     * @param key 无因次参数 (M12、omega1、omega2、lambda1、rmD、LfD、nf，边界模型另需 reD)
+     * @return 表未加载或参数超出表范围时返回 false；个别节点无效 (极早期 z 上求解失败) 时对应值为 NaN
+     */
+    bool lookup(const QMap<QString, double>& key, LaplaceCurve& out) const;
+
+private:
+    // 并行计算全部曲线，被取消时返回 false
+    static bool computeData(Geometry geometry, const std::function<double(double, const QMap<QString, double>&)>& laplace,
+                            const CancellationToken* token, std::atomic<int>* progress, QVector<float>& data);
+    // 按文件格式写出表头与数据
+    static bool writeTable(QIODevice* device, Geometry geometry, const QVector<float>& data);
+    // 以下两个函数须在持有 m_mutex 时调用
+    bool openLocked(const QString& path, Geometry geometry);
+    void closeLocked();
+
+    struct Axis {
+        QVector<double> values;  // 连续轴为 log10 值，裂缝条数轴为原值
+        int stride = 0;          // 在数据数组中的跨度 (以曲线为单位)
+    };
+
+    mutable QMutex m_mutex;
+    QString m_path;
+    Geometry m_geometry;
+    QFile m_file;
+    uchar* m_map;            // 映射起始地址
+    const float* m_data;     // 数据区起始地址
+    QVector<Axis> m_axes;
+    int m_zCount;
+    double m_logZ0;
+    double m_zStep;
+};
+
+#endif // TYPECURVETABLE_H
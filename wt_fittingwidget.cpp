@@ -13,6 +13,12 @@
 #include "ui_wt_fittingwidget.h"
 #include "modelparameter.h"
 #include "modelselect.h"
+#include "modelcomparisondialog.h"
+#include "objectivelandscapedialog.h"
+#include "typecurvematchdialog.h"
+#include "mcmcdialog.h"
+#include "flowregimeidentifier.h"
+#include "flowregimeoverlay.h"
 
 #include <QtConcurrent>
 #include <QMessageBox>
@@ -31,8 +37,10 @@
 #include <QJsonObject>
 #include <QJsonArray>
 #include <QDateTime>
+#include <QProgressDialog>
+#include <QEventLoop>
+#include <QTimer>
 #include <QBuffer>
-#include <Eigen/Dense>
 
 // ===========================================================================
 // FittingWidget 实现
@@ -44,7 +52,9 @@ FittingWidget::FittingWidget(QWidget *parent) :
     m_modelManager(nullptr),
     m_plotTitle(nullptr),
     m_currentModelType(ModelManager::Model_1),
-    m_isFitting(false)
+    m_obsLocked(false),
+    m_isFitting(false),
+    m_previewPending(false)
 {
     ui->setupUi(this);
 
@@ -72,6 +82,13 @@ FittingWidget::FittingWidget(QWidget *parent) :
     connect(this, &FittingWidget::sigIterationUpdated, this, &FittingWidget::onIterationUpdate, Qt::QueuedConnection);
     connect(this, &FittingWidget::sigProgress, ui->progressBar, &QProgressBar::setValue);
     connect(&m_watcher, &QFutureWatcher<void>::finished, this, &FittingWidget::onFitFinished);
+    connect(&m_previewWatcher, &QFutureWatcher<ModelCurveData>::finished, this, &FittingWidget::onPreviewFinished);
+    connect(&m_refineWatcher, &QFutureWatcher<ModelCurveData>::finished, this, &FittingWidget::onRefinementFinished);
+    connect(&m_compareWatcher, &QFutureWatcher<void>::finished, this, &FittingWidget::onCompareFinished);
+    connect(&m_compareWatcher, &QFutureWatcher<void>::progressValueChanged, this, [this](int done) {
+        if(!m_compareSessions.isEmpty()) ui->progressBar->setValue(done * 100 / m_compareSessions.size());
+    });
+    connect(ui->tableParams, &QTableWidget::itemChanged, this, &FittingWidget::onParamTableItemChanged);
 
     // [注意] 此处删除了 btnSelectParams 的手动 connect，避免弹窗出现两次
 
@@ -83,7 +100,18 @@ FittingWidget::FittingWidget(QWidget *parent) :
     onSliderWeightChanged(50);
 }
 
-FittingWidget::~FittingWidget() { delete ui; }
+FittingWidget::~FittingWidget()
+{
+    // 页签关闭时停止仍在运行的拟合，并等待工作线程退出
+    if(m_session) m_session->requestStop();
+    for(const auto& s : m_compareSessions) s->requestStop();
+    cancelRefinement();
+    m_watcher.waitForFinished();
+    m_compareWatcher.waitForFinished();
+    m_previewWatcher.waitForFinished();
+    m_refineWatcher.waitForFinished();
+    delete ui;
+}
 
 void FittingWidget::setModelManager(ModelManager *m) {
     m_modelManager = m;
@@ -163,6 +191,7 @@ QJsonObject FittingWidget::getJsonState() const
     obsData["pressure"] = pressArr;
     obsData["derivative"] = derivArr;
     root["observedData"] = obsData;
+    root["observedDataLocked"] = m_obsLocked;
 
     return root;
 }
@@ -231,6 +260,7 @@ void FittingWidget::loadFittingState(const QJsonObject& root)
 
         setObservedData(t, p, d);
     }
+    m_obsLocked = root["observedDataLocked"].toBool(false);
 
     updateModelCurve();
 
@@ -431,6 +461,7 @@ void FittingWidget::setupPlot() {
 
 void FittingWidget::setObservedData(const QVector<double>& t, const QVector<double>& p, const QVector<double>& d) {
     m_obsTime = t; m_obsPressure = p; m_obsDerivative = d;
+    FlowRegimeOverlay::clear(m_plot);
 
     QVector<double> vt, vp, vd;
     for(int i=0; i<t.size(); ++i) {
@@ -477,20 +508,50 @@ void FittingWidget::on_btnRunFit_clicked() {
     if(m_obsTime.isEmpty()) { QMessageBox::warning(this,"错误","请先加载观测数据。"); return; }
 
     m_paramChart->updateParamsFromTable();
-    m_isFitting = true; m_stopRequested = false; ui->btnRunFit->setEnabled(false);
+    m_isFitting = true; ui->btnRunFit->setEnabled(false);
+    cancelRefinement();
 
-    ModelManager::ModelType modelType = m_currentModelType;
-    QList<FitParameter> paramsCopy = m_paramChart->getParameters();
+    // 会话持有模型类型、参数、权重和观测数据的快照，工作线程不再访问本控件
+    QSharedPointer<FitSession> session(new FitSession(m_modelManager), &QObject::deleteLater);
+    session->setModelType(m_currentModelType);
+    session->setParameters(m_paramChart->getParameters());
+    session->setWeight(ui->sliderWeight->value() / 100.0);
+    session->setObservedData(m_obsTime, m_obsPressure, m_obsDerivative);
 
-    double w = ui->sliderWeight->value() / 100.0;
-    (void)QtConcurrent::run([this, modelType, paramsCopy, w](){ runOptimizationTask(modelType, paramsCopy, w); });
+    applySessionOptions(session.data());
+
+    // 会话信号在工作线程发出，经排队连接转发到本控件
+    connect(session.data(), &FitSession::sigIterationUpdated, this, &FittingWidget::sigIterationUpdated, Qt::QueuedConnection);
+    connect(session.data(), &FitSession::sigProgress, this, &FittingWidget::sigProgress, Qt::QueuedConnection);
+
+    m_session = session;
+    m_watcher.setFuture(QtConcurrent::run([session](){ session->run(); }));
+}
+
+void FittingWidget::on_btnStop_clicked() {
+    if(m_session) m_session->requestStop();
+    for(const auto& s : m_compareSessions) s->requestStop();
 }
 
-void FittingWidget::runOptimizationTask(ModelManager::ModelType modelType, QList<FitParameter> fitParams, double weight) {
-    runLevenbergMarquardtOptimization(modelType, fitParams, weight);
+void FittingWidget::applySessionOptions(FitSession* session) const {
+    // 时间预算: 到达时限后返回当前最优参数
+    static const qint64 budgets[] = { 0, 2000, 10000, 30000 };
+    int budgetIndex = qBound(0, ui->comboTimeBudget->currentIndex(), 3);
+    session->setTimeBudget(budgets[budgetIndex]);
+    session->setSurrogateSearch(ui->chkSurrogate->isChecked());
+    // 拟合方法: LM 迭代，或限定真实模型调用次数的贝叶斯优化
+    static const int forwardBudgets[] = { 0, 60, 100 };
+    int methodIndex = qBound(0, ui->comboFitMethod->currentIndex(), 2);
+    session->setMethod(methodIndex == 0 ? FitSession::Method_LM : FitSession::Method_Bayesian);
+    if(methodIndex > 0) session->setForwardBudget(forwardBudgets[methodIndex]);
+    // 反演阶数: 迭代阶段固定用 N=4，最终曲线使用界面选择的阶数
+    session->setStehfestOrder(4, selectedStehfestOrder());
 }
 
-void FittingWidget::on_btnStop_clicked() { m_stopRequested=true; }
+int FittingWidget::selectedStehfestOrder() const {
+    static const int orders[] = { 6, 8, 10, 12 };
+    return orders[qBound(0, ui->comboStehfestOrder->currentIndex(), 3)];
+}
 void FittingWidget::on_btnImportModel_clicked() { updateModelCurve(); }
 
 void FittingWidget::on_btnExportData_clicked() {
@@ -566,140 +627,57 @@ void FittingWidget::updateModelCurve() {
     QVector<double> targetT = m_obsTime;
     if(targetT.isEmpty()) { for(double e = -4; e <= 4; e += 0.1) targetT.append(pow(10, e)); }
 
-    ModelCurveData res = m_modelManager->calculateTheoreticalCurve(type, currentParams, targetT);
-    onIterationUpdate(0, currentParams, std::get<0>(res), std::get<1>(res), std::get<2>(res));
-}
-
-void FittingWidget::runLevenbergMarquardtOptimization(ModelManager::ModelType modelType, QList<FitParameter> params, double weight) {
-    if(m_modelManager) m_modelManager->setHighPrecision(false);
-
-    QVector<int> fitIndices;
-    for(int i=0; i<params.size(); ++i) if(params[i].isFit) fitIndices.append(i);
-    int nParams = fitIndices.size();
-    if(nParams == 0) { QMetaObject::invokeMethod(this, "onFitFinished"); return; }
-
-    double lambda = 0.01; int maxIter = 50; double currentSSE = 1e15;
-    QMap<QString, double> currentParamMap;
-    for(const auto& p : params) currentParamMap.insert(p.name, p.value);
-
-    if(currentParamMap.contains("L") && currentParamMap.contains("Lf") && currentParamMap["L"] > 1e-9)
-        currentParamMap["LfD"] = currentParamMap["Lf"] / currentParamMap["L"];
-
-    QVector<double> residuals = calculateResiduals(currentParamMap, modelType, weight);
-    currentSSE = calculateSumSquaredError(residuals);
-    ModelCurveData curve = m_modelManager->calculateTheoreticalCurve(modelType, currentParamMap);
-    emit sigIterationUpdated(currentSSE/residuals.size(), currentParamMap, std::get<0>(curve), std::get<1>(curve), std::get<2>(curve));
+    // 第一阶段: 缓存或预制表命中时立即绘制粗网格预览，否则粗网格反演也放到后台
+    cancelRefinement();
+    QSharedPointer<CancellationToken> token(new CancellationToken);
+    m_refineToken = token;
+    m_refineParams = currentParams;
+
+    ModelManager* manager = m_modelManager;
+    ModelCurveData preview;
+    m_previewPending = !m_modelManager->cachedPreviewCurve(type, currentParams, targetT, preview);
+    if(!m_previewPending) {
+        onIterationUpdate(0, currentParams, std::get<0>(preview), std::get<1>(preview), std::get<2>(preview));
+    } else {
+        m_previewWatcher.setFuture(QtConcurrent::run([manager, type, currentParams, targetT, token]() {
+            if(token->isCancelled()) return ModelCurveData();
+            return manager->calculatePreviewCurve(type, currentParams, targetT);
+        }));
+    }
 
-    for(int iter = 0; iter < maxIter; ++iter) {
-        if(m_stopRequested) break;
-        if (!residuals.isEmpty() && (currentSSE / residuals.size()) < 3e-3) break;
+    // 第二阶段: 后台全精度计算，新的编辑会取消尚未完成的预览与细化
+    QMap<QString,double> fullParams = currentParams;
+    fullParams["N"] = selectedStehfestOrder();
+    m_refineWatcher.setFuture(QtConcurrent::run([manager, type, fullParams, targetT, token]() {
+        return manager->calculateTheoreticalCurve(type, fullParams, targetT, token.data());
+    }));
+}
 
-        emit sigProgress(iter * 100 / maxIter);
-        QVector<QVector<double>> J = computeJacobian(currentParamMap, residuals, fitIndices, modelType, params, weight);
-        int nRes = residuals.size();
+void FittingWidget::cancelRefinement() {
+    if(m_refineToken) m_refineToken->cancel();
+    m_refineToken.clear();
+}
 
-        QVector<QVector<double>> H(nParams, QVector<double>(nParams, 0.0));
-        QVector<double> g(nParams, 0.0);
-        for(int k=0; k<nRes; ++k) {
-            for(int i=0; i<nParams; ++i) {
-                g[i] += J[k][i] * residuals[k];
-                for(int j=0; j<=i; ++j) H[i][j] += J[k][i] * J[k][j];
-            }
-        }
-        for(int i=0; i<nParams; ++i) for(int j=i+1; j<nParams; ++j) H[i][j] = H[j][i];
-
-        bool stepAccepted = false;
-        for(int tryIter=0; tryIter<5; ++tryIter) {
-            QVector<QVector<double>> H_lm = H;
-            for(int i=0; i<nParams; ++i) H_lm[i][i] += lambda * (1.0 + std::abs(H[i][i]));
-            QVector<double> negG(nParams); for(int i=0;i<nParams;++i) negG[i] = -g[i];
-            QVector<double> delta = solveLinearSystem(H_lm, negG);
-
-            QMap<QString, double> trialMap = currentParamMap;
-            for(int i=0; i<nParams; ++i) {
-                int pIdx = fitIndices[i];
-                QString pName = params[pIdx].name;
-                double oldVal = currentParamMap[pName];
-                bool isLog = (oldVal > 1e-12 && pName != "S" && pName != "nf");
-                double newVal;
-                if(isLog) {
-                    double logVal = log10(oldVal) + delta[i];
-                    newVal = pow(10.0, logVal);
-                } else {
-                    newVal = oldVal + delta[i];
-                }
-                newVal = qMax(params[pIdx].min, qMin(newVal, params[pIdx].max));
-                trialMap[pName] = newVal;
-            }
-            if(trialMap.contains("L") && trialMap.contains("Lf") && trialMap["L"] > 1e-9) trialMap["LfD"] = trialMap["Lf"] / trialMap["L"];
-
-            QVector<double> newRes = calculateResiduals(trialMap, modelType, weight);
-            double newSSE = calculateSumSquaredError(newRes);
-            if(newSSE < currentSSE) {
-                currentSSE = newSSE; currentParamMap = trialMap; residuals = newRes; lambda /= 10.0; stepAccepted = true;
-                ModelCurveData iterCurve = m_modelManager->calculateTheoreticalCurve(modelType, currentParamMap);
-                emit sigIterationUpdated(currentSSE/nRes, currentParamMap, std::get<0>(iterCurve), std::get<1>(iterCurve), std::get<2>(iterCurve));
-                break;
-            } else { lambda *= 10.0; }
-        }
-        if(!stepAccepted && lambda > 1e10) break;
-    }
-
-    if(m_modelManager) m_modelManager->setHighPrecision(true);
-    if(currentParamMap.contains("L") && currentParamMap.contains("Lf") && currentParamMap["L"] > 1e-9)
-        currentParamMap["LfD"] = currentParamMap["Lf"] / currentParamMap["L"];
-    ModelCurveData finalCurve = m_modelManager->calculateTheoreticalCurve(modelType, currentParamMap);
-    emit sigIterationUpdated(currentSSE/residuals.size(), currentParamMap, std::get<0>(finalCurve), std::get<1>(finalCurve), std::get<2>(finalCurve));
-    QMetaObject::invokeMethod(this, "onFitFinished");
-}
-
-QVector<double> FittingWidget::calculateResiduals(const QMap<QString, double>& params, ModelManager::ModelType modelType, double weight) {
-    if(!m_modelManager || m_obsTime.isEmpty()) return QVector<double>();
-    ModelCurveData res = m_modelManager->calculateTheoreticalCurve(modelType, params, m_obsTime);
-    const QVector<double>& pCal = std::get<1>(res); const QVector<double>& dpCal = std::get<2>(res);
-    QVector<double> r; double wp = weight; double wd = 1.0 - weight;
-    int count = qMin(m_obsPressure.size(), pCal.size());
-    for(int i=0; i<count; ++i) {
-        if(m_obsPressure[i] > 1e-10 && pCal[i] > 1e-10) r.append( (log(m_obsPressure[i]) - log(pCal[i])) * wp ); else r.append(0.0);
-    }
-    int dCount = qMin(m_obsDerivative.size(), dpCal.size()); dCount = qMin(dCount, count);
-    for(int i=0; i<dCount; ++i) {
-        if(m_obsDerivative[i] > 1e-10 && dpCal[i] > 1e-10) r.append( (log(m_obsDerivative[i]) - log(dpCal[i])) * wd ); else r.append(0.0);
-    }
-    return r;
-}
-
-QVector<QVector<double>> FittingWidget::computeJacobian(const QMap<QString, double>& params, const QVector<double>& baseResiduals, const QVector<int>& fitIndices, ModelManager::ModelType modelType, const QList<FitParameter>& currentFitParams, double weight) {
-    int nRes = baseResiduals.size(); int nParams = fitIndices.size();
-    QVector<QVector<double>> J(nRes, QVector<double>(nParams));
-    for(int j = 0; j < nParams; ++j) {
-        int idx = fitIndices[j]; QString pName = currentFitParams[idx].name;
-        double val = params.value(pName); bool isLog = (val > 1e-12 && pName != "S" && pName != "nf");
-        double h; QMap<QString, double> pPlus = params; QMap<QString, double> pMinus = params;
-        if(isLog) { h = 0.01; double valLog = log10(val); pPlus[pName] = pow(10.0, valLog + h); pMinus[pName] = pow(10.0, valLog - h); }
-        else { h = 1e-4; pPlus[pName] = val + h; pMinus[pName] = val - h; }
-        auto updateDeps = [](QMap<QString,double>& map) { if(map.contains("L") && map.contains("Lf") && map["L"] > 1e-9) map["LfD"] = map["Lf"] / map["L"]; };
-        if(pName == "L" || pName == "Lf") { updateDeps(pPlus); updateDeps(pMinus); }
-        QVector<double> rPlus = calculateResiduals(pPlus, modelType, weight);
-        QVector<double> rMinus = calculateResiduals(pMinus, modelType, weight);
-        if(rPlus.size() == nRes && rMinus.size() == nRes) {
-            for(int i=0; i<nRes; ++i) J[i][j] = (rPlus[i] - rMinus[i]) / (2.0 * h);
-        }
-    }
-    return J;
+void FittingWidget::onPreviewFinished() {
+    // 已被取代、或全精度曲线已先完成 (令牌已清空) 时丢弃预览
+    if(!m_previewPending || !m_refineToken || m_refineToken->isCancelled() || m_isFitting) return;
+    m_previewPending = false;
+    ModelCurveData res = m_previewWatcher.result();
+    onIterationUpdate(0, m_refineParams, std::get<0>(res), std::get<1>(res), std::get<2>(res));
 }
 
-QVector<double> FittingWidget::solveLinearSystem(const QVector<QVector<double>>& A, const QVector<double>& b) {
-    int n = b.size(); if (n == 0) return QVector<double>();
-    Eigen::MatrixXd matA(n, n); Eigen::VectorXd vecB(n);
-    for (int i = 0; i < n; ++i) { vecB(i) = b[i]; for (int j = 0; j < n; ++j) matA(i, j) = A[i][j]; }
-    Eigen::VectorXd x = matA.ldlt().solve(vecB);
-    QVector<double> res(n); for (int i = 0; i < n; ++i) res[i] = x(i);
-    return res;
+void FittingWidget::onRefinementFinished() {
+    // 被取消 (参数再次修改或开始拟合) 的结果直接丢弃
+    if(!m_refineToken || m_refineToken->isCancelled() || m_isFitting) return;
+    ModelCurveData res = m_refineWatcher.result();
+    m_refineToken.clear();
+    onIterationUpdate(0, m_refineParams, std::get<0>(res), std::get<1>(res), std::get<2>(res));
 }
 
-double FittingWidget::calculateSumSquaredError(const QVector<double>& residuals) {
-    double sse = 0.0; for(double v : residuals) sse += v*v; return sse;
+void FittingWidget::onParamTableItemChanged(QTableWidgetItem* item) {
+    // 仅数值列的人工编辑触发预览；拟合过程中由迭代结果刷新
+    if(!item || item->column() != 2 || m_isFitting) return;
+    updateModelCurve();
 }
 
 void FittingWidget::onIterationUpdate(double err, const QMap<QString,double>& p,
@@ -719,7 +697,311 @@ void FittingWidget::onIterationUpdate(double err, const QMap<QString,double>& p,
     plotCurves(t, p_curve, d_curve, true);
 }
 
-void FittingWidget::onFitFinished() { m_isFitting = false; ui->btnRunFit->setEnabled(true); QMessageBox::information(this, "完成", "拟合完成。"); }
+void FittingWidget::onFitFinished() {
+    m_isFitting = false; ui->btnRunFit->setEnabled(true);
+    bool timedOut = m_session && m_session->isDeadlineReached();
+    m_session.reset();
+    if(timedOut) QMessageBox::information(this, "完成", "已达到拟合时间预算，已返回当前最优参数。");
+    else QMessageBox::information(this, "完成", "拟合完成。");
+}
+
+QList<FitParameter> FittingWidget::buildParamsForModel(ModelManager::ModelType type) const {
+    QList<FitParameter> current = m_paramChart->getParameters();
+    bool hasStorage = (type == ModelManager::Model_1 || type == ModelManager::Model_3 || type == ModelManager::Model_5);
+
+    QList<FitParameter> out;
+    QMap<QString, double> defaults = m_modelManager->getDefaultParameters(type);
+    QMapIterator<QString, double> it(defaults);
+    while(it.hasNext()) {
+        it.next();
+        FitParameter p;
+        bool found = false;
+        for(const auto& c : current) {
+            if(c.name == it.key()) { p = c; found = true; break; }
+        }
+        // 当前模型没有或取值无效的参数 (如 reD、变井储模型的 cD/S)：取默认值，新增的参数固定不拟合
+        bool storageKey = (it.key() == "cD" || it.key() == "S");
+        if(!found || (hasStorage && it.key() == "cD" && p.value <= 0)) {
+            p.name = it.key();
+            p.value = it.value();
+            if(!found) p.isFit = false;  // 已有参数 (如取值无效的 cD) 保留用户的拟合选择
+            FittingParameterChart::defaultBounds(p.name, p.value, p.min, p.max);
+            QString symbol, uniSym, unit;
+            FittingParameterChart::getParamDisplayInfo(p.name, p.displayName, symbol, uniSym, unit);
+            p.isVisible = true;
+        }
+        // 恒定井储模型不使用 cD/S，不计入拟合参数
+        if(!hasStorage && storageKey) { p.value = 0.0; p.isFit = false; }
+        out.append(p);
+    }
+    return out;
+}
+
+void FittingWidget::clearComparisonGraphs() {
+    // 图层 0-3 为实测与当前模型曲线，其后为对比叠加曲线
+    while(m_plot->graphCount() > 4) m_plot->removeGraph(m_plot->graphCount() - 1);
+}
+
+void FittingWidget::on_btnFitAllModels_clicked() {
+    if(m_isFitting) return;
+    if(m_obsTime.isEmpty()) { QMessageBox::warning(this,"错误","请先加载观测数据。"); return; }
+    if(!m_modelManager) return;
+
+    m_paramChart->updateParamsFromTable();
+    bool anyFit = false;
+    for(const auto& p : m_paramChart->getParameters()) anyFit = anyFit || p.isFit;
+    if(!anyFit) { QMessageBox::warning(this,"提示","请先在参数配置中选择需要拟合的参数。"); return; }
+
+    cancelRefinement();
+    clearComparisonGraphs();
+    m_plot->replot();
+
+    // 每个候选模型一个独立会话，参数以当前表格为基础
+    const QList<ModelManager::ModelType> candidates = { ModelManager::Model_1, ModelManager::Model_2, ModelManager::Model_3,
+                                                        ModelManager::Model_4, ModelManager::Model_5, ModelManager::Model_6 };
+    double w = ui->sliderWeight->value() / 100.0;
+    m_compareSessions.clear();
+    m_compareParams.clear();
+    for(ModelManager::ModelType type : candidates) {
+        QList<FitParameter> params = buildParamsForModel(type);
+        QSharedPointer<FitSession> session(new FitSession(m_modelManager), &QObject::deleteLater);
+        session->setModelType(type);
+        session->setParameters(params);
+        session->setWeight(w);
+        session->setObservedData(m_obsTime, m_obsPressure, m_obsDerivative);
+        applySessionOptions(session.data());
+        m_compareSessions.append(session);
+        m_compareParams.insert((int)type, params);
+    }
+
+    m_isFitting = true;
+    ui->btnRunFit->setEnabled(false); ui->btnFitAllModels->setEnabled(false);
+    ui->progressBar->setValue(0);
+    m_compareWatcher.setFuture(QtConcurrent::map(m_compareSessions, [](const QSharedPointer<FitSession>& s) { s->run(); }));
+}
+
+void FittingWidget::onCompareFinished() {
+    m_isFitting = false;
+    ui->btnRunFit->setEnabled(true); ui->btnFitAllModels->setEnabled(true);
+    ui->progressBar->setValue(100);
+
+    QList<ModelComparisonResult> results;
+    for(const auto& s : m_compareSessions) {
+        ModelComparisonResult r;
+        r.type = s->modelType();
+        r.params = s->resultParameters();
+        r.curve = s->resultCurve();
+        r.sse = s->resultSSE();
+        r.n = s->residualCount();
+        r.k = s->fittedParameterCount();
+        r.valid = r.n > 0;
+        results.append(r);
+    }
+    m_compareSessions.clear();
+    ModelComparisonDialog::rankResults(results);
+
+    // 叠加各模型的最优拟合曲线: 实线为压力，虚线为导数
+    static const QList<QColor> colors = { QColor(230, 25, 75), QColor(60, 180, 75), QColor(0, 130, 200),
+                                          QColor(245, 130, 48), QColor(145, 30, 180), QColor(70, 240, 240) };
+    clearComparisonGraphs();
+    for(int i = 0; i < results.size(); ++i) {
+        const ModelComparisonResult& r = results[i];
+        if(!r.valid) continue;
+        QColor c = colors[(int)r.type % colors.size()];
+        QCPGraph* gp = m_plot->addGraph();
+        gp->setData(std::get<0>(r.curve), std::get<1>(r.curve));
+        gp->setPen(QPen(c, 1.5, Qt::SolidLine));
+        gp->setName(QString("#%1 模型%2").arg(i + 1).arg((int)r.type + 1));
+        QCPGraph* gd = m_plot->addGraph();
+        gd->setData(std::get<0>(r.curve), std::get<2>(r.curve));
+        gd->setPen(QPen(c, 1.5, Qt::DashLine));
+        gd->removeFromLegend();
+    }
+    m_plot->replot();
+
+    ModelComparisonDialog dlg(results, this);
+    if(dlg.exec() == QDialog::Accepted && dlg.selectedIndex() >= 0) {
+        const ModelComparisonResult& best = results[dlg.selectedIndex()];
+        QList<FitParameter> params = m_compareParams.value((int)best.type);
+        for(auto& p : params) {
+            if(best.params.contains(p.name)) p.value = best.params[p.name];
+        }
+        m_currentModelType = best.type;
+        m_paramChart->setParameters(params);
+        ui->btn_modelSelect->setText("当前: " + ModelManager::getModelTypeName(best.type));
+        clearComparisonGraphs();
+        updateModelCurve();
+    }
+}
+
+void FittingWidget::on_btnLandscape_clicked() {
+    if(m_isFitting) return;
+    if(m_obsTime.isEmpty()) { QMessageBox::warning(this,"错误","请先加载观测数据。"); return; }
+    if(!m_modelManager) return;
+
+    m_paramChart->updateParamsFromTable();
+    ObjectiveLandscapeDialog dlg(m_modelManager, m_currentModelType, m_paramChart->getParameters(), ui->sliderWeight->value() / 100.0,
+                                 m_obsTime, m_obsPressure, m_obsDerivative, this);
+    if(dlg.exec() == QDialog::Accepted) {
+        QMap<QString, double> best = dlg.bestParameters();
+        if(best.isEmpty()) return;
+        QList<FitParameter> params = m_paramChart->getParameters();
+        for(auto& p : params) {
+            if(best.contains(p.name)) p.value = best[p.name];
+        }
+        m_paramChart->setParameters(params);
+        updateModelCurve();
+    }
+}
+
+void FittingWidget::on_btnTypeCurveMatch_clicked() {
+    if(m_isFitting) return;
+    if(m_obsTime.isEmpty()) { QMessageBox::warning(this,"错误","请先加载观测数据。"); return; }
+    if(!m_modelManager) return;
+
+    const QString bankPath = TypeCurveBank::defaultFilePath();
+    if(m_typeCurveBank.isEmpty() && !m_typeCurveBank.load(bankPath)) {
+        if(QMessageBox::question(this, "图版匹配", "未找到图版库文件，是否现在生成？\n(仅需生成一次，耗时约数分钟)") != QMessageBox::Yes) return;
+
+        const int samplesPerModel = 300;
+        CancellationToken token;
+        std::atomic<int> progress(0);
+        QProgressDialog dlg("正在生成图版库...", "取消", 0, samplesPerModel * 6, this);
+        dlg.setWindowModality(Qt::WindowModal);
+        dlg.setMinimumDuration(0);
+        connect(&dlg, &QProgressDialog::canceled, this, [&token]() { token.cancel(); });
+
+        QFutureWatcher<bool> watcher;
+        QEventLoop loop;
+        QTimer timer;
+        connect(&timer, &QTimer::timeout, &dlg, [&]() { dlg.setValue(progress.load()); });
+        connect(&watcher, &QFutureWatcher<bool>::finished, &loop, &QEventLoop::quit);
+        TypeCurveBank* bank = &m_typeCurveBank;
+        ModelManager* manager = m_modelManager;
+        watcher.setFuture(QtConcurrent::run([bank, manager, samplesPerModel, &token, &progress]() {
+            return bank->generate(manager, samplesPerModel, &token, &progress);
+        }));
+        timer.start(200);
+        loop.exec();
+        timer.stop();
+        dlg.reset();
+        if(!watcher.result() || m_typeCurveBank.isEmpty()) return;
+        if(!m_typeCurveBank.save(bankPath)) QMessageBox::warning(this, "提示", "图版库保存失败: " + bankPath);
+    }
+
+    m_paramChart->updateParamsFromTable();
+    QMap<QString, double> base;
+    for(const auto& p : m_paramChart->getParameters()) base.insert(p.name, p.value);
+    QList<TypeCurveMatch> matches = m_typeCurveBank.match(m_obsTime, m_obsPressure, m_obsDerivative, base, 10);
+    if(matches.isEmpty()) { QMessageBox::warning(this, "图版匹配", "实测数据时间跨度过短或与图版库无重叠，未找到匹配。"); return; }
+
+    TypeCurveMatchDialog dlg(matches, this);
+    if(dlg.exec() != QDialog::Accepted || dlg.selectedIndex() < 0) return;
+    const TypeCurveMatch& m = matches[dlg.selectedIndex()];
+
+    // 切换到匹配模型，并把匹配值写入参数表；超出原上下限的参数同步放宽范围
+    QList<FitParameter> params = buildParamsForModel(m.type);
+    for(auto& p : params) {
+        if(!m.params.contains(p.name)) continue;
+        if(p.name == "cD" || p.name == "S") {
+            bool hasStorage = (m.type == ModelManager::Model_1 || m.type == ModelManager::Model_3 || m.type == ModelManager::Model_5);
+            if(!hasStorage) continue;
+        }
+        p.value = m.params[p.name];
+        if(p.value < p.min) p.min = (p.value > 0) ? p.value * 0.1 : p.value;
+        if(p.value > p.max) p.max = p.value * 10.0;
+    }
+    m_currentModelType = m.type;
+    m_paramChart->setParameters(params);
+    ui->btn_modelSelect->setText("当前: " + ModelManager::getModelTypeName(m.type));
+    clearComparisonGraphs();
+    updateModelCurve();
+    if(dlg.fitRequested()) on_btnRunFit_clicked();
+}
+
+void FittingWidget::on_btnFlowRegime_clicked() {
+    if(m_isFitting) return;
+    if(m_obsTime.isEmpty()) { QMessageBox::warning(this,"错误","请先加载观测数据。"); return; }
+
+    QVector<FlowRegimeSegment> segments = FlowRegimeIdentifier::identify(m_obsTime, m_obsDerivative);
+    FlowRegimeOverlay::draw(m_plot, m_plot->xAxis, m_plot->yAxis, segments);
+    m_plot->replot();
+    if(segments.isEmpty()) { QMessageBox::warning(this, "流动段识别", "导数数据点不足或时间跨度过短，无法识别流动段。"); return; }
+
+    QString summary;
+    for(const FlowRegimeSegment& seg : segments) {
+        if(seg.regime == FlowRegimeSegment::Transition) continue;
+        summary += QString("%1: %2 ~ %3 h (斜率 %4)\n").arg(FlowRegimeSegment::regimeName(seg.regime))
+                       .arg(seg.tStart, 0, 'g', 3).arg(seg.tEnd, 0, 'g', 3).arg(seg.slope, 0, 'f', 2);
+    }
+
+    // 由井储段与径向流段估计初值，只保留当前模型含有的参数
+    m_paramChart->updateParamsFromTable();
+    QMap<QString, double> base;
+    for(const auto& p : m_paramChart->getParameters()) base.insert(p.name, p.value);
+    QMap<QString, double> estimates = FlowRegimeIdentifier::estimateParameters(segments, base);
+    bool hasStorage = (m_currentModelType == ModelManager::Model_1 || m_currentModelType == ModelManager::Model_3 || m_currentModelType == ModelManager::Model_5);
+    if(!hasStorage) estimates.remove("cD");
+    for(auto it = estimates.begin(); it != estimates.end();) {
+        if(base.contains(it.key())) ++it; else it = estimates.erase(it);
+    }
+    if(estimates.isEmpty()) {
+        QMessageBox::information(this, "流动段识别", summary + "\n未识别到可用于估计参数的井储段或径向流段。");
+        return;
+    }
+
+    QString text = summary + "\n参数估计:\n";
+    for(auto it = estimates.constBegin(); it != estimates.constEnd(); ++it)
+        text += QString("%1 = %2 (当前 %3)\n").arg(it.key()).arg(it.value(), 0, 'g', 4).arg(base.value(it.key()), 0, 'g', 4);
+    if(QMessageBox::question(this, "流动段识别", text + "\n是否写入参数表作为拟合初值？") != QMessageBox::Yes) return;
+
+    // 与图版匹配相同: 超出原上下限的参数同步放宽范围
+    QList<FitParameter> params = m_paramChart->getParameters();
+    for(auto& p : params) {
+        if(!estimates.contains(p.name)) continue;
+        p.value = estimates[p.name];
+        if(p.value < p.min) p.min = p.value * 0.1;
+        if(p.value > p.max) p.max = p.value * 10.0;
+    }
+    m_paramChart->setParameters(params);
+    updateModelCurve();
+}
+
+void FittingWidget::on_btnUncertainty_clicked() {
+    if(m_isFitting) return;
+    if(m_obsTime.isEmpty()) { QMessageBox::warning(this,"错误","请先加载观测数据。"); return; }
+    if(!m_modelManager) return;
+
+    m_paramChart->updateParamsFromTable();
+    McmcDialog dlg(m_modelManager, m_currentModelType, m_paramChart->getParameters(), ui->sliderWeight->value() / 100.0,
+                   m_obsTime, m_obsPressure, m_obsDerivative, this);
+    dlg.exec();
+}
+
+bool FittingWidget::hasObservedData() const { return !m_obsTime.isEmpty(); }
+bool FittingWidget::isFitting() const { return m_isFitting; }
+void FittingWidget::setObservedDataLocked(bool locked) { m_obsLocked = locked; }
+bool FittingWidget::isObservedDataLocked() const { return m_obsLocked; }
+
+JointFitDataset FittingWidget::jointFitDataset() {
+    m_paramChart->updateParamsFromTable();
+    JointFitDataset ds;
+    ds.type = m_currentModelType;
+    ds.params = m_paramChart->getParameters();
+    ds.weight = ui->sliderWeight->value() / 100.0;
+    ds.t = m_obsTime; ds.p = m_obsPressure; ds.d = m_obsDerivative;
+    return ds;
+}
+
+void FittingWidget::applyFittedParameters(const QMap<QString, double>& params) {
+    if(m_isFitting) return;
+    QList<FitParameter> current = m_paramChart->getParameters();
+    for(auto& p : current) {
+        if(params.contains(p.name)) p.value = params[p.name];
+    }
+    m_paramChart->setParameters(current);
+    updateModelCurve();
+}
 
 void FittingWidget::plotCurves(const QVector<double>& t, const QVector<double>& p, const QVector<double>& d, bool isModel) {
     QVector<double> vt, vp, vd;
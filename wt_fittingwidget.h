@@ -16,6 +16,7 @@
 #include <QVector>
 #include <QFutureWatcher>
 #include <QJsonObject>
+#include <QSharedPointer>
 #include "modelmanager.h"
 #include "mousezoom.h"
 #include "chartsetting1.h"
@@ -24,6 +25,9 @@
 #include "fittingparameterchart.h"
 #include "fittingobserveddata.h"
 #include "paramselectdialog.h"
+#include "fitsession.h"
+#include "typecurvebank.h"
+#include "jointfitsession.h"
 
 namespace Ui { class FittingWidget; }
 
@@ -50,6 +54,16 @@ public:
     // 获取当前拟合状态的 JSON 对象（用于保存到项目文件）
     QJsonObject getJsonState() const;
 
+    // 联合拟合接口: 是否已有观测数据、是否正在拟合、当前模型/参数/数据快照、回写拟合结果
+    bool hasObservedData() const;
+    bool isFitting() const;
+    JointFitDataset jointFitDataset();
+    void applyFittedParameters(const QMap<QString, double>& params);
+
+    // 观测数据锁定: 由流动段划分生成的分析页不随数据页的整段数据刷新
+    void setObservedDataLocked(bool locked);
+    bool isObservedDataLocked() const;
+
 signals:
     // 拟合完成信号
     void fittingCompleted(ModelManager::ModelType modelType, const QMap<QString, double>& parameters);
@@ -64,6 +78,11 @@ private slots:
     // UI 按钮槽函数
     void on_btnLoadData_clicked();      // 加载数据
     void on_btnRunFit_clicked();        // 开始拟合
+    void on_btnFitAllModels_clicked();  // 多模型并行拟合对比
+    void on_btnLandscape_clicked();     // 目标函数分布图
+    void on_btnTypeCurveMatch_clicked(); // 图版库匹配初值
+    void on_btnFlowRegime_clicked();    // 导数流动段识别与初值估计
+    void on_btnUncertainty_clicked();   // 参数不确定性分析
     void on_btnStop_clicked();          // 停止拟合
     void on_btnImportModel_clicked();   // 刷新曲线
     void on_btnExportData_clicked();    // 导出参数
@@ -80,7 +99,11 @@ private slots:
     // 内部逻辑槽函数
     void onIterationUpdate(double err, const QMap<QString,double>& p, const QVector<double>& t, const QVector<double>& p_curve, const QVector<double>& d_curve);
     void onFitFinished();
+    void onCompareFinished();
     void onSliderWeightChanged(int value); // 权重滑块改变
+    void onParamTableItemChanged(QTableWidgetItem* item); // 参数表数值被编辑
+    void onPreviewFinished();              // 后台粗网格预览计算完成
+    void onRefinementFinished();           // 后台全精度曲线计算完成
 
 private:
     Ui::FittingWidget *ui;
@@ -97,31 +120,43 @@ private:
     QVector<double> m_obsTime;
     QVector<double> m_obsPressure;
     QVector<double> m_obsDerivative;
+    bool m_obsLocked;
 
-    // 拟合控制标志
+    // 拟合控制: 每次拟合创建独立的会话对象，工作线程只持有会话的共享指针
     bool m_isFitting;
-    bool m_stopRequested;
+    QSharedPointer<FitSession> m_session;
     QFutureWatcher<void> m_watcher;
 
+    // 多模型对比: 每个候选模型一个独立会话，并行运行
+    QList<QSharedPointer<FitSession>> m_compareSessions;
+    QMap<int, QList<FitParameter>> m_compareParams; // 各模型的初始参数配置 (按模型类型)
+    QFutureWatcher<void> m_compareWatcher;
+
+    TypeCurveBank m_typeCurveBank;  // 图版库 (首次匹配时从文件加载)
+
+    // 交互预览: 缓存或预制表命中时立即绘制粗网格曲线，否则粗网格预览与全精度曲线都在后台计算
+    QSharedPointer<CancellationToken> m_refineToken;
+    QMap<QString, double> m_refineParams;
+    bool m_previewPending;  // 当前参数的预览在后台计算 (命中缓存时为 false，忽略更早的预览任务)
+    QFutureWatcher<ModelCurveData> m_previewWatcher;
+    QFutureWatcher<ModelCurveData> m_refineWatcher;
+
     // 初始化绘图控件配置
     void setupPlot();
     // 初始化默认模型状态
     void initializeDefaultModel();
-    // 根据当前参数更新理论曲线
+    // 根据当前参数更新理论曲线 (渐进式: 粗预览 + 后台细化)
     void updateModelCurve();
-
-    // 优化算法相关函数 (Levenberg-Marquardt)
-    void runOptimizationTask(ModelManager::ModelType modelType, QList<FitParameter> fitParams, double weight);
-    void runLevenbergMarquardtOptimization(ModelManager::ModelType modelType, QList<FitParameter> params, double weight);
-
-    // 计算残差
-    QVector<double> calculateResiduals(const QMap<QString, double>& params, ModelManager::ModelType modelType, double weight);
-    // 计算雅可比矩阵
-    QVector<QVector<double>> computeJacobian(const QMap<QString, double>& params, const QVector<double>& residuals, const QVector<int>& fitIndices, ModelManager::ModelType modelType, const QList<FitParameter>& currentFitParams, double weight);
-    // 求解线性方程组 (Eigen)
-    QVector<double> solveLinearSystem(const QVector<QVector<double>>& A, const QVector<double>& b);
-    // 计算平方误差和
-    double calculateSumSquaredError(const QVector<double>& residuals);
+    // 取消尚未完成的后台细化
+    void cancelRefinement();
+    // 以当前参数为基础，构造指定模型的拟合参数配置
+    QList<FitParameter> buildParamsForModel(ModelManager::ModelType type) const;
+    // 移除多模型对比叠加的曲线
+    void clearComparisonGraphs();
+    // 按界面选项 (时间预算、代理模型初值、拟合方法、反演阶数) 配置拟合会话
+    void applySessionOptions(FitSession* session) const;
+    // 界面选择的最终曲线 Stehfest 阶数
+    int selectedStehfestOrder() const;
 
     // 获取图表 Base64 字符串用于报告
     QString getPlotImageBase64();
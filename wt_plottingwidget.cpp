@@ -18,6 +18,10 @@
 #include "chartsetting1.h"
 #include "chartsetting2.h"
 #include "modelparameter.h"
+#include "derivativeengine.h"
+#include "derivativesmoother.h"
+#include "superpositiontime.h"
+#include "flowregimeoverlay.h"
 
 #include <QMessageBox>
 #include <QFileDialog>
@@ -27,6 +31,7 @@
 #include <QJsonObject>
 #include <QJsonArray>
 #include <QtMath>
+#include <limits>
 
 // === JSON 转换辅助 ===
 QJsonArray vectorToJson(const QVector<double>& vec) {
@@ -72,6 +77,11 @@ QJsonObject CurveInfo::toJson() const {
         obj["LSpacing"] = LSpacing;
         obj["isSmooth"] = isSmooth;
         obj["smoothFactor"] = smoothFactor;
+        obj["smoothMethod"] = smoothMethod;
+        obj["smoothWindow"] = smoothWindow;
+        obj["timeFunction"] = timeFunction;
+        obj["rateCurve"] = rateCurve;
+        obj["ratePeriod"] = ratePeriod;
         obj["derivData"] = vectorToJson(derivData);
         obj["derivShape"] = (int)derivShape;
         obj["derivPointColor"] = derivPointColor.name();
@@ -113,6 +123,11 @@ CurveInfo CurveInfo::fromJson(const QJsonObject& json) {
         info.LSpacing = json["LSpacing"].toDouble();
         info.isSmooth = json["isSmooth"].toBool();
         info.smoothFactor = json["smoothFactor"].toInt();
+        info.smoothMethod = json["smoothMethod"].toInt(DerivativeSmoothingConfig::MovingAverage);
+        info.smoothWindow = json["smoothWindow"].toDouble(0.3);
+        info.timeFunction = json["timeFunction"].toInt(SuperpositionTime::ElapsedTime);
+        info.rateCurve = json["rateCurve"].toString();
+        info.ratePeriod = json["ratePeriod"].toInt(0);
         info.derivData = jsonToVector(json["derivData"].toArray());
         info.derivShape = (QCPScatterStyle::ScatterShape)json["derivShape"].toInt();
         info.derivPointColor = QColor(json["derivPointColor"].toString());
@@ -155,7 +170,8 @@ WT_PlottingWidget::~WT_PlottingWidget()
     delete ui;
 }
 
-void WT_PlottingWidget::setDataModel(QStandardItemModel* model) { m_dataModel = model; }
+void WT_PlottingWidget::setDataModel(ColumnarTableModel* model) { m_dataModel = model; }
+void WT_PlottingWidget::setDecimationConfig(const DecimationConfig& config) { m_decimation = config; }
 void WT_PlottingWidget::setProjectPath(const QString& path) { m_projectPath = path; }
 
 // [新增] 加载项目数据
@@ -164,6 +180,7 @@ void WT_PlottingWidget::loadProjectData()
     // 1. 清空当前状态
     m_curves.clear();
     ui->listWidget_Curves->clear();
+    FlowRegimeOverlay::clear(ui->customPlot);
     ui->customPlot->clearGraphs();
     ui->customPlot->replot();
     m_currentDisplayedCurve.clear();
@@ -204,6 +221,7 @@ void WT_PlottingWidget::saveProjectData()
 void WT_PlottingWidget::setupPlotStyle(ChartMode mode)
 {
     m_currentMode = mode;
+    FlowRegimeOverlay::clear(ui->customPlot);
     ui->customPlot->plotLayout()->clear();
     ui->customPlot->clearGraphs();
 
@@ -265,8 +283,8 @@ void WT_PlottingWidget::on_btn_NewCurve_clicked()
         info.type = 0;
 
         for(int i=0; i<m_dataModel->rowCount(); ++i) {
-            info.xData.append(m_dataModel->item(i, info.xCol)->text().toDouble());
-            info.yData.append(m_dataModel->item(i, info.yCol)->text().toDouble());
+            info.xData.append(m_dataModel->value(i, info.xCol));
+            info.yData.append(m_dataModel->value(i, info.yCol));
         }
 
         m_curves.insert(info.name, info);
@@ -300,10 +318,10 @@ void WT_PlottingWidget::on_btn_PressureRate_clicked()
         info.x2Col = dlg.getProdXCol(); info.y2Col = dlg.getProdYCol();
 
         for(int i=0; i<m_dataModel->rowCount(); ++i) {
-            info.xData.append(m_dataModel->item(i, info.xCol)->text().toDouble());
-            info.yData.append(m_dataModel->item(i, info.yCol)->text().toDouble());
-            info.x2Data.append(m_dataModel->item(i, info.x2Col)->text().toDouble());
-            info.y2Data.append(m_dataModel->item(i, info.y2Col)->text().toDouble());
+            info.xData.append(m_dataModel->value(i, info.xCol));
+            info.yData.append(m_dataModel->value(i, info.yCol));
+            info.x2Data.append(m_dataModel->value(i, info.x2Col));
+            info.y2Data.append(m_dataModel->value(i, info.y2Col));
         }
 
         info.pointShape = dlg.getPressShape(); info.pointColor = dlg.getPressPointColor();
@@ -336,6 +354,10 @@ void WT_PlottingWidget::on_btn_Derivative_clicked()
 {
     if(!m_dataModel) return;
     PlottingDialog3 dlg(m_dataModel, this);
+    QStringList rateCurves;
+    for(auto it = m_curves.constBegin(); it != m_curves.constEnd(); ++it)
+        if(it.value().type == 1) rateCurves << it.key();
+    dlg.setRateCurves(rateCurves);
     if(dlg.exec() == QDialog::Accepted) {
         CurveInfo info;
         info.name = dlg.getCurveName();
@@ -347,41 +369,63 @@ void WT_PlottingWidget::on_btn_Derivative_clicked()
         info.LSpacing = dlg.getLSpacing();
         info.isSmooth = dlg.isSmoothEnabled();
         info.smoothFactor = dlg.getSmoothFactor();
+        DerivativeSmoothingConfig smoothing = dlg.getSmoothingConfig();
+        if(info.isSmooth) info.smoothMethod = smoothing.method;
+        info.smoothWindow = smoothing.logWindow;
+        info.rateCurve = dlg.getRateCurve();
+        info.timeFunction = dlg.getTimeFunction();
+        info.ratePeriod = dlg.getRatePeriod();
+
+        // 变产量: 由产量曲线构造产量史，只取选定流动段，横坐标为段内经过时间 Δt
+        RateHistory history;
+        int period = -1;
+        if(m_curves.contains(info.rateCurve)) {
+            const CurveInfo& rate = m_curves[info.rateCurve];
+            history = (rate.prodGraphType == 0) ? RateHistory::fromDurations(rate.x2Data, rate.y2Data)
+                                                : RateHistory::fromSamples(rate.x2Data, rate.y2Data);
+            int count = history.periodCount();
+            if(count > 0) period = (info.ratePeriod > 0) ? qMin(info.ratePeriod, count) - 1 : count - 1;
+        }
+        double tStart = 0, tEnd = std::numeric_limits<double>::infinity();
+        if(period >= 0) {
+            tStart = history.periodStart(period);
+            if(period + 1 < history.periodCount()) tEnd = history.periodStart(period + 1);
+        }
 
+        // 实测压力的基准取流动段开始时刻 (段前最后一点) 的压力
+        // 行数超过抽稀门限时逐点送入抽稀器，只保留每个对数周期的少量点
+        const bool decimate = m_decimation.appliesTo(m_dataModel->rowCount());
+        LogTimeDecimator decimator(m_decimation);
         double initialP = 0; bool first = true;
         for(int i=0; i<m_dataModel->rowCount(); ++i) {
-            double t = m_dataModel->item(i, info.xCol)->text().toDouble();
-            double p = m_dataModel->item(i, info.yCol)->text().toDouble();
+            double t = m_dataModel->value(i, info.xCol);
+            double p = m_dataModel->value(i, info.yCol);
+            if(period >= 0 && t <= tStart) { initialP = p; first = false; continue; }
+            if(t >= tEnd) continue;
             if(first) { initialP = p; first = false; }
             double dp = info.isMeasuredP ? std::abs(p - initialP) : p;
-            if(t > 0 && dp > 0) { info.xData.append(t); info.yData.append(dp); }
+            double dt = t - tStart;
+            if(dt > 0 && dp > 0) {
+                if(decimate) decimator.append(dt, dp);
+                else { info.xData.append(dt); info.yData.append(dp); }
+            }
+        }
+        if(decimate) {
+            decimator.finish();
+            info.xData = decimator.time();
+            info.yData = decimator.pressure();
         }
 
         if(info.xData.size() < 3) { QMessageBox::warning(this, "错误", "数据点不足"); return; }
 
-        QVector<double> derData;
-        for (int i = 0; i < info.xData.size(); ++i) {
-            double t = info.xData[i];
-            double logT = std::log(t);
-            int l=i, r=i;
-            while(l>0 && std::log(info.xData[l]) > logT - info.LSpacing) l--;
-            while(r<info.xData.size()-1 && std::log(info.xData[r]) < logT + info.LSpacing) r++;
-            double num = info.yData[r] - info.yData[l];
-            double den = std::log(info.xData[r]) - std::log(info.xData[l]);
-            derData.append(std::abs(den)>1e-6 ? num/den : 0);
-        }
+        // 与数据处理、拟合模块使用同一 Bourdet 导数算法，自变量按所选时间函数
+        QVector<double> axis = (period >= 0)
+            ? SuperpositionTime::derivativeAxis(history, period, info.xData, (SuperpositionTime::TimeFunction)info.timeFunction)
+            : DerivativeEngine::logTime(info.xData);
+        QVector<double> derData = DerivativeEngine::bourdetOnAxis(axis, info.yData, info.LSpacing);
 
-        if(info.isSmooth && info.smoothFactor > 1) {
-            QVector<double> smoothed;
-            int half = info.smoothFactor/2;
-            for (int i = 0; i < derData.size(); ++i) {
-                double sum = 0; int cnt = 0;
-                for (int j = i - half; j <= i + half; ++j) {
-                    if (j >= 0 && j < derData.size()) { sum += derData[j]; cnt++; }
-                }
-                smoothed.append(sum / cnt);
-            }
-            info.derivData = smoothed;
+        if(info.isSmooth) {
+            info.derivData = DerivativeSmoother::apply(info.xData, derData, smoothing);
         } else {
             info.derivData = derData;
         }
@@ -483,11 +527,18 @@ void WT_PlottingWidget::drawDerivativePlot(const CurveInfo& info)
     QPen p2(info.derivLineColor, 2, info.derivLineStyle);
     g2->setPen(p2);
     if(info.derivLineStyle == Qt::NoPen) g2->setLineStyle(QCPGraph::lsNone);
+    if(ui->check_ShowRegimes->isChecked()) drawRegimeOverlay(info, g2);
 
     ui->customPlot->rescaleAxes();
     ui->customPlot->replot();
 }
 
+void WT_PlottingWidget::drawRegimeOverlay(const CurveInfo& info, QCPGraph* derivGraph)
+{
+    FlowRegimeOverlay::draw(ui->customPlot, derivGraph->keyAxis(), derivGraph->valueAxis(),
+                            FlowRegimeIdentifier::identify(info.xData, info.derivData));
+}
+
 void WT_PlottingWidget::on_listWidget_Curves_itemDoubleClicked(QListWidgetItem *item)
 {
     QString name = item->text();
@@ -598,6 +649,16 @@ void WT_PlottingWidget::on_check_ShowLines_toggled(bool checked) {
     ui->customPlot->replot();
 }
 
+void WT_PlottingWidget::on_check_ShowRegimes_toggled(bool checked) {
+    // 只有单坐标系的导数图 (压力为第 0 条、导数为第 1 条曲线) 才标注流动段
+    FlowRegimeOverlay::clear(ui->customPlot);
+    if(checked && m_currentMode == Mode_Single && m_curves.contains(m_currentDisplayedCurve)
+        && m_curves[m_currentDisplayedCurve].type == 2 && ui->customPlot->graphCount() >= 2) {
+        drawRegimeOverlay(m_curves[m_currentDisplayedCurve], ui->customPlot->graph(1));
+    }
+    ui->customPlot->replot();
+}
+
 void WT_PlottingWidget::on_btn_FitToData_clicked() {
     ui->customPlot->rescaleAxes(); ui->customPlot->replot();
 }
@@ -618,8 +679,8 @@ void WT_PlottingWidget::on_btn_Manage_clicked() {
         if(info.type == 0) {
             info.xData.clear(); info.yData.clear();
             for(int i=0; i<m_dataModel->rowCount(); ++i) {
-                info.xData.append(m_dataModel->item(i, info.xCol)->text().toDouble());
-                info.yData.append(m_dataModel->item(i, info.yCol)->text().toDouble());
+                info.xData.append(m_dataModel->value(i, info.xCol));
+                info.yData.append(m_dataModel->value(i, info.yCol));
             }
         }
         if(m_currentDisplayedCurve == name) on_listWidget_Curves_itemDoubleClicked(item);
@@ -638,7 +699,7 @@ void WT_PlottingWidget::on_btn_Delete_clicked() {
     if(msgBox.exec() == QMessageBox::Yes) {
         m_curves.remove(name);
         delete item;
-        if(m_currentDisplayedCurve == name) { ui->customPlot->clearGraphs(); ui->customPlot->replot(); m_currentDisplayedCurve.clear(); }
+        if(m_currentDisplayedCurve == name) { FlowRegimeOverlay::clear(ui->customPlot); ui->customPlot->clearGraphs(); ui->customPlot->replot(); m_currentDisplayedCurve.clear(); }
     }
 }
 
@@ -2,12 +2,13 @@
 #define WT_PLOTTINGWIDGET_H
 
 #include <QWidget>
-#include <QStandardItemModel>
 #include <QMap>
 #include <QListWidgetItem>
 #include <QJsonObject>
+#include "columnartablemodel.h"
 #include "mousezoom.h"
 #include "plottingstackwidget.h"
+#include "logtimedecimator.h"
 
 namespace Ui {
 class WT_PlottingWidget;
@@ -40,6 +41,11 @@ struct CurveInfo {
     double LSpacing;
     bool isSmooth;
     int smoothFactor;
+    int smoothMethod;      // DerivativeSmoothingConfig::Method
+    double smoothWindow;   // 对数域滤波器的 ln t 半宽
+    int timeFunction;      // SuperpositionTime::TimeFunction
+    QString rateCurve;     // 产量史所在的压力产量图，空表示不使用
+    int ratePeriod;        // 分析的流动段 (从 1 开始，0 为最后一段)
 
     QVector<double> derivData; // 缓存
     QCPScatterStyle::ScatterShape derivShape;
@@ -49,7 +55,8 @@ struct CurveInfo {
 
     CurveInfo() : xCol(-1), yCol(-1), x2Col(-1), y2Col(-1),
         pointShape(QCPScatterStyle::ssDisc), type(0), prodGraphType(0),
-        isMeasuredP(true), LSpacing(0.1), isSmooth(false), smoothFactor(3) {}
+        isMeasuredP(true), LSpacing(0.1), isSmooth(false), smoothFactor(3),
+        smoothMethod(1), smoothWindow(0.3), timeFunction(0), ratePeriod(0) {}
 
     QJsonObject toJson() const;
     static CurveInfo fromJson(const QJsonObject& json);
@@ -63,7 +70,9 @@ public:
     explicit WT_PlottingWidget(QWidget *parent = nullptr);
     ~WT_PlottingWidget();
 
-    void setDataModel(QStandardItemModel* model);
+    void setDataModel(ColumnarTableModel* model);
+    // 导数曲线在数据量大时按此配置做对数时间抽稀
+    void setDecimationConfig(const DecimationConfig& config);
     void setProjectPath(const QString& path);
 
     // [新增] 加载并恢复图表数据
@@ -80,6 +89,7 @@ private slots:
 
     void on_listWidget_Curves_itemDoubleClicked(QListWidgetItem *item);
     void on_check_ShowLines_toggled(bool checked);
+    void on_check_ShowRegimes_toggled(bool checked);
     void on_btn_ExportData_clicked();
     void on_btn_ChartSettings_clicked();
     void on_btn_ExportImg_clicked();
@@ -88,7 +98,8 @@ private slots:
 
 private:
     Ui::WT_PlottingWidget *ui;
-    QStandardItemModel* m_dataModel;
+    ColumnarTableModel* m_dataModel;
+    DecimationConfig m_decimation;
     QString m_projectPath;
 
     QMap<QString, CurveInfo> m_curves;
@@ -113,6 +124,8 @@ private:
     void addCurveToPlot(const CurveInfo& info);
     void drawStackedPlot(const CurveInfo& info);
     void drawDerivativePlot(const CurveInfo& info);
+    // 在导数曲线上识别并标注流动段
+    void drawRegimeOverlay(const CurveInfo& info, QCPGraph* derivGraph);
 
     QListWidgetItem* getCurrentSelectedItem();
     void executeExport(bool fullRange, double startKey = 0, double endKey = 0);